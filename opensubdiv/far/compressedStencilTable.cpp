@@ -0,0 +1,329 @@
+//
+//   Copyright 2019 Pixar
+//
+//   Licensed under the Apache License, Version 2.0 (the "Apache License")
+//   with the following modification; you may not use this file except in
+//   compliance with the Apache License and the following modification to it:
+//   Section 6. Trademarks. is deleted and replaced with:
+//
+//   6. Trademarks. This License does not grant permission to use the trade
+//      names, trademarks, service marks, or product names of the Licensor
+//      and its affiliates, except as required to comply with Section 4(c) of
+//      the License and to reproduce the content of the NOTICE file.
+//
+//   You may obtain a copy of the Apache License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the Apache License with the above modification is
+//   distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//   KIND, either express or implied. See the Apache License for the specific
+//   language governing permissions and limitations under the Apache License.
+//
+
+#include "../far/compressedStencilTable.h"
+#include "../far/error.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace OpenSubdiv {
+namespace OPENSUBDIV_VERSION {
+
+namespace Far {
+
+unsigned short
+CompressedStencilTable::EncodeHalf(float f) {
+
+    unsigned int bits;
+    std::memcpy(&bits, &f, sizeof(float));
+
+    unsigned short sign = (unsigned short)((bits >> 16) & 0x8000);
+
+    float magnitude = std::fabs(f);
+    if (magnitude >= 65504.0f) {
+        // largest finite half
+        return sign | 0x7bff;
+    }
+    if (magnitude < 6.103515625e-05f) {
+        // denormal half : multiple of 2^-24
+        return sign | (unsigned short)(magnitude * 16777216.0f + 0.5f);
+    }
+
+    // rebias the exponent and round the mantissa to the nearest
+    unsigned int h = (((bits & 0x7fffffff) - (112u << 23)) + 0x1000) >> 13;
+    return sign | (unsigned short)h;
+}
+
+CompressedStencilTable const *
+CompressedStencilTable::Create(StencilTableReal<float> const & table,
+                               Options options) {
+
+    std::vector<int> const & sizes = table.GetSizes();
+    std::vector<Index> const & indices = table.GetControlIndices();
+    std::vector<float> const & weights = table.GetWeights();
+
+    int numStencils = table.GetNumStencils(),
+        blockSize = GetBlockSize();
+
+    CompressedStencilTable * result = new CompressedStencilTable;
+    result->_numControlVertices = table.GetNumControlVertices();
+
+    //
+    //  Sizes and offsets of the blocks (the weights of the source table are
+    //  not required to be contiguous, so its offsets are kept in 'offsets'):
+    //
+    std::vector<Index> offsets(numStencils);
+
+    result->_sizes.resize(numStencils);
+    result->_blockOffsets.reserve((numStencils + blockSize - 1) / blockSize);
+
+    int numElements = 0;
+    for (int i=0; i<numStencils; ++i) {
+        if (sizes[i] > 0xffff) {
+            Error(FAR_RUNTIME_ERROR, "Failure in CompressedStencilTable::Create() -- "
+                "stencil %d has more than 65535 weights.", i);
+            delete result;
+            return 0;
+        }
+        if ((i % blockSize) == 0) {
+            result->_blockOffsets.push_back(numElements);
+        }
+        offsets[i] = table.GetOffsets().empty() ?
+            (i ? offsets[i-1] + sizes[i-1] : 0) : table.GetOffsets()[i];
+
+        result->_sizes[i] = (unsigned short)sizes[i];
+        numElements += sizes[i];
+    }
+
+    for (int i=0; i<(int)result->_blockOffsets.size(); ++i) {
+        int blockEnd = (i+1 < (int)result->_blockOffsets.size()) ?
+            result->_blockOffsets[i+1] : numElements;
+        result->_maxBlockElements = std::max(result->_maxBlockElements,
+            blockEnd - result->_blockOffsets[i]);
+    }
+
+    //
+    //  Indices -- use the most compact of the encodings able to represent
+    //  all of them:
+    //
+    Index maxIndex = 0;
+    bool relativeFits = true;
+    for (int i=0; i<numStencils; ++i) {
+        Index const * stencilIndices = &indices[offsets[i]];
+
+        Index minStencilIndex = 0,
+              maxStencilIndex = 0;
+        for (int j=0; j<sizes[i]; ++j) {
+            minStencilIndex = j ? std::min(minStencilIndex, stencilIndices[j]) : stencilIndices[j];
+            maxStencilIndex = j ? std::max(maxStencilIndex, stencilIndices[j]) : stencilIndices[j];
+        }
+        maxIndex = std::max(maxIndex, maxStencilIndex);
+        relativeFits &= ((maxStencilIndex - minStencilIndex) <= 0xffff);
+    }
+
+    if (maxIndex <= 0xffff) {
+        result->_indexEncoding = INDEX_16;
+    } else if (relativeFits) {
+        result->_indexEncoding = INDEX_16_RELATIVE;
+        result->_indexBases.resize(numStencils);
+    } else {
+        result->_indexEncoding = INDEX_32;
+    }
+
+    if (result->_indexEncoding == INDEX_32) {
+        result->_indices32.resize(numElements);
+    } else {
+        result->_indices16.resize(numElements);
+    }
+
+    for (int i=0, dst=0; i<numStencils; ++i) {
+        Index const * stencilIndices = &indices[offsets[i]];
+
+        Index base = 0;
+        if (result->_indexEncoding == INDEX_16_RELATIVE) {
+            base = sizes[i] ? *std::min_element(stencilIndices, stencilIndices + sizes[i]) : 0;
+            result->_indexBases[i] = base;
+        }
+        for (int j=0; j<sizes[i]; ++j, ++dst) {
+            if (result->_indexEncoding == INDEX_32) {
+                result->_indices32[dst] = stencilIndices[j];
+            } else {
+                result->_indices16[dst] = (unsigned short)(stencilIndices[j] - base);
+            }
+        }
+    }
+
+    //
+    //  Weights -- the error is measured with the decoding used by the
+    //  evaluators:
+    //
+    result->_weightEncoding = options.weightEncoding;
+
+    if (result->_weightEncoding == WEIGHT_FIXED16) {
+        float maxWeight = 0.0f;
+        for (int i=0; i<numStencils; ++i) {
+            for (int j=0; j<sizes[i]; ++j) {
+                maxWeight = std::max(maxWeight, std::fabs(weights[offsets[i] + j]));
+            }
+        }
+        result->_weightScale = (maxWeight > 0.0f) ? (maxWeight / 32767.0f) : 1.0f;
+    }
+
+    if (result->_weightEncoding != WEIGHT_FLOAT) {
+        result->_weights16.resize(numElements);
+
+        for (int i=0, dst=0; i<numStencils; ++i) {
+            for (int j=0; j<sizes[i]; ++j, ++dst) {
+                float w = weights[offsets[i] + j];
+
+                if (result->_weightEncoding == WEIGHT_HALF) {
+                    result->_weights16[dst] = EncodeHalf(w);
+                } else {
+                    float q = std::floor(w / result->_weightScale + 0.5f);
+                    q = std::max(-32767.0f, std::min(32767.0f, q));
+                    result->_weights16[dst] = (unsigned short)(short)q;
+                }
+                result->_maxWeightError = std::max(result->_maxWeightError,
+                    std::fabs(result->decodeWeight(dst) - w));
+            }
+        }
+
+        if ((options.maxWeightError > 0.0f) &&
+            (result->_maxWeightError > options.maxWeightError)) {
+            std::vector<unsigned short>().swap(result->_weights16);
+            result->_weightEncoding = WEIGHT_FLOAT;
+            result->_weightScale = 1.0f;
+            result->_maxWeightError = 0.0f;
+        }
+    }
+
+    if (result->_weightEncoding == WEIGHT_FLOAT) {
+        result->_weights32.resize(numElements);
+        for (int i=0, dst=0; i<numStencils; ++i) {
+            for (int j=0; j<sizes[i]; ++j, ++dst) {
+                result->_weights32[dst] = weights[offsets[i] + j];
+            }
+        }
+    }
+    return result;
+}
+
+size_t
+CompressedStencilTable::GetMemoryUsage() const {
+
+    return sizeof(CompressedStencilTable) +
+        _sizes.size() * sizeof(unsigned short) +
+        _blockOffsets.size() * sizeof(Index) +
+        _indices16.size() * sizeof(unsigned short) +
+        _indexBases.size() * sizeof(Index) +
+        _indices32.size() * sizeof(Index) +
+        _weights16.size() * sizeof(unsigned short) +
+        _weights32.size() * sizeof(float);
+}
+
+Index
+CompressedStencilTable::GetOffset(Index stencil) const {
+
+    assert(stencil>=0 && stencil<=GetNumStencils());
+
+    int block = stencil / GetBlockSize();
+    if (block == (int)_blockOffsets.size()) {
+        // past the last stencil
+        return (Index)(_weights16.size() + _weights32.size());
+    }
+
+    Index offset = _blockOffsets[block];
+    for (Index i=block*GetBlockSize(); i<stencil; ++i) {
+        offset += _sizes[i];
+    }
+    return offset;
+}
+
+int
+CompressedStencilTable::GetStencil(Index stencil,
+                                   Index * indices, float * weights) const {
+
+    Index offset = GetOffset(stencil);
+
+    int size = _sizes[stencil];
+    for (int j=0; j<size; ++j) {
+        indices[j] = decodeIndex(stencil, offset + j);
+        weights[j] = decodeWeight(offset + j);
+    }
+    return size;
+}
+
+void
+CompressedStencilTable::DecodeStencils(Index start, Index end,
+    int * sizes, Index * indices, float * weights) const {
+
+    assert(start>=0 && start<=end && end<=GetNumStencils());
+
+    Index offset = GetOffset(start);
+
+    int numElements = 0;
+    for (Index i=start; i<end; ++i) {
+        sizes[i-start] = _sizes[i];
+        numElements += _sizes[i];
+    }
+    if (numElements == 0) {
+        return;
+    }
+
+    //  Decode each array with a loop specific to its encoding:
+    switch (_indexEncoding) {
+        case INDEX_16 : {
+            unsigned short const * src = &_indices16[offset];
+            for (int k=0; k<numElements; ++k) {
+                indices[k] = src[k];
+            }
+        } break;
+        case INDEX_16_RELATIVE : {
+            unsigned short const * src = &_indices16[offset];
+            for (Index i=start; i<end; ++i) {
+                Index base = _indexBases[i];
+                for (int j=0; j<_sizes[i]; ++j) {
+                    *indices++ = base + *src++;
+                }
+            }
+        } break;
+        default :
+            std::memcpy(indices, &_indices32[offset], numElements * sizeof(Index));
+            break;
+    }
+
+    switch (_weightEncoding) {
+        case WEIGHT_HALF : {
+            //  As DecodeHalf(), without branches so that the compiler
+            //  vectorizes the loop : denormal halves are rebiased as the
+            //  smallest normal exponent, which is then subtracted
+            unsigned short const * src = &_weights16[offset];
+            for (int k=0; k<numElements; ++k) {
+                unsigned int h = src[k],
+                             denormal = ((h & 0x7c00) == 0),
+                             bits = ((h & 0x7fff) << 13) + ((112u + denormal) << 23);
+                float magnitude;
+                std::memcpy(&magnitude, &bits, sizeof(float));
+                magnitude -= (float)(int)denormal * 6.103515625e-05f; // 2^-14
+                weights[k] = magnitude * (1.0f - (float)(int)((h >> 15) << 1));
+            }
+        } break;
+        case WEIGHT_FIXED16 : {
+            unsigned short const * src = &_weights16[offset];
+            float scale = _weightScale;
+            for (int k=0; k<numElements; ++k) {
+                weights[k] = (short)src[k] * scale;
+            }
+        } break;
+        default :
+            std::memcpy(weights, &_weights32[offset], numElements * sizeof(float));
+            break;
+    }
+}
+
+} // end namespace Far
+
+} // end namespace OPENSUBDIV_VERSION
+} // end namespace OpenSubdiv
@@ -0,0 +1,260 @@
+//
+//   Copyright 2019 Pixar
+//
+//   Licensed under the Apache License, Version 2.0 (the "Apache License")
+//   with the following modification; you may not use this file except in
+//   compliance with the Apache License and the following modification to it:
+//   Section 6. Trademarks. is deleted and replaced with:
+//
+//   6. Trademarks. This License does not grant permission to use the trade
+//      names, trademarks, service marks, or product names of the Licensor
+//      and its affiliates, except as required to comply with Section 4(c) of
+//      the License and to reproduce the content of the NOTICE file.
+//
+//   You may obtain a copy of the Apache License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the Apache License with the above modification is
+//   distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//   KIND, either express or implied. See the Apache License for the specific
+//   language governing permissions and limitations under the Apache License.
+//
+
+#ifndef OPENSUBDIV3_FAR_COMPRESSED_STENCILTABLE_H
+#define OPENSUBDIV3_FAR_COMPRESSED_STENCILTABLE_H
+
+#include "../version.h"
+
+#include "../far/types.h"
+#include "../far/stencilTable.h"
+
+#include <cassert>
+#include <cstring>
+#include <vector>
+
+namespace OpenSubdiv {
+namespace OPENSUBDIV_VERSION {
+
+namespace Far {
+
+/// \brief Table of subdivision stencils stored in a compact encoding
+///
+/// Applying a StencilTable is bound by the bandwidth needed to read its
+/// 32-bit indices and weights.  A CompressedStencilTable stores the same
+/// stencils with :
+///
+///   - 16-bit sizes and no per-stencil offsets : the offset of the first of
+///     each block of GetBlockSize() stencils is stored, the others being
+///     implied by the sizes,
+///
+///   - 16-bit control vertex indices, either absolute when the table indexes
+///     no more than 65536 control vertices, or relative to the smallest index
+///     of each stencil when those of each stencil span less than 65536, and
+///     32-bit indices otherwise,
+///
+///   - 16-bit weights, either IEEE half floats or fixed point numbers scaled
+///     by the largest weight of the table.
+///
+/// Indices are encoded without loss.  The largest difference between the
+/// decoded and the original weights is measured when the table is created,
+/// and the weights are kept as floats when it exceeds the bound given in the
+/// Options.
+///
+/// Compressed tables can be passed to Osd::CpuEvaluator::EvalStencils() and
+/// Osd::OmpEvaluator::EvalStencils(), which decode them on the fly.
+///
+class CompressedStencilTable {
+
+public:
+
+    enum IndexEncoding {
+        INDEX_32 = 0,               ///< 32-bit indices
+        INDEX_16,                   ///< 16-bit indices
+        INDEX_16_RELATIVE           ///< 16-bit indices relative to a 32-bit
+                                    ///  base index of each stencil
+    };
+
+    enum WeightEncoding {
+        WEIGHT_FLOAT = 0,           ///< 32-bit floats
+        WEIGHT_HALF,                ///< IEEE 754 half floats
+        WEIGHT_FIXED16              ///< 16-bit fixed point numbers scaled by
+                                    ///  GetWeightScale()
+    };
+
+    struct Options {
+
+        Options() : weightEncoding(WEIGHT_FLOAT),
+                    maxWeightError(0.0f) { }
+
+        WeightEncoding weightEncoding; ///< Encoding of the weights (lossless
+                                       ///  floats by default, 16-bit
+                                       ///  encodings must be requested)
+        float          maxWeightError; ///< Largest absolute error allowed on
+                                       ///  a weight, weights are stored as
+                                       ///  floats if exceeded (ignored if 0)
+    };
+
+    /// \brief Returns a compressed copy of a stencil table, or NULL if
+    ///        a stencil has more than 65535 weights
+    ///
+    /// @param table    The stencil table to compress
+    ///
+    /// @param options  Options controlling the encoding
+    ///
+    static CompressedStencilTable const * Create(
+        StencilTableReal<float> const & table, Options options = Options());
+
+    /// \brief Returns the number of stencils in the table
+    int GetNumStencils() const { return (int)_sizes.size(); }
+
+    /// \brief Returns the number of control vertices indexed in the table
+    int GetNumControlVertices() const { return _numControlVertices; }
+
+    /// \brief Returns the number of stencils of each block
+    static int GetBlockSize() { return 64; }
+
+    /// \brief Returns the largest number of weights of a block of stencils
+    int GetMaxBlockElements() const { return _maxBlockElements; }
+
+    /// \brief Returns the encoding of the control vertex indices
+    IndexEncoding GetIndexEncoding() const { return _indexEncoding; }
+
+    /// \brief Returns the encoding of the weights
+    WeightEncoding GetWeightEncoding() const { return _weightEncoding; }
+
+    /// \brief Returns the largest absolute error of a decoded weight
+    float GetMaxWeightError() const { return _maxWeightError; }
+
+    /// \brief Returns the scale of WEIGHT_FIXED16 weights
+    float GetWeightScale() const { return _weightScale; }
+
+    /// \brief Returns the memory used by the table, in bytes
+    size_t GetMemoryUsage() const;
+
+    /// \brief Returns the offset to the weights of the given stencil
+    Index GetOffset(Index stencil) const;
+
+    /// \brief Decodes the control vertex indices and weights of a stencil,
+    ///        returning the number of weights
+    ///
+    /// @param stencil  Index of the stencil
+    ///
+    /// @param indices  Destination of the control vertex indices
+    ///
+    /// @param weights  Destination of the weights
+    ///
+    int GetStencil(Index stencil, Index * indices, float * weights) const;
+
+    /// \brief Decodes consecutive stencils in the arrays of a StencilTable
+    ///
+    /// @param start    Index of the first stencil
+    ///
+    /// @param end      Index after the last stencil
+    ///
+    /// @param sizes    Destination of the number of weights of each stencil
+    ///
+    /// @param indices  Destination of the control vertex indices
+    ///
+    /// @param weights  Destination of the weights
+    ///
+    void DecodeStencils(Index start, Index end,
+                        int * sizes, Index * indices, float * weights) const;
+
+    /// \brief Updates point values based on the control values
+    ///
+    /// @param controlValues  Buffer with primvar data for the control vertices
+    ///
+    /// @param values         Destination buffer for the interpolated primvar
+    ///                       data
+    ///
+    template <class T>
+    void UpdateValues(T const *controlValues, T *values) const;
+
+    /// \brief Returns the float value of an IEEE half float
+    static float DecodeHalf(unsigned short h) {
+        //  Normal halves are rebiased into floats, denormal halves converted
+        //  from their integer mantissa (so that no denormal float, which is
+        //  slow to operate on, is produced -- Inf and NaN never occur)
+        unsigned int bits = ((unsigned int)(h & 0x7fff) << 13) + (112u << 23);
+        float magnitude;
+        std::memcpy(&magnitude, &bits, sizeof(float));
+        if ((h & 0x7c00) == 0) {
+            magnitude = (float)(h & 0x03ff) * 5.9604644775390625e-08f; // 2^-24
+        }
+        return (h & 0x8000) ? -magnitude : magnitude;
+    }
+
+    /// \brief Returns the IEEE half float nearest to a float (clamped to the
+    ///        largest half)
+    static unsigned short EncodeHalf(float f);
+
+protected:
+    CompressedStencilTable() :
+        _numControlVertices(0), _maxBlockElements(0),
+        _indexEncoding(INDEX_32), _weightEncoding(WEIGHT_FLOAT),
+        _weightScale(1.0f), _maxWeightError(0.0f) { }
+
+    float decodeWeight(Index i) const {
+        switch (_weightEncoding) {
+            case WEIGHT_HALF    : return DecodeHalf(_weights16[i]);
+            case WEIGHT_FIXED16 : return (short)_weights16[i] * _weightScale;
+            default             : return _weights32[i];
+        }
+    }
+
+    Index decodeIndex(Index stencil, Index i) const {
+        switch (_indexEncoding) {
+            case INDEX_16          : return _indices16[i];
+            case INDEX_16_RELATIVE : return _indexBases[stencil] + _indices16[i];
+            default                : return _indices32[i];
+        }
+    }
+
+    int _numControlVertices,
+        _maxBlockElements;
+
+    IndexEncoding  _indexEncoding;
+    WeightEncoding _weightEncoding;
+
+    float _weightScale,
+          _maxWeightError;
+
+    std::vector<unsigned short> _sizes;        // number of weights of each stencil
+    std::vector<Index>          _blockOffsets; // offset of the first stencil of each block
+
+    std::vector<unsigned short> _indices16;    // INDEX_16 and INDEX_16_RELATIVE
+    std::vector<Index>          _indexBases;   // INDEX_16_RELATIVE
+    std::vector<Index>          _indices32;    // INDEX_32
+
+    std::vector<unsigned short> _weights16;    // WEIGHT_HALF and WEIGHT_FIXED16
+    std::vector<float>          _weights32;    // WEIGHT_FLOAT
+};
+
+// Update values by applying the decoded weights to new control values
+template <class T> void
+CompressedStencilTable::UpdateValues(T const *controlValues, T *values) const {
+
+    Index offset = 0;
+    for (int i=0; i<GetNumStencils(); ++i) {
+
+        // Zero out the result accumulators
+        values[i].Clear();
+
+        // For each element in the array, add the coef's contribution
+        for (int j=0; j<_sizes[i]; ++j, ++offset) {
+            values[i].AddWithWeight( controlValues[decodeIndex(i, offset)],
+                                     decodeWeight(offset) );
+        }
+    }
+}
+
+} // end namespace Far
+
+} // end namespace OPENSUBDIV_VERSION
+using namespace OPENSUBDIV_VERSION;
+
+} // end namespace OpenSubdiv
+
+#endif /* OPENSUBDIV3_FAR_COMPRESSED_STENCILTABLE_H */
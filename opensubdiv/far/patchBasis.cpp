@@ -40,35 +40,116 @@ enum SplineBasis {
     BASIS_BOX_SPLINE
 };
 
+//
+//  Parameterization of the locations of a batch, extracted from their
+//  PatchParams before all locations are evaluated together (the batch is
+//  padded with the first location):
+//
+template <typename REAL>
+struct BatchParams {
+    static int const N = BASIS_BATCH_SIZE;
+
+    BatchParams(int numPoints, PatchParam const params[],
+                REAL const sIn[], REAL const tIn[]) {
+
+        assert(numPoints>0 && numPoints<=N);
+
+        //  Unpack the PatchParams:
+        float fracInv[N];
+        REAL  uOrigin[N],
+              vOrigin[N];
+
+        for (int k = 0; k < N; ++k) {
+            int i = (k < numPoints) ? k : 0;
+
+            PatchParam const & param = params[i];
+
+            int depth = param.GetDepth();
+
+            fracInv[k] = float(1 << (param.NonQuadRoot() ? (depth-1) : depth));
+            uOrigin[k] = (REAL)param.GetU();
+            vOrigin[k] = (REAL)param.GetV();
+
+            s[k] = sIn[i];
+            t[k] = tIn[i];
+            dScale[k] = (REAL)(1 << depth);
+
+            //  boundary edges as 0 or 1 multipliers to adjust weights without
+            //  branches
+            int boundary = param.GetBoundary();
+            for (int edge = 0; edge < 4; ++edge) {
+                boundaryMask[edge][k] = (REAL)((boundary >> edge) & 1);
+            }
+        }
+
+        //  Normalize the locations (as PatchParam::Normalize()):
+        for (int k = 0; k < N; ++k) {
+            REAL frac = (REAL)(1.0f / fracInv[k]);
+
+            s[k] = (s[k] - uOrigin[k]*frac) / frac;
+            t[k] = (t[k] - vOrigin[k]*frac) / frac;
+        }
+    }
+
+    REAL s[N],
+         t[N],
+         dScale[N],
+         boundaryMask[4][N];
+};
+
 template <SplineBasis BASIS>
 class Spline {
 
 public:
 
     // curve weights
-    static void GetWeights(float t, float point[], float deriv[], float deriv2[]);
+    template <typename REAL>
+    static void GetWeights(REAL t, REAL point[], REAL deriv[], REAL deriv2[]);
 
     // box-spline weights
-    static void GetWeights(float v, float w, float point[]);
+    template <typename REAL>
+    static void GetWeights(REAL v, REAL w, REAL point[]);
 
     // patch weights
+    template <typename REAL>
     static void GetPatchWeights(PatchParam const & param,
-        float s, float t, float point[], float deriv1[], float deriv2[], float deriv11[], float deriv12[], float deriv22[]);
+        REAL s, REAL t, REAL point[], REAL deriv1[], REAL deriv2[], REAL deriv11[], REAL deriv12[], REAL deriv22[]);
 
     // adjust patch weights for boundary (and corner) edges
+    template <typename REAL>
     static void AdjustBoundaryWeights(PatchParam const & param,
-        float sWeights[4], float tWeights[4]);
+        REAL sWeights[4], REAL tWeights[4]);
+
+    //
+    //  Batched variants -- weights are interleaved by location (see
+    //  BASIS_BATCH_SIZE):
+    //
+
+    // curve weights
+    template <typename REAL>
+    static void GetWeightsBatch(REAL const t[], REAL point[], REAL deriv[], REAL deriv2[]);
+
+    // patch weights
+    template <typename REAL>
+    static void GetPatchWeightsBatch(BatchParams<REAL> const & params,
+        REAL point[], REAL deriv1[], REAL deriv2[], REAL deriv11[], REAL deriv12[], REAL deriv22[]);
+
+    // adjust patch weights for boundary (and corner) edges
+    template <typename REAL>
+    static void AdjustBoundaryWeightsBatch(BatchParams<REAL> const & params,
+        REAL sWeights[], REAL tWeights[]);
 };
 
 template <>
+template <typename REAL>
 inline void Spline<BASIS_BEZIER>::GetWeights(
-    float t, float point[4], float deriv[4], float deriv2[4]) {
+    REAL t, REAL point[4], REAL deriv[4], REAL deriv2[4]) {
 
     // The four uniform cubic Bezier basis functions (in terms of t and its
     // complement tC) evaluated at t:
-    float t2 = t*t;
-    float tC = 1.0f - t;
-    float tC2 = tC * tC;
+    REAL t2 = t*t;
+    REAL tC = 1.0f - t;
+    REAL tC2 = tC * tC;
 
     assert(point);
     point[0] = tC2 * tC;
@@ -94,14 +175,15 @@ inline void Spline<BASIS_BEZIER>::GetWeights(
 }
 
 template <>
+template <typename REAL>
 inline void Spline<BASIS_BSPLINE>::GetWeights(
-    float t, float point[4], float deriv[4], float deriv2[4]) {
+    REAL t, REAL point[4], REAL deriv[4], REAL deriv2[4]) {
 
     // The four uniform cubic B-Spline basis functions evaluated at t:
-    float const one6th = 1.0f / 6.0f;
+    REAL const one6th = (REAL)(1.0 / 6.0);
 
-    float t2 = t * t;
-    float t3 = t * t2;
+    REAL t2 = t * t;
+    REAL t3 = t * t2;
 
     assert(point);
     point[0] = one6th * (1.0f - 3.0f*(t -      t2) -      t3);
@@ -127,10 +209,11 @@ inline void Spline<BASIS_BSPLINE>::GetWeights(
 }
 
 template <>
+template <typename REAL>
 inline void Spline<BASIS_BOX_SPLINE>::GetWeights(
-    float v, float w, float point[12]) {
+    REAL v, REAL w, REAL point[12]) {
 
-    float u = 1.0f - v - w;
+    REAL u = 1.0f - v - w;
 
     //
     //  The 12 basis functions of the quartic box spline (unscaled by their common
@@ -142,15 +225,15 @@ inline void Spline<BASIS_BOX_SPLINE>::GetWeights(
     //       2 terms for the 6 points on faces opposite the triangle corners
     //
     //  Powers of each variable for notational convenience:
-    float u2 = u*u;
-    float u3 = u*u2;
-    float u4 = u*u3;
-    float v2 = v*v;
-    float v3 = v*v2;
-    float v4 = v*v3;
-    float w2 = w*w;
-    float w3 = w*w2;
-    float w4 = w*w3;
+    REAL u2 = u*u;
+    REAL u3 = u*u2;
+    REAL u4 = u*u3;
+    REAL v2 = v*v;
+    REAL v3 = v*v2;
+    REAL v4 = v*v3;
+    REAL w2 = w*w;
+    REAL w3 = w*w2;
+    REAL w4 = w*w3;
 
     //  And now the basis functions:
     point[ 0] = u4 + 2.0f*u3*v;
@@ -175,17 +258,18 @@ inline void Spline<BASIS_BOX_SPLINE>::GetWeights(
                 v4 + 6*v3*u + 8*v3*w + 36*v2*u*w + 24*v2*w2 + 24*v*w3 + 6*w4 + 60*w2*u*v + 12*u2*v2;
 
     for (int i = 0; i < 12; ++i) {
-        point[i] *= 1.0f / 12.0f;
+        point[i] *= (REAL)(1.0 / 12.0);
     }
 }
 
 template <>
+template <typename REAL>
 inline void Spline<BASIS_BILINEAR>::GetPatchWeights(PatchParam const & param,
-    float s, float t, float point[4], float derivS[4], float derivT[4], float derivSS[4], float derivST[4], float derivTT[4]) {
+    REAL s, REAL t, REAL point[4], REAL derivS[4], REAL derivT[4], REAL derivSS[4], REAL derivST[4], REAL derivTT[4]) {
 
     param.Normalize(s,t);
 
-    float sC = 1.0f - s,
+    REAL sC = 1.0f - s,
           tC = 1.0f - t;
 
     if (point) {
@@ -196,7 +280,7 @@ inline void Spline<BASIS_BILINEAR>::GetPatchWeights(PatchParam const & param,
     }
     
     if (derivS && derivT) {
-        float dScale = (float)(1 << param.GetDepth());
+        REAL dScale = (REAL)(1 << param.GetDepth());
 
         derivS[0] = -tC * dScale;
         derivS[1] =  tC * dScale;
@@ -209,7 +293,7 @@ inline void Spline<BASIS_BILINEAR>::GetPatchWeights(PatchParam const & param,
         derivT[3] =  sC * dScale;
 
         if (derivSS && derivST && derivTT) {
-            float d2Scale = dScale * dScale;
+            REAL d2Scale = dScale * dScale;
 
             for(int i=0;i<4;i++) {
                 derivSS[i] = 0;
@@ -225,8 +309,9 @@ inline void Spline<BASIS_BILINEAR>::GetPatchWeights(PatchParam const & param,
 }
 
 template <SplineBasis BASIS>
+template <typename REAL>
 void Spline<BASIS>::AdjustBoundaryWeights(PatchParam const & param,
-    float sWeights[4], float tWeights[4]) {
+    REAL sWeights[4], REAL tWeights[4]) {
 
     int boundary = param.GetBoundary();
 
@@ -253,10 +338,11 @@ void Spline<BASIS>::AdjustBoundaryWeights(PatchParam const & param,
 }
 
 template <SplineBasis BASIS>
+template <typename REAL>
 void Spline<BASIS>::GetPatchWeights(PatchParam const & param,
-    float s, float t, float point[16], float derivS[16], float derivT[16], float derivSS[16], float derivST[16], float derivTT[16]) {
+    REAL s, REAL t, REAL point[16], REAL derivS[16], REAL derivT[16], REAL derivSS[16], REAL derivST[16], REAL derivTT[16]) {
 
-    float sWeights[4], tWeights[4], dsWeights[4], dtWeights[4], dssWeights[4], dttWeights[4];
+    REAL sWeights[4], tWeights[4], dsWeights[4], dtWeights[4], dssWeights[4], dttWeights[4];
 
     param.Normalize(s,t);
 
@@ -280,7 +366,7 @@ void Spline<BASIS>::GetPatchWeights(PatchParam const & param,
         // Compute the tensor product weight of the differentiated (s,t) basis
         // function corresponding to each control vertex (scaled accordingly):
 
-        float dScale = (float)(1 << param.GetDepth());
+        REAL dScale = (REAL)(1 << param.GetDepth());
 
         AdjustBoundaryWeights(param, dsWeights, dtWeights);
 
@@ -295,7 +381,7 @@ void Spline<BASIS>::GetPatchWeights(PatchParam const & param,
             // Compute the tensor product weight of appropriate differentiated
             // (s,t) basis functions for each control vertex (scaled accordingly):
         
-            float d2Scale = dScale * dScale;
+            REAL d2Scale = dScale * dScale;
 
             AdjustBoundaryWeights(param, dssWeights, dttWeights);
 
@@ -310,23 +396,237 @@ void Spline<BASIS>::GetPatchWeights(PatchParam const & param,
     }
 }
 
+//
+//  Batched evaluation -- the same computations as above, with each expression
+//  evaluated for all locations of the batch in a loop over the locations
+//  (which the compiler maps to SIMD lanes):
+//
+template <>
+template <typename REAL>
+inline void Spline<BASIS_BSPLINE>::GetWeightsBatch(
+    REAL const t[], REAL point[], REAL deriv[], REAL deriv2[]) {
+
+    int const N = BASIS_BATCH_SIZE;
+
+    REAL const one6th = (REAL)(1.0 / 6.0);
+
+    assert(point);
+    for (int k = 0; k < N; ++k) {
+        REAL t2 = t[k] * t[k];
+        REAL t3 = t[k] * t2;
+
+        point[0*N+k] = one6th * (1.0f - 3.0f*(t[k] -   t2) -      t3);
+        point[1*N+k] = one6th * (4.0f              - 6.0f*t2  + 3.0f*t3);
+        point[2*N+k] = one6th * (1.0f + 3.0f*(t[k] +   t2  -      t3));
+        point[3*N+k] = one6th * (                                 t3);
+    }
+
+    if (deriv) {
+        for (int k = 0; k < N; ++k) {
+            REAL t2 = t[k] * t[k];
+
+            deriv[0*N+k] = -0.5f*t2 +      t[k] - 0.5f;
+            deriv[1*N+k] =  1.5f*t2 - 2.0f*t[k];
+            deriv[2*N+k] = -1.5f*t2 +      t[k] + 0.5f;
+            deriv[3*N+k] =  0.5f*t2;
+        }
+    }
+
+    if (deriv2) {
+        for (int k = 0; k < N; ++k) {
+            deriv2[0*N+k] = -       t[k] + 1.0f;
+            deriv2[1*N+k] =  3.0f * t[k] - 2.0f;
+            deriv2[2*N+k] = -3.0f * t[k] + 1.0f;
+            deriv2[3*N+k] =         t[k];
+        }
+    }
+}
+
+template <>
+template <typename REAL>
+inline void Spline<BASIS_BILINEAR>::GetPatchWeightsBatch(BatchParams<REAL> const & params,
+    REAL point[], REAL derivS[], REAL derivT[], REAL derivSS[], REAL derivST[], REAL derivTT[]) {
+
+    int const N = BASIS_BATCH_SIZE;
+
+    REAL const * s = params.s,
+               * t = params.t,
+               * dScale = params.dScale;
+
+    if (point) {
+        for (int k = 0; k < N; ++k) {
+            REAL sC = 1.0f - s[k],
+                 tC = 1.0f - t[k];
+
+            point[0*N+k] = sC * tC;
+            point[1*N+k] = s[k] * tC;
+            point[2*N+k] = s[k] * t[k];
+            point[3*N+k] = sC * t[k];
+        }
+    }
+
+    if (derivS && derivT) {
+        for (int k = 0; k < N; ++k) {
+            REAL sC = 1.0f - s[k],
+                 tC = 1.0f - t[k];
+
+            derivS[0*N+k] = -tC * dScale[k];
+            derivS[1*N+k] =  tC * dScale[k];
+            derivS[2*N+k] = t[k] * dScale[k];
+            derivS[3*N+k] = -t[k] * dScale[k];
+
+            derivT[0*N+k] = -sC * dScale[k];
+            derivT[1*N+k] = -s[k] * dScale[k];
+            derivT[2*N+k] = s[k] * dScale[k];
+            derivT[3*N+k] =  sC * dScale[k];
+        }
+
+        if (derivSS && derivST && derivTT) {
+            for (int k = 0; k < N; ++k) {
+                REAL d2Scale = dScale[k] * dScale[k];
+
+                for (int i = 0; i < 4; ++i) {
+                    derivSS[i*N+k] = 0;
+                    derivTT[i*N+k] = 0;
+                }
+
+                derivST[0*N+k] =  d2Scale;
+                derivST[1*N+k] = -d2Scale;
+                derivST[2*N+k] = -d2Scale;
+                derivST[3*N+k] =  d2Scale;
+            }
+        }
+    }
+}
+
+//
+//  Adjusts the weights of a boundary edge for the locations of a batch : the
+//  weight of the exterior point (masked by the boundary edge) is redistributed
+//  to the two interior points
+//
+template <typename REAL>
+inline void adjustBoundaryWeightsBatch(REAL const boundaryMask[],
+    REAL weights[], int exterior, int adjacent, int opposite) {
+
+    int const N = BASIS_BATCH_SIZE;
+
+    REAL * wExterior = weights + exterior*N,
+         * wAdjacent = weights + adjacent*N,
+         * wOpposite = weights + opposite*N;
+
+    for (int k = 0; k < N; ++k) {
+        REAL w = boundaryMask[k] * wExterior[k];
+
+        wOpposite[k] -= w;
+        wAdjacent[k] += 2*w;
+        wExterior[k] -= w;
+    }
+}
+
+template <SplineBasis BASIS>
+template <typename REAL>
+void Spline<BASIS>::AdjustBoundaryWeightsBatch(BatchParams<REAL> const & params,
+    REAL sWeights[], REAL tWeights[]) {
+
+    //  Equivalent to AdjustBoundaryWeights() with the weight w of the exterior
+    //  point masked by the boundary edge (and so unchanged when not a boundary)
+    adjustBoundaryWeightsBatch(params.boundaryMask[0], tWeights, 0, 1, 2);
+    adjustBoundaryWeightsBatch(params.boundaryMask[1], sWeights, 3, 2, 1);
+    adjustBoundaryWeightsBatch(params.boundaryMask[2], tWeights, 3, 2, 1);
+    adjustBoundaryWeightsBatch(params.boundaryMask[3], sWeights, 0, 1, 2);
+}
+
+template <SplineBasis BASIS>
+template <typename REAL>
+void Spline<BASIS>::GetPatchWeightsBatch(BatchParams<REAL> const & params,
+    REAL point[], REAL derivS[], REAL derivT[], REAL derivSS[], REAL derivST[], REAL derivTT[]) {
+
+    int const N = BASIS_BATCH_SIZE;
+
+    REAL sWeights[4*N], tWeights[4*N], dsWeights[4*N], dtWeights[4*N], dssWeights[4*N], dttWeights[4*N];
+
+    //  local copy of the scales (which the compiler cannot otherwise assume
+    //  not to alias the resulting weights)
+    REAL dScale[N];
+    for (int k = 0; k < N; ++k) {
+        dScale[k] = params.dScale[k];
+    }
+
+    assert(point);
+
+    Spline<BASIS>::GetWeightsBatch(params.s, sWeights, derivS ? dsWeights : 0, derivSS ? dssWeights : 0);
+    Spline<BASIS>::GetWeightsBatch(params.t, tWeights, derivT ? dtWeights : 0, derivTT ? dttWeights : 0);
+
+    AdjustBoundaryWeightsBatch(params, sWeights, tWeights);
+
+    for (int i = 0; i < 4; ++i) {
+        for (int j = 0; j < 4; ++j) {
+            for (int k = 0; k < N; ++k) {
+                point[(4*i+j)*N+k] = sWeights[j*N+k] * tWeights[i*N+k];
+            }
+        }
+    }
+
+    if (derivS && derivT) {
+        AdjustBoundaryWeightsBatch(params, dsWeights, dtWeights);
+
+        for (int i = 0; i < 4; ++i) {
+            for (int j = 0; j < 4; ++j) {
+                for (int k = 0; k < N; ++k) {
+                    derivS[(4*i+j)*N+k] = dsWeights[j*N+k] * tWeights[i*N+k] * dScale[k];
+                }
+                for (int k = 0; k < N; ++k) {
+                    derivT[(4*i+j)*N+k] = sWeights[j*N+k] * dtWeights[i*N+k] * dScale[k];
+                }
+            }
+        }
+
+        if (derivSS && derivST && derivTT) {
+            REAL d2Scale[N];
+            for (int k = 0; k < N; ++k) {
+                d2Scale[k] = dScale[k] * dScale[k];
+            }
+
+            AdjustBoundaryWeightsBatch(params, dssWeights, dttWeights);
+
+            for (int i = 0; i < 4; ++i) {
+                for (int j = 0; j < 4; ++j) {
+                    for (int k = 0; k < N; ++k) {
+                        derivSS[(4*i+j)*N+k] = dssWeights[j*N+k] * tWeights[i*N+k] * d2Scale[k];
+                    }
+                    for (int k = 0; k < N; ++k) {
+                        derivST[(4*i+j)*N+k] = dsWeights[j*N+k] * dtWeights[i*N+k] * d2Scale[k];
+                    }
+                    for (int k = 0; k < N; ++k) {
+                        derivTT[(4*i+j)*N+k] = sWeights[j*N+k] * dttWeights[i*N+k] * d2Scale[k];
+                    }
+                }
+            }
+        }
+    }
+}
+
+template <typename REAL>
 void GetBilinearWeights(PatchParam const & param,
-    float s, float t, float point[4], float deriv1[4], float deriv2[4], float deriv11[4], float deriv12[4], float deriv22[4]) {
+    REAL s, REAL t, REAL point[4], REAL deriv1[4], REAL deriv2[4], REAL deriv11[4], REAL deriv12[4], REAL deriv22[4]) {
     Spline<BASIS_BILINEAR>::GetPatchWeights(param, s, t, point, deriv1, deriv2, deriv11, deriv12, deriv22);
 }
 
-void GetBezierWeights(PatchParam const param,
-    float s, float t, float point[16], float deriv1[16], float deriv2[16], float deriv11[16], float deriv12[16], float deriv22[16]) {
+template <typename REAL>
+void GetBezierWeights(PatchParam const & param,
+    REAL s, REAL t, REAL point[16], REAL deriv1[16], REAL deriv2[16], REAL deriv11[16], REAL deriv12[16], REAL deriv22[16]) {
     Spline<BASIS_BEZIER>::GetPatchWeights(param, s, t, point, deriv1, deriv2, deriv11, deriv12, deriv22);
 }
 
+template <typename REAL>
 void GetBSplineWeights(PatchParam const & param,
-    float s, float t, float point[16], float deriv1[16], float deriv2[16], float deriv11[16], float deriv12[16], float deriv22[16]) {
+    REAL s, REAL t, REAL point[16], REAL deriv1[16], REAL deriv2[16], REAL deriv11[16], REAL deriv12[16], REAL deriv22[16]) {
     Spline<BASIS_BSPLINE>::GetPatchWeights(param, s, t, point, deriv1, deriv2, deriv11, deriv12, deriv22);
 }
 
+template <typename REAL>
 void GetGregoryWeights(PatchParam const & param,
-    float s, float t, float point[20], float deriv1[20], float deriv2[20], float deriv11[20], float deriv12[20], float deriv22[20]) {
+    REAL s, REAL t, REAL point[20], REAL deriv1[20], REAL deriv2[20], REAL deriv11[20], REAL deriv12[20], REAL deriv22[20]) {
     //
     //  P3         e3-      e2+         P2
     //     15------17-------11--------10
@@ -364,8 +664,8 @@ void GetGregoryWeights(PatchParam const & param,
     //  interior points will be denoted G -- so we have B(s), B(t) and G(s,t):
     //
     //  Directional Bezier basis functions B at s and t:
-    float Bs[4], Bds[4], Bdss[4];
-    float Bt[4], Bdt[4], Bdtt[4];
+    REAL Bs[4], Bds[4], Bdss[4];
+    REAL Bt[4], Bdt[4], Bdtt[4];
 
     param.Normalize(s,t);
 
@@ -373,16 +673,16 @@ void GetGregoryWeights(PatchParam const & param,
     Spline<BASIS_BEZIER>::GetWeights(t, Bt, deriv2 ? Bdt : 0, deriv22 ? Bdtt : 0);
 
     //  Rational multipliers G at s and t:
-    float sC = 1.0f - s;
-    float tC = 1.0f - t;
+    REAL sC = 1.0f - s;
+    REAL tC = 1.0f - t;
 
     //  Use <= here to avoid compiler warnings -- the sums should always be non-negative:
-    float df0 = s  + t;   df0 = (df0 <= 0.0f) ? 1.0f : (1.0f / df0);
-    float df1 = sC + t;   df1 = (df1 <= 0.0f) ? 1.0f : (1.0f / df1);
-    float df2 = sC + tC;  df2 = (df2 <= 0.0f) ? 1.0f : (1.0f / df2);
-    float df3 = s  + tC;  df3 = (df3 <= 0.0f) ? 1.0f : (1.0f / df3);
+    REAL df0 = s  + t;   df0 = (df0 <= 0.0f) ? 1.0f : (1.0f / df0);
+    REAL df1 = sC + t;   df1 = (df1 <= 0.0f) ? 1.0f : (1.0f / df1);
+    REAL df2 = sC + tC;  df2 = (df2 <= 0.0f) ? 1.0f : (1.0f / df2);
+    REAL df3 = s  + tC;  df3 = (df3 <= 0.0f) ? 1.0f : (1.0f / df3);
 
-    float G[8] = { s*df0, t*df0,  t*df1, sC*df1,  sC*df2, tC*df2,  tC*df3, s*df3 };
+    REAL G[8] = { s*df0, t*df0,  t*df1, sC*df1,  sC*df2, tC*df2,  tC*df3, s*df3 };
 
     //  Combined weights for boundary and interior points:
     for (int i = 0; i < 12; ++i) {
@@ -406,8 +706,8 @@ void GetGregoryWeights(PatchParam const & param,
     if (deriv1 && deriv2) {
         bool find_second_partials = deriv1 && deriv12 && deriv22;
         //  Remember to include derivative scaling in all assignments below:
-        float dScale = (float)(1 << param.GetDepth());
-        float d2Scale = dScale * dScale;
+        REAL dScale = (REAL)(1 << param.GetDepth());
+        REAL d2Scale = dScale * dScale;
 
         //  Combined weights for boundary points -- simple (scaled) tensor products:
         for (int i = 0; i < 12; ++i) {
@@ -458,14 +758,14 @@ void GetGregoryWeights(PatchParam const & param,
         //  (and with 4 or 8 computations involving these constants, this is all very SIMD
         //  friendly...) but for now we treat all 8 independently for simplicity.
         //
-        //float N[8] = {   s,     t,      t,     sC,      sC,     tC,      tC,     s };
-        float D[8] = {   df0,   df0,    df1,    df1,     df2,    df2,     df3,   df3 };
+        //REAL N[8] = {   s,     t,      t,     sC,      sC,     tC,      tC,     s };
+        REAL D[8] = {   df0,   df0,    df1,    df1,     df2,    df2,     df3,   df3 };
 
-        static float const Nds[8] = { 1.0f, 0.0f,  0.0f, -1.0f, -1.0f,  0.0f,  0.0f,  1.0f };
-        static float const Ndt[8] = { 0.0f, 1.0f,  1.0f,  0.0f,  0.0f, -1.0f, -1.0f,  0.0f };
+        static REAL const Nds[8] = { 1.0f, 0.0f,  0.0f, -1.0f, -1.0f,  0.0f,  0.0f,  1.0f };
+        static REAL const Ndt[8] = { 0.0f, 1.0f,  1.0f,  0.0f,  0.0f, -1.0f, -1.0f,  0.0f };
 
-        static float const Dds[8] = { 1.0f, 1.0f, -1.0f, -1.0f, -1.0f, -1.0f,  1.0f,  1.0f };
-        static float const Ddt[8] = { 1.0f, 1.0f,  1.0f,  1.0f, -1.0f, -1.0f, -1.0f, -1.0f };
+        static REAL const Dds[8] = { 1.0f, 1.0f, -1.0f, -1.0f, -1.0f, -1.0f,  1.0f,  1.0f };
+        static REAL const Ddt[8] = { 1.0f, 1.0f,  1.0f,  1.0f, -1.0f, -1.0f, -1.0f, -1.0f };
 
         //  Combined weights for interior points -- (scaled) combinations of B, B', G and G':
         for (int i = 0; i < 8; ++i) {
@@ -474,19 +774,19 @@ void GetGregoryWeights(PatchParam const & param,
             int sCol = interiorBezSCol[i];
 
             //  Quotient rule for G' (re-expressed in terms of G to simplify (and D = 1/D)):
-            float Gds = (Nds[i] - Dds[i] * G[i]) * D[i];
-            float Gdt = (Ndt[i] - Ddt[i] * G[i]) * D[i];
+            REAL Gds = (Nds[i] - Dds[i] * G[i]) * D[i];
+            REAL Gdt = (Ndt[i] - Ddt[i] * G[i]) * D[i];
 
             //  Product rule combining B and B' with G and G' (and scaled):
             deriv1[iDst] = (Bds[sCol] * G[i] + Bs[sCol] * Gds) * Bt[tRow] * dScale;
             deriv2[iDst] = (Bdt[tRow] * G[i] + Bt[tRow] * Gdt) * Bs[sCol] * dScale;
 
             if (find_second_partials) {
-                float Dsqr_inv = D[i]*D[i];
+                REAL Dsqr_inv = D[i]*D[i];
 
-                float Gdss = 2.0f * Dds[i] * Dsqr_inv * (G[i] * Dds[i] - Nds[i]);
-                float Gdst = Dsqr_inv * (2.0f * G[i] * Dds[i] * Ddt[i] - Nds[i] * Ddt[i] - Ndt[i] * Dds[i]);
-                float Gdtt = 2.0f * Ddt[i] * Dsqr_inv * (G[i] * Ddt[i] - Ndt[i]);
+                REAL Gdss = 2.0f * Dds[i] * Dsqr_inv * (G[i] * Dds[i] - Nds[i]);
+                REAL Gdst = Dsqr_inv * (2.0f * G[i] * Dds[i] * Ddt[i] - Nds[i] * Ddt[i] - Ndt[i] * Dds[i]);
+                REAL Gdtt = 2.0f * Ddt[i] * Dsqr_inv * (G[i] * Ddt[i] - Ndt[i]);
 
                 deriv11[iDst] = (Bdss[sCol] * G[i] + 2.0f * Bds[sCol] * Gds + Bs[sCol] * Gdss) * Bt[tRow] * d2Scale;
                 deriv12[iDst] = (Bt[tRow] * (Bs[sCol] * Gdst + Bds[sCol] * Gdt) + Bdt[tRow] * (Bds[sCol] * G[i] + Bs[sCol] * Gds)) * d2Scale;
@@ -497,6 +797,51 @@ void GetGregoryWeights(PatchParam const & param,
     }
 }
 
+template <typename REAL>
+void GetBilinearWeights(int numPoints, PatchParam const params[], REAL const s[], REAL const t[],
+    REAL point[], REAL deriv1[], REAL deriv2[], REAL deriv11[], REAL deriv12[], REAL deriv22[]) {
+    Spline<BASIS_BILINEAR>::GetPatchWeightsBatch(BatchParams<REAL>(numPoints, params, s, t),
+        point, deriv1, deriv2, deriv11, deriv12, deriv22);
+}
+
+template <typename REAL>
+void GetBSplineWeights(int numPoints, PatchParam const params[], REAL const s[], REAL const t[],
+    REAL point[], REAL deriv1[], REAL deriv2[], REAL deriv11[], REAL deriv12[], REAL deriv22[]) {
+    Spline<BASIS_BSPLINE>::GetPatchWeightsBatch(BatchParams<REAL>(numPoints, params, s, t),
+        point, deriv1, deriv2, deriv11, deriv12, deriv22);
+}
+
+//
+//  Explicit instantiation for the supported precisions:
+//
+template void GetBilinearWeights<float>(PatchParam const & param,
+    float s, float t, float point[4], float deriv1[4], float deriv2[4], float deriv11[4], float deriv12[4], float deriv22[4]);
+template void GetBezierWeights<float>(PatchParam const & param,
+    float s, float t, float point[16], float deriv1[16], float deriv2[16], float deriv11[16], float deriv12[16], float deriv22[16]);
+template void GetBSplineWeights<float>(PatchParam const & param,
+    float s, float t, float point[16], float deriv1[16], float deriv2[16], float deriv11[16], float deriv12[16], float deriv22[16]);
+template void GetGregoryWeights<float>(PatchParam const & param,
+    float s, float t, float point[20], float deriv1[20], float deriv2[20], float deriv11[20], float deriv12[20], float deriv22[20]);
+
+template void GetBilinearWeights<double>(PatchParam const & param,
+    double s, double t, double point[4], double deriv1[4], double deriv2[4], double deriv11[4], double deriv12[4], double deriv22[4]);
+template void GetBezierWeights<double>(PatchParam const & param,
+    double s, double t, double point[16], double deriv1[16], double deriv2[16], double deriv11[16], double deriv12[16], double deriv22[16]);
+template void GetBSplineWeights<double>(PatchParam const & param,
+    double s, double t, double point[16], double deriv1[16], double deriv2[16], double deriv11[16], double deriv12[16], double deriv22[16]);
+template void GetGregoryWeights<double>(PatchParam const & param,
+    double s, double t, double point[20], double deriv1[20], double deriv2[20], double deriv11[20], double deriv12[20], double deriv22[20]);
+
+template void GetBilinearWeights<float>(int numPoints, PatchParam const params[], float const s[], float const t[],
+    float point[], float deriv1[], float deriv2[], float deriv11[], float deriv12[], float deriv22[]);
+template void GetBSplineWeights<float>(int numPoints, PatchParam const params[], float const s[], float const t[],
+    float point[], float deriv1[], float deriv2[], float deriv11[], float deriv12[], float deriv22[]);
+
+template void GetBilinearWeights<double>(int numPoints, PatchParam const params[], double const s[], double const t[],
+    double point[], double deriv1[], double deriv2[], double deriv11[], double deriv12[], double deriv22[]);
+template void GetBSplineWeights<double>(int numPoints, PatchParam const params[], double const s[], double const t[],
+    double point[], double deriv1[], double deriv2[], double deriv11[], double deriv12[], double deriv22[]);
+
 } // end namespace internal
 } // end namespace Far
 
@@ -44,18 +44,46 @@ namespace internal {
 //
 // So this interface will be changing in future.
 //
+// The functions are templated on the precision of the parametric location
+// and the resulting weights -- only float and double are instantiated.
+//
 
+template <typename REAL>
 void GetBilinearWeights(PatchParam const & patchParam,
-    float s, float t, float wP[4], float wDs[4], float wDt[4], float wDss[4] = 0, float wDst[4] = 0, float wDtt[4] = 0);
+    REAL s, REAL t, REAL wP[4], REAL wDs[4], REAL wDt[4], REAL wDss[4] = 0, REAL wDst[4] = 0, REAL wDtt[4] = 0);
 
+template <typename REAL>
 void GetBezierWeights(PatchParam const & patchParam,
-    float s, float t, float wP[16], float wDs[16], float wDt[16], float wDss[16] = 0, float wDst[16] = 0, float wDtt[16] = 0);
+    REAL s, REAL t, REAL wP[16], REAL wDs[16], REAL wDt[16], REAL wDss[16] = 0, REAL wDst[16] = 0, REAL wDtt[16] = 0);
 
+template <typename REAL>
 void GetBSplineWeights(PatchParam const & patchParam,
-    float s, float t, float wP[16], float wDs[16], float wDt[16], float wDss[16] = 0, float wDst[16] = 0, float wDtt[16] = 0);
+    REAL s, REAL t, REAL wP[16], REAL wDs[16], REAL wDt[16], REAL wDss[16] = 0, REAL wDst[16] = 0, REAL wDtt[16] = 0);
 
+template <typename REAL>
 void GetGregoryWeights(PatchParam const & patchParam,
-    float s, float t, float wP[20], float wDs[20], float wDt[20], float wDss[20] = 0, float wDst[20] = 0, float wDtt[20] = 0);
+    REAL s, REAL t, REAL wP[20], REAL wDs[20], REAL wDt[20], REAL wDss[20] = 0, REAL wDst[20] = 0, REAL wDtt[20] = 0);
+
+//
+// Batched variants evaluating the weights of up to BASIS_BATCH_SIZE locations
+// (each with its own PatchParam) at once.
+//
+// The weights are interleaved by location, i.e. the weight of control point i
+// at location j is stored at w[i * BASIS_BATCH_SIZE + j], so that the loops
+// over the locations of a batch operate on contiguous data and are vectorized
+// by the compiler.  Arrays of weights must hold BASIS_BATCH_SIZE times the
+// number of control points of the patch -- the weights of locations beyond
+// numPoints are undefined.
+//
+enum { BASIS_BATCH_SIZE = 8 };
+
+template <typename REAL>
+void GetBilinearWeights(int numPoints, PatchParam const patchParams[], REAL const s[], REAL const t[],
+    REAL wP[], REAL wDs[], REAL wDt[], REAL wDss[] = 0, REAL wDst[] = 0, REAL wDtt[] = 0);
+
+template <typename REAL>
+void GetBSplineWeights(int numPoints, PatchParam const patchParams[], REAL const s[], REAL const t[],
+    REAL wP[], REAL wDs[], REAL wDt[], REAL wDss[] = 0, REAL wDst[] = 0, REAL wDtt[] = 0);
 
 
 } // end namespace internal
@@ -33,6 +33,12 @@
 
 #include <cassert>
 #include <cstdio>
+#include <cstring>
+#include <map>
+
+#ifdef OPENSUBDIV_HAS_OPENMP
+    #include <omp.h>
+#endif
 
 namespace OpenSubdiv {
 namespace OPENSUBDIV_VERSION {
@@ -162,6 +168,73 @@ namespace {
 } // namespace anon
 
 
+//
+//  ConversionMatrixCache -- the conversion matrix of an irregular patch only
+//  depends on the Corners of its SourcePatch (the remaining members being
+//  derived from them), and only a few distinct combinations of those occur
+//  in practice.  The matrices are kept in a map keyed by the Corners, which
+//  is guarded by a lock (a no-op without OpenMP) as patches may be
+//  identified concurrently.  Entries are never modified or removed once
+//  inserted, so the matrices can be read without holding the lock:
+//
+class PatchBuilder::ConversionMatrixCache {
+public:
+    struct Key {
+        Key(SourcePatch const & sourcePatch) {
+            //  Corners are zero-initialized (including their padding)
+            std::memcpy(corners, sourcePatch._corners, sizeof(corners));
+        }
+
+        bool operator<(Key const & other) const {
+            return std::memcmp(corners, other.corners, sizeof(corners)) < 0;
+        }
+
+        SourcePatch::Corner corners[4];
+    };
+
+public:
+#ifdef OPENSUBDIV_HAS_OPENMP
+    ConversionMatrixCache()  { omp_init_lock(&_lock); }
+    ~ConversionMatrixCache() { omp_destroy_lock(&_lock); }
+#endif
+
+    //  Returns the matrix of the given key, or NULL if not yet computed
+    SparseMatrix<float> const * Find(Key const & key) {
+        acquire();
+        Map::const_iterator it = _matrices.find(key);
+        SparseMatrix<float> const * matrix =
+            (it != _matrices.end()) ? &it->second : 0;
+        release();
+        return matrix;
+    }
+
+    //  Inserts a computed matrix (keeping the existing one if another thread
+    //  computed it meanwhile -- both being identical)
+    void Insert(Key const & key, SparseMatrix<float> const & matrix) {
+        acquire();
+        if (_matrices.find(key) == _matrices.end()) {
+            _matrices.insert(Map::value_type(key, matrix));
+        }
+        release();
+    }
+
+private:
+    typedef std::map<Key, SparseMatrix<float> > Map;
+
+    Map _matrices;
+
+#ifdef OPENSUBDIV_HAS_OPENMP
+    void acquire() { omp_set_lock(&_lock); }
+    void release() { omp_unset_lock(&_lock); }
+
+    omp_lock_t _lock;
+#else
+    void acquire() { }
+    void release() { }
+#endif
+};
+
+
 //
 //  Factory method and constructor:
 //
@@ -182,7 +255,8 @@ PatchBuilder::Create(TopologyRefiner const& refiner, Options const& options) {
 
 PatchBuilder::PatchBuilder(
     TopologyRefiner const& refiner, Options const& options) :
-        _refiner(refiner), _options(options) {
+        _refiner(refiner), _options(options),
+        _irregMatrixCache(new ConversionMatrixCache) {
 
     //
     //  Initialize members with properties of the subdivision scheme and patch
@@ -197,6 +271,7 @@ PatchBuilder::PatchBuilder(
 }
 
 PatchBuilder::~PatchBuilder() {
+    delete _irregMatrixCache;
 }
 
 //
@@ -810,8 +885,19 @@ PatchBuilder::GetIrregularPatchConversionMatrix(
     assembleIrregularSourcePatch(
             levelIndex, faceIndex, cornerSpans, sourcePatch);
 
-    return convertToPatchType(
-        sourcePatch, GetIrregularPatchType(), conversionMatrix);
+    //  Copy the memoized matrix for these Corners, or compute and insert it:
+    ConversionMatrixCache::Key key(sourcePatch);
+
+    SparseMatrix<float> const * cachedMatrix = _irregMatrixCache->Find(key);
+    if (cachedMatrix) {
+        conversionMatrix = *cachedMatrix;
+    } else {
+        convertToPatchType(
+            sourcePatch, GetIrregularPatchType(), conversionMatrix);
+
+        _irregMatrixCache->Insert(key, conversionMatrix);
+    }
+    return conversionMatrix.GetNumRows();
 }
 
 
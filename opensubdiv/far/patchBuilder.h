@@ -226,6 +226,8 @@ public:
             Index patchPoints[],
             int fvc = -1) const;
 
+    //  Conversion matrices depend only on the Corners of the SourcePatch and
+    //  are memoized for each distinct combination (safe to call concurrently)
     int GetIrregularPatchConversionMatrix(int level, Index face,
             Vtr::internal::Level::VSpan const cornerSpans[],
             SparseMatrix<float> &             matrix) const;
@@ -297,6 +299,14 @@ protected:
                                    PatchDescriptor::Type patchType,
                                    SparseMatrix<float> & matrix) const = 0;
 
+private:
+    //  Memoized irregular patch conversion matrices (see patchBuilder.cpp):
+    class ConversionMatrixCache;
+
+    //  Copying would share the cache
+    PatchBuilder(PatchBuilder const &);
+    PatchBuilder & operator=(PatchBuilder const &);
+
 protected:
     TopologyRefiner const& _refiner;
     Options const          _options;
@@ -309,6 +319,9 @@ protected:
     PatchDescriptor::Type _irregPatchType;
     PatchDescriptor::Type _nativePatchType;
     PatchDescriptor::Type _linearPatchType;
+
+private:
+    ConversionMatrixCache * _irregMatrixCache;
 };
 
 } // end namespace Far
@@ -25,6 +25,7 @@
 #include "../far/patchMap.h"
 
 #include <algorithm>
+#include <vector>
 
 namespace OpenSubdiv {
 namespace OPENSUBDIV_VERSION {
@@ -32,7 +33,7 @@ namespace OPENSUBDIV_VERSION {
 namespace Far {
 
 // Constructor
-PatchMap::PatchMap( PatchTable const & patchTable ) {
+PatchMap::PatchMap( PatchTable const & patchTable ) : _numFaces(0) {
     initialize( patchTable );
 }
 
@@ -158,8 +159,89 @@ PatchMap::initialize( PatchTable const & patchTable ) {
         }
     }
 
-    // copy the resulting quadtree to eliminate un-unused vector capacity
-    _quadtree = quadtree;
+    // copy the resulting quadtree to eliminate un-unused vector capacity, with
+    // the nodes of each face made contiguous
+    _numFaces = nfaces;
+    reorderQuadtree(quadtree);
+}
+
+// The nodes are created in the order of the patches, which are sorted by type
+// rather than by face : copy them so that the nodes of each face follow its
+// root node in depth-first order and are traversed with fewer cache misses.
+void
+PatchMap::reorderQuadtree( QuadTree const & quadtree ) {
+
+    int nnodes = (int)quadtree.size();
+
+    _quadtree.resize(nnodes);
+
+    std::vector<int> stack;
+    for (int face=0, next=_numFaces; face<_numFaces; ++face) {
+
+        // the root nodes are left in place
+        _quadtree[face] = quadtree[face];
+        stack.push_back(face);
+
+        while (! stack.empty()) {
+            QuadNode & node = _quadtree[stack.back()];
+            stack.pop_back();
+
+            // push the children in reverse order so that they are visited
+            // (and numbered) in the order of their quadrants
+            for (int quadrant=3; quadrant>=0; --quadrant) {
+                QuadNode::Child & child = node.children[quadrant];
+                if (child.isSet && ! child.isLeaf) {
+                    _quadtree[next] = quadtree[child.idx];
+                    child.idx = next;
+                    stack.push_back(next++);
+                }
+            }
+        }
+    }
+}
+
+void
+PatchMap::FindPatches( int numLocations, int const * faceids,
+                       float const * u, float const * v,
+                       Handle const ** handles,
+                       bool useMultipleThreads ) const {
+
+    // Group the locations by face when scattered and numerous enough for the
+    // faces to be visited many times (an ordering is of little use otherwise)
+    bool sorted = true;
+    for (int i=1; sorted && i<numLocations; ++i) {
+        sorted = faceids[i-1] <= faceids[i];
+    }
+
+    std::vector<int> order;
+    if (! sorted && (numLocations >= _numFaces)) {
+
+        // counting sort -- invalid faces are grouped at the end
+        std::vector<int> offsets(_numFaces + 2, 0);
+        for (int i=0; i<numLocations; ++i) {
+            int face = faceids[i];
+            ++offsets[((face<0) || (face>=_numFaces) ? _numFaces : face) + 1];
+        }
+        for (int i=0; i<=_numFaces; ++i) {
+            offsets[i+1] += offsets[i];
+        }
+        order.resize(numLocations);
+        for (int i=0; i<numLocations; ++i) {
+            int face = faceids[i];
+            order[offsets[((face<0) || (face>=_numFaces) ? _numFaces : face)]++] = i;
+        }
+    }
+    int const * indices = order.empty() ? 0 : &order[0];
+
+#ifdef OPENSUBDIV_HAS_OPENMP
+    #pragma omp parallel for if (useMultipleThreads && (numLocations > 1024))
+#else
+    (void)useMultipleThreads;
+#endif
+    for (int i=0; i<numLocations; ++i) {
+        int loc = indices ? indices[i] : i;
+        handles[loc] = findPatch(faceids[loc], u[loc], v[loc]);
+    }
 }
 
 
@@ -72,6 +72,31 @@ public:
     ///
     Handle const * FindPatch( int faceid, float u, float v ) const;
 
+    /// \brief Returns handles to the sub-patches of many (face, u, v) locations.
+    ///
+    /// Equivalent to calling FindPatch() for each location, but locations are
+    /// processed grouped by face so that the nodes of each face are traversed
+    /// together, and can optionally be distributed across threads.
+    ///
+    /// @param numLocations        Number of locations
+    ///
+    /// @param faceids             Index of the face of each location
+    ///
+    /// @param u                   Local u parameter of each location
+    ///
+    /// @param v                   Local v parameter of each location
+    ///
+    /// @param handles             Output : handle to the sub-patch of each
+    ///                            location (NULL as for FindPatch())
+    ///
+    /// @param useMultipleThreads  Distribute the locations across threads
+    ///                            (requires OpenMP)
+    ///
+    void FindPatches( int numLocations, int const * faceids,
+                      float const * u, float const * v,
+                      Handle const ** handles,
+                      bool useMultipleThreads = false ) const;
+
 private:
 
     inline void initialize( PatchTable const & patchTable );
@@ -115,6 +140,14 @@ private:
     //
     template <class T> static int resolveQuadrant(T & median, T & u, T & v);
 
+    // reorders the nodes of the quadtree so that those of each face are
+    // contiguous (in depth-first order)
+    void reorderQuadtree( QuadTree const & quadtree );
+
+    // branchless variant of FindPatch() used for batches of locations
+    inline Handle const * findPatch( int faceid, float u, float v ) const;
+
+    int                   _numFaces; // number of faces (root nodes of the quadtree)
     std::vector<Handle>   _handles;  // all the patches in the PatchTable
     std::vector<QuadNode> _quadtree; // quadtree nodes
 };
@@ -182,6 +215,43 @@ PatchMap::FindPatch( int faceid, float u, float v ) const {
     return 0;
 }
 
+// Resolves quadrants without branches (see resolveQuadrant() for indexing)
+inline PatchMap::Handle const *
+PatchMap::findPatch( int faceid, float u, float v ) const {
+
+    if ((faceid<0) || (faceid>=_numFaces))
+        return NULL;
+
+    QuadNode const * node = &_quadtree[faceid];
+
+    float half = 0.5f;
+
+    for (int depth=0; depth<0xFF; ++depth) {
+
+        int uHigh = (u>=half),
+            vHigh = (v>=half);
+
+        int quadrant = (uHigh * 3) ^ vHigh;
+
+        QuadNode::Child child = node->children[quadrant];
+
+        if (! child.isSet)
+            return 0;
+
+        if (child.isLeaf)
+            return &_handles[child.idx];
+
+        node = &_quadtree[child.idx];
+
+        u -= uHigh ? half : 0.0f;
+        v -= vHigh ? half : 0.0f;
+        half *= 0.5f;
+    }
+
+    assert(0);
+    return 0;
+}
+
 } // end namespace Far
 
 } // end namespace OPENSUBDIV_VERSION
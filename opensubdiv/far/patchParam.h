@@ -205,7 +205,8 @@ struct PatchParam {
     /// @param u  u parameter
     /// @param v  v parameter
     ///
-    void Normalize( float & u, float & v ) const;
+    template <typename REAL>
+    void Normalize( REAL & u, REAL & v ) const;
 
     /// \brief A (u,v) pair in a normalized parametric space is mapped back into the
     /// fraction of parametric space covered by this face.
@@ -213,7 +214,8 @@ struct PatchParam {
     /// @param u  u parameter
     /// @param v  v parameter
     ///
-    void Unnormalize( float & u, float & v ) const;
+    template <typename REAL>
+    void Unnormalize( REAL & u, REAL & v ) const;
 
     /// \brief Returns whether the patch is regular
     bool IsRegular() const { return (unpack(field1,1,5) != 0); }
@@ -261,25 +263,27 @@ PatchParam::GetParamFraction( ) const {
     }
 }
 
+template <typename REAL>
 inline void
-PatchParam::Normalize( float & u, float & v ) const {
+PatchParam::Normalize( REAL & u, REAL & v ) const {
 
-    float frac = GetParamFraction();
+    REAL frac = (REAL)GetParamFraction();
 
-    float pu = (float)GetU()*frac;
-    float pv = (float)GetV()*frac;
+    REAL pu = (REAL)GetU()*frac;
+    REAL pv = (REAL)GetV()*frac;
 
     u = (u - pu) / frac,
     v = (v - pv) / frac;
 }
 
+template <typename REAL>
 inline void
-PatchParam::Unnormalize( float & u, float & v ) const {
+PatchParam::Unnormalize( REAL & u, REAL & v ) const {
 
-    float frac = GetParamFraction();
+    REAL frac = (REAL)GetParamFraction();
 
-    float pu = (float)GetU()*frac;
-    float pv = (float)GetV()*frac;
+    REAL pu = (REAL)GetU()*frac;
+    REAL pv = (REAL)GetV()*frac;
 
     u = u * frac + pu,
     v = v * frac + pv;
@@ -33,11 +33,11 @@ namespace OPENSUBDIV_VERSION {
 
 namespace Far {
 
-PatchTable::PatchTable(int maxvalence) :
+PatchTable::PatchTable(int maxvalence, PatchDescriptor varyingDesc) :
     _maxValence(maxvalence),
     _localPointStencils(NULL),
     _localPointVaryingStencils(NULL),
-    _varyingDesc(Far::PatchDescriptor::QUADS) {
+    _varyingDesc(varyingDesc) {
 }
 
 // Copy constructor
@@ -565,6 +565,29 @@ PatchTable::print() const {
     }
 }
 
+namespace {
+    //
+    //  Dispatch to the basis functions matching the given patch type -- shared
+    //  by the single and double precision public methods below:
+    //
+    template <typename REAL>
+    void
+    evaluatePatchBasis(PatchDescriptor::Type patchType, PatchParam const & param,
+        REAL s, REAL t, REAL wP[], REAL wDs[], REAL wDt[],
+        REAL wDss[], REAL wDst[], REAL wDtt[]) {
+
+        if (patchType == PatchDescriptor::REGULAR) {
+            internal::GetBSplineWeights(param, s, t, wP, wDs, wDt, wDss, wDst, wDtt);
+        } else if (patchType == PatchDescriptor::GREGORY_BASIS) {
+            internal::GetGregoryWeights(param, s, t, wP, wDs, wDt, wDss, wDst, wDtt);
+        } else if (patchType == PatchDescriptor::QUADS) {
+            internal::GetBilinearWeights(param, s, t, wP, wDs, wDt, wDss, wDst, wDtt);
+        } else {
+            assert(0);
+        }
+    }
+}
+
 //
 //  Evaluate basis functions for vertex and derivatives at (s,t):
 //
@@ -574,18 +597,18 @@ PatchTable::EvaluateBasis(
     float wP[], float wDs[], float wDt[],
     float wDss[], float wDst[], float wDtt[]) const {
 
-    PatchDescriptor::Type patchType = GetPatchArrayDescriptor(handle.arrayIndex).GetType();
-    PatchParam const & param = _paramTable[handle.patchIndex];
+    evaluatePatchBasis(GetPatchArrayDescriptor(handle.arrayIndex).GetType(),
+        _paramTable[handle.patchIndex], s, t, wP, wDs, wDt, wDss, wDst, wDtt);
+}
 
-    if (patchType == PatchDescriptor::REGULAR) {
-        internal::GetBSplineWeights(param, s, t, wP, wDs, wDt, wDss, wDst, wDtt);
-    } else if (patchType == PatchDescriptor::GREGORY_BASIS) {
-        internal::GetGregoryWeights(param, s, t, wP, wDs, wDt, wDss, wDst, wDtt);
-    } else if (patchType == PatchDescriptor::QUADS) {
-        internal::GetBilinearWeights(param, s, t, wP, wDs, wDt, wDss, wDst, wDtt);
-    } else {
-        assert(0);
-    }
+void
+PatchTable::EvaluateBasis(
+    PatchHandle const & handle, double s, double t,
+    double wP[], double wDs[], double wDt[],
+    double wDss[], double wDst[], double wDtt[]) const {
+
+    evaluatePatchBasis(GetPatchArrayDescriptor(handle.arrayIndex).GetType(),
+        _paramTable[handle.patchIndex], s, t, wP, wDs, wDt, wDss, wDst, wDtt);
 }
 
 //
@@ -602,6 +625,17 @@ PatchTable::EvaluateBasisVarying(
     internal::GetBilinearWeights(param, s, t, wP, wDs, wDt, wDss, wDst, wDtt);
 }
 
+void
+PatchTable::EvaluateBasisVarying(
+    PatchHandle const & handle, double s, double t,
+    double wP[], double wDs[], double wDt[],
+    double wDss[], double wDst[], double wDtt[]) const {
+
+    PatchParam const & param = _paramTable[handle.patchIndex];
+
+    internal::GetBilinearWeights(param, s, t, wP, wDs, wDt, wDss, wDst, wDtt);
+}
+
 //
 //  Evaluate basis functions for face-varying and derivatives at (s,t):
 //
@@ -617,17 +651,23 @@ PatchTable::EvaluateBasisFaceVarying(
             ? PatchDescriptor::REGULAR
             : GetFVarPatchDescriptor(channel).GetType();
 
-    if (patchType == PatchDescriptor::REGULAR) {
-        internal::GetBSplineWeights(param, s, t, wP, wDs, wDt, wDss, wDst, wDtt);
-    } else if (patchType == PatchDescriptor::GREGORY_BASIS) {
-        internal::GetGregoryWeights(param, s, t, wP, wDs, wDt, wDss, wDst, wDtt);
-    } else if (patchType == PatchDescriptor::QUADS) {
-        internal::GetBilinearWeights(param, s, t, wP, wDs, wDt, wDss, wDst, wDtt);
-    } else {
-        assert(0);
-    }
+    evaluatePatchBasis(patchType, param, s, t, wP, wDs, wDt, wDss, wDst, wDtt);
 }
 
+void
+PatchTable::EvaluateBasisFaceVarying(
+    PatchHandle const & handle, double s, double t,
+    double wP[], double wDs[], double wDt[],
+    double wDss[], double wDst[], double wDtt[],
+    int channel) const {
+
+    PatchParam param = getPatchFVarPatchParam(handle.patchIndex, channel);
+    PatchDescriptor::Type patchType = param.IsRegular()
+            ? PatchDescriptor::REGULAR
+            : GetFVarPatchDescriptor(channel).GetType();
+
+    evaluatePatchBasis(patchType, param, s, t, wP, wDs, wDt, wDss, wDst, wDtt);
+}
 
 } // end namespace Far
 
@@ -394,6 +394,11 @@ public:
         float wP[], float wDu[] = 0, float wDv[] = 0,
         float wDuu[] = 0, float wDuv[] = 0, float wDvv[] = 0) const;
 
+    /// \brief Same as above, in double precision
+    void EvaluateBasis(PatchHandle const & handle, double u, double v,
+        double wP[], double wDu[] = 0, double wDv[] = 0,
+        double wDuu[] = 0, double wDuv[] = 0, double wDvv[] = 0) const;
+
     /// \brief Evaluate basis functions for a varying value and
     /// derivatives at a given (u,v) parametric location of a patch.
     ///
@@ -420,6 +425,11 @@ public:
         float wP[], float wDu[] = 0, float wDv[] = 0,
         float wDuu[] = 0, float wDuv[] = 0, float wDvv[] = 0) const;
 
+    /// \brief Same as above, in double precision
+    void EvaluateBasisVarying(PatchHandle const & handle, double u, double v,
+        double wP[], double wDu[] = 0, double wDv[] = 0,
+        double wDuu[] = 0, double wDuv[] = 0, double wDvv[] = 0) const;
+
     /// \brief Evaluate basis functions for a face-varying value and
     /// derivatives at a given (u,v) parametric location of a patch.
     ///
@@ -448,14 +458,22 @@ public:
         float wP[], float wDu[] = 0, float wDv[] = 0,
         float wDuu[] = 0, float wDuv[] = 0, float wDvv[] = 0,
         int channel = 0) const;
+
+    /// \brief Same as above, in double precision
+    void EvaluateBasisFaceVarying(PatchHandle const & handle, double u, double v,
+        double wP[], double wDu[] = 0, double wDv[] = 0,
+        double wDuu[] = 0, double wDuv[] = 0, double wDvv[] = 0,
+        int channel = 0) const;
     //@}
 
 protected:
 
     friend class PatchTableBuilder;
+    friend class TableSerializer;
 
     // Factory constructor
-    PatchTable(int maxvalence);
+    PatchTable(int maxvalence,
+        PatchDescriptor varyingDesc = PatchDescriptor::QUADS);
 
     Index getPatchIndex(int array, int patch) const;
 
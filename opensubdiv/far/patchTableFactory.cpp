@@ -37,6 +37,10 @@
 
 #include <cstdio>
 
+#ifdef OPENSUBDIV_HAS_OPENMP
+    #include <omp.h>
+#endif
+
 namespace OpenSubdiv {
 namespace OPENSUBDIV_VERSION {
 namespace Far {
@@ -103,7 +107,8 @@ public:
     //
     typedef PatchTableFactory::Options Options;
 
-    PatchTableBuilder(TopologyRefiner const & refiner, Options options);
+    PatchTableBuilder(TopologyRefiner const & refiner, Options options,
+                      ConstIndexArray selectedFaces);
     ~PatchTableBuilder();
 
     void BuildUniform();
@@ -291,10 +296,22 @@ private:
             getRefinerFVarChannel(fvcInTable));
     }
 
+    //  Flags the faces of a level descending from the selected base faces,
+    //  given the flags of the previous level:
+    void selectLevelFaces(int levelIndex,
+                          std::vector<unsigned char> & selected) const;
+
     //  Methods for identifying and assigning patch-related data:
     void identifyPatchTopology(PatchTuple const & patch, PatchInfo & patchInfo,
                                int fvcInTable = -1);
 
+    void identifyPatchTopologies(int patchBegin, int patchEnd,
+                                 std::vector<PatchInfo> & patchInfos,
+                                 std::vector<PatchInfo> & fvarPatchInfos);
+
+    void inheritPatchProperties(PatchInfo & patchInfo,
+                                PatchInfo & lastPatchInfo) const;
+
     int assignPatchPointsAndStencils(PatchTuple const & patch,
                                      PatchInfo const & patchInfo,
                                      Index * patchPoints,
@@ -319,6 +336,7 @@ private:
     //  Refiner and Options passed on construction:
     TopologyRefiner const & _refiner;
     Options const           _options;
+    ConstIndexArray const   _selectedFaces;
 
     // Flags indicating the need for processing based on provided options
     unsigned int _requiresLocalPoints          : 1;
@@ -355,8 +373,9 @@ private:
 
 // Constructor
 PatchTableBuilder::PatchTableBuilder(
-    TopologyRefiner const & refiner, Options opts) :
-    _refiner(refiner), _options(opts),
+    TopologyRefiner const & refiner, Options opts,
+    ConstIndexArray selectedFaces) :
+    _refiner(refiner), _options(opts), _selectedFaces(selectedFaces),
     _table(0), _patchBuilder(0), _ptexIndices(refiner),
     _numRegularPatches(0), _numIrregularPatches(0),
     _legacyGregoryHelper(0) {
@@ -448,6 +467,32 @@ PatchTableBuilder::~PatchTableBuilder() {
 }
 
 
+void
+PatchTableBuilder::selectLevelFaces(int levelIndex,
+        std::vector<unsigned char> & selected) const {
+
+    if (levelIndex == 0) {
+        selected.assign(_refiner.getLevel(0).getNumFaces(), false);
+        for (int i = 0; i < _selectedFaces.size(); ++i) {
+            assert((_selectedFaces[i] >= 0) &&
+                   (_selectedFaces[i] < (int)selected.size()));
+            selected[_selectedFaces[i]] = true;
+        }
+    } else {
+        Vtr::internal::Refinement const & refinement =
+            _refiner.getRefinement(levelIndex - 1);
+
+        std::vector<unsigned char> parentSelected;
+        parentSelected.swap(selected);
+
+        selected.resize(refinement.child().getNumFaces());
+        for (int face = 0; face < (int)selected.size(); ++face) {
+            selected[face] =
+                parentSelected[refinement.getChildFaceParentFace(face)];
+        }
+    }
+}
+
 void
 PatchTableBuilder::identifyPatchTopology(PatchTuple const & patch,
         PatchInfo & patchInfo, int fvarInTable) {
@@ -511,6 +556,64 @@ PatchTableBuilder::identifyPatchTopology(PatchTuple const & patch,
     }
 }
 
+//
+//  Identifies the topology of the patches [patchBegin, patchEnd) -- and that
+//  of their non-linear face-varying patches not matching it -- concurrently,
+//  to be assigned in order afterwards:
+//
+void
+PatchTableBuilder::identifyPatchTopologies(int patchBegin, int patchEnd,
+        std::vector<PatchInfo> & patchInfos,
+        std::vector<PatchInfo> & fvarPatchInfos) {
+
+    int numFVarChannels = (int)_fvarChannelIndices.size();
+
+    patchInfos.resize(patchEnd - patchBegin);
+    fvarPatchInfos.resize((patchEnd - patchBegin) * numFVarChannels);
+
+#ifdef OPENSUBDIV_HAS_OPENMP
+    #pragma omp parallel for schedule(dynamic, 16)
+#endif
+    for (int patchIndex = patchBegin; patchIndex < patchEnd; ++patchIndex) {
+
+        PatchTuple const & patch = _patches[patchIndex];
+
+        identifyPatchTopology(patch, patchInfos[patchIndex - patchBegin]);
+
+        for (int fvc = 0; fvc < numFVarChannels; ++fvc) {
+            if (!isFVarChannelLinear(fvc) && !doesFVarTopologyMatch(patch, fvc)) {
+                identifyPatchTopology(patch, fvarPatchInfos[
+                    (patchIndex - patchBegin) * numFVarChannels + fvc], fvc);
+            }
+        }
+    }
+}
+
+//
+//  The properties not assigned by identifyPatchTopology() to irregular patches
+//  keep those of the patch previously identified with the same PatchInfo in
+//  the serial build -- when identified concurrently, they are inherited in
+//  order from the properties of the last patch, which are updated:
+//
+void
+PatchTableBuilder::inheritPatchProperties(PatchInfo & patchInfo,
+        PatchInfo & lastPatchInfo) const {
+
+    if (!patchInfo.isRegular) {
+        patchInfo.isRegSingleCrease = lastPatchInfo.isRegSingleCrease;
+        patchInfo.regBoundaryMask   = lastPatchInfo.regBoundaryMask;
+        patchInfo.regSharpness      = lastPatchInfo.regSharpness;
+        if (!_requiresIrregularLocalPoints) {
+            patchInfo.paramBoundaryMask = lastPatchInfo.paramBoundaryMask;
+        }
+    }
+    lastPatchInfo.isRegular         = patchInfo.isRegular;
+    lastPatchInfo.isRegSingleCrease = patchInfo.isRegSingleCrease;
+    lastPatchInfo.regBoundaryMask   = patchInfo.regBoundaryMask;
+    lastPatchInfo.regSharpness      = patchInfo.regSharpness;
+    lastPatchInfo.paramBoundaryMask = patchInfo.paramBoundaryMask;
+}
+
 int
 PatchTableBuilder::assignPatchPointsAndStencils(PatchTuple const & patch,
         PatchInfo const & patchInfo, Index * patchPoints,
@@ -704,6 +807,21 @@ PatchTableBuilder::BuildUniform() {
                                 ? PatchDescriptor::TRIANGLES
                                 : _patchBuilder->GetLinearPatchType();
 
+    //
+    //  When a subset of the base faces is selected, flag the faces of each
+    //  level descending from them:
+    //
+    std::vector< std::vector<unsigned char> > selectedLevelFaces;
+    if (_selectedFaces.size()) {
+        selectedLevelFaces.resize(maxlevel+1);
+
+        std::vector<unsigned char> selected;
+        for (int level=0; level<=maxlevel; ++level) {
+            selectLevelFaces(level, selected);
+            selectedLevelFaces[level] = selected;
+        }
+    }
+
     //
     //  Allocate and initialize the table's members.
     //
@@ -717,9 +835,10 @@ PatchTableBuilder::BuildUniform() {
         TopologyLevel const & refLevel = _refiner.GetLevel(level);
 
         int npatches = refLevel.GetNumFaces();
-        if (_refiner.HasHoles()) {
+        if (_refiner.HasHoles() || _selectedFaces.size()) {
             for (int i = npatches - 1; i >= 0; --i) {
-                npatches -= refLevel.IsFaceHole(i);
+                npatches -= refLevel.IsFaceHole(i) ||
+                    (_selectedFaces.size() && !selectedLevelFaces[level][i]);
             }
         }
         assert(npatches>=0);
@@ -781,6 +900,9 @@ PatchTableBuilder::BuildUniform() {
                 if (_refiner.HasHoles() && refLevel.IsFaceHole(face)) {
                     continue;
                 }
+                if (_selectedFaces.size() && !selectedLevelFaces[level][face]) {
+                    continue;
+                }
 
                 ConstIndexArray fverts = refLevel.GetFaceVertices(face);
                 for (int vert=0; vert<fverts.size(); ++vert) {
@@ -876,6 +998,8 @@ PatchTableBuilder::identifyAdaptivePatches() {
         _levelFVarValueOffsets[fvc].push_back(0);
     }
 
+    std::vector<unsigned char> selected;
+
     for (int levelIndex=0; levelIndex<_refiner.GetNumLevels(); ++levelIndex) {
         Level const & level = _refiner.getLevel(levelIndex);
 
@@ -889,15 +1013,45 @@ PatchTableBuilder::identifyAdaptivePatches() {
                 + level.getNumFVarValues(refinerChannel));
         }
 
-        for (int faceIndex = 0; faceIndex < level.getNumFaces(); ++faceIndex) {
+        //
+        //  Classify the faces of the level (concurrently when threaded) and
+        //  append their patches in order -- only the faces descending from
+        //  the selected base faces are considered if any were given:
+        //
+        enum { NO_PATCH = 0, REGULAR_PATCH, IRREGULAR_PATCH };
 
-            if (_patchBuilder->IsFaceAPatch(levelIndex, faceIndex) &&
+        int numFaces = level.getNumFaces();
+
+        if (_selectedFaces.size()) {
+            selectLevelFaces(levelIndex, selected);
+        }
+
+        std::vector<unsigned char> facePatches(numFaces);
+#ifdef OPENSUBDIV_HAS_OPENMP
+        #pragma omp parallel for schedule(static) if (_options.useMultipleThreads)
+#endif
+        for (int faceIndex = 0; faceIndex < numFaces; ++faceIndex) {
+
+            if ((selected.empty() || selected[faceIndex]) &&
+                _patchBuilder->IsFaceAPatch(levelIndex, faceIndex) &&
                 _patchBuilder->IsFaceALeaf(levelIndex, faceIndex)) {
 
+                facePatches[faceIndex] =
+                    _patchBuilder->IsPatchRegular(levelIndex, faceIndex)
+                    ? REGULAR_PATCH : IRREGULAR_PATCH;
+            } else {
+                facePatches[faceIndex] = NO_PATCH;
+            }
+        }
+
+        for (int faceIndex = 0; faceIndex < numFaces; ++faceIndex) {
+
+            if (facePatches[faceIndex] != NO_PATCH) {
+
                 _patches.push_back(PatchTuple(faceIndex, levelIndex));
 
                 // Count the patches here to simplify subsequent allocation.
-                if (_patchBuilder->IsPatchRegular(levelIndex, faceIndex)) {
+                if (facePatches[faceIndex] == REGULAR_PATCH) {
                     ++_numRegularPatches;
                 } else {
                     ++_numIrregularPatches;
@@ -1076,8 +1230,28 @@ PatchTableBuilder::populateAdaptivePatches() {
     //  Intentionally declare local vairables to contain patch topology info
     //  outside the loop to avoid repeated memory de-allocation/re-allocation
     //  associated with a change-of-basis.
-    PatchInfo patchInfo;
-    PatchInfo fvarPatchInfo;
+    PatchInfo serialPatchInfo;
+    PatchInfo serialFVarPatchInfo;
+
+    //
+    //  When threaded, the topology of the patches -- whose identification,
+    //  notably the change-of-basis of irregular patches, dominates the cost
+    //  of the build -- is identified concurrently for chunks of patches.  The
+    //  patches are then assigned in order, so that the local points, their
+    //  stencils and the sharpness values are those of the serial build:
+    //
+#ifdef OPENSUBDIV_HAS_OPENMP
+    bool identifyConcurrently = _options.useMultipleThreads &&
+                                (omp_get_max_threads() > 1);
+#else
+    bool identifyConcurrently = false;
+#endif
+    int const patchChunkSize = 1024;
+
+    std::vector<PatchInfo> chunkPatchInfos;
+    std::vector<PatchInfo> chunkFVarPatchInfos;
+
+    int numFVarChannels = (int)_fvarChannelIndices.size();
 
     for (int patchIndex = 0; patchIndex < (int)_patches.size(); ++patchIndex) {
 
@@ -1086,7 +1260,20 @@ PatchTableBuilder::populateAdaptivePatches() {
         //
         //  Identify and assign points, stencils, sharpness, etc. for this patch:
         //
-        identifyPatchTopology(patch, patchInfo);
+        int chunkIndex = patchIndex % patchChunkSize;
+        if (identifyConcurrently && (chunkIndex == 0)) {
+            identifyPatchTopologies(patchIndex,
+                std::min(patchIndex + patchChunkSize, (int)_patches.size()),
+                chunkPatchInfos, chunkFVarPatchInfos);
+        }
+
+        PatchInfo & patchInfo = identifyConcurrently
+                              ? chunkPatchInfos[chunkIndex] : serialPatchInfo;
+        if (!identifyConcurrently) {
+            identifyPatchTopology(patch, patchInfo);
+        } else {
+            inheritPatchProperties(patchInfo, serialPatchInfo);
+        }
 
         PatchArrayBuilder * arrayBuilder = &arrayBuilders[ARRAY_REGULAR];
         if (!patchInfo.isRegular) {
@@ -1138,11 +1325,19 @@ PatchTableBuilder::populateAdaptivePatches() {
                 //
                 bool fvcTopologyMatches = doesFVarTopologyMatch(patch, fvc);
 
+                PatchInfo & fvarPatchInfo = identifyConcurrently
+                    ? chunkFVarPatchInfos[chunkIndex * numFVarChannels + fvc]
+                    : serialFVarPatchInfo;
+
                 PatchInfo & fvcPatchInfo = fvcTopologyMatches
                                          ? patchInfo : fvarPatchInfo;
 
                 if (!fvcTopologyMatches) {
-                    identifyPatchTopology(patch, fvcPatchInfo, fvc);
+                    if (!identifyConcurrently) {
+                        identifyPatchTopology(patch, fvcPatchInfo, fvc);
+                    } else {
+                        inheritPatchProperties(fvcPatchInfo, serialFVarPatchInfo);
+                    }
                 }
                 assignPatchPointsAndStencils(patch, fvcPatchInfo,
                         arrayBuilder->fptr[fvc], *fvarLocalPointHelpers[fvc], fvc);
@@ -1809,9 +2004,10 @@ PatchTableBuilder::LegacyGregoryHelper::FinalizeVertexValence(
 //  to the PatchTableBuilder implementation
 //
 PatchTable *
-PatchTableFactory::Create(TopologyRefiner const & refiner, Options options) {
+PatchTableFactory::Create(TopologyRefiner const & refiner, Options options,
+                          ConstIndexArray selectedFaces) {
 
-    PatchTableBuilder builder(refiner, options);
+    PatchTableBuilder builder(refiner, options, selectedFaces);
 
     if (refiner.IsUniform()) {
         builder.BuildUniform();
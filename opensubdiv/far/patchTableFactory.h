@@ -65,6 +65,7 @@ public:
              generateFVarTables(false),
              generateFVarLegacyLinearPatches(true),
              generateLegacySharpCornerPatches(true),
+             useMultipleThreads(false),
              numFVarChannels(-1),
              fvarChannelIndices(0)
         { }
@@ -91,7 +92,11 @@ public:
 
                      // legacy behaviors (default to true)
                      generateFVarLegacyLinearPatches  : 1, ///< Generate all linear face-varying patches (legacy)
-                     generateLegacySharpCornerPatches : 1; ///< Generate sharp regular patches at smooth corners (legacy)
+                     generateLegacySharpCornerPatches : 1, ///< Generate sharp regular patches at smooth corners (legacy)
+
+                     // construction
+                     useMultipleThreads : 1; ///< Identify the patches concurrently (requires OpenMP, adaptive
+                                             ///< refinement only), the resulting table is identical
 
         int          numFVarChannels;          ///< Number of channel indices and interpolation modes passed
         int const *  fvarChannelIndices;       ///< List containing the indices of the channels selected for the factory
@@ -121,10 +126,18 @@ public:
     ///
     /// @param options              Options controlling the creation of the table
     ///
+    /// @param selectedFaces        Base faces for which patches are generated
+    ///                             (all the base faces if empty) -- only the
+    ///                             patches of these faces and of the refined
+    ///                             faces descending from them are included,
+    ///                             e.g. for a refiner adaptively refined with
+    ///                             the same faces
+    ///
     /// @return                     A new instance of PatchTable
     ///
     static PatchTable * Create(TopologyRefiner const & refiner,
-                               Options options=Options());
+                               Options options=Options(),
+                               ConstIndexArray selectedFaces=ConstIndexArray());
 
 public:
     //  PatchFaceTag
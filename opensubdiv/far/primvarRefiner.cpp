@@ -0,0 +1,61 @@
+//
+//   Copyright 2013 Pixar
+//
+//   Licensed under the Apache License, Version 2.0 (the "Apache License")
+//   with the following modification; you may not use this file except in
+//   compliance with the Apache License and the following modification to it:
+//   Section 6. Trademarks. is deleted and replaced with:
+//
+//   6. Trademarks. This License does not grant permission to use the trade
+//      names, trademarks, service marks, or product names of the Licensor
+//      and its affiliates, except as required to comply with Section 4(c) of
+//      the License and to reproduce the content of the NOTICE file.
+//
+//   You may obtain a copy of the Apache License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the Apache License with the above modification is
+//   distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//   KIND, either express or implied. See the Apache License for the specific
+//   language governing permissions and limitations under the Apache License.
+//
+
+
+#include "../far/primvarRefiner.h"
+
+#include <algorithm>
+
+namespace OpenSubdiv {
+namespace OPENSUBDIV_VERSION {
+
+namespace Far {
+namespace internal {
+
+//
+//  The ranges interpolated by the templated PrimvarRefiner methods are
+//  dispatched here, so that they are threaded according to the options the
+//  library was built with rather than those of the client code:
+//
+void
+ForEachRange(int numItems, int rangeSize, bool concurrently,
+             RangeFunction function, void const * data) {
+
+#ifdef OPENSUBDIV_HAS_OPENMP
+    #pragma omp parallel for if (concurrently)
+#else
+    (void)concurrently;
+#endif
+    for (int begin = 0; begin < numItems; begin += rangeSize) {
+        int end = std::min(begin + rangeSize, numItems);
+
+        function(data, begin, end);
+    }
+}
+
+} // end namespace internal
+} // end namespace Far
+
+} // end namespace OPENSUBDIV_VERSION
+} // end namespace OpenSubdiv
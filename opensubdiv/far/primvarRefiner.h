@@ -49,18 +49,119 @@ namespace OPENSUBDIV_VERSION {
 
 namespace Far {
 
+namespace internal {
+
+//
+//  Adaptor of a raw buffer of interleaved primvar data to the interface
+//  expected of the templated primvar buffers -- the LENGTH components of each
+//  element are known at compile time when non-zero, so that the loops of
+//  Clear() and AddWithWeight() are unrolled and vectorized by the compiler:
+//
+template <typename REAL, int LENGTH>
+class RawPrimvarBuffer {
+public:
+    class Element {
+    public:
+        Element(REAL * data, int length) : _data(data), _length(length) { }
+
+        void Clear() {
+            int length = LENGTH ? LENGTH : _length;
+            for (int k = 0; k < length; ++k) {
+                _data[k] = 0;
+            }
+        }
+
+        void AddWithWeight(Element const & src, REAL weight) {
+            int length = LENGTH ? LENGTH : _length;
+            for (int k = 0; k < length; ++k) {
+                _data[k] += weight * src._data[k];
+            }
+        }
+
+    private:
+        REAL * _data;
+        int    _length;
+    };
+
+    //  Source buffers are also adapted here (hence the const_cast) -- only
+    //  the elements of destination buffers are ever modified
+    RawPrimvarBuffer(REAL const * data, int offset, int length, int stride) :
+        _data(const_cast<REAL *>(data) + offset), _length(length), _stride(stride) { }
+
+    Element operator[](int index) const {
+        return Element(_data + (size_t)index * _stride, _length);
+    }
+
+private:
+    REAL * _data;
+    int    _length,
+           _stride;
+};
+
+//
+//  Applies a function to the consecutive ranges [begin, end) of rangeSize items
+//  partitioning [0, numItems) -- concurrently when requested and the library
+//  was built with OpenMP.  This is not a template, so that the threading of
+//  the templated PrimvarRefiner methods does not depend on the compiler
+//  options of the client code instantiating them:
+//
+typedef void (*RangeFunction)(void const * data, int begin, int end);
+
+void ForEachRange(int numItems, int rangeSize, bool concurrently,
+                  RangeFunction function, void const * data);
+
+} // end namespace internal
 
 ///
 ///  \brief Applies refinement operations to generic primvar data.
 ///
-class PrimvarRefiner {
+///  The floating point type REAL of the interpolation weights passed to the
+///  AddWithWeight() methods of the primvar classes is templated, allowing
+///  weights to be computed in single or double precision.
+///
+template <typename REAL>
+class PrimvarRefinerReal {
 
 public:
-    PrimvarRefiner(TopologyRefiner const & refiner) : _refiner(refiner) { }
-    ~PrimvarRefiner() { }
+    struct Options {
+
+        Options() : useMultipleThreads(false) { }
+
+        /// \brief Interpolate the child components originating from each type
+        ///        of parent component concurrently, see the \ref templating
+        ///        "note" below
+        ///
+        /// \note The threads are those of the library, which must be built
+        ///       with OpenMP for this option to have any effect (regardless of
+        ///       the compiler options of the client code).  It applies to the
+        ///       vertex and face-varying interpolation and limit methods --
+        ///       uniform face and varying data are interpolated serially.
+        ///
+        unsigned int useMultipleThreads : 1;
+    };
+
+    PrimvarRefinerReal(TopologyRefiner const & refiner, Options options = Options()) :
+        _refiner(refiner), _options(options) { }
+    ~PrimvarRefinerReal() { }
 
     TopologyRefiner const & GetTopologyRefiner() const { return _refiner; }
 
+    /// \brief Returns the options specified on construction
+    Options GetOptions() const { return _options; }
+
+    /// \brief Layout of the primvar data in a raw buffer (as in
+    ///        Osd::BufferDescriptor) : the 'length' components of element
+    ///        i start at index 'offset + i * stride'
+    struct BufferDescriptor {
+
+        BufferDescriptor() : offset(0), length(0), stride(0) { }
+        BufferDescriptor(int o, int l, int s) : offset(o), length(l), stride(s) { }
+
+        int offset;   ///< offset to the first element
+        int length;   ///< number of components of each element
+        int stride;   ///< distance between consecutive elements
+    };
+
     //@{
     ///  @name Primvar data interpolation
     ///
@@ -78,8 +179,8 @@ public:
     ///
     ///       class MyDestination {
     ///           void Clear();
-    ///           void AddWithWeight(MySource const & value, float weight);
-    ///           void AddWithWeight(MyDestination const & value, float weight);
+    ///           void AddWithWeight(MySource const & value, REAL weight);
+    ///           void AddWithWeight(MyDestination const & value, REAL weight);
     ///       };
     ///
     ///       \endcode
@@ -96,6 +197,12 @@ public:
     ///       <br><br>
     ///       See the <a href=http://graphics.pixar.com/opensubdiv/docs/tutorials.html>
     ///       Far tutorials</a> for code examples.
+    ///       <br><br>
+    ///       When Options::useMultipleThreads is set, Clear() and AddWithWeight()
+    ///       are invoked concurrently on distinct destination elements (and
+    ///       operator[] on both buffers), which must therefore not share any
+    ///       mutable state.  The interpolated values are identical to those
+    ///       computed on a single thread.
     ///
 
     /// \brief Apply vertex interpolation weights to a primvar buffer for a single
@@ -160,6 +267,39 @@ public:
     ///
     template <class T, class U> void InterpolateFaceVarying(int level, T const & src, U & dst, int channel = 0) const;
 
+    //@}
+
+    //@{
+    ///  @name Raw primvar buffer interpolation
+    ///
+    /// \brief Variants of the methods above interpolating the components of
+    ///        raw buffers of REAL, described by a BufferDescriptor
+    ///
+    /// The buffers of the source and destination levels follow the same
+    /// conventions as those of the templated methods, but all the components
+    /// of an element (e.g. interleaved positions, normals and colors) are
+    /// interpolated together in a loop inlined in the refiner: the weights
+    /// are computed once for all of them, without a call to AddWithWeight()
+    /// per component.  The source and destination lengths must be equal.
+    ///
+    /// The resulting values are those computed by the templated methods
+    /// with a primvar class accumulating the components in the same order.
+    ///
+    void Interpolate(int level, REAL const * src, BufferDescriptor const & srcDesc,
+                                REAL * dst,       BufferDescriptor const & dstDesc) const;
+
+    void InterpolateVarying(int level, REAL const * src, BufferDescriptor const & srcDesc,
+                                       REAL * dst,       BufferDescriptor const & dstDesc) const;
+
+    void InterpolateFaceVarying(int level, REAL const * src, BufferDescriptor const & srcDesc,
+                                           REAL * dst,       BufferDescriptor const & dstDesc,
+                                           int channel = 0) const;
+
+    //@}
+
+    //@{
+    ///  @name Primvar data limit evaluation
+    ///
 
     /// \brief Apply limit weights to a primvar buffer
     ///
@@ -184,8 +324,9 @@ public:
 private:
 
     //  Non-copyable:
-    PrimvarRefiner(PrimvarRefiner const & src) : _refiner(src._refiner) { }
-    PrimvarRefiner & operator=(PrimvarRefiner const &) { return *this; }
+    PrimvarRefinerReal(PrimvarRefinerReal const & src) :
+        _refiner(src._refiner), _options(src._options) { }
+    PrimvarRefinerReal & operator=(PrimvarRefinerReal const &) { return *this; }
 
     template <Sdc::SchemeType SCHEME, class T, class U> void interpFromFaces(int, T const &, U &) const;
     template <Sdc::SchemeType SCHEME, class T, class U> void interpFromEdges(int, T const &, U &) const;
@@ -201,17 +342,122 @@ private:
     template <Sdc::SchemeType SCHEME, class T, class U>
     void limitFVar(T const & src, U * dst, int channel) const;
 
+    //  The methods above process their parent components in ranges -- the
+    //  variants below interpolate a single range [begin, end), so that ranges
+    //  are interpolated concurrently with buffers private to each of them:
+    template <Sdc::SchemeType SCHEME, class T, class U> void interpFromFaces(int, T const &, U &, int, int) const;
+    template <Sdc::SchemeType SCHEME, class T, class U> void interpFromEdges(int, T const &, U &, int, int) const;
+    template <Sdc::SchemeType SCHEME, class T, class U> void interpFromVerts(int, T const &, U &, int, int) const;
+
+    template <Sdc::SchemeType SCHEME, class T, class U> void interpFVarFromFaces(int, T const &, U &, int, int, int) const;
+    template <Sdc::SchemeType SCHEME, class T, class U> void interpFVarFromEdges(int, T const &, U &, int, int, int) const;
+    template <Sdc::SchemeType SCHEME, class T, class U> void interpFVarFromVerts(int, T const &, U &, int, int, int) const;
+
+    template <Sdc::SchemeType SCHEME, class T, class U, class U1, class U2>
+    void limit(T const & src, U & pos, U1 * tan1, U2 * tan2, int begin, int end) const;
+
+    template <Sdc::SchemeType SCHEME, class T, class U>
+    void limitFVar(T const & src, U * dst, int channel, int begin, int end) const;
+
+    //  A single range unless multiple threads are used:
+    int getRangeSize(int numComponents) const {
+        int const threadedRangeSize = 256;
+        return (_options.useMultipleThreads && (numComponents > threadedRangeSize)) ?
+            threadedRangeSize : numComponents;
+    }
+
+    //  The arguments of the range variants above, with a function applying
+    //  them to a range as expected by internal::ForEachRange():
+    template <class T, class U>
+    struct Ranges {
+        typedef void (PrimvarRefinerReal::*Method)(int, T const &, U &, int, int) const;
+
+        PrimvarRefinerReal const * refiner;
+        Method                     method;
+        int                        level;
+        T const *                  src;
+        U *                        dst;
+
+        static void Apply(void const * data, int begin, int end) {
+            Ranges const & r = *static_cast<Ranges const *>(data);
+            (r.refiner->*r.method)(r.level, *r.src, *r.dst, begin, end);
+        }
+    };
+
+    template <class T, class U>
+    struct FVarRanges {
+        typedef void (PrimvarRefinerReal::*Method)(int, T const &, U &, int, int, int) const;
+
+        PrimvarRefinerReal const * refiner;
+        Method                     method;
+        int                        level;
+        int                        channel;
+        T const *                  src;
+        U *                        dst;
+
+        static void Apply(void const * data, int begin, int end) {
+            FVarRanges const & r = *static_cast<FVarRanges const *>(data);
+            (r.refiner->*r.method)(r.level, *r.src, *r.dst, r.channel, begin, end);
+        }
+    };
+
+    template <class T, class U, class U1, class U2>
+    struct LimitRanges {
+        typedef void (PrimvarRefinerReal::*Method)(T const &, U &, U1 *, U2 *, int, int) const;
+
+        PrimvarRefinerReal const * refiner;
+        Method                     method;
+        T const *                  src;
+        U *                        pos;
+        U1 *                       tan1;
+        U2 *                       tan2;
+
+        static void Apply(void const * data, int begin, int end) {
+            LimitRanges const & r = *static_cast<LimitRanges const *>(data);
+            (r.refiner->*r.method)(*r.src, *r.pos, r.tan1, r.tan2, begin, end);
+        }
+    };
+
+    template <class T, class U>
+    struct LimitFVarRanges {
+        typedef void (PrimvarRefinerReal::*Method)(T const &, U *, int, int, int) const;
+
+        PrimvarRefinerReal const * refiner;
+        Method                     method;
+        T const *                  src;
+        U *                        dst;
+        int                        channel;
+
+        static void Apply(void const * data, int begin, int end) {
+            LimitFVarRanges const & r = *static_cast<LimitFVarRanges const *>(data);
+            (r.refiner->*r.method)(*r.src, r.dst, r.channel, begin, end);
+        }
+    };
+
+    enum RawInterpolation { RAW_VERTEX, RAW_VARYING, RAW_FACE_VARYING };
+
+    void interpolateRaw(RawInterpolation type, int level,
+        REAL const * src, BufferDescriptor const & srcDesc,
+        REAL * dst, BufferDescriptor const & dstDesc, int channel) const;
+
+    template <int LENGTH>
+    void interpolateRaw(RawInterpolation type, int level,
+        REAL const * src, BufferDescriptor const & srcDesc,
+        REAL * dst, BufferDescriptor const & dstDesc, int channel) const;
+
 private:
 
     TopologyRefiner const &  _refiner;
 
+    Options                  _options;
+
 private:
     //
     //  Local class to fulfill interface for <typename MASK> in the Scheme mask queries:
     //
     class Mask {
     public:
-        typedef float Weight;  //  Also part of the expected interface
+        typedef REAL Weight;  //  Also part of the expected interface
 
     public:
         Mask(Weight* v, Weight* e, Weight* f) : 
@@ -261,9 +507,10 @@ private:
 //  use as a template parameter in subsequent implementation will be factored
 //  out of a later release:
 //
+template <typename REAL>
 template <class T, class U>
 inline void
-PrimvarRefiner::Interpolate(int level, T const & src, U & dst) const {
+PrimvarRefinerReal<REAL>::Interpolate(int level, T const & src, U & dst) const {
 
     assert(level>0 && level<=(int)_refiner._refinements.size());
 
@@ -286,9 +533,10 @@ PrimvarRefiner::Interpolate(int level, T const & src, U & dst) const {
     }
 }
 
+template <typename REAL>
 template <class T, class U>
 inline void
-PrimvarRefiner::InterpolateFaceVarying(int level, T const & src, U & dst, int channel) const {
+PrimvarRefinerReal<REAL>::InterpolateFaceVarying(int level, T const & src, U & dst, int channel) const {
 
     assert(level>0 && level<=(int)_refiner._refinements.size());
 
@@ -311,9 +559,10 @@ PrimvarRefiner::InterpolateFaceVarying(int level, T const & src, U & dst, int ch
     }
 }
 
+template <typename REAL>
 template <class T, class U>
 inline void
-PrimvarRefiner::Limit(T const & src, U & dst) const {
+PrimvarRefinerReal<REAL>::Limit(T const & src, U & dst) const {
 
     if (_refiner.getLevel(_refiner.GetMaxLevel()).getNumVertexEdgesTotal() == 0) {
         Error(FAR_RUNTIME_ERROR,
@@ -335,9 +584,10 @@ PrimvarRefiner::Limit(T const & src, U & dst) const {
     }
 }
 
+template <typename REAL>
 template <class T, class U, class U1, class U2>
 inline void
-PrimvarRefiner::Limit(T const & src, U & dstPos, U1 & dstTan1, U2 & dstTan2) const {
+PrimvarRefinerReal<REAL>::Limit(T const & src, U & dstPos, U1 & dstTan1, U2 & dstTan2) const {
 
     if (_refiner.getLevel(_refiner.GetMaxLevel()).getNumVertexEdgesTotal() == 0) {
         Error(FAR_RUNTIME_ERROR,
@@ -359,9 +609,10 @@ PrimvarRefiner::Limit(T const & src, U & dstPos, U1 & dstTan1, U2 & dstTan2) con
     }
 }
 
+template <typename REAL>
 template <class T, class U>
 inline void
-PrimvarRefiner::LimitFaceVarying(T const & src, U & dst, int channel) const {
+PrimvarRefinerReal<REAL>::LimitFaceVarying(T const & src, U & dst, int channel) const {
 
     if (_refiner.getLevel(_refiner.GetMaxLevel()).getNumVertexEdgesTotal() == 0) {
         Error(FAR_RUNTIME_ERROR,
@@ -383,16 +634,90 @@ PrimvarRefiner::LimitFaceVarying(T const & src, U & dst, int channel) const {
     }
 }
 
+//
+//  Raw primvar buffers are adapted to the templated interface, with the most
+//  common lengths of the elements dispatched to fixed size loops:
+//
+template <typename REAL>
+inline void
+PrimvarRefinerReal<REAL>::Interpolate(int level,
+        REAL const * src, BufferDescriptor const & srcDesc,
+        REAL * dst, BufferDescriptor const & dstDesc) const {
+
+    interpolateRaw(RAW_VERTEX, level, src, srcDesc, dst, dstDesc, 0);
+}
+
+template <typename REAL>
+inline void
+PrimvarRefinerReal<REAL>::InterpolateVarying(int level,
+        REAL const * src, BufferDescriptor const & srcDesc,
+        REAL * dst, BufferDescriptor const & dstDesc) const {
+
+    interpolateRaw(RAW_VARYING, level, src, srcDesc, dst, dstDesc, 0);
+}
+
+template <typename REAL>
+inline void
+PrimvarRefinerReal<REAL>::InterpolateFaceVarying(int level,
+        REAL const * src, BufferDescriptor const & srcDesc,
+        REAL * dst, BufferDescriptor const & dstDesc, int channel) const {
+
+    interpolateRaw(RAW_FACE_VARYING, level, src, srcDesc, dst, dstDesc, channel);
+}
+
+template <typename REAL>
+inline void
+PrimvarRefinerReal<REAL>::interpolateRaw(RawInterpolation type, int level,
+        REAL const * src, BufferDescriptor const & srcDesc,
+        REAL * dst, BufferDescriptor const & dstDesc, int channel) const {
+
+    assert(srcDesc.length == dstDesc.length);
+
+    switch (dstDesc.length) {
+    case 1:  interpolateRaw<1>(type, level, src, srcDesc, dst, dstDesc, channel); break;
+    case 2:  interpolateRaw<2>(type, level, src, srcDesc, dst, dstDesc, channel); break;
+    case 3:  interpolateRaw<3>(type, level, src, srcDesc, dst, dstDesc, channel); break;
+    case 4:  interpolateRaw<4>(type, level, src, srcDesc, dst, dstDesc, channel); break;
+    default: interpolateRaw<0>(type, level, src, srcDesc, dst, dstDesc, channel); break;
+    }
+}
+
+template <typename REAL>
+template <int LENGTH>
+inline void
+PrimvarRefinerReal<REAL>::interpolateRaw(RawInterpolation type, int level,
+        REAL const * src, BufferDescriptor const & srcDesc,
+        REAL * dst, BufferDescriptor const & dstDesc, int channel) const {
+
+    internal::RawPrimvarBuffer<REAL, LENGTH>
+        srcBuffer(src, srcDesc.offset, srcDesc.length, srcDesc.stride),
+        dstBuffer(dst, dstDesc.offset, dstDesc.length, dstDesc.stride);
+
+    switch (type) {
+    case RAW_VERTEX:
+        Interpolate(level, srcBuffer, dstBuffer);
+        break;
+    case RAW_VARYING:
+        InterpolateVarying(level, srcBuffer, dstBuffer);
+        break;
+    case RAW_FACE_VARYING:
+        InterpolateFaceVarying(level, srcBuffer, dstBuffer, channel);
+        break;
+    }
+}
+
+template <typename REAL>
 template <class T, class U>
 inline void
-PrimvarRefiner::InterpolateFaceUniform(int level, T const & src, U & dst) const {
+PrimvarRefinerReal<REAL>::InterpolateFaceUniform(int level, T const & src, U & dst) const {
 
     assert(level>0 && level<=(int)_refiner._refinements.size());
 
     Vtr::internal::Refinement const & refinement = _refiner.getRefinement(level-1);
     Vtr::internal::Level const & child = refinement.child();
 
-    for (int cFace = 0; cFace < child.getNumFaces(); ++cFace) {
+    int numChildFaces = child.getNumFaces();
+    for (int cFace = 0; cFace < numChildFaces; ++cFace) {
 
         Vtr::Index pFace = refinement.getChildFaceParentFace(cFace);
 
@@ -400,9 +725,10 @@ PrimvarRefiner::InterpolateFaceUniform(int level, T const & src, U & dst) const
     }
 }
 
+template <typename REAL>
 template <class T, class U>
 inline void
-PrimvarRefiner::InterpolateVarying(int level, T const & src, U & dst) const {
+PrimvarRefinerReal<REAL>::InterpolateVarying(int level, T const & src, U & dst) const {
 
     assert(level>0 && level<=(int)_refiner._refinements.size());
 
@@ -415,7 +741,8 @@ PrimvarRefiner::InterpolateVarying(int level, T const & src, U & dst) const {
     //
     if (refinement.getNumChildVerticesFromFaces() > 0) {
 
-        for (int face = 0; face < parent.getNumFaces(); ++face) {
+        int numFaces = parent.getNumFaces();
+        for (int face = 0; face < numFaces; ++face) {
 
             Vtr::Index cVert = refinement.getFaceChildVertex(face);
             if (Vtr::IndexIsValid(cVert)) {
@@ -423,7 +750,7 @@ PrimvarRefiner::InterpolateVarying(int level, T const & src, U & dst) const {
                 //  Apply the weights to the parent face's vertices:
                 ConstIndexArray fVerts = parent.getFaceVertices(face);
 
-                float fVaryingWeight = 1.0f / (float) fVerts.size();
+                REAL fVaryingWeight = 1.0f / (REAL) fVerts.size();
 
                 dst[cVert].Clear();
                 for (int i = 0; i < fVerts.size(); ++i) {
@@ -432,7 +759,9 @@ PrimvarRefiner::InterpolateVarying(int level, T const & src, U & dst) const {
             }
         }
     }
-    for (int edge = 0; edge < parent.getNumEdges(); ++edge) {
+
+    int numEdges = parent.getNumEdges();
+    for (int edge = 0; edge < numEdges; ++edge) {
 
         Vtr::Index cVert = refinement.getEdgeChildVertex(edge);
         if (Vtr::IndexIsValid(cVert)) {
@@ -445,7 +774,9 @@ PrimvarRefiner::InterpolateVarying(int level, T const & src, U & dst) const {
             dst[cVert].AddWithWeight(src[eVerts[1]], 0.5f);
         }
     }
-    for (int vert = 0; vert < parent.getNumVertices(); ++vert) {
+
+    int numVerts = parent.getNumVertices();
+    for (int vert = 0; vert < numVerts; ++vert) {
 
         Vtr::Index cVert = refinement.getVertexChildVertex(vert);
         if (Vtr::IndexIsValid(cVert)) {
@@ -462,9 +793,25 @@ PrimvarRefiner::InterpolateVarying(int level, T const & src, U & dst) const {
 //  Internal implementation methods -- grouping vertices to be interpolated
 //  based on the type of parent component from which they originated:
 //
+template <typename REAL>
 template <Sdc::SchemeType SCHEME, class T, class U>
 inline void
-PrimvarRefiner::interpFromFaces(int level, T const & src, U & dst) const {
+PrimvarRefinerReal<REAL>::interpFromFaces(int level, T const & src, U & dst) const {
+
+    int numComponents = _refiner.getRefinement(level-1).parent().getNumFaces();
+
+    Ranges<T,U> ranges = { this, &PrimvarRefinerReal::interpFromFaces<SCHEME,T,U>,
+        level, &src, &dst };
+
+    internal::ForEachRange(numComponents, getRangeSize(numComponents),
+        _options.useMultipleThreads, &Ranges<T,U>::Apply, &ranges);
+}
+
+template <typename REAL>
+template <Sdc::SchemeType SCHEME, class T, class U>
+inline void
+PrimvarRefinerReal<REAL>::interpFromFaces(int level, T const & src, U & dst,
+        int begin, int end) const {
 
     Vtr::internal::Refinement const & refinement = _refiner.getRefinement(level-1);
     Vtr::internal::Level const &      parent     = refinement.parent();
@@ -473,9 +820,9 @@ PrimvarRefiner::interpFromFaces(int level, T const & src, U & dst) const {
 
     Sdc::Scheme<SCHEME> scheme(_refiner._subdivOptions);
 
-    Vtr::internal::StackBuffer<float,16> fVertWeights(parent.getMaxValence());
+    Vtr::internal::StackBuffer<REAL,16> fVertWeights(parent.getMaxValence());
 
-    for (int face = 0; face < parent.getNumFaces(); ++face) {
+    for (int face = begin; face < end; ++face) {
 
         Vtr::Index cVert = refinement.getFaceChildVertex(face);
         if (!Vtr::IndexIsValid(cVert))
@@ -499,9 +846,25 @@ PrimvarRefiner::interpFromFaces(int level, T const & src, U & dst) const {
     }
 }
 
+template <typename REAL>
 template <Sdc::SchemeType SCHEME, class T, class U>
 inline void
-PrimvarRefiner::interpFromEdges(int level, T const & src, U & dst) const {
+PrimvarRefinerReal<REAL>::interpFromEdges(int level, T const & src, U & dst) const {
+
+    int numComponents = _refiner.getRefinement(level-1).parent().getNumEdges();
+
+    Ranges<T,U> ranges = { this, &PrimvarRefinerReal::interpFromEdges<SCHEME,T,U>,
+        level, &src, &dst };
+
+    internal::ForEachRange(numComponents, getRangeSize(numComponents),
+        _options.useMultipleThreads, &Ranges<T,U>::Apply, &ranges);
+}
+
+template <typename REAL>
+template <Sdc::SchemeType SCHEME, class T, class U>
+inline void
+PrimvarRefinerReal<REAL>::interpFromEdges(int level, T const & src, U & dst,
+        int begin, int end) const {
 
     Vtr::internal::Refinement const & refinement = _refiner.getRefinement(level-1);
     Vtr::internal::Level const &      parent     = refinement.parent();
@@ -511,10 +874,10 @@ PrimvarRefiner::interpFromEdges(int level, T const & src, U & dst) const {
 
     Vtr::internal::EdgeInterface eHood(parent);
 
-    float                               eVertWeights[2];
-    Vtr::internal::StackBuffer<float,8> eFaceWeights(parent.getMaxEdgeFaces());
+    REAL                               eVertWeights[2];
+    Vtr::internal::StackBuffer<REAL,8> eFaceWeights(parent.getMaxEdgeFaces());
 
-    for (int edge = 0; edge < parent.getNumEdges(); ++edge) {
+    for (int edge = begin; edge < end; ++edge) {
 
         Vtr::Index cVert = refinement.getEdgeChildVertex(edge);
         if (!Vtr::IndexIsValid(cVert))
@@ -568,9 +931,25 @@ PrimvarRefiner::interpFromEdges(int level, T const & src, U & dst) const {
     }
 }
 
+template <typename REAL>
+template <Sdc::SchemeType SCHEME, class T, class U>
+inline void
+PrimvarRefinerReal<REAL>::interpFromVerts(int level, T const & src, U & dst) const {
+
+    int numComponents = _refiner.getRefinement(level-1).parent().getNumVertices();
+
+    Ranges<T,U> ranges = { this, &PrimvarRefinerReal::interpFromVerts<SCHEME,T,U>,
+        level, &src, &dst };
+
+    internal::ForEachRange(numComponents, getRangeSize(numComponents),
+        _options.useMultipleThreads, &Ranges<T,U>::Apply, &ranges);
+}
+
+template <typename REAL>
 template <Sdc::SchemeType SCHEME, class T, class U>
 inline void
-PrimvarRefiner::interpFromVerts(int level, T const & src, U & dst) const {
+PrimvarRefinerReal<REAL>::interpFromVerts(int level, T const & src, U & dst,
+        int begin, int end) const {
 
     Vtr::internal::Refinement const & refinement = _refiner.getRefinement(level-1);
     Vtr::internal::Level const &      parent     = refinement.parent();
@@ -580,9 +959,9 @@ PrimvarRefiner::interpFromVerts(int level, T const & src, U & dst) const {
 
     Vtr::internal::VertexInterface vHood(parent, child);
 
-    Vtr::internal::StackBuffer<float,32> weightBuffer(2*parent.getMaxValence());
+    Vtr::internal::StackBuffer<REAL,32> weightBuffer(2*parent.getMaxValence());
 
-    for (int vert = 0; vert < parent.getNumVertices(); ++vert) {
+    for (int vert = begin; vert < end; ++vert) {
 
         Vtr::Index cVert = refinement.getVertexChildVertex(vert);
         if (!Vtr::IndexIsValid(cVert))
@@ -592,9 +971,9 @@ PrimvarRefiner::interpFromVerts(int level, T const & src, U & dst) const {
         ConstIndexArray vEdges = parent.getVertexEdges(vert),
                         vFaces = parent.getVertexFaces(vert);
 
-        float   vVertWeight,
-              * vEdgeWeights = weightBuffer,
-              * vFaceWeights = vEdgeWeights + vEdges.size();
+        REAL   vVertWeight,
+             * vEdgeWeights = weightBuffer,
+             * vFaceWeights = vEdgeWeights + vEdges.size();
 
         Mask vMask(&vVertWeight, vEdgeWeights, vFaceWeights);
 
@@ -641,9 +1020,25 @@ PrimvarRefiner::interpFromVerts(int level, T const & src, U & dst) const {
 //
 // Internal face-varying implementation details:
 //
+template <typename REAL>
 template <Sdc::SchemeType SCHEME, class T, class U>
 inline void
-PrimvarRefiner::interpFVarFromFaces(int level, T const & src, U & dst, int channel) const {
+PrimvarRefinerReal<REAL>::interpFVarFromFaces(int level, T const & src, U & dst, int channel) const {
+
+    int numComponents = _refiner.getRefinement(level-1).parent().getNumFaces();
+
+    FVarRanges<T,U> ranges = { this, &PrimvarRefinerReal::interpFVarFromFaces<SCHEME,T,U>,
+        level, channel, &src, &dst };
+
+    internal::ForEachRange(numComponents, getRangeSize(numComponents),
+        _options.useMultipleThreads, &FVarRanges<T,U>::Apply, &ranges);
+}
+
+template <typename REAL>
+template <Sdc::SchemeType SCHEME, class T, class U>
+inline void
+PrimvarRefinerReal<REAL>::interpFVarFromFaces(int level, T const & src, U & dst, int channel,
+        int begin, int end) const {
 
     Vtr::internal::Refinement const & refinement = _refiner.getRefinement(level-1);
 
@@ -657,9 +1052,9 @@ PrimvarRefiner::interpFVarFromFaces(int level, T const & src, U & dst, int chann
     Vtr::internal::FVarLevel const & parentFVar = parentLevel.getFVarLevel(channel);
     Vtr::internal::FVarLevel const & childFVar  = childLevel.getFVarLevel(channel);
 
-    Vtr::internal::StackBuffer<float,16> fValueWeights(parentLevel.getMaxValence());
+    Vtr::internal::StackBuffer<REAL,16> fValueWeights(parentLevel.getMaxValence());
 
-    for (int face = 0; face < parentLevel.getNumFaces(); ++face) {
+    for (int face = begin; face < end; ++face) {
 
         Vtr::Index cVert = refinement.getFaceChildVertex(face);
         if (!Vtr::IndexIsValid(cVert))
@@ -689,9 +1084,25 @@ PrimvarRefiner::interpFVarFromFaces(int level, T const & src, U & dst, int chann
     }
 }
 
+template <typename REAL>
 template <Sdc::SchemeType SCHEME, class T, class U>
 inline void
-PrimvarRefiner::interpFVarFromEdges(int level, T const & src, U & dst, int channel) const {
+PrimvarRefinerReal<REAL>::interpFVarFromEdges(int level, T const & src, U & dst, int channel) const {
+
+    int numComponents = _refiner.getRefinement(level-1).parent().getNumEdges();
+
+    FVarRanges<T,U> ranges = { this, &PrimvarRefinerReal::interpFVarFromEdges<SCHEME,T,U>,
+        level, channel, &src, &dst };
+
+    internal::ForEachRange(numComponents, getRangeSize(numComponents),
+        _options.useMultipleThreads, &FVarRanges<T,U>::Apply, &ranges);
+}
+
+template <typename REAL>
+template <Sdc::SchemeType SCHEME, class T, class U>
+inline void
+PrimvarRefinerReal<REAL>::interpFVarFromEdges(int level, T const & src, U & dst, int channel,
+        int begin, int end) const {
 
     Vtr::internal::Refinement const & refinement = _refiner.getRefinement(level-1);
 
@@ -708,8 +1119,8 @@ PrimvarRefiner::interpFVarFromEdges(int level, T const & src, U & dst, int chann
     //  Allocate and initialize (if linearly interpolated) interpolation weights for
     //  the edge mask:
     //
-    float                               eVertWeights[2];
-    Vtr::internal::StackBuffer<float,8> eFaceWeights(parentLevel.getMaxEdgeFaces());
+    REAL                               eVertWeights[2];
+    Vtr::internal::StackBuffer<REAL,8> eFaceWeights(parentLevel.getMaxEdgeFaces());
 
     Mask eMask(eVertWeights, 0, eFaceWeights);
 
@@ -725,7 +1136,7 @@ PrimvarRefiner::interpFVarFromEdges(int level, T const & src, U & dst, int chann
 
     Vtr::internal::EdgeInterface eHood(parentLevel);
 
-    for (int edge = 0; edge < parentLevel.getNumEdges(); ++edge) {
+    for (int edge = begin; edge < end; ++edge) {
 
         Vtr::Index cVert = refinement.getEdgeChildVertex(edge);
         if (!Vtr::IndexIsValid(cVert))
@@ -833,9 +1244,25 @@ PrimvarRefiner::interpFVarFromEdges(int level, T const & src, U & dst, int chann
     }
 }
 
+template <typename REAL>
+template <Sdc::SchemeType SCHEME, class T, class U>
+inline void
+PrimvarRefinerReal<REAL>::interpFVarFromVerts(int level, T const & src, U & dst, int channel) const {
+
+    int numComponents = _refiner.getRefinement(level-1).parent().getNumVertices();
+
+    FVarRanges<T,U> ranges = { this, &PrimvarRefinerReal::interpFVarFromVerts<SCHEME,T,U>,
+        level, channel, &src, &dst };
+
+    internal::ForEachRange(numComponents, getRangeSize(numComponents),
+        _options.useMultipleThreads, &FVarRanges<T,U>::Apply, &ranges);
+}
+
+template <typename REAL>
 template <Sdc::SchemeType SCHEME, class T, class U>
 inline void
-PrimvarRefiner::interpFVarFromVerts(int level, T const & src, U & dst, int channel) const {
+PrimvarRefinerReal<REAL>::interpFVarFromVerts(int level, T const & src, U & dst, int channel,
+        int begin, int end) const {
 
     Vtr::internal::Refinement const & refinement = _refiner.getRefinement(level-1);
 
@@ -850,13 +1277,13 @@ PrimvarRefiner::interpFVarFromVerts(int level, T const & src, U & dst, int chann
 
     bool isLinearFVar = parentFVar.isLinear() || (_refiner._subdivType == Sdc::SCHEME_BILINEAR);
 
-    Vtr::internal::StackBuffer<float,32> weightBuffer(2*parentLevel.getMaxValence());
+    Vtr::internal::StackBuffer<REAL,32> weightBuffer(2*parentLevel.getMaxValence());
 
     Vtr::internal::StackBuffer<Vtr::Index,16> vEdgeValues(parentLevel.getMaxValence());
 
     Vtr::internal::VertexInterface vHood(parentLevel, childLevel);
 
-    for (int vert = 0; vert < parentLevel.getNumVertices(); ++vert) {
+    for (int vert = begin; vert < end; ++vert) {
 
         Vtr::Index cVert = refinement.getVertexChildVertex(vert);
         if (!Vtr::IndexIsValid(cVert))
@@ -881,9 +1308,9 @@ PrimvarRefiner::interpFVarFromVerts(int level, T const & src, U & dst, int chann
             //
             ConstIndexArray vEdges = parentLevel.getVertexEdges(vert);
 
-            float   vVertWeight;
-            float * vEdgeWeights = weightBuffer;
-            float * vFaceWeights = vEdgeWeights + vEdges.size();
+            REAL   vVertWeight;
+            REAL * vEdgeWeights = weightBuffer;
+            REAL * vFaceWeights = vEdgeWeights + vEdges.size();
 
             Mask vMask(&vVertWeight, vEdgeWeights, vFaceWeights);
 
@@ -974,8 +1401,8 @@ PrimvarRefiner::interpFVarFromVerts(int level, T const & src, U & dst, int chann
                     Index pEndValues[2];
                     parentFVar.getVertexCreaseEndValues(vert, pSibling, pEndValues);
 
-                    float vWeight = 0.75f;
-                    float eWeight = 0.125f;
+                    REAL vWeight = 0.75f;
+                    REAL eWeight = 0.125f;
 
                     //
                     //  If semi-sharp we need to apply fractional weighting -- if made sharp because
@@ -983,10 +1410,10 @@ PrimvarRefiner::interpFVarFromVerts(int level, T const & src, U & dst, int chann
                     //  other sibling (should only occur when there are 2):
                     //
                     if (pValueTags[pSibling].isSemiSharp()) {
-                        float wCorner = pValueTags[pSibling].isDepSharp()
+                        REAL wCorner = pValueTags[pSibling].isDepSharp()
                                       ? refineFVar.getFractionalWeight(vert, !pSibling, cVert, !cSibling)
                                       : refineFVar.getFractionalWeight(vert, pSibling, cVert, cSibling);
-                        float wCrease = 1.0f - wCorner;
+                        REAL wCrease = 1.0f - wCorner;
 
                         vWeight = wCrease * 0.75f + wCorner;
                         eWeight = wCrease * 0.125f;
@@ -1000,9 +1427,25 @@ PrimvarRefiner::interpFVarFromVerts(int level, T const & src, U & dst, int chann
     }
 }
 
+template <typename REAL>
 template <Sdc::SchemeType SCHEME, class T, class U, class U1, class U2>
 inline void
-PrimvarRefiner::limit(T const & src, U & dstPos, U1 * dstTan1Ptr, U2 * dstTan2Ptr) const {
+PrimvarRefinerReal<REAL>::limit(T const & src, U & dstPos, U1 * dstTan1Ptr, U2 * dstTan2Ptr) const {
+
+    int numComponents = _refiner.getLevel(_refiner.GetMaxLevel()).getNumVertices();
+
+    LimitRanges<T,U,U1,U2> ranges = { this, &PrimvarRefinerReal::limit<SCHEME,T,U,U1,U2>,
+        &src, &dstPos, dstTan1Ptr, dstTan2Ptr };
+
+    internal::ForEachRange(numComponents, getRangeSize(numComponents),
+        _options.useMultipleThreads, &LimitRanges<T,U,U1,U2>::Apply, &ranges);
+}
+
+template <typename REAL>
+template <Sdc::SchemeType SCHEME, class T, class U, class U1, class U2>
+inline void
+PrimvarRefinerReal<REAL>::limit(T const & src, U & dstPos, U1 * dstTan1Ptr, U2 * dstTan2Ptr,
+        int begin, int end) const {
 
     Sdc::Scheme<SCHEME> scheme(_refiner._subdivOptions);
 
@@ -1013,17 +1456,17 @@ PrimvarRefiner::limit(T const & src, U & dstPos, U1 * dstTan1Ptr, U2 * dstTan2Pt
     int  numMasks = 1 + (hasTangents ? 2 : 0);
 
     Vtr::internal::StackBuffer<Index,33> indexBuffer(maxWeightsPerMask);
-    Vtr::internal::StackBuffer<float,99> weightBuffer(numMasks * maxWeightsPerMask);
-
-    float * vPosWeights = weightBuffer,
-          * ePosWeights = vPosWeights + 1,
-          * fPosWeights = ePosWeights + level.getMaxValence();
-    float * vTan1Weights = vPosWeights + maxWeightsPerMask,
-          * eTan1Weights = ePosWeights + maxWeightsPerMask,
-          * fTan1Weights = fPosWeights + maxWeightsPerMask;
-    float * vTan2Weights = vTan1Weights + maxWeightsPerMask,
-          * eTan2Weights = eTan1Weights + maxWeightsPerMask,
-          * fTan2Weights = fTan1Weights + maxWeightsPerMask;
+    Vtr::internal::StackBuffer<REAL,99> weightBuffer(numMasks * maxWeightsPerMask);
+
+    REAL * vPosWeights = weightBuffer,
+         * ePosWeights = vPosWeights + 1,
+         * fPosWeights = ePosWeights + level.getMaxValence();
+    REAL * vTan1Weights = vPosWeights + maxWeightsPerMask,
+         * eTan1Weights = ePosWeights + maxWeightsPerMask,
+         * fTan1Weights = fPosWeights + maxWeightsPerMask;
+    REAL * vTan2Weights = vTan1Weights + maxWeightsPerMask,
+         * eTan2Weights = eTan1Weights + maxWeightsPerMask,
+         * fTan2Weights = fTan1Weights + maxWeightsPerMask;
 
     Mask posMask( vPosWeights,  ePosWeights,  fPosWeights);
     Mask tan1Mask(vTan1Weights, eTan1Weights, fTan1Weights);
@@ -1033,7 +1476,7 @@ PrimvarRefiner::limit(T const & src, U & dstPos, U1 * dstTan1Ptr, U2 * dstTan2Pt
     //  this mask type was intended for another purpose.  Consider one for the limit:
     Vtr::internal::VertexInterface vHood(level, level);
 
-    for (int vert = 0; vert < level.getNumVertices(); ++vert) {
+    for (int vert = begin; vert < end; ++vert) {
         ConstIndexArray vEdges = level.getVertexEdges(vert);
 
         //  Incomplete vertices (present in sparse refinement) do not have their full
@@ -1134,9 +1577,25 @@ PrimvarRefiner::limit(T const & src, U & dstPos, U1 * dstTan1Ptr, U2 * dstTan2Pt
     }
 }
 
+template <typename REAL>
 template <Sdc::SchemeType SCHEME, class T, class U>
 inline void
-PrimvarRefiner::limitFVar(T const & src, U * dst, int channel) const {
+PrimvarRefinerReal<REAL>::limitFVar(T const & src, U * dst, int channel) const {
+
+    int numComponents = _refiner.getLevel(_refiner.GetMaxLevel()).getNumVertices();
+
+    LimitFVarRanges<T,U> ranges = { this, &PrimvarRefinerReal::limitFVar<SCHEME,T,U>,
+        &src, dst, channel };
+
+    internal::ForEachRange(numComponents, getRangeSize(numComponents),
+        _options.useMultipleThreads, &LimitFVarRanges<T,U>::Apply, &ranges);
+}
+
+template <typename REAL>
+template <Sdc::SchemeType SCHEME, class T, class U>
+inline void
+PrimvarRefinerReal<REAL>::limitFVar(T const & src, U * dst, int channel,
+        int begin, int end) const {
 
     Sdc::Scheme<SCHEME> scheme(_refiner._subdivOptions);
 
@@ -1145,13 +1604,13 @@ PrimvarRefiner::limitFVar(T const & src, U * dst, int channel) const {
 
     int maxWeightsPerMask = 1 + 2 * level.getMaxValence();
 
-    Vtr::internal::StackBuffer<float,33> weightBuffer(maxWeightsPerMask);
+    Vtr::internal::StackBuffer<REAL,33> weightBuffer(maxWeightsPerMask);
     Vtr::internal::StackBuffer<Index,16> vEdgeBuffer(level.getMaxValence());
 
     //  This is a bit obscure -- assign both parent and child as last level
     Vtr::internal::VertexInterface vHood(level, level);
 
-    for (int vert = 0; vert < level.getNumVertices(); ++vert) {
+    for (int vert = begin; vert < end; ++vert) {
 
         ConstIndexArray vEdges  = level.getVertexEdges(vert);
         ConstIndexArray vValues = fvarChannel.getVertexValues(vert);
@@ -1178,9 +1637,9 @@ PrimvarRefiner::limitFVar(T const & src, U * dst, int channel) const {
 
             //  Assign the mask weights to the common buffer and compute the mask:
             //
-            float * vWeights = weightBuffer,
-                  * eWeights = vWeights + 1,
-                  * fWeights = eWeights + vEdges.size();
+            REAL * vWeights = weightBuffer,
+                 * eWeights = vWeights + 1,
+                 * fWeights = eWeights + vEdges.size();
 
             Mask vMask(vWeights, eWeights, fWeights);
 
@@ -1233,15 +1692,27 @@ PrimvarRefiner::limitFVar(T const & src, U * dst, int channel) const {
                     Index vEndValues[2];
                     fvarChannel.getVertexCreaseEndValues(vert, i, vEndValues);
 
-                    dst[vValue].AddWithWeight(src[vEndValues[0]], 1.0f/6.0f);
-                    dst[vValue].AddWithWeight(src[vEndValues[1]], 1.0f/6.0f);
-                    dst[vValue].AddWithWeight(src[vValue], 2.0f/3.0f);
+                    dst[vValue].AddWithWeight(src[vEndValues[0]], REAL(1.0/6.0));
+                    dst[vValue].AddWithWeight(src[vEndValues[1]], REAL(1.0/6.0));
+                    dst[vValue].AddWithWeight(src[vValue], REAL(2.0/3.0));
                 }
             }
         }
     }
 }
 
+
+///
+///  \brief Applies refinement operations to generic primvar data with
+///         single precision interpolation weights.
+///
+class PrimvarRefiner : public PrimvarRefinerReal<float> {
+
+public:
+    PrimvarRefiner(TopologyRefiner const & refiner, Options options = Options())
+        : PrimvarRefinerReal<float>(refiner, options) { }
+};
+
 } // end namespace Far
 
 } // end namespace OPENSUBDIV_VERSION
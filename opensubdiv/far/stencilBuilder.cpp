@@ -24,7 +24,10 @@
 
 #include "../far/stencilBuilder.h"
 #include "../far/topologyRefiner.h"
- 
+
+#include <algorithm>
+#include <cstring>
+
 namespace OpenSubdiv {
 namespace OPENSUBDIV_VERSION {
 
@@ -37,25 +40,27 @@ namespace {
 #pragma warning disable 1572
 #endif
 
-    inline bool isWeightZero(float w) { return (w == 0.0f); }
+    template <typename REAL>
+    inline bool isWeightZero(REAL w) { return (w == (REAL)0.0); }
 
 #ifdef __INTEL_COMPILER
 #pragma warning (pop)
 #endif
 }
 
+template <typename REAL>
 struct Point1stDerivWeight {
-    float p;
-    float du;
-    float dv;
+    REAL p;
+    REAL du;
+    REAL dv;
 
     Point1stDerivWeight()
         : p(0.0f), du(0.0f), dv(0.0f)
     { }
-    Point1stDerivWeight(float w)
+    Point1stDerivWeight(REAL w)
         : p(w), du(w), dv(w)
     { }
-    Point1stDerivWeight(float w, float wDu, float wDv)
+    Point1stDerivWeight(REAL w, REAL wDu, REAL wDv)
         : p(w), du(wDu), dv(wDv)
     { }
 
@@ -74,22 +79,23 @@ struct Point1stDerivWeight {
     }
 };
 
+template <typename REAL>
 struct Point2ndDerivWeight {
-    float p;
-    float du;
-    float dv;
-    float duu;
-    float duv;
-    float dvv;
+    REAL p;
+    REAL du;
+    REAL dv;
+    REAL duu;
+    REAL duv;
+    REAL dvv;
 
     Point2ndDerivWeight()
         : p(0.0f), du(0.0f), dv(0.0f), duu(0.0f), duv(0.0f), dvv(0.0f)
     { }
-    Point2ndDerivWeight(float w)
+    Point2ndDerivWeight(REAL w)
         : p(w), du(w), dv(w), duu(w), duv(w), dvv(w)
     { }
-    Point2ndDerivWeight(float w, float wDu, float wDv,
-                        float wDuu, float wDuv, float wDvv)
+    Point2ndDerivWeight(REAL w, REAL wDu, REAL wDv,
+                        REAL wDuu, REAL wDuv, REAL wDvv)
         : p(w), du(wDu), dv(wDv), duu(wDuu), duv(wDuv), dvv(wDvv)
     { }
 
@@ -116,6 +122,7 @@ struct Point2ndDerivWeight {
 
 /// Stencil table constructor set.
 ///
+template <typename REAL>
 class WeightTable {
 public:
     WeightTable(int coarseVerts,
@@ -125,16 +132,11 @@ public:
         , _lastOffset(0)
         , _coarseVertCount(coarseVerts)
         , _compactWeights(compactWeights)
+        , _deferred(false)
     {
-        // These numbers were chosen by profiling production assets at uniform
-        // level 3.
-        size_t n = std::max(coarseVerts,
-                      std::min(int(5*1024*1024),
-                          coarseVerts*2));
-        _dests.reserve(n);
-        _sources.reserve(n);
-        _weights.reserve(n);
-        
+        // The element arrays are not reserved up front but grown as needed
+        // (see growElements()), their excess capacity being released when
+        // the stencils are transferred to a table.
         if (!genCtrlVertStencils)
             return;
 
@@ -198,18 +200,23 @@ public:
     public:
         Point1stDerivAccumulator(WeightTable* tbl) : _tbl(tbl)
         { }
-        void PushBack(Point1stDerivWeight weight) {
+        void Reserve(size_t n) {
+            _tbl->_weights.reserve(n);
+            _tbl->_duWeights.reserve(n);
+            _tbl->_dvWeights.reserve(n);
+        }
+        void PushBack(Point1stDerivWeight<REAL> weight) {
             _tbl->_weights.push_back(weight.p);
             _tbl->_duWeights.push_back(weight.du);
             _tbl->_dvWeights.push_back(weight.dv);
         }
-        void Add(size_t i, Point1stDerivWeight weight) {
+        void Add(size_t i, Point1stDerivWeight<REAL> weight) {
             _tbl->_weights[i] += weight.p;
             _tbl->_duWeights[i] += weight.du;
             _tbl->_dvWeights[i] += weight.dv;
         }
-        Point1stDerivWeight Get(size_t index) {
-            return Point1stDerivWeight(_tbl->_weights[index],
+        Point1stDerivWeight<REAL> Get(size_t index) {
+            return Point1stDerivWeight<REAL>(_tbl->_weights[index],
                                        _tbl->_duWeights[index],
                                        _tbl->_dvWeights[index]);
         }
@@ -223,7 +230,15 @@ public:
     public:
         Point2ndDerivAccumulator(WeightTable* tbl) : _tbl(tbl)
         { }
-        void PushBack(Point2ndDerivWeight weight) {
+        void Reserve(size_t n) {
+            _tbl->_weights.reserve(n);
+            _tbl->_duWeights.reserve(n);
+            _tbl->_dvWeights.reserve(n);
+            _tbl->_duuWeights.reserve(n);
+            _tbl->_duvWeights.reserve(n);
+            _tbl->_dvvWeights.reserve(n);
+        }
+        void PushBack(Point2ndDerivWeight<REAL> weight) {
             _tbl->_weights.push_back(weight.p);
             _tbl->_duWeights.push_back(weight.du);
             _tbl->_dvWeights.push_back(weight.dv);
@@ -231,7 +246,7 @@ public:
             _tbl->_duvWeights.push_back(weight.duv);
             _tbl->_dvvWeights.push_back(weight.dvv);
         }
-        void Add(size_t i, Point2ndDerivWeight weight) {
+        void Add(size_t i, Point2ndDerivWeight<REAL> weight) {
             _tbl->_weights[i] += weight.p;
             _tbl->_duWeights[i] += weight.du;
             _tbl->_dvWeights[i] += weight.dv;
@@ -239,8 +254,8 @@ public:
             _tbl->_duvWeights[i] += weight.duv;
             _tbl->_dvvWeights[i] += weight.dvv;
         }
-        Point2ndDerivWeight Get(size_t index) {
-            return Point2ndDerivWeight(_tbl->_weights[index],
+        Point2ndDerivWeight<REAL> Get(size_t index) {
+            return Point2ndDerivWeight<REAL>(_tbl->_weights[index],
                                        _tbl->_duWeights[index],
                                        _tbl->_dvWeights[index],
                                        _tbl->_duuWeights[index],
@@ -257,13 +272,16 @@ public:
     public:
         ScalarAccumulator(WeightTable* tbl) : _tbl(tbl)
         { }
-        void PushBack(float weight) {
+        void Reserve(size_t n) {
+            _tbl->_weights.reserve(n);
+        }
+        void PushBack(REAL weight) {
             _tbl->_weights.push_back(weight);
         }
-        void Add(size_t i, float w) {
+        void Add(size_t i, REAL w) {
             _tbl->_weights[i] += w;
         }
-        float Get(size_t index) {
+        REAL Get(size_t index) {
             return _tbl->_weights[index];
         }
     };
@@ -280,29 +298,237 @@ public:
     std::vector<int> const&
     GetSources() const { return _sources; }
 
-    std::vector<float> const&
+    std::vector<REAL> const&
     GetWeights() const { return _weights; }
 
-    std::vector<float> const&
+    std::vector<REAL> const&
     GetDuWeights() const { return _duWeights; }
 
-    std::vector<float> const&
+    std::vector<REAL> const&
     GetDvWeights() const { return _dvWeights; }
 
-    std::vector<float> const&
+    std::vector<REAL> const&
     GetDuuWeights() const { return _duuWeights; }
 
-    std::vector<float> const&
+    std::vector<REAL> const&
     GetDuvWeights() const { return _duvWeights; }
 
-    std::vector<float> const&
+    std::vector<REAL> const&
     GetDvvWeights() const { return _dvvWeights; }
 
     void SetCoarseVertCount(int numVerts) {
         _coarseVertCount = numVerts;
     }
+
+    // Transfers the stencils to the given vectors (derivative weights only
+    // if given) and releases the memory only used while building them.
+    void ReleaseStencils(std::vector<int> & offsets,
+                         std::vector<int> & sizes,
+                         std::vector<int> & sources,
+                         std::vector<REAL> & weights,
+                         std::vector<REAL> * duWeights = 0,
+                         std::vector<REAL> * dvWeights = 0,
+                         std::vector<REAL> * duuWeights = 0,
+                         std::vector<REAL> * duvWeights = 0,
+                         std::vector<REAL> * dvvWeights = 0)
+    {
+        std::vector<int>().swap(_dests);
+        std::vector<int>().swap(_deferredDests);
+        std::vector<int>().swap(_deferredSources);
+        std::vector<REAL>().swap(_deferredWeights);
+
+        offsets.swap(_indices);
+        sizes.swap(_sizes);
+        sources.swap(_sources);
+        weights.swap(_weights);
+        if (duWeights) duWeights->swap(_duWeights);
+        if (dvWeights) dvWeights->swap(_dvWeights);
+        if (duuWeights) duuWeights->swap(_duuWeights);
+        if (duvWeights) duvWeights->swap(_duvWeights);
+        if (dvvWeights) dvvWeights->swap(_dvvWeights);
+
+        _size = 0;
+        _lastOffset = 0;
+    }
+
+    // When deferred, scalar contributions are only recorded by Defer() and
+    // added to the table by ResolveDeferred().
+    bool IsDeferred() const { return _deferred; }
+
+    void SetDeferred(bool deferred) {
+        _deferred = deferred;
+    }
+
+    void Defer(int src, int dest, REAL weight) {
+        _deferredDests.push_back(dest);
+        _deferredSources.push_back(src);
+        _deferredWeights.push_back(weight);
+    }
+
+    // Adds all deferred contributions to the table, with the same result as
+    // the equivalent sequence of AddWithWeight() calls.
+    //
+    // Each destination stencil only depends on its own contributions and on
+    // the stencils of its sources, so consecutive destinations whose sources
+    // are all already in the table are grouped in chunks and factorized
+    // concurrently into local arrays before being appended in order.  Sources
+    // which are themselves deferred (e.g. the face-points contributing to the
+    // edge-points of the same level) split the work into successive passes.
+    void ResolveDeferred()
+    {
+        int numDeferred = (int)_deferredDests.size();
+        if (numDeferred == 0) {
+            return;
+        }
+
+        // Find the runs of contributions to the same destination
+        std::vector<int> runs;
+        runs.reserve(numDeferred / 4 + 1);
+        int maxDest = -1;
+        for (int i = 0; i < numDeferred; ++i) {
+            if (i == 0 || _deferredDests[i] != _deferredDests[i-1]) {
+                runs.push_back(i);
+                maxDest = std::max(maxDest, _deferredDests[i]);
+            }
+        }
+        int numRuns = (int)runs.size();
+        runs.push_back(numDeferred);
+
+        if (maxDest+1 > (int)_indices.size()) {
+            _indices.resize(maxDest+1);
+            _sizes.resize(maxDest+1);
+        }
+
+        // Split the runs into passes which do not reference their own
+        // destinations and resolve each of them in turn
+        std::vector<int> passOfDest(maxDest+1, -1);
+        int pass = 0,
+            firstRun = 0;
+        for (int r = 0; r < numRuns; ++r) {
+            bool dependent = false;
+            for (int i = runs[r]; i < runs[r+1] && !dependent; ++i) {
+                int src = _deferredSources[i];
+                dependent = (src <= maxDest) && (passOfDest[src] == pass);
+            }
+            if (dependent) {
+                resolvePass(&runs[0], firstRun, r);
+                firstRun = r;
+                ++pass;
+            }
+            passOfDest[_deferredDests[runs[r]]] = pass;
+        }
+        resolvePass(&runs[0], firstRun, numRuns);
+
+        _deferredDests.clear();
+        _deferredSources.clear();
+        _deferredWeights.clear();
+    }
+
 private:
 
+    // Stencils of a chunk of deferred destinations
+    struct DeferredChunk {
+        std::vector<int> sizes;
+        std::vector<int> sources;
+        std::vector<REAL> weights;
+    };
+
+    // Factorize the independent deferred runs [firstRun, lastRun)
+    // concurrently and append the resulting stencils to the table.
+    void resolvePass(int const * runs, int firstRun, int lastRun)
+    {
+        int const runsPerChunk = 512;
+        int numChunks = (lastRun - firstRun + runsPerChunk - 1) / runsPerChunk;
+
+        std::vector<DeferredChunk> chunks(numChunks);
+
+#ifdef OPENSUBDIV_HAS_OPENMP
+        #pragma omp parallel for schedule(dynamic) if (numChunks > 1)
+#endif
+        for (int c = 0; c < numChunks; ++c) {
+            int chunkFirst = firstRun + c * runsPerChunk,
+                chunkLast = std::min(lastRun, chunkFirst + runsPerChunk);
+            resolveChunk(runs, chunkFirst, chunkLast, chunks[c]);
+        }
+
+        // Make room for the new elements
+        size_t numOldElements = _sources.size(),
+               numNewElements = 0;
+        for (int c = 0; c < numChunks; ++c) {
+            numNewElements += chunks[c].sources.size();
+        }
+        growElements(numOldElements + numNewElements, GetScalarAccumulator());
+        _dests.resize(numOldElements + numNewElements);
+        _sources.resize(numOldElements + numNewElements);
+        _weights.resize(numOldElements + numNewElements);
+
+        // Append the chunks in order -- stencil offsets are assigned serially
+        // in case a destination appears in more than one run
+        int offset = (int)numOldElements;
+        for (int c = 0, r = firstRun; c < numChunks; ++c) {
+            DeferredChunk const & chunk = chunks[c];
+            int chunkSize = (int)chunk.sources.size();
+            if (chunkSize) {
+                std::memcpy(&_sources[offset], &chunk.sources[0],
+                            chunkSize * sizeof(int));
+                std::memcpy(&_weights[offset], &chunk.weights[0],
+                            chunkSize * sizeof(REAL));
+            }
+            for (int i = 0; i < (int)chunk.sizes.size(); ++i, ++r) {
+                int dst = _deferredDests[runs[r]];
+                _indices[dst] = offset;
+                _sizes[dst] = chunk.sizes[i];
+                std::fill(_dests.begin() + offset,
+                          _dests.begin() + offset + chunk.sizes[i], dst);
+                _lastOffset = offset;
+                offset += chunk.sizes[i];
+            }
+        }
+        _size = offset;
+    }
+
+    // Factorize the deferred runs [firstRun, lastRun) into a chunk, performing
+    // the same operations, in the same order, as AddWithWeight() and merge().
+    void resolveChunk(int const * runs, int firstRun, int lastRun,
+                      DeferredChunk & chunk) const
+    {
+        chunk.sizes.resize(lastRun - firstRun);
+        for (int r = firstRun; r < lastRun; ++r) {
+            int stencilStart = (int)chunk.sources.size();
+            for (int i = runs[r]; i < runs[r+1]; ++i) {
+                int src = _deferredSources[i];
+                REAL weight = _deferredWeights[i];
+                if (src < _coarseVertCount) {
+                    mergeIntoChunk(src, weight, REAL(1.0), stencilStart, chunk);
+                } else {
+                    int start = _indices[src];
+                    for (int j = start; j < start+_sizes[src]; ++j) {
+                        assert(_sources[j] < _coarseVertCount);
+                        mergeIntoChunk(_sources[j], _weights[j], weight,
+                                       stencilStart, chunk);
+                    }
+                }
+            }
+            chunk.sizes[r - firstRun] =
+                (int)chunk.sources.size() - stencilStart;
+        }
+    }
+
+    void mergeIntoChunk(int src, REAL weight, REAL weightFactor,
+                        int stencilStart, DeferredChunk & chunk) const
+    {
+        if (_compactWeights) {
+            for (int i = stencilStart; i < (int)chunk.sources.size(); ++i) {
+                if (chunk.sources[i] == src) {
+                    chunk.weights[i] += weight*weightFactor;
+                    return;
+                }
+            }
+        }
+        chunk.sources.push_back(src);
+        chunk.weights.push_back(weight*weightFactor);
+    }
+
     // Merge a vertex weight into the stencil table, if there is an existing
     // weight for a given source vertex it will be combined.
     //
@@ -340,10 +566,32 @@ private:
         add(src, dst, weight*weightFactor, weights);
     }
 
+    // Ensure the element arrays can hold numElements, growing them by half
+    // their size (and at least a chunk of 64K elements) rather than letting
+    // them double -- which would leave up to as much unused capacity as
+    // stencil data until the table is complete.
+    template <class WACCUM>
+    void growElements(size_t numElements, WACCUM weights)
+    {
+        if (numElements <= _sources.capacity()) {
+            return;
+        }
+        size_t const chunkSize = 64*1024;
+
+        size_t n = _sources.size();
+        n = std::max(numElements, n + std::max(n/2, chunkSize));
+
+        _dests.reserve(n);
+        _sources.reserve(n);
+        weights.Reserve(n);
+    }
+
     // Add a new vertex weight to the stencil table.
     template <class W, class WACCUM>
     void add(int src, int dst, W weight, WACCUM weights)
     {
+        growElements(_sources.size() + 1, weights);
+
         // The _dests array has num(weights) elements mapping each individual
         // element back to a specific stencil. The array is constructed in such
         // a way that the current stencil being built is always at the end of
@@ -387,12 +635,12 @@ private:
 
     // The actual stencil data.
     std::vector<int> _sources;
-    std::vector<float> _weights;
-    std::vector<float> _duWeights;
-    std::vector<float> _dvWeights;
-    std::vector<float> _duuWeights;
-    std::vector<float> _duvWeights;
-    std::vector<float> _dvvWeights;
+    std::vector<REAL> _weights;
+    std::vector<REAL> _duWeights;
+    std::vector<REAL> _dvWeights;
+    std::vector<REAL> _duuWeights;
+    std::vector<REAL> _duvWeights;
+    std::vector<REAL> _dvvWeights;
 
     // Index data used to recover stencil-to-vertex mapping.
     std::vector<int> _indices;
@@ -403,31 +651,41 @@ private:
     int _lastOffset;
     int _coarseVertCount;
     bool _compactWeights;
+
+    // Contributions recorded while deferred.
+    bool _deferred;
+    std::vector<int> _deferredDests;
+    std::vector<int> _deferredSources;
+    std::vector<REAL> _deferredWeights;
 };
 
-StencilBuilder::StencilBuilder(int coarseVertCount,
-                               bool genCtrlVertStencils,
-                               bool compactWeights)
-        : _weightTable(new WeightTable(coarseVertCount,
-                                   genCtrlVertStencils,
-                                   compactWeights))
+template <typename REAL>
+StencilBuilder<REAL>::StencilBuilder(int coarseVertCount,
+                                     bool genCtrlVertStencils,
+                                     bool compactWeights)
+        : _weightTable(new WeightTable<REAL>(coarseVertCount,
+                                             genCtrlVertStencils,
+                                             compactWeights))
 {
 }
 
-StencilBuilder::~StencilBuilder()
+template <typename REAL>
+StencilBuilder<REAL>::~StencilBuilder()
 {
     delete _weightTable;
 }
 
+template <typename REAL>
 size_t
-StencilBuilder::GetNumVerticesTotal() const
+StencilBuilder<REAL>::GetNumVerticesTotal() const
 {
     return _weightTable->GetWeights().size();
 }
 
 
-int 
-StencilBuilder::GetNumVertsInStencil(size_t stencilIndex) const
+template <typename REAL>
+int
+StencilBuilder<REAL>::GetNumVertsInStencil(size_t stencilIndex) const
 {
     if (stencilIndex > _weightTable->GetSizes().size() - 1)
         return 0;
@@ -435,70 +693,126 @@ StencilBuilder::GetNumVertsInStencil(size_t stencilIndex) const
     return (int)_weightTable->GetSizes()[stencilIndex];
 }
 
+template <typename REAL>
 void
-StencilBuilder::SetCoarseVertCount(int numVerts)
+StencilBuilder<REAL>::SetCoarseVertCount(int numVerts)
 {
     _weightTable->SetCoarseVertCount(numVerts);
 }
 
+template <typename REAL>
+void
+StencilBuilder<REAL>::SetDeferred(bool deferred)
+{
+    _weightTable->SetDeferred(deferred);
+}
+
+template <typename REAL>
+void
+StencilBuilder<REAL>::ResolveDeferred()
+{
+    _weightTable->ResolveDeferred();
+}
+
+template <typename REAL>
+void
+StencilBuilder<REAL>::ReleaseStencils(std::vector<int> & offsets,
+                                      std::vector<int> & sizes,
+                                      std::vector<int> & sources,
+                                      std::vector<REAL> & weights)
+{
+    _weightTable->ReleaseStencils(offsets, sizes, sources, weights);
+}
+
+template <typename REAL>
+void
+StencilBuilder<REAL>::ReleaseStencils(std::vector<int> & offsets,
+                                      std::vector<int> & sizes,
+                                      std::vector<int> & sources,
+                                      std::vector<REAL> & weights,
+                                      std::vector<REAL> & duWeights,
+                                      std::vector<REAL> & dvWeights,
+                                      std::vector<REAL> & duuWeights,
+                                      std::vector<REAL> & duvWeights,
+                                      std::vector<REAL> & dvvWeights)
+{
+    _weightTable->ReleaseStencils(offsets, sizes, sources, weights,
+        &duWeights, &dvWeights, &duuWeights, &duvWeights, &dvvWeights);
+}
+
+template <typename REAL>
 std::vector<int> const&
-StencilBuilder::GetStencilOffsets() const {
+StencilBuilder<REAL>::GetStencilOffsets() const {
     return _weightTable->GetOffsets();
 }
 
-std::vector<int> const& 
-StencilBuilder::GetStencilSizes() const {
+template <typename REAL>
+std::vector<int> const&
+StencilBuilder<REAL>::GetStencilSizes() const {
     return _weightTable->GetSizes();
 }
 
+template <typename REAL>
 std::vector<int> const&
-StencilBuilder::GetStencilSources() const {
+StencilBuilder<REAL>::GetStencilSources() const {
     return _weightTable->GetSources();
 }
 
-std::vector<float> const&
-StencilBuilder::GetStencilWeights() const {
+template <typename REAL>
+std::vector<REAL> const&
+StencilBuilder<REAL>::GetStencilWeights() const {
     return _weightTable->GetWeights();
 }
 
-std::vector<float> const&
-StencilBuilder::GetStencilDuWeights() const {
+template <typename REAL>
+std::vector<REAL> const&
+StencilBuilder<REAL>::GetStencilDuWeights() const {
     return _weightTable->GetDuWeights();
 }
 
-std::vector<float> const&
-StencilBuilder::GetStencilDvWeights() const {
+template <typename REAL>
+std::vector<REAL> const&
+StencilBuilder<REAL>::GetStencilDvWeights() const {
     return _weightTable->GetDvWeights();
 }
 
-std::vector<float> const&
-StencilBuilder::GetStencilDuuWeights() const {
+template <typename REAL>
+std::vector<REAL> const&
+StencilBuilder<REAL>::GetStencilDuuWeights() const {
     return _weightTable->GetDuuWeights();
 }
 
-std::vector<float> const&
-StencilBuilder::GetStencilDuvWeights() const {
+template <typename REAL>
+std::vector<REAL> const&
+StencilBuilder<REAL>::GetStencilDuvWeights() const {
     return _weightTable->GetDuvWeights();
 }
 
-std::vector<float> const&
-StencilBuilder::GetStencilDvvWeights() const {
+template <typename REAL>
+std::vector<REAL> const&
+StencilBuilder<REAL>::GetStencilDvvWeights() const {
     return _weightTable->GetDvvWeights();
 }
 
+template <typename REAL>
 void
-StencilBuilder::Index::AddWithWeight(Index const & src, float weight)
+StencilBuilder<REAL>::Index::AddWithWeight(Index const & src, REAL weight)
 {
     // Ignore no-op weights.
     if (isWeightZero(weight)) {
         return;
     }
+    if (_owner->_weightTable->IsDeferred()) {
+        _owner->_weightTable->Defer(src._index, _index, weight);
+        return;
+    }
     _owner->_weightTable->AddWithWeight(src._index, _index, weight,
                                 _owner->_weightTable->GetScalarAccumulator());
 }
 
+template <typename REAL>
 void
-StencilBuilder::Index::AddWithWeight(Stencil const& src, float weight)
+StencilBuilder<REAL>::Index::AddWithWeight(StencilReal<REAL> const& src, REAL weight)
 {
     if (isWeightZero(weight)) {
         return;
@@ -506,25 +820,26 @@ StencilBuilder::Index::AddWithWeight(Stencil const& src, float weight)
 
     int srcSize = *src.GetSizePtr();
     Vtr::Index const * srcIndices = src.GetVertexIndices();
-    float const * srcWeights = src.GetWeights();
+    REAL const * srcWeights = src.GetWeights();
 
     for (int i = 0; i < srcSize; ++i) {
-        float w = srcWeights[i];
+        REAL w = srcWeights[i];
         if (isWeightZero(w)) {
             continue;
         }
 
         Vtr::Index srcIndex = srcIndices[i];
 
-        float wgt = weight * w;
+        REAL wgt = weight * w;
         _owner->_weightTable->AddWithWeight(srcIndex, _index, wgt,
                             _owner->_weightTable->GetScalarAccumulator());
     }  
 }
 
+template <typename REAL>
 void
-StencilBuilder::Index::AddWithWeight(Stencil const& src,
-    float weight, float du, float dv)
+StencilBuilder<REAL>::Index::AddWithWeight(StencilReal<REAL> const& src,
+    REAL weight, REAL du, REAL dv)
 {
     if (isWeightZero(weight) && isWeightZero(du) && isWeightZero(dv)) {
         return;
@@ -532,25 +847,26 @@ StencilBuilder::Index::AddWithWeight(Stencil const& src,
 
     int srcSize = *src.GetSizePtr();
     Vtr::Index const * srcIndices = src.GetVertexIndices();
-    float const * srcWeights = src.GetWeights();
+    REAL const * srcWeights = src.GetWeights();
 
     for (int i = 0; i < srcSize; ++i) {
-        float w = srcWeights[i];
+        REAL w = srcWeights[i];
         if (isWeightZero(w)) {
             continue;
         }
 
         Vtr::Index srcIndex = srcIndices[i];
 
-        Point1stDerivWeight wgt = Point1stDerivWeight(weight, du, dv) * w;
+        Point1stDerivWeight<REAL> wgt = Point1stDerivWeight<REAL>(weight, du, dv) * w;
         _owner->_weightTable->AddWithWeight(srcIndex, _index, wgt,
                            _owner->_weightTable->GetPoint1stDerivAccumulator());
     }
 }
 
+template <typename REAL>
 void
-StencilBuilder::Index::AddWithWeight(Stencil const& src,
-    float weight, float du, float dv, float duu, float duv, float dvv)
+StencilBuilder<REAL>::Index::AddWithWeight(StencilReal<REAL> const& src,
+    REAL weight, REAL du, REAL dv, REAL duu, REAL duv, REAL dvv)
 {
     if (isWeightZero(weight) && isWeightZero(du) && isWeightZero(dv) &&
         isWeightZero(duu) && isWeightZero(duv) && isWeightZero(dvv)) {
@@ -559,22 +875,28 @@ StencilBuilder::Index::AddWithWeight(Stencil const& src,
 
     int srcSize = *src.GetSizePtr();
     Vtr::Index const * srcIndices = src.GetVertexIndices();
-    float const * srcWeights = src.GetWeights();
+    REAL const * srcWeights = src.GetWeights();
 
     for (int i = 0; i < srcSize; ++i) {
-        float w = srcWeights[i];
+        REAL w = srcWeights[i];
         if (isWeightZero(w)) {
             continue;
         }
 
         Vtr::Index srcIndex = srcIndices[i];
 
-        Point2ndDerivWeight wgt = Point2ndDerivWeight(weight, du, dv, duu, duv, dvv) * w;
+        Point2ndDerivWeight<REAL> wgt = Point2ndDerivWeight<REAL>(weight, du, dv, duu, duv, dvv) * w;
         _owner->_weightTable->AddWithWeight(srcIndex, _index, wgt,
                            _owner->_weightTable->GetPoint2ndDerivAccumulator());
     }
 }
 
+//
+//  Explicit instantiation for float and double:
+//
+template class StencilBuilder<float>;
+template class StencilBuilder<double>;
+
 } // end namespace internal
 } // end namespace Far
 } // end namespace OPENSUBDIV_VERSION
@@ -0,0 +1,165 @@
+//
+//   Copyright 2019 Pixar
+//
+//   Licensed under the Apache License, Version 2.0 (the "Apache License")
+//   with the following modification; you may not use this file except in
+//   compliance with the Apache License and the following modification to it:
+//   Section 6. Trademarks. is deleted and replaced with:
+//
+//   6. Trademarks. This License does not grant permission to use the trade
+//      names, trademarks, service marks, or product names of the Licensor
+//      and its affiliates, except as required to comply with Section 4(c) of
+//      the License and to reproduce the content of the NOTICE file.
+//
+//   You may obtain a copy of the Apache License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the Apache License with the above modification is
+//   distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//   KIND, either express or implied. See the Apache License for the specific
+//   language governing permissions and limitations under the Apache License.
+//
+
+
+#include "../far/stencilDependencyTable.h"
+#include "../far/error.h"
+
+#include <algorithm>
+
+namespace OpenSubdiv {
+namespace OPENSUBDIV_VERSION {
+
+namespace Far {
+
+template <typename REAL>
+StencilDependencyTable const *
+StencilDependencyTable::create(StencilTableReal<REAL> const & table) {
+
+    int numControlVerts = table.GetNumControlVertices(),
+        numStencils = table.GetNumStencils();
+
+    std::vector<int> const & sizes = table.GetSizes();
+    std::vector<Index> const & indices = table.GetControlIndices();
+
+    StencilDependencyTable * result = new StencilDependencyTable;
+    result->_numStencils = numStencils;
+
+    //
+    //  Count the stencils gathering each control vertex -- a vertex listed
+    //  more than once by a stencil is counted each time and the duplicates
+    //  removed afterwards:
+    //
+    std::vector<Index> & offsets = result->_offsets;
+    offsets.assign(numControlVerts + 1, 0);
+
+    for (int i=0, ofs=0; i<numStencils; ++i) {
+        if (! table.GetOffsets().empty()) {
+            ofs = table.GetOffsets()[i];
+        }
+        for (int j=0; j<sizes[i]; ++j) {
+            Index v = indices[ofs + j];
+            if ((v < 0) || (v >= numControlVerts)) {
+                Error(FAR_RUNTIME_ERROR, "Failure in StencilDependencyTable::Create() -- "
+                    "stencil %d gathers vertex %d which is not a control vertex.", i, v);
+                delete result;
+                return 0;
+            }
+            ++offsets[v + 1];
+        }
+        ofs += sizes[i];
+    }
+    for (int v=0; v<numControlVerts; ++v) {
+        offsets[v + 1] += offsets[v];
+    }
+
+    //  Fill the stencils of each control vertex in increasing order:
+    std::vector<Index> & stencils = result->_stencils;
+    stencils.resize(offsets[numControlVerts]);
+
+    std::vector<Index> fill(offsets.begin(), offsets.end() - 1);
+    for (int i=0, ofs=0; i<numStencils; ++i) {
+        if (! table.GetOffsets().empty()) {
+            ofs = table.GetOffsets()[i];
+        }
+        for (int j=0; j<sizes[i]; ++j) {
+            Index v = indices[ofs + j];
+            if ((fill[v] == offsets[v]) || (stencils[fill[v] - 1] != i)) {
+                stencils[fill[v]++] = i;
+            }
+        }
+        ofs += sizes[i];
+    }
+
+    //  Compact the lists shortened by duplicates:
+    Index dst = 0;
+    for (int v=0; v<numControlVerts; ++v) {
+        Index begin = offsets[v];
+        offsets[v] = dst;
+        for (Index k=begin; k<fill[v]; ++k) {
+            stencils[dst++] = stencils[k];
+        }
+    }
+    offsets[numControlVerts] = dst;
+    stencils.resize(dst);
+
+    return result;
+}
+
+StencilDependencyTable const *
+StencilDependencyTable::Create(StencilTableReal<float> const & table) {
+    return create(table);
+}
+
+StencilDependencyTable const *
+StencilDependencyTable::Create(StencilTableReal<double> const & table) {
+    return create(table);
+}
+
+int
+StencilDependencyTable::GetAffectedStencils(Index const * controlVertices,
+    int numControlVertices, std::vector<Index> & stencils) const {
+
+    stencils.clear();
+
+    int numDependents = 0;
+    for (int i=0; i<numControlVertices; ++i) {
+        numDependents += GetDependentStencils(controlVertices[i]).size();
+    }
+
+    if ((numControlVertices > 1) && (numDependents * 32 > _numStencils)) {
+        //  Many stencils are affected : flag them, which is cheaper than
+        //  sorting the lists
+        std::vector<unsigned char> affected(_numStencils, 0);
+        for (int i=0; i<numControlVertices; ++i) {
+            ConstIndexArray dependents = GetDependentStencils(controlVertices[i]);
+            for (int j=0; j<dependents.size(); ++j) {
+                affected[dependents[j]] = 1;
+            }
+        }
+        for (int i=0; i<_numStencils; ++i) {
+            if (affected[i]) {
+                stencils.push_back(i);
+            }
+        }
+    } else {
+        stencils.reserve(numDependents);
+        for (int i=0; i<numControlVertices; ++i) {
+            ConstIndexArray dependents = GetDependentStencils(controlVertices[i]);
+            stencils.insert(stencils.end(), dependents.begin(), dependents.end());
+        }
+        //  The list of a single vertex is already sorted and unique:
+        if (numControlVertices > 1) {
+            std::sort(stencils.begin(), stencils.end());
+            stencils.erase(std::unique(stencils.begin(), stencils.end()),
+                           stencils.end());
+        }
+    }
+    return (int)stencils.size();
+}
+
+} // end namespace Far
+
+} // end namespace OPENSUBDIV_VERSION
+} // end namespace OpenSubdiv
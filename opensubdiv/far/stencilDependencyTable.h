@@ -0,0 +1,120 @@
+//
+//   Copyright 2019 Pixar
+//
+//   Licensed under the Apache License, Version 2.0 (the "Apache License")
+//   with the following modification; you may not use this file except in
+//   compliance with the Apache License and the following modification to it:
+//   Section 6. Trademarks. is deleted and replaced with:
+//
+//   6. Trademarks. This License does not grant permission to use the trade
+//      names, trademarks, service marks, or product names of the Licensor
+//      and its affiliates, except as required to comply with Section 4(c) of
+//      the License and to reproduce the content of the NOTICE file.
+//
+//   You may obtain a copy of the Apache License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the Apache License with the above modification is
+//   distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//   KIND, either express or implied. See the Apache License for the specific
+//   language governing permissions and limitations under the Apache License.
+//
+
+
+#ifndef OPENSUBDIV3_FAR_STENCIL_DEPENDENCY_TABLE_H
+#define OPENSUBDIV3_FAR_STENCIL_DEPENDENCY_TABLE_H
+
+#include "../version.h"
+
+#include "../far/types.h"
+#include "../far/stencilTable.h"
+
+#include <cassert>
+#include <vector>
+
+namespace OpenSubdiv {
+namespace OPENSUBDIV_VERSION {
+
+namespace Far {
+
+/// \brief Table of the stencils gathering each control vertex
+///
+/// A StencilDependencyTable transposes a StencilTable : it lists, for each
+/// control vertex, the stencils whose weights apply to it. When only a few
+/// control vertices are modified (e.g. interactive editing), the stencils
+/// affected can be gathered and re-evaluated alone, see
+/// Osd::CpuEvaluator::EvalModifiedStencils().
+///
+/// Limit stencil tables are supported as well, their derivative weights
+/// applying to the same control vertices.
+///
+class StencilDependencyTable {
+
+public:
+
+    /// \brief Returns the dependencies of the stencils of a table, or NULL
+    ///        if the stencils are not factorized (i.e. they gather vertices
+    ///        other than the control vertices)
+    ///
+    /// @param table  The stencil table
+    ///
+    static StencilDependencyTable const * Create(
+        StencilTableReal<float> const & table);
+
+    /// \brief Double precision variant of the above
+    static StencilDependencyTable const * Create(
+        StencilTableReal<double> const & table);
+
+    /// \brief Returns the number of control vertices of the table
+    int GetNumControlVertices() const { return (int)_offsets.size() - 1; }
+
+    /// \brief Returns the number of stencils of the table
+    int GetNumStencils() const { return _numStencils; }
+
+    /// \brief Returns the stencils gathering a control vertex, in increasing
+    ///        order
+    ConstIndexArray GetDependentStencils(Index controlVertex) const {
+        assert(controlVertex>=0 && controlVertex<GetNumControlVertices());
+        return ConstIndexArray(_stencils.empty() ? 0 :
+            &_stencils[0] + _offsets[controlVertex],
+            _offsets[controlVertex+1] - _offsets[controlVertex]);
+    }
+
+    /// \brief Gathers the stencils affected by modified control vertices
+    ///
+    /// @param controlVertices     Indices of the modified control vertices
+    ///
+    /// @param numControlVertices  Number of modified control vertices
+    ///
+    /// @param stencils            Destination of the indices of the affected
+    ///                            stencils, sorted in increasing order and
+    ///                            without duplicates
+    ///
+    /// \return The number of affected stencils
+    ///
+    int GetAffectedStencils(Index const * controlVertices, int numControlVertices,
+                            std::vector<Index> & stencils) const;
+
+protected:
+    StencilDependencyTable() : _numStencils(0) { }
+
+    template <typename REAL>
+    static StencilDependencyTable const * create(
+        StencilTableReal<REAL> const & table);
+
+    int _numStencils;
+
+    std::vector<Index> _offsets,   // offset of the stencils of each control vertex
+                       _stencils;  // stencils gathering each control vertex
+};
+
+} // end namespace Far
+
+} // end namespace OPENSUBDIV_VERSION
+using namespace OPENSUBDIV_VERSION;
+
+} // end namespace OpenSubdiv
+
+#endif /* OPENSUBDIV3_FAR_STENCIL_DEPENDENCY_TABLE_H */
@@ -25,6 +25,8 @@
 #include "../version.h"
 #include "../far/stencilTable.h"
 
+#include <algorithm>
+
 namespace OpenSubdiv {
 namespace OPENSUBDIV_VERSION {
 
@@ -32,6 +34,7 @@ namespace Far {
 
 
 namespace {
+    template <typename REAL>
     void
     copyStencilData(int numControlVerts,
                     bool includeCoarseVerts,
@@ -42,18 +45,18 @@ namespace {
                     std::vector<int> *        _sizes,
                     std::vector<int> const*    sources,
                     std::vector<int> *        _sources,
-                    std::vector<float> const*  weights,
-                    std::vector<float> *      _weights,
-                    std::vector<float> const*  duWeights=NULL,
-                    std::vector<float> *      _duWeights=NULL,
-                    std::vector<float> const*  dvWeights=NULL,
-                    std::vector<float> *      _dvWeights=NULL,
-                    std::vector<float> const*  duuWeights=NULL,
-                    std::vector<float> *      _duuWeights=NULL,
-                    std::vector<float> const*  duvWeights=NULL,
-                    std::vector<float> *      _duvWeights=NULL,
-                    std::vector<float> const*  dvvWeights=NULL,
-                    std::vector<float> *      _dvvWeights=NULL) {
+                    std::vector<REAL> const*   weights,
+                    std::vector<REAL> *       _weights,
+                    std::vector<REAL> const*   duWeights=NULL,
+                    std::vector<REAL> *       _duWeights=NULL,
+                    std::vector<REAL> const*   dvWeights=NULL,
+                    std::vector<REAL> *       _dvWeights=NULL,
+                    std::vector<REAL> const*   duuWeights=NULL,
+                    std::vector<REAL> *       _duuWeights=NULL,
+                    std::vector<REAL> const*   duvWeights=NULL,
+                    std::vector<REAL> *       _duvWeights=NULL,
+                    std::vector<REAL> const*   dvvWeights=NULL,
+                    std::vector<REAL> *       _dvvWeights=NULL) {
         size_t start = includeCoarseVerts ? 0 : firstOffset;
 
         _offsets->resize(offsets->size());
@@ -94,28 +97,28 @@ namespace {
             std::memcpy(&(*_sources)[curOffset],
                         &(*sources)[off], sz*sizeof(int));
             std::memcpy(&(*_weights)[curOffset],
-                        &(*weights)[off], sz*sizeof(float));
+                        &(*weights)[off], sz*sizeof(REAL));
 
             if (_duWeights && !_duWeights->empty()) {
                 std::memcpy(&(*_duWeights)[curOffset],
-                            &(*duWeights)[off], sz*sizeof(float));
+                            &(*duWeights)[off], sz*sizeof(REAL));
             }
             if (_dvWeights && !_dvWeights->empty()) {
                 std::memcpy(&(*_dvWeights)[curOffset],
-                        &(*dvWeights)[off], sz*sizeof(float));
+                        &(*dvWeights)[off], sz*sizeof(REAL));
             }
 
             if (_duuWeights && !_duuWeights->empty()) {
                 std::memcpy(&(*_duuWeights)[curOffset],
-                        &(*duuWeights)[off], sz*sizeof(float));
+                        &(*duuWeights)[off], sz*sizeof(REAL));
             }
             if (_duvWeights && !_duvWeights->empty()) {
                 std::memcpy(&(*_duvWeights)[curOffset],
-                        &(*duvWeights)[off], sz*sizeof(float));
+                        &(*duvWeights)[off], sz*sizeof(REAL));
             }
             if (_dvvWeights && !_dvvWeights->empty()) {
                 std::memcpy(&(*_dvvWeights)[curOffset],
-                        &(*dvvWeights)[off], sz*sizeof(float));
+                        &(*dvvWeights)[off], sz*sizeof(REAL));
             }
 
             curOffset += sz;
@@ -139,15 +142,104 @@ namespace {
         if (_dvvWeights && !_dvvWeights->empty())
             _dvvWeights->resize(weightCount);
     }
+
+    //
+    //  Selects the stencils retained from those accumulated by a factory --
+    //  the same as copyStencilData() above -- returning their offsets and
+    //  sizes and the total number of weights.  The data can be compacted in
+    //  place if the stencils are stored in order:
+    //
+    int
+    selectStencils(int numControlVerts,
+                   bool includeCoarseVerts,
+                   size_t firstOffset,
+                   std::vector<int> const & offsets,
+                   std::vector<int> const & sizes,
+                   std::vector<int> &       selectedOffsets,
+                   std::vector<int> &       selectedSizes,
+                   bool &                   inOrder) {
+
+        size_t start = includeCoarseVerts ? 0 : firstOffset;
+
+        selectedOffsets.clear();
+        selectedSizes.clear();
+        selectedOffsets.reserve(offsets.size() - std::min(start, offsets.size()));
+        selectedSizes.reserve(offsets.size() - std::min(start, offsets.size()));
+
+        int weightCount = 0,
+            nextOffset = 0;
+
+        inOrder = true;
+
+        for (size_t i=start; i<offsets.size(); i++) {
+            if (includeCoarseVerts && (int)i == numControlVerts)
+                i = std::max(i, firstOffset);
+
+            selectedOffsets.push_back(offsets[i]);
+            selectedSizes.push_back(sizes[i]);
+
+            if (sizes[i]) {
+                inOrder &= (offsets[i] >= nextOffset);
+                nextOffset = offsets[i] + sizes[i];
+            }
+            weightCount += sizes[i];
+        }
+        return weightCount;
+    }
+
+    //
+    //  Gathers the data of the selected stencils at the front of the vector,
+    //  moving it in place when in order or through a compacted copy otherwise,
+    //  and releases the excess capacity.  Vectors are processed one at a time,
+    //  so that at most one of them is duplicated at any time:
+    //
+    template <typename T>
+    void
+    compactStencilData(std::vector<int> const & selectedOffsets,
+                       std::vector<int> const & selectedSizes,
+                       int weightCount, bool inOrder,
+                       std::vector<T> & data) {
+
+        if (data.empty()) return;
+
+        if (inOrder) {
+            int curOffset = 0;
+            for (size_t i=0; i<selectedSizes.size(); ++i) {
+                int sz = selectedSizes[i];
+                if (sz && (selectedOffsets[i] != curOffset)) {
+                    std::memmove(&data[curOffset], &data[selectedOffsets[i]],
+                                 sz*sizeof(T));
+                }
+                curOffset += sz;
+            }
+            data.resize(weightCount);
+            if (data.capacity() > data.size()) {
+                std::vector<T>(data).swap(data);
+            }
+        } else {
+            std::vector<T> compacted(weightCount);
+            int curOffset = 0;
+            for (size_t i=0; i<selectedSizes.size(); ++i) {
+                int sz = selectedSizes[i];
+                if (sz) {
+                    std::memcpy(&compacted[curOffset], &data[selectedOffsets[i]],
+                                sz*sizeof(T));
+                }
+                curOffset += sz;
+            }
+            data.swap(compacted);
+        }
+    }
 };
 
-StencilTable::StencilTable(int numControlVerts,
-                           std::vector<int> const& offsets,
-                           std::vector<int> const& sizes,
-                           std::vector<int> const& sources,
-                           std::vector<float> const& weights,
-                           bool includeCoarseVerts,
-                           size_t firstOffset)
+template <typename REAL>
+StencilTableReal<REAL>::StencilTableReal(int numControlVerts,
+                                         std::vector<int> const& offsets,
+                                         std::vector<int> const& sizes,
+                                         std::vector<int> const& sources,
+                                         std::vector<REAL> const& weights,
+                                         bool includeCoarseVerts,
+                                         size_t firstOffset)
     : _numControlVertices(numControlVerts) {
     copyStencilData(numControlVerts,
                     includeCoarseVerts,
@@ -158,8 +250,37 @@ StencilTable::StencilTable(int numControlVerts,
                     &weights, &_weights);
 }
 
+template <typename REAL>
+void
+StencilTableReal<REAL>::assignStencils(std::vector<int> & offsets,
+                                       std::vector<int> & sizes,
+                                       std::vector<int> & sources,
+                                       std::vector<REAL> & weights,
+                                       bool includeCoarseVerts,
+                                       size_t firstOffset) {
+
+    std::vector<int> selectedOffsets;
+    bool inOrder = false;
+
+    int weightCount = selectStencils(_numControlVertices,
+        includeCoarseVerts, firstOffset, offsets, sizes,
+        selectedOffsets, _sizes, inOrder);
+
+    std::vector<int>().swap(offsets);
+    std::vector<int>().swap(sizes);
+
+    compactStencilData(selectedOffsets, _sizes, weightCount, inOrder, sources);
+    compactStencilData(selectedOffsets, _sizes, weightCount, inOrder, weights);
+
+    _indices.swap(sources);
+    _weights.swap(weights);
+
+    generateOffsets();
+}
+
+template <typename REAL>
 void
-StencilTable::Clear() {
+StencilTableReal<REAL>::Clear() {
     _numControlVertices=0;
     _sizes.clear();
     _offsets.clear();
@@ -167,26 +288,28 @@ StencilTable::Clear() {
     _weights.clear();
 }
 
-LimitStencilTable::LimitStencilTable(int numControlVerts,
+template <typename REAL>
+LimitStencilTableReal<REAL>::LimitStencilTableReal(
+                                     int numControlVerts,
                                      std::vector<int> const& offsets,
                                      std::vector<int> const& sizes,
                                      std::vector<int> const& sources,
-                                     std::vector<float> const& weights,
-                                     std::vector<float> const& duWeights,
-                                     std::vector<float> const& dvWeights,
-                                     std::vector<float> const& duuWeights,
-                                     std::vector<float> const& duvWeights,
-                                     std::vector<float> const& dvvWeights,
+                                     std::vector<REAL> const& weights,
+                                     std::vector<REAL> const& duWeights,
+                                     std::vector<REAL> const& dvWeights,
+                                     std::vector<REAL> const& duuWeights,
+                                     std::vector<REAL> const& duvWeights,
+                                     std::vector<REAL> const& dvvWeights,
                                      bool includeCoarseVerts,
                                      size_t firstOffset)
-    : StencilTable(numControlVerts) {
+    : StencilTableReal<REAL>(numControlVerts) {
     copyStencilData(numControlVerts,
                     includeCoarseVerts,
                     firstOffset,
-                    &offsets, &_offsets,
-                    &sizes, &_sizes,
-                    &sources, &_indices,
-                    &weights, &_weights,
+                    &offsets, &this->_offsets,
+                    &sizes, &this->_sizes,
+                    &sources, &this->_indices,
+                    &weights, &this->_weights,
                     &duWeights, &_duWeights,
                     &dvWeights, &_dvWeights,
                     &duuWeights, &_duuWeights,
@@ -194,9 +317,55 @@ LimitStencilTable::LimitStencilTable(int numControlVerts,
                     &dvvWeights, &_dvvWeights);
 }
 
+template <typename REAL>
+void
+LimitStencilTableReal<REAL>::assignStencils(std::vector<int> & offsets,
+                                            std::vector<int> & sizes,
+                                            std::vector<int> & sources,
+                                            std::vector<REAL> & weights,
+                                            std::vector<REAL> & duWeights,
+                                            std::vector<REAL> & dvWeights,
+                                            std::vector<REAL> & duuWeights,
+                                            std::vector<REAL> & duvWeights,
+                                            std::vector<REAL> & dvvWeights,
+                                            bool includeCoarseVerts,
+                                            size_t firstOffset) {
+
+    std::vector<int> selectedOffsets;
+    bool inOrder = false;
+
+    int weightCount = selectStencils(this->_numControlVertices,
+        includeCoarseVerts, firstOffset, offsets, sizes,
+        selectedOffsets, this->_sizes, inOrder);
+
+    std::vector<int>().swap(offsets);
+    std::vector<int>().swap(sizes);
+
+    std::vector<int> const & selectedSizes = this->_sizes;
+
+    compactStencilData(selectedOffsets, selectedSizes, weightCount, inOrder, sources);
+    compactStencilData(selectedOffsets, selectedSizes, weightCount, inOrder, weights);
+    compactStencilData(selectedOffsets, selectedSizes, weightCount, inOrder, duWeights);
+    compactStencilData(selectedOffsets, selectedSizes, weightCount, inOrder, dvWeights);
+    compactStencilData(selectedOffsets, selectedSizes, weightCount, inOrder, duuWeights);
+    compactStencilData(selectedOffsets, selectedSizes, weightCount, inOrder, duvWeights);
+    compactStencilData(selectedOffsets, selectedSizes, weightCount, inOrder, dvvWeights);
+
+    this->_indices.swap(sources);
+    this->_weights.swap(weights);
+    _duWeights.swap(duWeights);
+    _dvWeights.swap(dvWeights);
+    _duuWeights.swap(duuWeights);
+    _duvWeights.swap(duvWeights);
+    _dvvWeights.swap(dvvWeights);
+
+    this->generateOffsets();
+}
+
+template <typename REAL>
 void
-LimitStencilTable::Clear() {
-    StencilTable::Clear();
+LimitStencilTableReal<REAL>::Clear() {
+    StencilTableReal<REAL>::Clear();
     _duWeights.clear();
     _dvWeights.clear();
     _duuWeights.clear();
@@ -204,6 +373,14 @@ LimitStencilTable::Clear() {
     _dvvWeights.clear();
 }
 
+//
+//  Explicit instantiation for float and double:
+//
+template class StencilTableReal<float>;
+template class StencilTableReal<double>;
+
+template class LimitStencilTableReal<float>;
+template class LimitStencilTableReal<double>;
 
 } // end namespace Far
 
@@ -29,11 +29,16 @@
 #include "../far/patchMap.h"
 #include "../far/topologyRefiner.h"
 #include "../far/primvarRefiner.h"
+#include "../far/error.h"
 
 #include <cassert>
 #include <algorithm>
 #include <iostream>
 
+#ifdef OPENSUBDIV_HAS_OPENMP
+    #include <omp.h>
+#endif
+
 namespace OpenSubdiv {
 namespace OPENSUBDIV_VERSION {
 
@@ -45,24 +50,316 @@ namespace {
 #pragma warning disable 1572
 #endif
 
-    inline bool isWeightZero(float w) { return (w == 0.0f); }
+    template <typename REAL>
+    inline bool isWeightZero(REAL w) { return (w == (REAL)0.0); }
 
 #ifdef __INTEL_COMPILER
 #pragma warning (pop)
 #endif
+
+    //
+    //  The tables instantiated by the factories for a given precision -- the
+    //  float variants are the compatibility classes, so that the results can
+    //  be safely down-cast by StencilTableFactory and LimitStencilTableFactory:
+    //
+    template <typename REAL>
+    struct StencilTableTypes {
+        typedef StencilTableReal<REAL>      Table;
+        typedef LimitStencilTableReal<REAL> LimitTable;
+    };
+
+    template <>
+    struct StencilTableTypes<float> {
+        typedef StencilTable      Table;
+        typedef LimitStencilTable LimitTable;
+    };
+
+    template <typename T>
+    inline void appendVector(std::vector<T> & dst, std::vector<T> const & src) {
+        dst.insert(dst.end(), src.begin(), src.end());
+    }
+
+    template <typename T>
+    inline void reserveVector(std::vector<T> & dst, std::vector<T> const & src, size_t n) {
+        if (! src.empty()) dst.reserve(n);
+    }
+
+    //
+    //  Accumulates the limit stencils of the locations [begin, end), indexed
+    //  across all location arrays, into the builder and returns the number of
+    //  stencils generated (locations on holes have none):
+    //
+    template <typename REAL>
+    int appendLimitStencils(
+        typename LimitStencilTableFactoryReal<REAL>::LocationArrayVec const & locationArrays,
+        int begin, int end,
+        PatchTable const & patchtable, PatchMap const & patchmap,
+        StencilTableReal<REAL> const & src,
+        typename LimitStencilTableFactoryReal<REAL>::Options options,
+        internal::StencilBuilder<REAL> & builder) {
+
+        typedef typename LimitStencilTableFactoryReal<REAL>::LocationArray LocationArray;
+
+        typename internal::StencilBuilder<REAL>::Index origin(&builder, 0);
+        typename internal::StencilBuilder<REAL>::Index dst = origin;
+
+        REAL wP[20], wDs[20], wDt[20], wDss[20], wDst[20], wDtt[20];
+
+        int numLimitStencils = 0,
+            arrayBegin = 0;
+
+        for (size_t i=0; (i<locationArrays.size()) && (arrayBegin<end); ++i) {
+            LocationArray const & array = locationArrays[i];
+            assert(array.ptexIdx>=0);
+
+            int jBegin = std::max(begin - arrayBegin, 0),
+                jEnd = std::min(end - arrayBegin, array.numLocations);
+            arrayBegin += array.numLocations;
+
+            for (int j=jBegin; j<jEnd; ++j) { // for each face we're working on
+                REAL s = array.s[j],
+                     t = array.t[j]; // for each target (s,t) point on that face
+
+                PatchMap::Handle const * handle =
+                        patchmap.FindPatch(array.ptexIdx, (float)s, (float)t);
+                if (handle) {
+                    ConstIndexArray cvs = patchtable.GetPatchVertices(*handle);
+
+                    dst = origin[numLimitStencils];
+
+                    if (options.generate2ndDerivatives) {
+                        patchtable.EvaluateBasis(*handle, s, t, wP, wDs, wDt, wDss, wDst, wDtt);
+
+                        dst.Clear();
+                        for (int k = 0; k < cvs.size(); ++k) {
+                            dst.AddWithWeight(src[cvs[k]], wP[k], wDs[k], wDt[k], wDss[k], wDst[k], wDtt[k]);
+                        }
+                    } else if (options.generate1stDerivatives) {
+                        patchtable.EvaluateBasis(*handle, s, t, wP, wDs, wDt);
+
+                        dst.Clear();
+                        for (int k = 0; k < cvs.size(); ++k) {
+                            dst.AddWithWeight(src[cvs[k]], wP[k], wDs[k], wDt[k]);
+                        }
+                    } else {
+                        patchtable.EvaluateBasis(*handle, s, t, wP);
+
+                        dst.Clear();
+                        for (int k = 0; k < cvs.size(); ++k) {
+                            dst.AddWithWeight(src[cvs[k]], wP[k]);
+                        }
+                    }
+
+                    ++numLimitStencils;
+                }
+            }
+        }
+        return numLimitStencils;
+    }
+
+    //
+    //  Offsets of the stencils of a table, which are implied by the sizes
+    //  when the table has none:
+    //
+    inline void
+    getStencilOffsets(std::vector<int> const & sizes,
+                      std::vector<Index> const & tableOffsets,
+                      std::vector<Index> & offsets) {
+
+        if (! tableOffsets.empty()) {
+            offsets = tableOffsets;
+            return;
+        }
+        offsets.resize(sizes.size());
+        for (int i=0, offset=0; i<(int)sizes.size(); ++i) {
+            offsets[i] = offset;
+            offset += sizes[i];
+        }
+    }
+
+    //  Orders control vertices by increasing number of stencils gathering them
+    struct VertexDegreeLess {
+        VertexDegreeLess(std::vector<int> const & offsets) : _offsets(offsets) { }
+
+        bool operator()(Index a, Index b) const {
+            return (_offsets[a+1] - _offsets[a]) < (_offsets[b+1] - _offsets[b]);
+        }
+
+        std::vector<int> const & _offsets;
+    };
+
+    //
+    //  Computes a reverse Cuthill-McKee ordering of the graph connecting the
+    //  stencils to the control vertices they gather : the graph is traversed
+    //  breadth first from control vertices of lowest degree, each stencil
+    //  being ordered when first reached and queueing the control vertices it
+    //  gathers by increasing degree. Both orderings are returned as the
+    //  original index of each element. Returns false if an index is not that
+    //  of a control vertex.
+    //
+    bool
+    computeLocalityOrdering(int numControlVerts,
+                            std::vector<int> const & sizes,
+                            std::vector<Index> const & offsets,
+                            std::vector<Index> const & indices,
+                            std::vector<Index> & stencilOrder,
+                            std::vector<Index> & vertexOrder) {
+
+        int numStencils = (int)sizes.size();
+
+        //  Stencils gathering each control vertex:
+        std::vector<int> vertexOffsets(numControlVerts + 1, 0);
+        for (int i=0; i<numStencils; ++i) {
+            for (int j=0; j<sizes[i]; ++j) {
+                Index v = indices[offsets[i] + j];
+                if ((v < 0) || (v >= numControlVerts)) {
+                    return false;
+                }
+                ++vertexOffsets[v + 1];
+            }
+        }
+        for (int v=0; v<numControlVerts; ++v) {
+            vertexOffsets[v + 1] += vertexOffsets[v];
+        }
+
+        std::vector<Index> vertexStencils(vertexOffsets[numControlVerts]);
+        std::vector<int> vertexFill(vertexOffsets.begin(), vertexOffsets.end() - 1);
+        for (int i=0; i<numStencils; ++i) {
+            for (int j=0; j<sizes[i]; ++j) {
+                vertexStencils[vertexFill[indices[offsets[i] + j]]++] = i;
+            }
+        }
+
+        VertexDegreeLess degreeLess(vertexOffsets);
+
+        std::vector<Index> roots(numControlVerts);
+        for (int v=0; v<numControlVerts; ++v) {
+            roots[v] = v;
+        }
+        std::stable_sort(roots.begin(), roots.end(), degreeLess);
+
+        //  Breadth first traversal, the vertex order doubling as the queue:
+        std::vector<bool> vertexVisited(numControlVerts, false),
+                          stencilVisited(numStencils, false);
+
+        stencilOrder.clear();
+        stencilOrder.reserve(numStencils);
+        vertexOrder.clear();
+        vertexOrder.reserve(numControlVerts);
+
+        for (int r=0; r<numControlVerts; ++r) {
+            if (vertexVisited[roots[r]]) continue;
+
+            vertexVisited[roots[r]] = true;
+            vertexOrder.push_back(roots[r]);
+
+            for (size_t head=vertexOrder.size()-1; head<vertexOrder.size(); ++head) {
+                Index v = vertexOrder[head];
+
+                for (int k=vertexOffsets[v]; k<vertexOffsets[v+1]; ++k) {
+                    Index stencil = vertexStencils[k];
+                    if (stencilVisited[stencil]) continue;
+
+                    stencilVisited[stencil] = true;
+                    stencilOrder.push_back(stencil);
+
+                    size_t firstQueued = vertexOrder.size();
+                    for (int j=0; j<sizes[stencil]; ++j) {
+                        Index w = indices[offsets[stencil] + j];
+                        if (! vertexVisited[w]) {
+                            vertexVisited[w] = true;
+                            vertexOrder.push_back(w);
+                        }
+                    }
+                    std::stable_sort(vertexOrder.begin() + firstQueued,
+                                     vertexOrder.end(), degreeLess);
+                }
+            }
+        }
+        std::reverse(stencilOrder.begin(), stencilOrder.end());
+        std::reverse(vertexOrder.begin(), vertexOrder.end());
+
+        //  Stencils gathering no control vertex are left at the end:
+        for (int i=0; i<numStencils; ++i) {
+            if (! stencilVisited[i]) {
+                stencilOrder.push_back(i);
+            }
+        }
+        return true;
+    }
+
+    //
+    //  Gathers the coefficients of the reordered stencils (or nothing if the
+    //  table has none):
+    //
+    template <typename T>
+    void
+    permuteStencilData(std::vector<T> const & src,
+                       std::vector<int> const & sizes,
+                       std::vector<Index> const & offsets,
+                       std::vector<Index> const & stencilOrder,
+                       std::vector<T> & dst) {
+
+        if (src.empty()) {
+            dst.clear();
+            return;
+        }
+        dst.resize(src.size());
+
+        T * dstData = &dst[0];
+        for (int i=0; i<(int)stencilOrder.size(); ++i) {
+            Index stencil = stencilOrder[i];
+            std::copy(src.begin() + offsets[stencil],
+                      src.begin() + offsets[stencil] + sizes[stencil], dstData);
+            dstData += sizes[stencil];
+        }
+        dst.resize(dstData - &dst[0]);
+    }
+
+    //
+    //  Reorders the sizes and control vertex indices of a table:
+    //
+    void
+    permuteStencilIndices(int numControlVerts,
+                          std::vector<int> const & sizes,
+                          std::vector<Index> const & offsets,
+                          std::vector<Index> const & indices,
+                          std::vector<Index> const & stencilOrder,
+                          std::vector<Index> const * vertexOrder,
+                          std::vector<int> & dstSizes,
+                          std::vector<Index> & dstIndices) {
+
+        dstSizes.resize(stencilOrder.size());
+        for (int i=0; i<(int)stencilOrder.size(); ++i) {
+            dstSizes[i] = sizes[stencilOrder[i]];
+        }
+
+        permuteStencilData(indices, sizes, offsets, stencilOrder, dstIndices);
+
+        if (vertexOrder) {
+            std::vector<Index> newVertexIndex(numControlVerts);
+            for (int v=0; v<numControlVerts; ++v) {
+                newVertexIndex[(*vertexOrder)[v]] = v;
+            }
+            for (int k=0; k<(int)dstIndices.size(); ++k) {
+                dstIndices[k] = newVertexIndex[dstIndices[k]];
+            }
+        }
+    }
 }
 
 //------------------------------------------------------------------------------
 
+template <typename REAL>
 void
-StencilTableFactory::generateControlVertStencils(
-    int numControlVerts, Stencil & dst) {
+StencilTableFactoryReal<REAL>::generateControlVertStencils(
+    int numControlVerts, StencilReal<REAL> & dst) {
 
     // Control vertices contribute a single index with a weight of 1.0
     for (int i=0; i<numControlVerts; ++i) {
         *dst._size = 1;
         *dst._indices = i;
-        *dst._weights = 1.0f;
+        *dst._weights = 1.0;
         dst.Next();
     }
 }
@@ -70,10 +367,13 @@ StencilTableFactory::generateControlVertStencils(
 //
 // StencilTable factory
 //
-StencilTable const *
-StencilTableFactory::Create(TopologyRefiner const & refiner,
+template <typename REAL>
+StencilTableReal<REAL> const *
+StencilTableFactoryReal<REAL>::Create(TopologyRefiner const & refiner,
     Options options) {
 
+    typedef typename StencilTableTypes<REAL>::Table Table;
+
     bool interpolateVertex = options.interpolationMode==INTERPOLATE_VERTEX;
     bool interpolateVarying = options.interpolationMode==INTERPOLATE_VARYING;
     bool interpolateFaceVarying = options.interpolationMode==INTERPOLATE_FACE_VARYING;
@@ -84,12 +384,12 @@ StencilTableFactory::Create(TopologyRefiner const & refiner,
 
     int maxlevel = std::min(int(options.maxLevel), refiner.GetMaxLevel());
     if (maxlevel==0 && (! options.generateControlVerts)) {
-        StencilTable * result = new StencilTable;
+        Table * result = new Table;
         result->_numControlVertices = numControlVertices;
         return result;
     }
 
-    internal::StencilBuilder builder(numControlVertices,
+    internal::StencilBuilder<REAL> builder(numControlVertices,
                                 /*genControlVerts*/ true,
                                 /*compactWeights*/  true);
 
@@ -97,10 +397,14 @@ StencilTableFactory::Create(TopologyRefiner const & refiner,
     // Interpolate stencils for each refinement level using
     // PrimvarRefiner::InterpolateLevel<>() for vertex or varying
     //
-    PrimvarRefiner primvarRefiner(refiner);
+    PrimvarRefinerReal<REAL> primvarRefiner(refiner);
+
+    typename internal::StencilBuilder<REAL>::Index srcIndex(&builder, 0);
+    typename internal::StencilBuilder<REAL>::Index dstIndex(&builder, numControlVertices);
 
-    internal::StencilBuilder::Index srcIndex(&builder, 0);
-    internal::StencilBuilder::Index dstIndex(&builder, numControlVertices);
+    // When threaded, the weights of each level are only recorded during the
+    // interpolation and factorized concurrently afterwards
+    builder.SetDeferred(options.useMultipleThreads);
 
     for (int level=1; level<=maxlevel; ++level) {
         if (interpolateVertex) {
@@ -110,6 +414,7 @@ StencilTableFactory::Create(TopologyRefiner const & refiner,
         } else {
             primvarRefiner.InterpolateFaceVarying(level, srcIndex, dstIndex, options.fvarChannel);
         }
+        builder.ResolveDeferred();
 
         if (options.factorizeIntermediateLevels) {
             srcIndex = dstIndex;
@@ -132,23 +437,27 @@ StencilTableFactory::Create(TopologyRefiner const & refiner,
     if (! options.generateIntermediateLevels)
         firstOffset = srcIndex.GetOffset();
  
-    // Copy stencils from the StencilBuilder into the StencilTable.
+    // Transfer the stencils from the StencilBuilder into the StencilTable,
+    // which compacts them in place rather than copying them.
     // Always initialize numControlVertices (useful for torus case)
-    StencilTable * result = 
-                        new StencilTable(numControlVertices,
-                                          builder.GetStencilOffsets(),
-                                          builder.GetStencilSizes(),
-                                          builder.GetStencilSources(),
-                                          builder.GetStencilWeights(),
-                                          options.generateControlVerts,
-                                          firstOffset);
+    std::vector<int> offsets, sizes, sources;
+    std::vector<REAL> weights;
+    builder.ReleaseStencils(offsets, sizes, sources, weights);
+
+    Table * result = new Table(numControlVertices);
+    result->assignStencils(offsets, sizes, sources, weights,
+                           options.generateControlVerts, firstOffset);
     return result;
 }
 
 //------------------------------------------------------------------------------
 
-StencilTable const *
-StencilTableFactory::Create(int numTables, StencilTable const ** tables) {
+template <typename REAL>
+StencilTableReal<REAL> const *
+StencilTableFactoryReal<REAL>::Create(
+    int numTables, StencilTableReal<REAL> const ** tables) {
+
+    typedef typename StencilTableTypes<REAL>::Table Table;
 
     // XXXtakahito:
     // This function returns NULL for empty inputs or erroneous condition.
@@ -166,7 +475,7 @@ StencilTableFactory::Create(int numTables, StencilTable const ** tables) {
 
     for (int i=0; i<numTables; ++i) {
 
-        StencilTable const * st = tables[i];
+        StencilTableReal<REAL> const * st = tables[i];
         // allow the tables could have a null entry.
         if (!st) continue;
 
@@ -182,21 +491,21 @@ StencilTableFactory::Create(int numTables, StencilTable const ** tables) {
         return NULL;
     }
 
-    StencilTable * result = new StencilTable;
+    Table * result = new Table;
     result->resize(nstencils, nelems);
 
     int * sizes = &result->_sizes[0];
     Index * indices = &result->_indices[0];
-    float * weights = &result->_weights[0];
+    REAL * weights = &result->_weights[0];
     for (int i=0; i<numTables; ++i) {
-        StencilTable const * st = tables[i];
+        StencilTableReal<REAL> const * st = tables[i];
         if (!st) continue;
 
         int st_nstencils = st->GetNumStencils(),
             st_nelems = (int)st->_indices.size();
         memcpy(sizes, &st->_sizes[0], st_nstencils*sizeof(int));
         memcpy(indices, &st->_indices[0], st_nelems*sizeof(Index));
-        memcpy(weights, &st->_weights[0], st_nelems*sizeof(float));
+        memcpy(weights, &st->_weights[0], st_nelems*sizeof(REAL));
 
         sizes += st_nstencils;
         indices += st_nelems;
@@ -213,11 +522,53 @@ StencilTableFactory::Create(int numTables, StencilTable const ** tables) {
 
 //------------------------------------------------------------------------------
 
-StencilTable const *
-StencilTableFactory::AppendLocalPointStencilTable(
+template <typename REAL>
+StencilTableReal<REAL> const *
+StencilTableFactoryReal<REAL>::CreateReordered(
+    StencilTableReal<REAL> const & table,
+    std::vector<Index> & stencilPermutation,
+    std::vector<Index> * controlVertexPermutation) {
+
+    typedef typename StencilTableTypes<REAL>::Table Table;
+
+    int numControlVerts = table.GetNumControlVertices();
+
+    std::vector<Index> offsets, vertexOrder;
+    getStencilOffsets(table.GetSizes(), table.GetOffsets(), offsets);
+
+    if (! computeLocalityOrdering(numControlVerts, table.GetSizes(), offsets,
+            table.GetControlIndices(), stencilPermutation, vertexOrder)) {
+        Error(FAR_RUNTIME_ERROR, "Failure in StencilTableFactory::CreateReordered() -- "
+            "stencils must only gather control vertices.");
+        return NULL;
+    }
+
+    Table * result = new Table;
+    result->_numControlVertices = numControlVerts;
+
+    permuteStencilIndices(numControlVerts, table.GetSizes(), offsets,
+        table.GetControlIndices(), stencilPermutation,
+        controlVertexPermutation ? &vertexOrder : 0,
+        result->_sizes, result->_indices);
+    permuteStencilData(table.GetWeights(), table.GetSizes(), offsets,
+        stencilPermutation, result->_weights);
+
+    result->generateOffsets();
+
+    if (controlVertexPermutation) {
+        controlVertexPermutation->swap(vertexOrder);
+    }
+    return result;
+}
+
+//------------------------------------------------------------------------------
+
+template <typename REAL>
+StencilTableReal<REAL> const *
+StencilTableFactoryReal<REAL>::AppendLocalPointStencilTable(
     TopologyRefiner const &refiner,
-    StencilTable const * baseStencilTable,
-    StencilTable const * localPointStencilTable,
+    StencilTableReal<REAL> const * baseStencilTable,
+    StencilTableReal<float> const * localPointStencilTable,
     bool factorize) {
 
     return appendLocalPointStencilTable(
@@ -228,11 +579,12 @@ StencilTableFactory::AppendLocalPointStencilTable(
         factorize);
 }
 
-StencilTable const *
-StencilTableFactory::AppendLocalPointStencilTableFaceVarying(
+template <typename REAL>
+StencilTableReal<REAL> const *
+StencilTableFactoryReal<REAL>::AppendLocalPointStencilTableFaceVarying(
     TopologyRefiner const &refiner,
-    StencilTable const * baseStencilTable,
-    StencilTable const * localPointStencilTable,
+    StencilTableReal<REAL> const * baseStencilTable,
+    StencilTableReal<float> const * localPointStencilTable,
     int channel,
     bool factorize) {
 
@@ -244,14 +596,17 @@ StencilTableFactory::AppendLocalPointStencilTableFaceVarying(
         factorize);
 }
 
-StencilTable const *
-StencilTableFactory::appendLocalPointStencilTable(
+template <typename REAL>
+StencilTableReal<REAL> const *
+StencilTableFactoryReal<REAL>::appendLocalPointStencilTable(
     TopologyRefiner const &refiner,
-    StencilTable const * baseStencilTable,
-    StencilTable const * localPointStencilTable,
+    StencilTableReal<REAL> const * baseStencilTable,
+    StencilTableReal<float> const * localPointStencilTable,
     int channel,
     bool factorize) {
 
+    typedef typename StencilTableTypes<REAL>::Table Table;
+
     // factorize and append.
     if (baseStencilTable == NULL ||
         localPointStencilTable == NULL ||
@@ -317,19 +672,19 @@ StencilTableFactory::appendLocalPointStencilTable(
     int nLocalPointStencils = localPointStencilTable->GetNumStencils();
     int nLocalPointStencilsElements = 0;
 
-    internal::StencilBuilder builder(nControlVerts,
+    internal::StencilBuilder<REAL> builder(nControlVerts,
                                 /*genControlVerts*/ false,
                                 /*compactWeights*/  factorize);
-    internal::StencilBuilder::Index origin(&builder, 0);
-    internal::StencilBuilder::Index dst = origin;
-    internal::StencilBuilder::Index srcIdx = origin;
+    typename internal::StencilBuilder<REAL>::Index origin(&builder, 0);
+    typename internal::StencilBuilder<REAL>::Index dst = origin;
+    typename internal::StencilBuilder<REAL>::Index srcIdx = origin;
 
     for (int i = 0 ; i < nLocalPointStencils; ++i) {
-        Stencil src = localPointStencilTable->GetStencil(i);
+        StencilReal<float> src = localPointStencilTable->GetStencil(i);
         dst = origin[i];
         for (int j = 0; j < src.GetSize(); ++j) {
             Index index = src.GetVertexIndices()[j];
-            float weight = src.GetWeights()[j];
+            REAL weight = src.GetWeights()[j];
             if (isWeightZero(weight)) continue;
 
             if (factorize) {
@@ -349,14 +704,14 @@ StencilTableFactory::appendLocalPointStencilTable(
     }
 
     // create new stencil table
-    StencilTable * result = new StencilTable;
+    Table * result = new Table;
     result->_numControlVertices = nControlVerts;
     result->resize(nBaseStencils + nLocalPointStencils,
                    nBaseStencilsElements + nLocalPointStencilsElements);
 
     int* sizes = &result->_sizes[0];
     Index * indices = &result->_indices[0];
-    float * weights = &result->_weights[0];
+    REAL * weights = &result->_weights[0];
 
     // put base stencils first
     memcpy(sizes, &baseStencilTable->_sizes[0],
@@ -364,7 +719,7 @@ StencilTableFactory::appendLocalPointStencilTable(
     memcpy(indices, &baseStencilTable->_indices[0],
            nBaseStencilsElements*sizeof(Index));
     memcpy(weights, &baseStencilTable->_weights[0],
-           nBaseStencilsElements*sizeof(float));
+           nBaseStencilsElements*sizeof(REAL));
 
     sizes += nBaseStencils;
     indices += nBaseStencilsElements;
@@ -388,12 +743,15 @@ StencilTableFactory::appendLocalPointStencilTable(
 }
 
 //------------------------------------------------------------------------------
-LimitStencilTable const *
-LimitStencilTableFactory::Create(TopologyRefiner const & refiner,
+template <typename REAL>
+LimitStencilTableReal<REAL> const *
+LimitStencilTableFactoryReal<REAL>::Create(TopologyRefiner const & refiner,
     LocationArrayVec const & locationArrays,
-        StencilTable const * cvStencilsIn,
-          PatchTable const * patchTableIn,
-                     Options options) {
+        StencilTableReal<REAL> const * cvStencilsIn,
+                    PatchTable const * patchTableIn,
+                               Options options) {
+
+    typedef typename StencilTableTypes<REAL>::LimitTable LimitTable;
 
     // Compute the total number of stencils to generate
     int numStencils=0, numLimitStencils=0;
@@ -409,14 +767,14 @@ LimitStencilTableFactory::Create(TopologyRefiner const & refiner,
 
     int maxlevel = refiner.GetMaxLevel();
 
-    StencilTable const * cvstencils = cvStencilsIn;
+    StencilTableReal<REAL> const * cvstencils = cvStencilsIn;
     if (! cvstencils) {
         // Generate stencils for the control vertices - this is necessary to
         // properly factorize patches with control vertices at level 0 (natural
         // regular patches, such as in a torus)
         // note: the control vertices of the mesh are added as single-index
         //       stencils of weight 1.0f
-        StencilTableFactory::Options stencilTableOptions;
+        typename StencilTableFactoryReal<REAL>::Options stencilTableOptions;
         stencilTableOptions.generateIntermediateLevels = uniform ? false :true;
         stencilTableOptions.generateControlVerts = true;
         stencilTableOptions.generateOffsets = true;
@@ -424,7 +782,8 @@ LimitStencilTableFactory::Create(TopologyRefiner const & refiner,
         // PERFORMANCE: We could potentially save some mem-copies by not
         // instantiating the stencil tables and work directly off the source
         // data.
-        cvstencils = StencilTableFactory::Create(refiner, stencilTableOptions);
+        cvstencils = StencilTableFactoryReal<REAL>::Create(refiner,
+                                                           stencilTableOptions);
     } else {
         // Sanity checks
         //
@@ -458,8 +817,8 @@ LimitStencilTableFactory::Create(TopologyRefiner const & refiner,
             // if cvstencils is just created above, append endcap stencils
             if (StencilTable const *localPointStencilTable =
                 patchtable->GetLocalPointStencilTable()) {
-                StencilTable const *table =
-                    StencilTableFactory::AppendLocalPointStencilTable(
+                StencilTableReal<REAL> const *table =
+                    StencilTableFactoryReal<REAL>::AppendLocalPointStencilTable(
                         refiner, cvstencils, localPointStencilTable);
                 delete cvstencils;
                 cvstencils = table;
@@ -484,86 +843,176 @@ LimitStencilTableFactory::Create(TopologyRefiner const & refiner,
     //
     // Generate limit stencils for locations
     //
+    // When threaded, the locations are split in contiguous ranges, each of
+    // which is accumulated in its own builder.  The stencil of a location
+    // does not depend on other locations, so appending the ranges in order
+    // yields the same table as the serial build.
+    //
+    int numRanges = 1;
+#ifdef OPENSUBDIV_HAS_OPENMP
+    if (options.useMultipleThreads) {
+        int const minLocationsPerRange = 1024;
 
-    internal::StencilBuilder builder(refiner.GetLevel(0).GetNumVertices(),
+        numRanges = std::max(1, std::min(omp_get_max_threads(),
+                                         numStencils / minLocationsPerRange));
+    }
+#endif
+
+    std::vector<internal::StencilBuilder<REAL> *> builders(numRanges);
+    std::vector<int> numRangeStencils(numRanges);
+
+#ifdef OPENSUBDIV_HAS_OPENMP
+    #pragma omp parallel for schedule(static, 1) if (numRanges > 1)
+#endif
+    for (int range = 0; range < numRanges; ++range) {
+        builders[range] = new internal::StencilBuilder<REAL>(
+                                refiner.GetLevel(0).GetNumVertices(),
                                 /*genControlVerts*/ false,
                                 /*compactWeights*/  true);
-    internal::StencilBuilder::Index origin(&builder, 0);
-    internal::StencilBuilder::Index dst = origin;
 
-    float wP[20], wDs[20], wDt[20], wDss[20], wDst[20], wDtt[20];
+        numRangeStencils[range] = appendLimitStencils<REAL>(locationArrays,
+            (int)(((long long)numStencils * range) / numRanges),
+            (int)(((long long)numStencils * (range + 1)) / numRanges),
+            *patchtable, patchmap, *cvstencils, options, *builders[range]);
+    }
+    for (int range = 0; range < numRanges; ++range) {
+        numLimitStencils += numRangeStencils[range];
+    }
+
+    if (! cvStencilsIn) {
+        delete cvstencils;
+    }
+
+    if (! patchTableIn) {
+        delete patchtable;
+    }
 
-    for (size_t i=0; i<locationArrays.size(); ++i) {
-        LocationArray const & array = locationArrays[i];
-        assert(array.ptexIdx>=0);
+    //
+    // Transfer the proto-stencils into the limit stencil table -- those of
+    // each range are appended in turn and their builder deleted right away
+    // to limit the memory held at once
+    //
+    std::vector<int> offsets, sizes, sources;
+    std::vector<REAL> weights, duWeights, dvWeights,
+                      duuWeights, duvWeights, dvvWeights;
+
+    if (numRanges == 1) {
+        builders[0]->ReleaseStencils(offsets, sizes, sources, weights,
+            duWeights, dvWeights, duuWeights, duvWeights, dvvWeights);
+        delete builders[0];
+    } else {
+        // Concatenate the stencils of all ranges, offsetting those of each
+        // range by the number of weights of the preceding ones
+        size_t numWeights = 0;
+        for (int range = 0; range < numRanges; ++range) {
+            numWeights += builders[range]->GetStencilSources().size();
+        }
+        internal::StencilBuilder<REAL> const & first = *builders[0];
+
+        offsets.reserve(numLimitStencils);
+        sizes.reserve(numLimitStencils);
+        sources.reserve(numWeights);
+        reserveVector(weights, first.GetStencilWeights(), numWeights);
+        reserveVector(duWeights, first.GetStencilDuWeights(), numWeights);
+        reserveVector(dvWeights, first.GetStencilDvWeights(), numWeights);
+        reserveVector(duuWeights, first.GetStencilDuuWeights(), numWeights);
+        reserveVector(duvWeights, first.GetStencilDuvWeights(), numWeights);
+        reserveVector(dvvWeights, first.GetStencilDvvWeights(), numWeights);
+
+        for (int range = 0; range < numRanges; ++range) {
+            internal::StencilBuilder<REAL> const & builder = *builders[range];
+
+            int base = (int)sources.size();
+
+            std::vector<int> const & rangeOffsets = builder.GetStencilOffsets();
+            for (int i = 0; i < (int)rangeOffsets.size(); ++i) {
+                offsets.push_back(base + rangeOffsets[i]);
+            }
+            appendVector(sizes, builder.GetStencilSizes());
+            appendVector(sources, builder.GetStencilSources());
+            appendVector(weights, builder.GetStencilWeights());
+            appendVector(duWeights, builder.GetStencilDuWeights());
+            appendVector(dvWeights, builder.GetStencilDvWeights());
+            appendVector(duuWeights, builder.GetStencilDuuWeights());
+            appendVector(duvWeights, builder.GetStencilDuvWeights());
+            appendVector(dvvWeights, builder.GetStencilDvvWeights());
+
+            delete builders[range];
+        }
+    }
 
-        for (int j=0; j<array.numLocations; ++j) { // for each face we're working on
-            float s = array.s[j],
-                  t = array.t[j]; // for each target (s,t) point on that face
+    LimitTable * result = new LimitTable;
+    result->_numControlVertices = refiner.GetLevel(0).GetNumVertices();
 
-            PatchMap::Handle const * handle = 
-                                        patchmap.FindPatch(array.ptexIdx, s, t);
-            if (handle) {
-                ConstIndexArray cvs = patchtable->GetPatchVertices(*handle);
+    static_cast<LimitStencilTableReal<REAL> *>(result)->assignStencils(
+        offsets, sizes, sources, weights,
+        duWeights, dvWeights, duuWeights, duvWeights, dvvWeights,
+        /*ctrlVerts*/false,
+        /*fristOffset*/0);
+    return result;
+}
 
-                StencilTable const & src = *cvstencils;
-                dst = origin[numLimitStencils];
+template <typename REAL>
+LimitStencilTableReal<REAL> const *
+LimitStencilTableFactoryReal<REAL>::CreateReordered(
+    LimitStencilTableReal<REAL> const & table,
+    std::vector<Index> & stencilPermutation,
+    std::vector<Index> * controlVertexPermutation) {
 
-                if (options.generate2ndDerivatives) {
-                    patchtable->EvaluateBasis(*handle, s, t, wP, wDs, wDt, wDss, wDst, wDtt);
+    typedef typename StencilTableTypes<REAL>::LimitTable LimitTable;
 
-                    dst.Clear();
-                    for (int k = 0; k < cvs.size(); ++k) {
-                        dst.AddWithWeight(src[cvs[k]], wP[k], wDs[k], wDt[k], wDss[k], wDst[k], wDtt[k]);
-                    }
-                } else if (options.generate1stDerivatives) {
-                    patchtable->EvaluateBasis(*handle, s, t, wP, wDs, wDt);
+    int numControlVerts = table.GetNumControlVertices();
 
-                    dst.Clear();
-                    for (int k = 0; k < cvs.size(); ++k) {
-                        dst.AddWithWeight(src[cvs[k]], wP[k], wDs[k], wDt[k]);
-                    }
-                } else {
-                    patchtable->EvaluateBasis(*handle, s, t, wP);
+    std::vector<int> const & sizes = table.GetSizes();
 
-                    dst.Clear();
-                    for (int k = 0; k < cvs.size(); ++k) {
-                        dst.AddWithWeight(src[cvs[k]], wP[k]);
-                    }
-                }
+    std::vector<Index> offsets, vertexOrder;
+    getStencilOffsets(sizes, table.GetOffsets(), offsets);
 
-                ++numLimitStencils;
-            }
-        }
+    if (! computeLocalityOrdering(numControlVerts, sizes, offsets,
+            table.GetControlIndices(), stencilPermutation, vertexOrder)) {
+        Error(FAR_RUNTIME_ERROR, "Failure in LimitStencilTableFactory::CreateReordered() -- "
+            "stencils must only gather control vertices.");
+        return NULL;
     }
 
-    if (! cvStencilsIn) {
-        delete cvstencils;
-    }
+    LimitTable * result = new LimitTable;
+    result->_numControlVertices = numControlVerts;
+
+    permuteStencilIndices(numControlVerts, sizes, offsets,
+        table.GetControlIndices(), stencilPermutation,
+        controlVertexPermutation ? &vertexOrder : 0,
+        result->_sizes, result->_indices);
+
+    permuteStencilData(table.GetWeights(), sizes, offsets,
+        stencilPermutation, result->_weights);
+    permuteStencilData(table.GetDuWeights(), sizes, offsets,
+        stencilPermutation, result->_duWeights);
+    permuteStencilData(table.GetDvWeights(), sizes, offsets,
+        stencilPermutation, result->_dvWeights);
+    permuteStencilData(table.GetDuuWeights(), sizes, offsets,
+        stencilPermutation, result->_duuWeights);
+    permuteStencilData(table.GetDuvWeights(), sizes, offsets,
+        stencilPermutation, result->_duvWeights);
+    permuteStencilData(table.GetDvvWeights(), sizes, offsets,
+        stencilPermutation, result->_dvvWeights);
 
-    if (! patchTableIn) {
-        delete patchtable;
-    }
+    result->generateOffsets();
 
-    //
-    // Copy the proto-stencils into the limit stencil table
-    //
-    LimitStencilTable * result = new LimitStencilTable(
-                                          refiner.GetLevel(0).GetNumVertices(),
-                                          builder.GetStencilOffsets(),
-                                          builder.GetStencilSizes(),
-                                          builder.GetStencilSources(),
-                                          builder.GetStencilWeights(),
-                                          builder.GetStencilDuWeights(),
-                                          builder.GetStencilDvWeights(),
-                                          builder.GetStencilDuuWeights(),
-                                          builder.GetStencilDuvWeights(),
-                                          builder.GetStencilDvvWeights(),
-                                          /*ctrlVerts*/false,
-                                          /*fristOffset*/0);
+    if (controlVertexPermutation) {
+        controlVertexPermutation->swap(vertexOrder);
+    }
     return result;
 }
 
+//
+//  Explicit instantiation for the supported precisions:
+//
+template class StencilTableFactoryReal<float>;
+template class StencilTableFactoryReal<double>;
+
+template class LimitStencilTableFactoryReal<float>;
+template class LimitStencilTableFactoryReal<double>;
+
 } // end namespace Far
 
 } // end namespace OPENSUBDIV_VERSION
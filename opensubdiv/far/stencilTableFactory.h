@@ -38,6 +38,12 @@ namespace Far {
 
 class TopologyRefiner;
 
+template <typename REAL> class StencilReal;
+template <typename REAL> class StencilTableReal;
+
+template <typename REAL> class LimitStencilReal;
+template <typename REAL> class LimitStencilTableReal;
+
 class Stencil;
 class StencilTable;
 class LimitStencil;
@@ -45,7 +51,12 @@ class LimitStencilTable;
 
 /// \brief A specialized factory for StencilTable
 ///
-class StencilTableFactory {
+/// The factory is templated on the precision (REAL) of the stencil weights
+/// it generates -- float and double are supported.  StencilTableFactory is
+/// the single precision variant operating on StencilTable.
+///
+template <typename REAL>
+class StencilTableFactoryReal {
 
 public:
 
@@ -63,6 +74,7 @@ public:
                     generateIntermediateLevels(true),
                     factorizeIntermediateLevels(true),
                     maxLevel(10),
+                    useMultipleThreads(false),
                     fvarChannel(0) { }
 
         unsigned int interpolationMode           : 2, ///< interpolation mode
@@ -72,7 +84,10 @@ public:
                      factorizeIntermediateLevels : 1, ///< accumulate stencil weights from control
                                                       ///  vertices or from the stencils of the
                                                       ///  previous level
-                     maxLevel                    : 4; ///< generate stencils up to 'maxLevel'
+                     maxLevel                    : 4, ///< generate stencils up to 'maxLevel'
+                     useMultipleThreads          : 1; ///< factorize the stencils of each level
+                                                      ///  concurrently (requires OpenMP), the
+                                                      ///  resulting table is identical
         unsigned int fvarChannel;                     ///< face-varying channel to use
                                                       ///  when generating face-varying stencils
     };
@@ -88,7 +103,7 @@ public:
     ///
     /// @param options  Options controlling the creation of the table
     ///
-    static StencilTable const * Create(TopologyRefiner const & refiner,
+    static StencilTableReal<REAL> const * Create(TopologyRefiner const & refiner,
         Options options = Options());
 
 
@@ -104,7 +119,8 @@ public:
     ///
     /// @param tables    Array of input StencilTables
     ///
-    static StencilTable const * Create(int numTables, StencilTable const ** tables);
+    static StencilTableReal<REAL> const * Create(
+        int numTables, StencilTableReal<REAL> const ** tables);
 
 
     /// \brief Utility function for stencil splicing for local point stencils.
@@ -121,10 +137,13 @@ public:
     ///                             table so that the endcap points can be computed
     ///                             directly from control vertices.
     ///
-    static StencilTable const * AppendLocalPointStencilTable(
+    /// \note The local point stencils of a PatchTable are always single
+    ///       precision -- their weights are promoted to REAL when splicing.
+    ///
+    static StencilTableReal<REAL> const * AppendLocalPointStencilTable(
         TopologyRefiner const &refiner,
-        StencilTable const *baseStencilTable,
-        StencilTable const *localPointStencilTable,
+        StencilTableReal<REAL> const *baseStencilTable,
+        StencilTableReal<float> const *localPointStencilTable,
         bool factorize = true);
 
     /// \brief Utility function for stencil splicing for local point
@@ -144,23 +163,55 @@ public:
     ///                             table so that the endcap points can be computed
     ///                             directly from control vertices.
     ///
-    static StencilTable const * AppendLocalPointStencilTableFaceVarying(
+    static StencilTableReal<REAL> const * AppendLocalPointStencilTableFaceVarying(
         TopologyRefiner const &refiner,
-        StencilTable const *baseStencilTable,
-        StencilTable const *localPointStencilTable,
+        StencilTableReal<REAL> const *baseStencilTable,
+        StencilTableReal<float> const *localPointStencilTable,
         int channel = 0,
         bool factorize = true);
 
+    /// \brief Instantiates a copy of a StencilTable with its stencils, and
+    ///        optionally the control vertices they gather, reordered so that
+    ///        consecutive stencils gather nearby control vertices.
+    ///
+    /// The stencils are ordered by a reverse Cuthill-McKee traversal of the
+    /// graph connecting them to their control vertices, which improves the
+    /// cache locality of the evaluators on large meshes. Both permutations
+    /// hold the original index of each reordered element : stencil i of the
+    /// new table is stencil stencilPermutation[i] of the original one, and
+    /// its control vertex i is control vertex controlVertexPermutation[i].
+    /// The weights of each stencil are kept in their original order, so that
+    /// the remapped results are identical.
+    ///
+    /// \note The stencils must be factorized, i.e. only gather control
+    ///       vertices -- NULL is returned otherwise.
+    ///
+    /// @param table                    The StencilTable to reorder
+    ///
+    /// @param stencilPermutation       Original index of each stencil of the
+    ///                                 new table
+    ///
+    /// @param controlVertexPermutation Original index of each control vertex
+    ///                                 gathered by the new table (optional:
+    ///                                 the control vertices are not reordered
+    ///                                 if NULL)
+    ///
+    static StencilTableReal<REAL> const * CreateReordered(
+        StencilTableReal<REAL> const & table,
+        std::vector<Index> & stencilPermutation,
+        std::vector<Index> * controlVertexPermutation = 0);
+
 private:
 
     // Generate stencils for the coarse control-vertices (single weight = 1.0f)
-    static void generateControlVertStencils(int numControlVerts, Stencil & dst);
+    static void generateControlVertStencils(int numControlVerts,
+        StencilReal<REAL> & dst);
 
     // Internal method to splice local point stencils
-    static StencilTable const * appendLocalPointStencilTable(
+    static StencilTableReal<REAL> const * appendLocalPointStencilTable(
         TopologyRefiner const &refiner,
-        StencilTable const * baseStencilTable,
-        StencilTable const * localPointStencilTable,
+        StencilTableReal<REAL> const * baseStencilTable,
+        StencilTableReal<float> const * localPointStencilTable,
         int channel,
         bool factorize);
 };
@@ -176,7 +227,11 @@ private:
 /// normalized (s,t) patch coordinates. The factory exposes the LocationArray
 /// struct as a container for these location descriptors.
 ///
-class LimitStencilTableFactory {
+/// As with StencilTableFactoryReal, the factory is templated on the precision
+/// of the generated weights and of the (s,t) locations.
+///
+template <typename REAL>
+class LimitStencilTableFactoryReal {
 
 public:
 
@@ -188,8 +243,8 @@ public:
         int ptexIdx,        ///< ptex face index
             numLocations;   ///< number of (u,v) coordinates in the array
 
-        float const * s,    ///< array of u coordinates
-                    * t;    ///< array of v coordinates
+        REAL const * s,     ///< array of u coordinates
+                   * t;     ///< array of v coordinates
     };
 
     typedef std::vector<LocationArray> LocationArrayVec;
@@ -197,10 +252,14 @@ public:
     struct Options {
 
         Options() : generate1stDerivatives(true),
-                    generate2ndDerivatives(false) { }
+                    generate2ndDerivatives(false),
+                    useMultipleThreads(false) { }
 
         unsigned int generate1stDerivatives      : 1, ///< Generate weights for 1st derivatives
-                     generate2ndDerivatives      : 1; ///< Generate weights for 2nd derivatives
+                     generate2ndDerivatives      : 1, ///< Generate weights for 2nd derivatives
+                     useMultipleThreads          : 1; ///< generate the stencils of the locations
+                                                      ///  concurrently (requires OpenMP), the
+                                                      ///  resulting table is identical
     };
 
     /// \brief Instantiates LimitStencilTable from a TopologyRefiner that has
@@ -221,12 +280,118 @@ public:
     ///
     /// @param options          Options controlling the creation of the table
     ///
+    static LimitStencilTableReal<REAL> const * Create(
+        TopologyRefiner const & refiner,
+        LocationArrayVec const & locationArrays,
+            StencilTableReal<REAL> const * cvStencils=0,
+                        PatchTable const * patchTable=0,
+                                   Options options=Options());
+
+    /// \brief Instantiates a copy of a LimitStencilTable with its stencils,
+    ///        and optionally the control vertices they gather, reordered for
+    ///        cache locality (see StencilTableFactoryReal::CreateReordered())
+    ///
+    /// @param table                    The LimitStencilTable to reorder
+    ///
+    /// @param stencilPermutation       Original index of each stencil of the
+    ///                                 new table
+    ///
+    /// @param controlVertexPermutation Original index of each control vertex
+    ///                                 gathered by the new table (optional:
+    ///                                 the control vertices are not reordered
+    ///                                 if NULL)
+    ///
+    static LimitStencilTableReal<REAL> const * CreateReordered(
+        LimitStencilTableReal<REAL> const & table,
+        std::vector<Index> & stencilPermutation,
+        std::vector<Index> * controlVertexPermutation = 0);
+};
+
+/// \brief Stencil table factory class wrapping the template for compatibility.
+///
+class StencilTableFactory : public StencilTableFactoryReal<float> {
+protected:
+    typedef StencilTableFactoryReal<float> BaseFactory;
+
+public:
+    static StencilTable const * Create(TopologyRefiner const & refiner,
+        Options options = Options()) {
+
+        return static_cast<StencilTable const *>(
+                BaseFactory::Create(refiner, options));
+    }
+
+    static StencilTable const * Create(int numTables,
+        StencilTable const ** tables) {
+
+        return static_cast<StencilTable const *>(
+                BaseFactory::Create(numTables,
+                    reinterpret_cast<StencilTableReal<float> const **>(tables)));
+    }
+
+    static StencilTable const * AppendLocalPointStencilTable(
+        TopologyRefiner const &refiner,
+        StencilTable const *baseStencilTable,
+        StencilTable const *localPointStencilTable,
+        bool factorize = true) {
+
+        return static_cast<StencilTable const *>(
+                BaseFactory::AppendLocalPointStencilTable(refiner,
+                    baseStencilTable, localPointStencilTable, factorize));
+    }
+
+    static StencilTable const * AppendLocalPointStencilTableFaceVarying(
+        TopologyRefiner const &refiner,
+        StencilTable const *baseStencilTable,
+        StencilTable const *localPointStencilTable,
+        int channel = 0,
+        bool factorize = true) {
+
+        return static_cast<StencilTable const *>(
+                BaseFactory::AppendLocalPointStencilTableFaceVarying(refiner,
+                    baseStencilTable, localPointStencilTable,
+                    channel, factorize));
+    }
+
+    static StencilTable const * CreateReordered(
+        StencilTable const & table,
+        std::vector<Index> & stencilPermutation,
+        std::vector<Index> * controlVertexPermutation = 0) {
+
+        return static_cast<StencilTable const *>(
+                BaseFactory::CreateReordered(table,
+                    stencilPermutation, controlVertexPermutation));
+    }
+};
+
+/// \brief Limit stencil table factory class wrapping the template for
+/// compatibility.
+///
+class LimitStencilTableFactory : public LimitStencilTableFactoryReal<float> {
+protected:
+    typedef LimitStencilTableFactoryReal<float> BaseFactory;
+
+public:
     static LimitStencilTable const * Create(TopologyRefiner const & refiner,
         LocationArrayVec const & locationArrays,
             StencilTable const * cvStencils=0,
               PatchTable const * patchTable=0,
-                         Options options=Options());
-
+                         Options options=Options()) {
+
+        return static_cast<LimitStencilTable const *>(
+                BaseFactory::Create(refiner, locationArrays,
+                    cvStencils, patchTable, options));
+    }
+
+    static LimitStencilTable const * CreateReordered(
+        LimitStencilTable const & table,
+        std::vector<Index> & stencilPermutation,
+        std::vector<Index> * controlVertexPermutation = 0) {
+
+        return static_cast<LimitStencilTable const *>(
+                BaseFactory::CreateReordered(table,
+                    stencilPermutation, controlVertexPermutation));
+    }
 };
 
 
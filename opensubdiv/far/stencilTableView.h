@@ -0,0 +1,242 @@
+//
+//   Copyright 2019 Pixar
+//
+//   Licensed under the Apache License, Version 2.0 (the "Apache License")
+//   with the following modification; you may not use this file except in
+//   compliance with the Apache License and the following modification to it:
+//   Section 6. Trademarks. is deleted and replaced with:
+//
+//   6. Trademarks. This License does not grant permission to use the trade
+//      names, trademarks, service marks, or product names of the Licensor
+//      and its affiliates, except as required to comply with Section 4(c) of
+//      the License and to reproduce the content of the NOTICE file.
+//
+//   You may obtain a copy of the Apache License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the Apache License with the above modification is
+//   distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//   KIND, either express or implied. See the Apache License for the specific
+//   language governing permissions and limitations under the Apache License.
+//
+#ifndef OPENSUBDIV3_FAR_STENCILTABLE_VIEW_H
+#define OPENSUBDIV3_FAR_STENCILTABLE_VIEW_H
+
+#include "../version.h"
+
+#include "../far/types.h"
+#include "../far/stencilTable.h"
+
+#include <algorithm>
+#include <cassert>
+
+namespace OpenSubdiv {
+namespace OPENSUBDIV_VERSION {
+
+namespace Far {
+
+/// \brief Read-only view of a table of subdivision stencils.
+///
+/// A StencilTableView presents the same interface as a StencilTable over
+/// arrays that it does not own : the arrays of an existing StencilTable, or
+/// arrays stored in externally managed memory such as a file mapped by many
+/// processes (see TableSerializer::ReadStencilTableView()).  No data is copied
+/// and the arrays must remain valid for the lifetime of the view.
+///
+/// Views can be passed wherever the Osd evaluators accept a stencil table,
+/// e.g. Osd::CpuEvaluator::EvalStencils().
+///
+template <typename REAL>
+class StencilTableViewReal {
+
+public:
+
+    /// \brief Constructs an empty view
+    StencilTableViewReal() :
+        _numControlVertices(0), _numStencils(0), _numElements(0),
+        _sizes(0), _offsets(0), _indices(0), _weights(0) { }
+
+    /// \brief Constructs a view of externally owned arrays
+    ///
+    /// @param numControlVertices  Number of control vertices indexed
+    ///
+    /// @param numStencils         Number of stencils
+    ///
+    /// @param sizes               Number of weights of each stencil
+    ///
+    /// @param offsets             Offset to the weights of each stencil
+    ///
+    /// @param numElements         Number of control indices and weights
+    ///
+    /// @param indices             Control vertex indices of all stencils
+    ///
+    /// @param weights             Weights of all stencils
+    ///
+    StencilTableViewReal(int numControlVertices, int numStencils,
+                         int const * sizes, Index const * offsets,
+                         int numElements,
+                         Index const * indices, REAL const * weights) :
+        _numControlVertices(numControlVertices),
+        _numStencils(numStencils), _numElements(numElements),
+        _sizes(sizes), _offsets(offsets), _indices(indices), _weights(weights) { }
+
+    /// \brief Constructs a view of the arrays of a stencil table
+    explicit StencilTableViewReal(StencilTableReal<REAL> const & table) :
+        _numControlVertices(table.GetNumControlVertices()),
+        _numStencils(table.GetNumStencils()),
+        _numElements((int)table.GetControlIndices().size()),
+        _sizes(getData(table.GetSizes())),
+        _offsets(getData(table.GetOffsets())),
+        _indices(getData(table.GetControlIndices())),
+        _weights(getData(table.GetWeights())) { }
+
+    /// \brief Returns the number of stencils in the table
+    int GetNumStencils() const {
+        return _numStencils;
+    }
+
+    /// \brief Returns the number of control vertices indexed in the table
+    int GetNumControlVertices() const {
+        return _numControlVertices;
+    }
+
+    /// \brief Returns a Stencil at index i in the table
+    StencilReal<REAL> GetStencil(Index i) const {
+        assert(_offsets && i<_numStencils);
+
+        Index ofs = _offsets[i];
+
+        return StencilReal<REAL>(const_cast<int *>(&_sizes[i]),
+                                 const_cast<Index *>(&_indices[ofs]),
+                                 const_cast<REAL *>(&_weights[ofs]));
+    }
+
+    /// \brief Returns the stencil at index i in the table
+    StencilReal<REAL> operator[] (Index index) const {
+        return GetStencil(index);
+    }
+
+    /// \brief Returns the number of control vertices of each stencil in the table
+    Vtr::ConstArray<int> GetSizes() const {
+        return Vtr::ConstArray<int>(_sizes, _numStencils);
+    }
+
+    /// \brief Returns the offset to a given stencil
+    ConstIndexArray GetOffsets() const {
+        return ConstIndexArray(_offsets, _numStencils);
+    }
+
+    /// \brief Returns the indices of the control vertices
+    ConstIndexArray GetControlIndices() const {
+        return ConstIndexArray(_indices, _numElements);
+    }
+
+    /// \brief Returns the stencil interpolation weights
+    Vtr::ConstArray<REAL> GetWeights() const {
+        return Vtr::ConstArray<REAL>(_weights, _numElements);
+    }
+
+    /// \brief Updates point values based on the control values
+    ///
+    /// \note The destination buffers are assumed to have allocated at least
+    ///       \c GetNumStencils() elements.
+    ///
+    /// @param controlValues  Buffer with primvar data for the control vertices
+    ///
+    /// @param values         Destination buffer for the interpolated primvar
+    ///                       data
+    ///
+    /// @param start          index of first value to update
+    ///
+    /// @param end            Index of last value to update
+    ///
+    template <class T>
+    void UpdateValues(T const *controlValues, T *values, Index start=-1, Index end=-1) const;
+
+private:
+    template <typename T>
+    static T const * getData(std::vector<T> const & v) {
+        return v.empty() ? 0 : &v[0];
+    }
+
+    int _numControlVertices,
+        _numStencils,
+        _numElements;
+
+    int   const * _sizes;
+    Index const * _offsets,
+                * _indices;
+    REAL  const * _weights;
+};
+
+/// \brief Stencil table view class wrapping the template for compatibility.
+///
+class StencilTableView : public StencilTableViewReal<float> {
+protected:
+    typedef StencilTableViewReal<float> BaseView;
+
+public:
+    StencilTableView() : BaseView() { }
+    StencilTableView(int numControlVertices, int numStencils,
+                     int const * sizes, Index const * offsets,
+                     int numElements,
+                     Index const * indices, float const * weights)
+        : BaseView(numControlVertices, numStencils, sizes, offsets,
+                   numElements, indices, weights) { }
+    explicit StencilTableView(StencilTableReal<float> const & table)
+        : BaseView(table) { }
+
+    Stencil GetStencil(Index index) const {
+        return Stencil(BaseView::GetStencil(index));
+    }
+    Stencil operator[] (Index index) const {
+        return Stencil(BaseView::GetStencil(index));
+    }
+};
+
+
+// Update values by applying cached stencil weights to new control values
+template <typename REAL>
+template <class T> void
+StencilTableViewReal<REAL>::UpdateValues(T const *controlValues, T *values,
+    Index start, Index end) const {
+
+    int const * sizes = _sizes;
+    Index const * indices = _indices;
+    REAL const * weights = _weights;
+
+    if (start>0) {
+        assert(start<_numStencils);
+        sizes += start;
+        indices += _offsets[start];
+        weights += _offsets[start];
+        values += start;
+    }
+
+    if (end<start || end<0) {
+        end = GetNumStencils();
+    }
+
+    int nstencils = end - std::max(0, start);
+    for (int i=0; i<nstencils; ++i, ++sizes) {
+
+        // Zero out the result accumulators
+        values[i].Clear();
+
+        // For each element in the array, add the coef's contribution
+        for (int j=0; j<*sizes; ++j, ++indices, ++weights) {
+            values[i].AddWithWeight( controlValues[*indices], *weights );
+        }
+    }
+}
+
+} // end namespace Far
+
+} // end namespace OPENSUBDIV_VERSION
+using namespace OPENSUBDIV_VERSION;
+
+} // end namespace OpenSubdiv
+
+#endif /* OPENSUBDIV3_FAR_STENCILTABLE_VIEW_H */
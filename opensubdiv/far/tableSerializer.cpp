@@ -0,0 +1,829 @@
+//
+//   Copyright 2019 Pixar
+//
+//   Licensed under the Apache License, Version 2.0 (the "Apache License")
+//   with the following modification; you may not use this file except in
+//   compliance with the Apache License and the following modification to it:
+//   Section 6. Trademarks. is deleted and replaced with:
+//
+//   6. Trademarks. This License does not grant permission to use the trade
+//      names, trademarks, service marks, or product names of the Licensor
+//      and its affiliates, except as required to comply with Section 4(c) of
+//      the License and to reproduce the content of the NOTICE file.
+//
+//   You may obtain a copy of the Apache License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the Apache License with the above modification is
+//   distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//   KIND, either express or implied. See the Apache License for the specific
+//   language governing permissions and limitations under the Apache License.
+//
+
+#include "../far/tableSerializer.h"
+#include "../far/error.h"
+
+#include <cstring>
+#include <istream>
+#include <limits>
+#include <ostream>
+
+namespace OpenSubdiv {
+namespace OPENSUBDIV_VERSION {
+
+namespace Far {
+
+//
+//  Layout of a serialized table:
+//
+//  The buffer starts with a Header identifying the format, its version, the
+//  byte order of the host that wrote it and the type of table it contains.
+//  The content of the table follows as a sequence of arrays, each preceded by
+//  an ArrayHeader giving its element count and size.  Headers are multiples of
+//  ALIGNMENT bytes and every array is padded to a multiple of ALIGNMENT, so the
+//  data of each array is aligned wrt the start of the buffer.  Scalar members
+//  of a table are written as a small array of ints.
+//
+//  Stencil table:
+//      scalars { numControlVertices }
+//      sizes, offsets, indices, weights
+//      (limit stencil tables only) du, dv, duu, duv, dvv weights
+//
+//  Patch table:
+//      scalars { maxValence, numPtexFaces, varyingPatchType, numPatchArrays,
+//                numFVarChannels, hasLocalPointStencils,
+//                hasLocalPointVaryingStencils }
+//      patch arrays { patchType, numPatches } for each array
+//      patch vertices, patch params, quad offsets, vertex valences,
+//      varying vertices, sharpness indices, sharpness values
+//      for each face-varying channel:
+//          scalars { interpolation, patchType, hasLocalPointStencils }
+//          patch values, patch params
+//      local point stencil tables (vertex, varying, then face-varying) when present
+//
+namespace {
+
+    char const         formatMagic[4] = { 'O', 'S', 'D', 'T' };
+    unsigned int const formatByteOrder = 0x01020304;
+
+    struct Header {
+        char         magic[4];
+        unsigned int byteOrder;
+        unsigned int version;
+        unsigned int tableType;
+        unsigned int realSize;
+        unsigned int reserved[3];
+    };
+
+    struct ArrayHeader {
+        unsigned int numElements;
+        unsigned int elementSize;
+        unsigned int reserved[2];
+    };
+
+    size_t
+    alignSize(size_t size) {
+        size_t const alignment = TableSerializer::ALIGNMENT;
+        return (size + alignment - 1) & ~(alignment - 1);
+    }
+
+    //
+    //  Writer -- appends headers and padded arrays to a stream:
+    //
+    class Writer {
+    public:
+        Writer(std::ostream & stream) : _stream(stream), _offset(0) { }
+
+        void WriteHeader(TableSerializer::TableType tableType, int realSize) {
+            Header header;
+            std::memset(&header, 0, sizeof(Header));
+            std::memcpy(header.magic, formatMagic, sizeof(formatMagic));
+            header.byteOrder = formatByteOrder;
+            header.version   = TableSerializer::VERSION;
+            header.tableType = tableType;
+            header.realSize  = realSize;
+            write(&header, sizeof(Header));
+        }
+
+        template <typename T>
+        void WriteArray(T const * elements, int numElements) {
+            ArrayHeader header;
+            std::memset(&header, 0, sizeof(ArrayHeader));
+            header.numElements = numElements;
+            header.elementSize = sizeof(T);
+            write(&header, sizeof(ArrayHeader));
+            write(elements, numElements * sizeof(T));
+            pad();
+        }
+        template <typename T>
+        void WriteArray(std::vector<T> const & elements) {
+            WriteArray(elements.empty() ? 0 : &elements[0], (int)elements.size());
+        }
+        template <typename T>
+        void WriteArray(Vtr::ConstArray<T> const & elements) {
+            WriteArray(elements.size() ? &elements[0] : 0, elements.size());
+        }
+
+        bool IsValid() const { return !_stream.fail(); }
+
+    private:
+        void write(void const * data, size_t size) {
+            if (size) {
+                _stream.write(static_cast<char const *>(data), size);
+                _offset += size;
+            }
+        }
+        void pad() {
+            static char const zeros[TableSerializer::ALIGNMENT] = { 0 };
+            write(zeros, alignSize(_offset) - _offset);
+        }
+
+        std::ostream & _stream;
+        size_t         _offset;
+    };
+
+    template <typename REAL>
+    void
+    writeStencilTable(Writer & writer, StencilTableReal<REAL> const & table) {
+
+        int scalars[] = { table.GetNumControlVertices() };
+        writer.WriteArray(scalars, 1);
+
+        writer.WriteArray(table.GetSizes());
+        writer.WriteArray(table.GetOffsets());
+        writer.WriteArray(table.GetControlIndices());
+        writer.WriteArray(table.GetWeights());
+    }
+
+    template <typename REAL>
+    void
+    writeLimitStencilTable(Writer & writer, LimitStencilTableReal<REAL> const & table) {
+
+        writeStencilTable(writer, table);
+
+        writer.WriteArray(table.GetDuWeights());
+        writer.WriteArray(table.GetDvWeights());
+        writer.WriteArray(table.GetDuuWeights());
+        writer.WriteArray(table.GetDuvWeights());
+        writer.WriteArray(table.GetDvvWeights());
+    }
+
+    void
+    writePatchTable(Writer & writer, PatchTable const & table) {
+
+        StencilTable const * vertexStencils  = table.GetLocalPointStencilTable();
+        StencilTable const * varyingStencils = table.GetLocalPointVaryingStencilTable();
+
+        int numPatchArrays  = table.GetNumPatchArrays(),
+            numFVarChannels = table.GetNumFVarChannels();
+
+        int scalars[] = { table.GetMaxValence(),
+                          table.GetNumPtexFaces(),
+                          table.GetVaryingPatchDescriptor().GetType(),
+                          numPatchArrays,
+                          numFVarChannels,
+                          vertexStencils != 0,
+                          varyingStencils != 0 };
+        writer.WriteArray(scalars, (int)(sizeof(scalars) / sizeof(int)));
+
+        std::vector<int> patchArrays(numPatchArrays * 2);
+        for (int i = 0; i < numPatchArrays; ++i) {
+            patchArrays[2*i + 0] = table.GetPatchArrayDescriptor(i).GetType();
+            patchArrays[2*i + 1] = table.GetNumPatches(i);
+        }
+        writer.WriteArray(patchArrays);
+
+        writer.WriteArray(table.GetPatchControlVerticesTable());
+        writer.WriteArray(table.GetPatchParamTable());
+        writer.WriteArray(table.GetQuadOffsetsTable());
+        writer.WriteArray(table.GetVertexValenceTable());
+        writer.WriteArray(table.GetVaryingVertices());
+        writer.WriteArray(table.GetSharpnessIndexTable());
+        writer.WriteArray(table.GetSharpnessValues());
+
+        for (int channel = 0; channel < numFVarChannels; ++channel) {
+            int channelScalars[] = {
+                table.GetFVarChannelLinearInterpolation(channel),
+                table.GetFVarPatchDescriptor(channel).GetType(),
+                table.GetLocalPointFaceVaryingStencilTable(channel) != 0 };
+            writer.WriteArray(channelScalars, 3);
+
+            writer.WriteArray(table.GetFVarValues(channel));
+            writer.WriteArray(table.GetFVarPatchParams(channel));
+        }
+
+        if (vertexStencils) {
+            writeStencilTable(writer, *vertexStencils);
+        }
+        if (varyingStencils) {
+            writeStencilTable(writer, *varyingStencils);
+        }
+        for (int channel = 0; channel < numFVarChannels; ++channel) {
+            StencilTable const * fvarStencils =
+                table.GetLocalPointFaceVaryingStencilTable(channel);
+            if (fvarStencils) {
+                writeStencilTable(writer, *fvarStencils);
+            }
+        }
+    }
+
+    bool
+    readHeader(void const * data, size_t size, Header & header) {
+
+        if (!data || (size < sizeof(Header))) return false;
+
+        std::memcpy(&header, data, sizeof(Header));
+        return std::memcmp(header.magic, formatMagic, sizeof(formatMagic)) == 0;
+    }
+
+    //  Traits to allocate the tables returned for each precision -- the
+    //  single precision tables are the classes used throughout the library:
+    template <typename REAL>
+    struct TableTypes {
+        typedef StencilTableReal<REAL>      StencilTableType;
+        typedef LimitStencilTableReal<REAL> LimitStencilTableType;
+    };
+    template <>
+    struct TableTypes<float> {
+        typedef StencilTable      StencilTableType;
+        typedef LimitStencilTable LimitStencilTableType;
+    };
+
+    template <typename REAL>
+    char const *
+    getTableName(TableSerializer::TableType tableType) {
+        switch (tableType) {
+            case TableSerializer::TABLE_STENCIL:
+                return (sizeof(REAL) == sizeof(float)) ?
+                    "ReadStencilTable" : "ReadStencilTableReal";
+            case TableSerializer::TABLE_LIMIT_STENCIL:
+                return (sizeof(REAL) == sizeof(float)) ?
+                    "ReadLimitStencilTable" : "ReadLimitStencilTableReal";
+            default:
+                return "ReadPatchTable";
+        }
+    }
+    //  Validation of the arrays read -- indices into the arrays of a table
+    //  (stencil offsets, sharpness indices) are checked against their sizes.
+    //  Indices into primvar buffers (control and patch vertices) can only be
+    //  checked to be non-negative : the size of those buffers is not part of
+    //  the table, e.g. stencils that are not factorized reference refined
+    //  vertices beyond the control vertices.
+    bool
+    validateStencils(int numStencils, int const * sizes, Index const * offsets,
+                     int numElements) {
+        for (int i = 0; i < numStencils; ++i) {
+            if ((sizes[i] < 0) || (offsets[i] < 0) ||
+                (offsets[i] > numElements - sizes[i])) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool
+    validateIndices(Index const * indices, int numIndices,
+                    Index minIndex, Index maxIndex) {
+        for (int i = 0; i < numIndices; ++i) {
+            if ((indices[i] < minIndex) || (indices[i] >= maxIndex)) {
+                return false;
+            }
+        }
+        return true;
+    }
+    bool
+    validateIndices(std::vector<Index> const & indices,
+                    Index minIndex, Index maxIndex) {
+        return indices.empty() || validateIndices(&indices[0],
+            (int)indices.size(), minIndex, maxIndex);
+    }
+
+    //  Patch descriptors must describe patches with control vertices, and the
+    //  control vertices of their patches (added to those of other patches)
+    //  must not overflow the size of an array:
+    bool
+    validatePatches(PatchDescriptor desc, int numPatches, int numVerts = 0) {
+        int numControlVertices = desc.GetNumControlVertices();
+        return (numControlVertices > 0) && (numPatches >= 0) && (numVerts >= 0) &&
+               (numPatches <= (std::numeric_limits<int>::max() - numVerts) /
+                    numControlVertices);
+    }
+
+    Index const maxVertexIndex = std::numeric_limits<Index>::max();
+} // end namespace
+
+//
+//  Reader -- validates the header and extracts arrays from a buffer:
+//
+class TableSerializer::Reader {
+public:
+    Reader(void const * data, size_t size) :
+        _data(static_cast<char const *>(data)), _size(size), _offset(0), _error(0) { }
+
+    bool ReadHeader(TableType tableType, int realSize) {
+        Header header;
+        if (!readHeader(_data, _size, header)) {
+            return fail("buffer does not contain a serialized table");
+        }
+        if (header.byteOrder != formatByteOrder) {
+            return fail("table was serialized with an incompatible byte order");
+        }
+        if (header.version != (unsigned int)VERSION) {
+            return fail("table was serialized with an unsupported version");
+        }
+        if ((header.tableType != (unsigned int)tableType) ||
+            (header.realSize != (unsigned int)realSize)) {
+            return fail("buffer contains a table of a different type");
+        }
+        _offset = sizeof(Header);
+        return true;
+    }
+
+    //  Returns the location of the next array in the buffer (no copy):
+    char const * ReadArrayData(int elementSize, int & numElements) {
+        if (_error) return 0;
+
+        ArrayHeader header;
+        if (_offset + sizeof(ArrayHeader) > _size) {
+            fail("buffer is truncated");
+            return 0;
+        }
+        std::memcpy(&header, _data + _offset, sizeof(ArrayHeader));
+        _offset += sizeof(ArrayHeader);
+
+        if (header.elementSize != (unsigned int)elementSize) {
+            fail("unexpected array element size");
+            return 0;
+        }
+        size_t arraySize = (size_t)header.numElements * header.elementSize;
+        if ((header.numElements > 0x7fffffff) || (_offset + arraySize > _size)) {
+            fail("buffer is truncated");
+            return 0;
+        }
+        char const * arrayData = _data + _offset;
+
+        _offset = alignSize(_offset + arraySize);
+        numElements = (int)header.numElements;
+        return arrayData;
+    }
+
+    template <typename T>
+    bool ReadArray(std::vector<T> & elements) {
+        int numElements = 0;
+        char const * arrayData = ReadArrayData(sizeof(T), numElements);
+        if (!arrayData) return false;
+
+        elements.resize(numElements);
+        if (numElements) {
+            std::memcpy(&elements[0], arrayData, numElements * sizeof(T));
+        }
+        return true;
+    }
+
+    //  Returns the array in place -- its elements must be aligned in memory:
+    template <typename T>
+    bool ReadArrayView(T const * & elements, int & numElements) {
+        char const * arrayData = ReadArrayData(sizeof(T), numElements);
+        if (!arrayData) return false;
+
+        if (reinterpret_cast<size_t>(arrayData) % sizeof(T)) {
+            return fail("buffer is not aligned");
+        }
+        elements = numElements ? reinterpret_cast<T const *>(arrayData) : 0;
+        return true;
+    }
+
+    template <typename T>
+    bool ReadArray(T * elements, int numElements) {
+        int numRead = 0;
+        char const * arrayData = ReadArrayData(sizeof(T), numRead);
+        if (!arrayData) return false;
+
+        if (numRead != numElements) {
+            return fail("unexpected array size");
+        }
+        if (numElements) {
+            std::memcpy(elements, arrayData, numElements * sizeof(T));
+        }
+        return true;
+    }
+
+    bool fail(char const * error) {
+        if (!_error) _error = error;
+        return false;
+    }
+
+    char const * GetError() const { return _error; }
+
+private:
+    char const * _data;
+    size_t       _size;
+    size_t       _offset;
+    char const * _error;
+};
+
+//
+//  Writing:
+//
+bool
+TableSerializer::Write(std::ostream & stream, StencilTableReal<float> const & table) {
+
+    Writer writer(stream);
+    writer.WriteHeader(TABLE_STENCIL, sizeof(float));
+    writeStencilTable(writer, table);
+    return writer.IsValid();
+}
+bool
+TableSerializer::Write(std::ostream & stream, StencilTableReal<double> const & table) {
+
+    Writer writer(stream);
+    writer.WriteHeader(TABLE_STENCIL, sizeof(double));
+    writeStencilTable(writer, table);
+    return writer.IsValid();
+}
+
+bool
+TableSerializer::Write(std::ostream & stream, LimitStencilTableReal<float> const & table) {
+
+    Writer writer(stream);
+    writer.WriteHeader(TABLE_LIMIT_STENCIL, sizeof(float));
+    writeLimitStencilTable(writer, table);
+    return writer.IsValid();
+}
+bool
+TableSerializer::Write(std::ostream & stream, LimitStencilTableReal<double> const & table) {
+
+    Writer writer(stream);
+    writer.WriteHeader(TABLE_LIMIT_STENCIL, sizeof(double));
+    writeLimitStencilTable(writer, table);
+    return writer.IsValid();
+}
+
+bool
+TableSerializer::Write(std::ostream & stream, PatchTable const & table) {
+
+    Writer writer(stream);
+    writer.WriteHeader(TABLE_PATCH, sizeof(float));
+    writePatchTable(writer, table);
+    return writer.IsValid();
+}
+
+//
+//  Reading:
+//
+TableSerializer::TableType
+TableSerializer::GetTableType(void const * data, size_t size, int * realSize) {
+
+    Header header;
+    if (!readHeader(data, size, header) || (header.byteOrder != formatByteOrder)) {
+        return TABLE_UNKNOWN;
+    }
+    if (realSize) {
+        *realSize = (int)header.realSize;
+    }
+    switch (header.tableType) {
+        case TABLE_STENCIL:       return TABLE_STENCIL;
+        case TABLE_LIMIT_STENCIL: return TABLE_LIMIT_STENCIL;
+        case TABLE_PATCH:         return TABLE_PATCH;
+        default:                  return TABLE_UNKNOWN;
+    }
+}
+
+template <typename REAL>
+bool
+TableSerializer::readStencilTable(Reader & reader, StencilTableReal<REAL> & table) {
+
+    if (!reader.ReadArray(&table._numControlVertices, 1) ||
+        !reader.ReadArray(table._sizes) ||
+        !reader.ReadArray(table._offsets) ||
+        !reader.ReadArray(table._indices) ||
+        !reader.ReadArray(table._weights)) {
+        return false;
+    }
+
+    //  The factories may leave unused weights at the end of the table, so
+    //  only require a weight for each index:
+    if ((table._sizes.size() != table._offsets.size()) ||
+        (table._indices.size() > table._weights.size())) {
+        return reader.fail("inconsistent stencil table arrays");
+    }
+    if (!table._sizes.empty() &&
+        !validateStencils((int)table._sizes.size(), &table._sizes[0],
+            &table._offsets[0], (int)table._indices.size())) {
+        return reader.fail("stencil out of range");
+    }
+    if ((table._numControlVertices < 0) ||
+        !validateIndices(table._indices, 0, maxVertexIndex)) {
+        return reader.fail("control vertex index out of range");
+    }
+    return true;
+}
+
+template <typename REAL>
+bool
+TableSerializer::readLimitStencilTable(Reader & reader, LimitStencilTableReal<REAL> & table) {
+
+    if (!readStencilTable(reader, table) ||
+        !reader.ReadArray(table._duWeights) ||
+        !reader.ReadArray(table._dvWeights) ||
+        !reader.ReadArray(table._duuWeights) ||
+        !reader.ReadArray(table._duvWeights) ||
+        !reader.ReadArray(table._dvvWeights)) {
+        return false;
+    }
+
+    size_t numElements = table._indices.size();
+    if ((!table._duWeights.empty()  && (table._duWeights.size()  < numElements)) ||
+        (!table._dvWeights.empty()  && (table._dvWeights.size()  < numElements)) ||
+        (!table._duuWeights.empty() && (table._duuWeights.size() < numElements)) ||
+        (!table._duvWeights.empty() && (table._duvWeights.size() < numElements)) ||
+        (!table._dvvWeights.empty() && (table._dvvWeights.size() < numElements))) {
+        return reader.fail("inconsistent limit stencil table arrays");
+    }
+    return true;
+}
+
+bool
+TableSerializer::readPatchTable(Reader & reader, PatchTable *& tablePtr) {
+
+    int scalars[7];
+    if (!reader.ReadArray(scalars, 7)) return false;
+
+    PatchDescriptor varyingDesc(scalars[2]);
+    if (!validatePatches(varyingDesc, 0)) {
+        return reader.fail("invalid varying patch descriptor");
+    }
+
+    //  The table is returned to the caller as soon as it is allocated, to be
+    //  released if reading fails below:
+    tablePtr = new PatchTable(scalars[0], varyingDesc);
+
+    PatchTable & table = *tablePtr;
+
+    table._numPtexFaces = scalars[1];
+
+    int numPatchArrays  = scalars[3],
+        numFVarChannels = scalars[4];
+
+    bool hasVertexStencils  = scalars[5] != 0,
+         hasVaryingStencils = scalars[6] != 0;
+
+    //  Patch arrays are rebuilt as the factory assembles them -- contiguously
+    //  and in order:
+    std::vector<int> patchArrays;
+    if (!reader.ReadArray(patchArrays)) return false;
+
+    if ((numPatchArrays < 0) || ((int)patchArrays.size() != 2 * numPatchArrays)) {
+        return reader.fail("inconsistent patch arrays");
+    }
+
+    table.reservePatchArrays(numPatchArrays);
+
+    int numPatches = 0,
+        numPatchVerts = 0;
+    for (int i = 0, voffset = 0, poffset = 0, qoffset = 0; i < numPatchArrays; ++i) {
+        PatchDescriptor desc(patchArrays[2*i + 0]);
+        int             npatches = patchArrays[2*i + 1];
+        if ((npatches <= 0) ||
+            (npatches > std::numeric_limits<int>::max() - numPatches) ||
+            !validatePatches(desc, npatches, numPatchVerts)) {
+            return reader.fail("inconsistent patch arrays");
+        }
+        table.pushPatchArray(desc, npatches, &voffset, &poffset, &qoffset);
+
+        numPatches    += npatches;
+        numPatchVerts += npatches * desc.GetNumControlVertices();
+    }
+
+    if (!reader.ReadArray(table._patchVerts) ||
+        !reader.ReadArray(table._paramTable) ||
+        !reader.ReadArray(table._quadOffsetsTable) ||
+        !reader.ReadArray(table._vertexValenceTable) ||
+        !reader.ReadArray(table._varyingVerts) ||
+        !reader.ReadArray(table._sharpnessIndices) ||
+        !reader.ReadArray(table._sharpnessValues)) {
+        return false;
+    }
+    if (((int)table._patchVerts.size() != numPatchVerts) ||
+        ((int)table._paramTable.size() != numPatches)) {
+        return reader.fail("inconsistent patch arrays");
+    }
+    //  Varying vertices are either absent or given for each patch:
+    if (!table._varyingVerts.empty() &&
+        (!validatePatches(varyingDesc, numPatches) ||
+         ((int)table._varyingVerts.size() !=
+              numPatches * varyingDesc.GetNumControlVertices()))) {
+        return reader.fail("inconsistent varying patch vertices");
+    }
+    if (!validateIndices(table._patchVerts, 0, maxVertexIndex) ||
+        !validateIndices(table._varyingVerts, 0, maxVertexIndex)) {
+        return reader.fail("patch vertex index out of range");
+    }
+
+    //  Sharpness indices are either absent or given for each patch, and refer
+    //  to the sharpness values (INDEX_INVALID for smooth patches):
+    if ((!table._sharpnessIndices.empty() &&
+         ((int)table._sharpnessIndices.size() != numPatches)) ||
+        !validateIndices(table._sharpnessIndices, INDEX_INVALID,
+            (Index)table._sharpnessValues.size())) {
+        return reader.fail("sharpness index out of range");
+    }
+
+    if (numFVarChannels < 0) {
+        return reader.fail("inconsistent face-varying channels");
+    }
+    table.allocateFVarPatchChannels(numFVarChannels);
+
+    std::vector<bool> hasFVarStencils(numFVarChannels, false);
+    for (int channel = 0; channel < numFVarChannels; ++channel) {
+        int channelScalars[3];
+        if (!reader.ReadArray(channelScalars, 3)) return false;
+
+        table.setFVarPatchChannelLinearInterpolation(
+            (Sdc::Options::FVarLinearInterpolation)channelScalars[0], channel);
+        hasFVarStencils[channel] = channelScalars[2] != 0;
+
+        //  Sizes of the channel's arrays are known from its descriptor and the
+        //  number of patches in the table:
+        PatchDescriptor desc(channelScalars[1]);
+        if (!validatePatches(desc, numPatches)) {
+            return reader.fail("invalid face-varying patch descriptor");
+        }
+        table.allocateFVarPatchChannelValues(desc, numPatches, channel);
+
+        IndexArray      values = table.getFVarValues(channel);
+        PatchParamArray params = table.getFVarPatchParams(channel);
+        if (!reader.ReadArray(values.size() ? &values[0] : (Index *)0, values.size()) ||
+            !reader.ReadArray(params.size() ? &params[0] : (PatchParam *)0, params.size())) {
+            return false;
+        }
+        if (values.size() &&
+            !validateIndices(&values[0], values.size(), 0, maxVertexIndex)) {
+            return reader.fail("face-varying value index out of range");
+        }
+    }
+
+    //  Local point stencil tables are owned by the patch table, which releases
+    //  them on destruction (including when reading fails below):
+    if (hasVertexStencils) {
+        StencilTable * stencils = new StencilTable();
+        table._localPointStencils = stencils;
+        if (!readStencilTable(reader, *stencils)) return false;
+    }
+    if (hasVaryingStencils) {
+        StencilTable * stencils = new StencilTable();
+        table._localPointVaryingStencils = stencils;
+        if (!readStencilTable(reader, *stencils)) return false;
+    }
+    for (int channel = 0; channel < numFVarChannels; ++channel) {
+        if (hasFVarStencils[channel]) {
+            if (table._localPointFaceVaryingStencils.empty()) {
+                table._localPointFaceVaryingStencils.resize(numFVarChannels, 0);
+            }
+            StencilTable * stencils = new StencilTable();
+            table._localPointFaceVaryingStencils[channel] = stencils;
+            if (!readStencilTable(reader, *stencils)) return false;
+        }
+    }
+    return true;
+}
+
+template <typename REAL>
+StencilTableReal<REAL> const *
+TableSerializer::ReadStencilTableReal(void const * data, size_t size) {
+
+    typedef typename TableTypes<REAL>::StencilTableType Table;
+
+    Reader reader(data, size);
+
+    Table * table = new Table();
+    if (!reader.ReadHeader(TABLE_STENCIL, sizeof(REAL)) ||
+        !readStencilTable<REAL>(reader, *table)) {
+        Error(FAR_RUNTIME_ERROR, "Failure in TableSerializer::%s() -- %s.",
+            getTableName<REAL>(TABLE_STENCIL), reader.GetError());
+        delete table;
+        return NULL;
+    }
+    return table;
+}
+
+template <typename REAL>
+LimitStencilTableReal<REAL> const *
+TableSerializer::ReadLimitStencilTableReal(void const * data, size_t size) {
+
+    typedef typename TableTypes<REAL>::LimitStencilTableType Table;
+
+    Reader reader(data, size);
+
+    Table * table = new Table();
+    if (!reader.ReadHeader(TABLE_LIMIT_STENCIL, sizeof(REAL)) ||
+        !readLimitStencilTable<REAL>(reader, *table)) {
+        Error(FAR_RUNTIME_ERROR, "Failure in TableSerializer::%s() -- %s.",
+            getTableName<REAL>(TABLE_LIMIT_STENCIL), reader.GetError());
+        delete table;
+        return NULL;
+    }
+    return table;
+}
+
+template <typename REAL>
+bool
+TableSerializer::ReadStencilTableViewReal(void const * data, size_t size,
+                                          StencilTableViewReal<REAL> & view) {
+
+    Reader reader(data, size);
+
+    int const   * sizes = 0;
+    Index const * offsets = 0,
+                * indices = 0;
+    REAL const  * weights = 0;
+
+    int numControlVertices = 0,
+        numStencils = 0,
+        numOffsets = 0,
+        numIndices = 0,
+        numWeights = 0;
+
+    if (reader.ReadHeader(TABLE_STENCIL, sizeof(REAL)) &&
+        reader.ReadArray(&numControlVertices, 1) &&
+        reader.ReadArrayView(sizes, numStencils) &&
+        reader.ReadArrayView(offsets, numOffsets) &&
+        reader.ReadArrayView(indices, numIndices) &&
+        reader.ReadArrayView(weights, numWeights)) {
+
+        if ((numStencils != numOffsets) || (numIndices > numWeights)) {
+            reader.fail("inconsistent stencil table arrays");
+        } else if (!validateStencils(numStencils, sizes, offsets, numIndices)) {
+            reader.fail("stencil out of range");
+        } else if ((numControlVertices < 0) ||
+            !validateIndices(indices, numIndices, 0, maxVertexIndex)) {
+            reader.fail("control vertex index out of range");
+        }
+    }
+    if (reader.GetError()) {
+        Error(FAR_RUNTIME_ERROR, "Failure in TableSerializer::%s() -- %s.",
+            (sizeof(REAL) == sizeof(float)) ?
+                "ReadStencilTableView" : "ReadStencilTableViewReal",
+            reader.GetError());
+        return false;
+    }
+
+    view = StencilTableViewReal<REAL>(numControlVertices, numStencils,
+        sizes, offsets, numIndices, indices, weights);
+    return true;
+}
+
+PatchTable *
+TableSerializer::ReadPatchTable(void const * data, size_t size) {
+
+    Reader reader(data, size);
+
+    PatchTable * table = 0;
+    if (!reader.ReadHeader(TABLE_PATCH, sizeof(float)) ||
+        !readPatchTable(reader, table)) {
+        Error(FAR_RUNTIME_ERROR, "Failure in TableSerializer::ReadPatchTable() -- %s.",
+            reader.GetError());
+        delete table;
+        return NULL;
+    }
+    return table;
+}
+
+bool
+TableSerializer::ReadStream(std::istream & stream, std::vector<char> & buffer) {
+
+    buffer.clear();
+
+    char chunk[64 * 1024];
+    while (stream.read(chunk, sizeof(chunk)) || (stream.gcount() > 0)) {
+        buffer.insert(buffer.end(), chunk, chunk + stream.gcount());
+    }
+    return !stream.bad();
+}
+
+//
+//  Explicit instantiation for the supported precisions:
+//
+template StencilTableReal<float> const *
+TableSerializer::ReadStencilTableReal<float>(void const *, size_t);
+template StencilTableReal<double> const *
+TableSerializer::ReadStencilTableReal<double>(void const *, size_t);
+
+template LimitStencilTableReal<float> const *
+TableSerializer::ReadLimitStencilTableReal<float>(void const *, size_t);
+template LimitStencilTableReal<double> const *
+TableSerializer::ReadLimitStencilTableReal<double>(void const *, size_t);
+
+template bool
+TableSerializer::ReadStencilTableViewReal<float>(void const *, size_t,
+    StencilTableViewReal<float> &);
+template bool
+TableSerializer::ReadStencilTableViewReal<double>(void const *, size_t,
+    StencilTableViewReal<double> &);
+
+} // end namespace Far
+
+} // end namespace OPENSUBDIV_VERSION
+} // end namespace OpenSubdiv
@@ -0,0 +1,193 @@
+//
+//   Copyright 2019 Pixar
+//
+//   Licensed under the Apache License, Version 2.0 (the "Apache License")
+//   with the following modification; you may not use this file except in
+//   compliance with the Apache License and the following modification to it:
+//   Section 6. Trademarks. is deleted and replaced with:
+//
+//   6. Trademarks. This License does not grant permission to use the trade
+//      names, trademarks, service marks, or product names of the Licensor
+//      and its affiliates, except as required to comply with Section 4(c) of
+//      the License and to reproduce the content of the NOTICE file.
+//
+//   You may obtain a copy of the Apache License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the Apache License with the above modification is
+//   distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//   KIND, either express or implied. See the Apache License for the specific
+//   language governing permissions and limitations under the Apache License.
+//
+#ifndef OPENSUBDIV3_FAR_TABLE_SERIALIZER_H
+#define OPENSUBDIV3_FAR_TABLE_SERIALIZER_H
+
+#include "../version.h"
+
+#include "../far/patchTable.h"
+#include "../far/stencilTable.h"
+#include "../far/stencilTableView.h"
+
+#include <cstddef>
+#include <iosfwd>
+#include <vector>
+
+namespace OpenSubdiv {
+namespace OPENSUBDIV_VERSION {
+
+namespace Far {
+
+/// \brief Binary serialization of stencil and patch tables
+///
+/// Tables depend only on the topology they were built from, so they can be
+/// built once, written to disk and read back by any process refining the same
+/// topology (see also Far::TopologyRefiner).
+///
+/// The format is a versioned, native-endian binary layout : a fixed size
+/// header followed by the arrays of the table, each preceded by its element
+/// count and size and aligned to TableSerializer::ALIGNMENT bytes from the
+/// start of the buffer. A file mapped into memory can therefore be read in
+/// place, and each array is loaded into its table with a single copy.
+///
+/// The Read methods report malformed or incompatible buffers through
+/// Far::Error() and return NULL.
+///
+class TableSerializer {
+
+public:
+
+    /// \brief Alignment (in bytes) of each array within a serialized buffer
+    enum { ALIGNMENT = 16 };
+
+    /// \brief Version of the format written by this library
+    enum { VERSION = 1 };
+
+    /// \brief Type of table held by a serialized buffer
+    enum TableType {
+        TABLE_UNKNOWN = 0,
+        TABLE_STENCIL,        ///< StencilTable (float or double)
+        TABLE_LIMIT_STENCIL,  ///< LimitStencilTable (float or double)
+        TABLE_PATCH           ///< PatchTable
+    };
+
+    /// \brief Returns the type of table held by the serialized buffer, or
+    /// TABLE_UNKNOWN if the buffer does not start with a valid header
+    ///
+    /// @param data       Start of the serialized buffer
+    ///
+    /// @param size       Size of the buffer in bytes
+    ///
+    /// @param realSize   Optional : size of the table's floating point type
+    ///
+    static TableType GetTableType(void const * data, size_t size,
+                                  int * realSize = 0);
+
+    //@{
+    /// \brief Writes a table to a binary stream
+    ///
+    /// @param stream  Destination stream (opened in binary mode)
+    ///
+    /// @param table   Table to serialize
+    ///
+    /// @return        False if writing to the stream failed
+    ///
+    static bool Write(std::ostream & stream, StencilTableReal<float> const & table);
+    static bool Write(std::ostream & stream, StencilTableReal<double> const & table);
+
+    static bool Write(std::ostream & stream, LimitStencilTableReal<float> const & table);
+    static bool Write(std::ostream & stream, LimitStencilTableReal<double> const & table);
+
+    static bool Write(std::ostream & stream, PatchTable const & table);
+    //@}
+
+    /// \brief Reads a StencilTable from a serialized buffer
+    ///
+    /// @param data  Start of the serialized buffer (e.g. a memory mapped file)
+    ///
+    /// @param size  Size of the buffer in bytes
+    ///
+    static StencilTable const * ReadStencilTable(void const * data, size_t size) {
+        return static_cast<StencilTable const *>(
+            ReadStencilTableReal<float>(data, size));
+    }
+
+    /// \brief Reads a LimitStencilTable from a serialized buffer
+    static LimitStencilTable const * ReadLimitStencilTable(void const * data, size_t size) {
+        return static_cast<LimitStencilTable const *>(
+            ReadLimitStencilTableReal<float>(data, size));
+    }
+
+    /// \brief Reads a PatchTable from a serialized buffer
+    static PatchTable * ReadPatchTable(void const * data, size_t size);
+
+    /// \brief Reads a stencil table of the given precision from a serialized
+    /// buffer (see ReadStencilTable)
+    template <typename REAL>
+    static StencilTableReal<REAL> const * ReadStencilTableReal(
+        void const * data, size_t size);
+
+    /// \brief Reads a limit stencil table of the given precision from a
+    /// serialized buffer (see ReadStencilTable)
+    template <typename REAL>
+    static LimitStencilTableReal<REAL> const * ReadLimitStencilTableReal(
+        void const * data, size_t size);
+
+    /// \brief Initializes a view of the stencil table serialized in a buffer
+    ///
+    /// Unlike ReadStencilTable(), the arrays of the table are not copied : the
+    /// view references them in place, so the buffer (typically a read-only
+    /// memory mapped file shared between processes) must remain valid for the
+    /// lifetime of the view.  The buffer must be aligned to ALIGNMENT bytes.
+    ///
+    /// @param data  Start of the serialized buffer
+    ///
+    /// @param size  Size of the buffer in bytes
+    ///
+    /// @param view  View initialized on success
+    ///
+    /// @return      False if the buffer does not hold a valid stencil table
+    ///
+    static bool ReadStencilTableView(void const * data, size_t size,
+                                     StencilTableView & view) {
+        return ReadStencilTableViewReal<float>(data, size, view);
+    }
+
+    /// \brief Initializes a view of the stencil table of the given precision
+    /// serialized in a buffer (see ReadStencilTableView)
+    template <typename REAL>
+    static bool ReadStencilTableViewReal(void const * data, size_t size,
+                                         StencilTableViewReal<REAL> & view);
+
+    /// \brief Reads the remaining content of a binary stream into a buffer
+    /// suitable for the Read methods above
+    ///
+    /// @param stream  Source stream (opened in binary mode)
+    ///
+    /// @param buffer  Destination buffer, resized to the content of the stream
+    ///
+    /// @return        False if reading from the stream failed
+    ///
+    static bool ReadStream(std::istream & stream, std::vector<char> & buffer);
+
+private:
+    class Reader;
+
+    template <typename REAL>
+    static bool readStencilTable(Reader & reader, StencilTableReal<REAL> & table);
+
+    template <typename REAL>
+    static bool readLimitStencilTable(Reader & reader, LimitStencilTableReal<REAL> & table);
+
+    static bool readPatchTable(Reader & reader, PatchTable *& table);
+};
+
+} // end namespace Far
+
+} // end namespace OPENSUBDIV_VERSION
+using namespace OPENSUBDIV_VERSION;
+
+} // end namespace OpenSubdiv
+
+#endif /* OPENSUBDIV3_FAR_TABLE_SERIALIZER_H */
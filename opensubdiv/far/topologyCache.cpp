@@ -0,0 +1,408 @@
+//
+//   Copyright 2019 Pixar
+//
+//   Licensed under the Apache License, Version 2.0 (the "Apache License")
+//   with the following modification; you may not use this file except in
+//   compliance with the Apache License and the following modification to it:
+//   Section 6. Trademarks. is deleted and replaced with:
+//
+//   6. Trademarks. This License does not grant permission to use the trade
+//      names, trademarks, service marks, or product names of the Licensor
+//      and its affiliates, except as required to comply with Section 4(c) of
+//      the License and to reproduce the content of the NOTICE file.
+//
+//   You may obtain a copy of the Apache License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the Apache License with the above modification is
+//   distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//   KIND, either express or implied. See the Apache License for the specific
+//   language governing permissions and limitations under the Apache License.
+//
+
+#include "../far/topologyCache.h"
+
+#include <cassert>
+#include <cstring>
+
+#if defined(_WIN32)
+    #ifndef WIN32_LEAN_AND_MEAN
+        #define WIN32_LEAN_AND_MEAN
+    #endif
+    #ifndef NOMINMAX
+        #define NOMINMAX
+    #endif
+    #include <windows.h>
+#else
+    #include <pthread.h>
+#endif
+
+namespace OpenSubdiv {
+namespace OPENSUBDIV_VERSION {
+
+namespace Far {
+
+//
+//  Lock -- guards the map of entries. The cache is shared by client threads
+//  of any kind (not only those of OpenMP), so a mutex of the platform is used:
+//
+class TopologyCache::Lock {
+public:
+#if defined(_WIN32)
+    Lock()  { InitializeCriticalSection(&_lock); }
+    ~Lock() { DeleteCriticalSection(&_lock); }
+
+    void Acquire() { EnterCriticalSection(&_lock); }
+    void Release() { LeaveCriticalSection(&_lock); }
+
+private:
+    CRITICAL_SECTION _lock;
+#else
+    Lock()  { pthread_mutex_init(&_lock, 0); }
+    ~Lock() { pthread_mutex_destroy(&_lock); }
+
+    void Acquire() { pthread_mutex_lock(&_lock); }
+    void Release() { pthread_mutex_unlock(&_lock); }
+
+private:
+    pthread_mutex_t _lock;
+#endif
+
+public:
+    //  Holds the lock for the lifetime of the scope:
+    class Scope {
+    public:
+        Scope(Lock & lock) : _lock(lock) { _lock.Acquire(); }
+        ~Scope() { _lock.Release(); }
+    private:
+        Lock & _lock;
+    };
+};
+
+namespace {
+    //
+    //  The key of an entry is a copy of all data identifying the topology and
+    //  its tables, flattened to a vector of ints:
+    //
+    class KeyBuilder {
+    public:
+        KeyBuilder(std::vector<int> & key) : _key(key) { }
+
+        void Add(int value) { _key.push_back(value); }
+
+        void Add(float value) {
+            int bits;
+            std::memcpy(&bits, &value, sizeof(int));
+            _key.push_back(bits);
+        }
+
+        template <typename T>
+        void AddArray(T const * values, int numValues) {
+            if (values == 0) numValues = 0;
+
+            Add(numValues);
+            for (int i = 0; i < numValues; ++i) {
+                Add(values[i]);
+            }
+        }
+
+    private:
+        std::vector<int> & _key;
+    };
+} // end namespace
+
+//
+//  Entries:
+//
+TopologyCache::Entry::Entry() :
+    _refiner(0), _patchTable(0), _stencilTable(0), _refCount(0), _lastUse(0) {
+}
+
+TopologyCache::Entry::~Entry() {
+    delete _stencilTable;
+    delete _patchTable;
+    delete _refiner;
+}
+
+//
+//  Cache:
+//
+TopologyCache::TopologyCache(int maxUnusedEntries) :
+    _maxUnusedEntries(maxUnusedEntries), _useCount(0), _lock(new Lock) {
+}
+
+TopologyCache::~TopologyCache() {
+
+    for (EntryMap::iterator it = _entries.begin(); it != _entries.end(); ++it) {
+        assert(it->second->_refCount == 0);
+        delete it->second;
+    }
+    delete _lock;
+}
+
+void
+TopologyCache::getKey(TopologyDescriptor const & desc,
+                      Options const & options, std::vector<int> & key) {
+
+    KeyBuilder builder(key);
+
+    //  Options (excluding those that do not affect the resulting tables, such
+    //  as the use of multiple threads):
+    builder.Add((int)options.schemeType);
+    builder.Add((int)options.schemeOptions.GetVtxBoundaryInterpolation());
+    builder.Add((int)options.schemeOptions.GetFVarLinearInterpolation());
+    builder.Add((int)options.schemeOptions.GetCreasingMethod());
+    builder.Add((int)options.schemeOptions.GetTriangleSubdivision());
+
+    builder.Add((int)options.adaptive);
+    if (options.adaptive) {
+        TopologyRefiner::AdaptiveOptions const & adaptive = options.adaptiveOptions;
+        builder.Add((int)adaptive.isolationLevel);
+        builder.Add((int)adaptive.secondaryLevel);
+        builder.Add((int)adaptive.useSingleCreasePatch);
+        builder.Add((int)adaptive.useInfSharpPatch);
+        builder.Add((int)adaptive.considerFVarChannels);
+        builder.Add((int)adaptive.orderVerticesFromFacesFirst);
+    } else {
+        TopologyRefiner::UniformOptions const & uniform = options.uniformOptions;
+        builder.Add((int)uniform.refinementLevel);
+        builder.Add((int)uniform.orderVerticesFromFacesFirst);
+        builder.Add((int)uniform.fullTopologyInLastLevel);
+    }
+
+    builder.Add((int)options.generatePatchTable);
+    if (options.generatePatchTable) {
+        PatchTableFactory::Options const & patch = options.patchTableOptions;
+        builder.Add((int)patch.generateAllLevels);
+        builder.Add((int)patch.triangulateQuads);
+        builder.Add((int)patch.useSingleCreasePatch);
+        builder.Add((int)patch.useInfSharpPatch);
+        builder.Add((int)patch.maxIsolationLevel);
+        builder.Add((int)patch.endCapType);
+        builder.Add((int)patch.shareEndCapPatchPoints);
+        builder.Add((int)patch.generateFVarTables);
+        builder.Add((int)patch.generateFVarLegacyLinearPatches);
+        builder.Add((int)patch.generateLegacySharpCornerPatches);
+        builder.Add(patch.numFVarChannels);
+        builder.AddArray(patch.fvarChannelIndices, patch.numFVarChannels);
+    }
+
+    builder.Add((int)options.generateStencilTable);
+    if (options.generateStencilTable) {
+        StencilTableFactory::Options const & stencil = options.stencilTableOptions;
+        builder.Add((int)stencil.interpolationMode);
+        builder.Add((int)stencil.generateOffsets);
+        builder.Add((int)stencil.generateControlVerts);
+        builder.Add((int)stencil.generateIntermediateLevels);
+        builder.Add((int)stencil.factorizeIntermediateLevels);
+        builder.Add((int)stencil.maxLevel);
+        builder.Add((int)stencil.fvarChannel);
+    }
+
+    //  Topology:
+    int numFaceVerts = 0;
+    if (desc.numVertsPerFace) {
+        for (int i = 0; i < desc.numFaces; ++i) {
+            numFaceVerts += desc.numVertsPerFace[i];
+        }
+    }
+    builder.Add(desc.numVertices);
+    builder.AddArray(desc.numVertsPerFace, desc.numFaces);
+    builder.AddArray(desc.vertIndicesPerFace, numFaceVerts);
+
+    builder.AddArray(desc.creaseVertexIndexPairs, 2 * desc.numCreases);
+    builder.AddArray(desc.creaseWeights, desc.numCreases);
+    builder.AddArray(desc.cornerVertexIndices, desc.numCorners);
+    builder.AddArray(desc.cornerWeights, desc.numCorners);
+    builder.AddArray(desc.holeIndices, desc.numHoles);
+    builder.Add((int)desc.isLeftHanded);
+
+    int numFVarChannels = desc.fvarChannels ? desc.numFVarChannels : 0;
+    builder.Add(numFVarChannels);
+    for (int i = 0; i < numFVarChannels; ++i) {
+        builder.Add(desc.fvarChannels[i].numValues);
+        builder.AddArray(desc.fvarChannels[i].valueIndices, numFaceVerts);
+    }
+}
+
+size_t
+TopologyCache::getHash(std::vector<int> const & key) {
+
+    size_t hash = key.size();
+    for (int i = 0; i < (int)key.size(); ++i) {
+        hash ^= (size_t)(unsigned int)key[i] + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+    }
+    return hash;
+}
+
+size_t
+TopologyCache::GetHash(TopologyDescriptor const & descriptor, Options const & options) {
+
+    std::vector<int> key;
+    getKey(descriptor, options, key);
+    return getHash(key);
+}
+
+TopologyCache::Entry *
+TopologyCache::createEntry(TopologyDescriptor const & descriptor,
+                           Options const & options) {
+
+    typedef TopologyRefinerFactory<TopologyDescriptor> RefinerFactory;
+
+    TopologyRefiner * refiner = RefinerFactory::Create(descriptor,
+        RefinerFactory::Options(options.schemeType, options.schemeOptions));
+    if (refiner == 0) {
+        return 0;
+    }
+
+    if (options.adaptive) {
+        refiner->RefineAdaptive(options.adaptiveOptions);
+    } else {
+        refiner->RefineUniform(options.uniformOptions);
+    }
+
+    Entry * entry = new Entry;
+    entry->_refiner = refiner;
+
+    if (options.generatePatchTable) {
+        entry->_patchTable =
+            PatchTableFactory::Create(*refiner, options.patchTableOptions);
+    }
+
+    if (options.generateStencilTable) {
+        StencilTable const * stencilTable =
+            StencilTableFactory::Create(*refiner, options.stencilTableOptions);
+
+        //  Append the local points of the patch table, so that all of its
+        //  control points can be computed from a single table:
+        if (entry->_patchTable && entry->_patchTable->GetLocalPointStencilTable()) {
+            if (StencilTable const * stencilTableWithLocalPoints =
+                StencilTableFactory::AppendLocalPointStencilTable(*refiner,
+                    stencilTable, entry->_patchTable->GetLocalPointStencilTable())) {
+                delete stencilTable;
+                stencilTable = stencilTableWithLocalPoints;
+            }
+        }
+        entry->_stencilTable = stencilTable;
+    }
+    return entry;
+}
+
+TopologyCache::Entry *
+TopologyCache::findEntry(size_t hash, std::vector<int> const & key) const {
+
+    std::pair<EntryMap::const_iterator, EntryMap::const_iterator> range =
+        _entries.equal_range(hash);
+
+    for (EntryMap::const_iterator it = range.first; it != range.second; ++it) {
+        if (it->second->_key == key) {
+            return it->second;
+        }
+    }
+    return 0;
+}
+
+TopologyCache::Entry const *
+TopologyCache::Acquire(TopologyDescriptor const & descriptor, Options const & options) {
+
+    std::vector<int> key;
+    getKey(descriptor, options, key);
+
+    size_t hash = getHash(key);
+    {
+        Lock::Scope scope(*_lock);
+
+        if (Entry * entry = findEntry(hash, key)) {
+            ++entry->_refCount;
+            entry->_lastUse = ++_useCount;
+            return entry;
+        }
+    }
+
+    //  Build the entry without holding the lock -- if another thread inserted
+    //  the same entry in the meantime, its entry is used and this one discarded:
+    Entry * newEntry = createEntry(descriptor, options);
+    if (newEntry == 0) {
+        return 0;
+    }
+
+    Entry * entry = 0;
+    {
+        Lock::Scope scope(*_lock);
+
+        entry = findEntry(hash, key);
+        if (entry == 0) {
+            entry = newEntry;
+            entry->_key.swap(key);
+            _entries.insert(EntryMap::value_type(hash, entry));
+            newEntry = 0;
+        }
+        ++entry->_refCount;
+        entry->_lastUse = ++_useCount;
+    }
+    delete newEntry;
+    return entry;
+}
+
+void
+TopologyCache::Release(Entry const * entry) {
+
+    if (entry == 0) return;
+
+    Lock::Scope scope(*_lock);
+
+    assert(entry->_refCount > 0);
+    --const_cast<Entry *>(entry)->_refCount;
+
+    if (entry->_refCount == 0) {
+        evictUnusedEntries(_maxUnusedEntries);
+    }
+}
+
+void
+TopologyCache::Clear() {
+
+    Lock::Scope scope(*_lock);
+
+    evictUnusedEntries(0);
+}
+
+int
+TopologyCache::GetNumEntries() const {
+
+    Lock::Scope scope(*_lock);
+
+    return (int)_entries.size();
+}
+
+void
+TopologyCache::evictUnusedEntries(int maxUnusedEntries) {
+
+    //  Evict the least recently used of the entries no longer acquired:
+    for (;;) {
+        int numUnused = 0;
+        EntryMap::iterator lru = _entries.end();
+
+        for (EntryMap::iterator it = _entries.begin(); it != _entries.end(); ++it) {
+            if (it->second->_refCount == 0) {
+                if ((lru == _entries.end()) ||
+                    (it->second->_lastUse < lru->second->_lastUse)) {
+                    lru = it;
+                }
+                ++numUnused;
+            }
+        }
+        if (numUnused <= maxUnusedEntries) {
+            break;
+        }
+        delete lru->second;
+        _entries.erase(lru);
+    }
+}
+
+} // end namespace Far
+
+} // end namespace OPENSUBDIV_VERSION
+} // end namespace OpenSubdiv
@@ -0,0 +1,197 @@
+//
+//   Copyright 2019 Pixar
+//
+//   Licensed under the Apache License, Version 2.0 (the "Apache License")
+//   with the following modification; you may not use this file except in
+//   compliance with the Apache License and the following modification to it:
+//   Section 6. Trademarks. is deleted and replaced with:
+//
+//   6. Trademarks. This License does not grant permission to use the trade
+//      names, trademarks, service marks, or product names of the Licensor
+//      and its affiliates, except as required to comply with Section 4(c) of
+//      the License and to reproduce the content of the NOTICE file.
+//
+//   You may obtain a copy of the Apache License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the Apache License with the above modification is
+//   distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//   KIND, either express or implied. See the Apache License for the specific
+//   language governing permissions and limitations under the Apache License.
+//
+#ifndef OPENSUBDIV3_FAR_TOPOLOGY_CACHE_H
+#define OPENSUBDIV3_FAR_TOPOLOGY_CACHE_H
+
+#include "../version.h"
+
+#include "../sdc/options.h"
+#include "../sdc/types.h"
+#include "../far/patchTable.h"
+#include "../far/patchTableFactory.h"
+#include "../far/stencilTable.h"
+#include "../far/stencilTableFactory.h"
+#include "../far/topologyDescriptor.h"
+#include "../far/topologyRefiner.h"
+
+#include <cstddef>
+#include <map>
+#include <vector>
+
+namespace OpenSubdiv {
+namespace OPENSUBDIV_VERSION {
+
+namespace Far {
+
+/// \brief Cache of refiners and tables shared between meshes of identical
+///        topology
+///
+/// Scenes often contain many meshes sharing the same topology (instanced
+/// geometry, crowds...) for which the same refiner, patch table and stencil
+/// table would otherwise be rebuilt for each mesh.  The cache identifies a
+/// topology by the contents of its TopologyDescriptor and by the options used
+/// to refine it and to build its tables, and returns the same immutable tables
+/// for all meshes with identical contents.
+///
+/// Entries are reference counted : Acquire() returns an entry that remains
+/// valid until it is passed to Release().  Released entries are kept for later
+/// reuse, the least recently used being evicted once their number exceeds the
+/// limit given to the cache.
+///
+/// Acquire() and Release() may be called concurrently from any threads.
+/// Tables are built outside of the cache lock, so that different topologies
+/// are built concurrently.
+///
+class TopologyCache {
+
+public:
+
+    /// \brief Options identifying the tables built for a topology
+    struct Options {
+
+        Options() :
+            schemeType(Sdc::SCHEME_CATMARK),
+            adaptive(true),
+            generatePatchTable(true),
+            generateStencilTable(true),
+            uniformOptions(2),
+            adaptiveOptions(2) { }
+
+        Sdc::SchemeType  schemeType;      ///< Subdivision scheme
+        Sdc::Options     schemeOptions;   ///< Subdivision options
+
+        unsigned int adaptive             : 1, ///< Refine adaptively (uniformly otherwise)
+                     generatePatchTable   : 1, ///< Build a PatchTable
+                     generateStencilTable : 1; ///< Build a StencilTable for vertex primvars
+                                               ///< (including the local points of the
+                                               ///< patch table when present)
+
+        TopologyRefiner::UniformOptions  uniformOptions;   ///< Uniform refinement options
+        TopologyRefiner::AdaptiveOptions adaptiveOptions;  ///< Adaptive refinement options
+
+        PatchTableFactory::Options       patchTableOptions;   ///< PatchTable options
+        StencilTableFactory::Options     stencilTableOptions; ///< StencilTable options
+    };
+
+    /// \brief Shared refiner and tables of a topology
+    class Entry {
+    public:
+        /// \brief Returns the refiner of the topology
+        TopologyRefiner const * GetRefiner() const { return _refiner; }
+
+        /// \brief Returns the patch table (NULL unless requested)
+        PatchTable const * GetPatchTable() const { return _patchTable; }
+
+        /// \brief Returns the stencil table for vertex primvars (NULL unless
+        ///        requested)
+        StencilTable const * GetStencilTable() const { return _stencilTable; }
+
+    private:
+        friend class TopologyCache;
+
+        Entry();
+        ~Entry();
+
+        std::vector<int> _key;
+
+        TopologyRefiner    * _refiner;
+        PatchTable const   * _patchTable;
+        StencilTable const * _stencilTable;
+
+        int           _refCount;
+        unsigned long _lastUse;
+    };
+
+public:
+
+    /// \brief Constructor
+    ///
+    /// @param maxUnusedEntries  Number of released entries kept for reuse
+    ///
+    TopologyCache(int maxUnusedEntries = 16);
+
+    /// \brief Destructor -- all entries must have been released
+    ~TopologyCache();
+
+    /// \brief Returns the entry for the given topology and options, building
+    ///        it if not already cached
+    ///
+    /// @param descriptor  Topology of the mesh
+    ///
+    /// @param options     Options for refinement and construction of tables
+    ///
+    /// @return            Shared entry to pass to Release() once no longer
+    ///                    used, or NULL if the topology is invalid
+    ///
+    Entry const * Acquire(TopologyDescriptor const & descriptor,
+                          Options const & options = Options());
+
+    /// \brief Releases an entry returned by Acquire()
+    void Release(Entry const * entry);
+
+    /// \brief Evicts all entries that are not currently acquired
+    void Clear();
+
+    /// \brief Returns the number of entries in the cache
+    int GetNumEntries() const;
+
+    /// \brief Returns a hash of the given topology and options -- equal
+    ///        topologies and options always have equal hashes
+    static size_t GetHash(TopologyDescriptor const & descriptor,
+                          Options const & options = Options());
+
+private:
+    // Non-copyable:
+    TopologyCache(TopologyCache const &) { }
+    TopologyCache & operator=(TopologyCache const &) { return *this; }
+
+    typedef std::multimap<size_t, Entry *> EntryMap;
+
+    static void getKey(TopologyDescriptor const & descriptor,
+                       Options const & options, std::vector<int> & key);
+
+    static size_t getHash(std::vector<int> const & key);
+
+    static Entry * createEntry(TopologyDescriptor const & descriptor,
+                               Options const & options);
+
+    Entry * findEntry(size_t hash, std::vector<int> const & key) const;
+
+    void evictUnusedEntries(int maxUnusedEntries);
+
+    class Lock;
+
+    EntryMap      _entries;
+    int           _maxUnusedEntries;
+    unsigned long _useCount;
+    Lock *        _lock;
+};
+
+} // end namespace Far
+
+} // end namespace OPENSUBDIV_VERSION
+using namespace OPENSUBDIV_VERSION;
+} // end namespace OpenSubdiv
+
+#endif /* OPENSUBDIV3_FAR_TOPOLOGY_CACHE_H */
@@ -22,6 +22,7 @@
 //   language governing permissions and limitations under the Apache License.
 //
 #include "../far/topologyRefiner.h"
+#include "../far/topologyRefinerFactory.h"
 #include "../far/error.h"
 #include "../vtr/fvarLevel.h"
 #include "../vtr/sparseSelector.h"
@@ -217,6 +218,7 @@ TopologyRefiner::RefineUniform(UniformOptions options) {
     Vtr::internal::Refinement::Options refineOptions;
     refineOptions._sparse         = false;
     refineOptions._faceVertsFirst = options.orderVerticesFromFacesFirst;
+    refineOptions._parallel       = options.useMultipleThreads;
 
     for (int i = 1; i <= (int)options.refinementLevel; ++i) {
         refineOptions._minimalTopology =
@@ -345,7 +347,8 @@ namespace internal {
 } // end namespace internal
 
 void
-TopologyRefiner::RefineAdaptive(AdaptiveOptions options) {
+TopologyRefiner::RefineAdaptive(AdaptiveOptions options,
+                                ConstIndexArray baseFacesToRefine) {
 
     if (_levels[0]->getNumVertices() == 0) {
         Error(FAR_RUNTIME_ERROR,
@@ -362,6 +365,15 @@ TopologyRefiner::RefineAdaptive(AdaptiveOptions options) {
             "Failure in TopologyRefiner::RefineAdaptive() -- currently only supported for Catmark scheme.");
         return;
     }
+    for (int i = 0; i < baseFacesToRefine.size(); ++i) {
+        if ((baseFacesToRefine[i] < 0) ||
+            (baseFacesToRefine[i] >= _levels[0]->getNumFaces())) {
+            Error(FAR_RUNTIME_ERROR,
+                "Failure in TopologyRefiner::RefineAdaptive() -- invalid base face %d.",
+                baseFacesToRefine[i]);
+            return;
+        }
+    }
 
     //
     //  Initialize member and local variables from the adaptive options:
@@ -415,9 +427,23 @@ TopologyRefiner::RefineAdaptive(AdaptiveOptions options) {
     refineOptions._sparse          = true;
     refineOptions._minimalTopology = false;
     refineOptions._faceVertsFirst  = options.orderVerticesFromFacesFirst;
+    refineOptions._parallel        = options.useMultipleThreads;
 
     Sdc::Split splitType = Sdc::SchemeTypeTraits::GetTopologicalSplitType(_subdivType);
 
+    //
+    //  When a subset of the base faces is given, only the faces descending from
+    //  them are inspected in subsequent levels (their children being gathered
+    //  after each refinement), so that the cost scales with the subset.  The
+    //  faces sharing a vertex with the subset are inspected as well, as their
+    //  refinement determines the transitions of the patches of the subset:
+    //
+    std::vector<Index> facesToRefine;
+    if (baseFacesToRefine.size()) {
+        std::vector<Index> faces(baseFacesToRefine.begin(), baseFacesToRefine.end());
+        gatherAffectedBaseFaces(faces, 1, facesToRefine);
+    }
+
     for (int i = 1; i <= potentialMaxLevel; ++i) {
 
         Vtr::internal::Level& parentLevel     = getLevel(i-1);
@@ -436,7 +462,10 @@ TopologyRefiner::RefineAdaptive(AdaptiveOptions options) {
         //
         Vtr::internal::SparseSelector selector(*refinement);
 
-        selectFeatureAdaptiveComponents(selector, (i <= shallowLevel) ? moreFeaturesMask : lessFeaturesMask);
+        selectFeatureAdaptiveComponents(selector,
+            (i <= shallowLevel) ? moreFeaturesMask : lessFeaturesMask,
+            ConstIndexArray(facesToRefine.empty() ? 0 : &facesToRefine[0],
+                            (int)facesToRefine.size()));
         if (selector.isSelectionEmpty()) {
             delete refinement;
             delete &childLevel;
@@ -447,12 +476,173 @@ TopologyRefiner::RefineAdaptive(AdaptiveOptions options) {
             appendLevel(childLevel);
             appendRefinement(*refinement);
         }
+
+        if (!facesToRefine.empty()) {
+            std::vector<Index> childFacesToRefine;
+            for (int j = 0; j < (int)facesToRefine.size(); ++j) {
+                ConstIndexArray cFaces = refinement->getFaceChildFaces(facesToRefine[j]);
+                for (int k = 0; k < cFaces.size(); ++k) {
+                    if (Vtr::IndexIsValid(cFaces[k])) {
+                        childFacesToRefine.push_back(cFaces[k]);
+                    }
+                }
+            }
+            if (childFacesToRefine.empty()) break;
+
+            facesToRefine.swap(childFacesToRefine);
+        }
     }
     _maxLevel = (unsigned int) _refinements.size();
 
     assembleFarLevels();
 }
 
+//
+//  Gathering the base faces affected by an edit -- those incident the vertices
+//  of the edited faces have a different limit surface, and in turn the faces
+//  incident their vertices may have edges split by their refinement (so two
+//  rings of faces, or just the edited faces for schemes without neighborhood):
+//
+void
+TopologyRefiner::GetAffectedBaseFaces(ConstIndexArray editedFaces,
+                                      std::vector<Index> & affectedFaces) const {
+
+    affectedFaces.clear();
+
+    for (int i = 0; i < editedFaces.size(); ++i) {
+        if ((editedFaces[i] < 0) || (editedFaces[i] >= _levels[0]->getNumFaces())) {
+            Error(FAR_RUNTIME_ERROR,
+                "Failure in TopologyRefiner::GetAffectedBaseFaces() -- invalid base face %d.",
+                editedFaces[i]);
+            return;
+        }
+    }
+
+    std::vector<Index> faces(editedFaces.begin(), editedFaces.end());
+
+    gatherAffectedBaseFaces(faces,
+        Sdc::SchemeTypeTraits::GetLocalNeighborhoodSize(_subdivType) ? 2 : 0,
+        affectedFaces);
+}
+
+void
+TopologyRefiner::gatherAffectedBaseFaces(std::vector<Index> & ring, int numRings,
+                                         std::vector<Index> & affectedFaces) const {
+
+    Vtr::internal::Level const & baseLevel = *_levels[0];
+
+    std::vector<unsigned char> isAffected(baseLevel.getNumFaces(), 0);
+
+    for (int i = 0; i < (int)ring.size(); ++i) {
+        isAffected[ring[i]] = 1;
+    }
+
+    for (int i = 0; i < numRings; ++i) {
+        std::vector<Index> nextRing;
+        for (int j = 0; j < (int)ring.size(); ++j) {
+            ConstIndexArray fVerts = baseLevel.getFaceVertices(ring[j]);
+            for (int k = 0; k < fVerts.size(); ++k) {
+                ConstIndexArray vFaces = baseLevel.getVertexFaces(fVerts[k]);
+                for (int l = 0; l < vFaces.size(); ++l) {
+                    if (!isAffected[vFaces[l]]) {
+                        isAffected[vFaces[l]] = 1;
+                        nextRing.push_back(vFaces[l]);
+                    }
+                }
+            }
+        }
+        ring.swap(nextRing);
+    }
+
+    affectedFaces.clear();
+    for (Index face = 0; face < (Index)isAffected.size(); ++face) {
+        if (isAffected[face]) {
+            affectedFaces.push_back(face);
+        }
+    }
+}
+
+//
+//  Updating the sharpness of the base level -- the tags of the given edges and
+//  of the vertices of both the given edges and vertices are re-computed as the
+//  factory computes them originally.  The faces incident these vertices have a
+//  different limit surface, and another ring of faces may have edges split by
+//  their refinement:
+//
+void
+TopologyRefiner::SetBaseSharpness(ConstIndexArray edges, float const * edgeSharpness,
+                                  ConstIndexArray vertices, float const * vertexSharpness,
+                                  std::vector<Index> & affectedFaces) {
+
+    affectedFaces.clear();
+
+    if (!_refinements.empty()) {
+        Error(FAR_RUNTIME_ERROR,
+            "Failure in TopologyRefiner::SetBaseSharpness() -- previous refinements already applied.");
+        return;
+    }
+    if (GetNumFVarChannels()) {
+        Error(FAR_RUNTIME_ERROR,
+            "Failure in TopologyRefiner::SetBaseSharpness() -- not supported with face-varying channels.");
+        return;
+    }
+
+    Vtr::internal::Level & baseLevel = *_levels[0];
+
+    for (int i = 0; i < edges.size(); ++i) {
+        if ((edges[i] < 0) || (edges[i] >= baseLevel.getNumEdges())) {
+            Error(FAR_RUNTIME_ERROR,
+                "Failure in TopologyRefiner::SetBaseSharpness() -- invalid base edge %d.", edges[i]);
+            return;
+        }
+    }
+    for (int i = 0; i < vertices.size(); ++i) {
+        if ((vertices[i] < 0) || (vertices[i] >= baseLevel.getNumVertices())) {
+            Error(FAR_RUNTIME_ERROR,
+                "Failure in TopologyRefiner::SetBaseSharpness() -- invalid base vertex %d.", vertices[i]);
+            return;
+        }
+    }
+
+    //  Assign the sharpness and gather the vertices whose tags depend on it:
+    std::vector<Index> dependentVerts(vertices.begin(), vertices.end());
+
+    for (int i = 0; i < edges.size(); ++i) {
+        baseLevel.getEdgeSharpness(edges[i]) = edgeSharpness[i];
+
+        ConstIndexArray eVerts = baseLevel.getEdgeVertices(edges[i]);
+        dependentVerts.push_back(eVerts[0]);
+        dependentVerts.push_back(eVerts[1]);
+    }
+    for (int i = 0; i < vertices.size(); ++i) {
+        baseLevel.getVertexSharpness(vertices[i]) = vertexSharpness[i];
+    }
+    if (dependentVerts.empty()) return;
+
+    //  Tag the edges before the vertices, whose tags depend on those of the edges:
+    if (edges.size()) {
+        TopologyRefinerFactoryBase::prepareEdgeTagsAndSharpness(*this, edges);
+    }
+    TopologyRefinerFactoryBase::prepareVertexTagsAndSharpness(*this,
+        ConstIndexArray(&dependentVerts[0], (int)dependentVerts.size()));
+
+    //  Gather the affected faces from those incident the re-tagged vertices:
+    std::vector<unsigned char> isIncident(baseLevel.getNumFaces(), 0);
+    std::vector<Index> incidentFaces;
+    for (int i = 0; i < (int)dependentVerts.size(); ++i) {
+        ConstIndexArray vFaces = baseLevel.getVertexFaces(dependentVerts[i]);
+        for (int j = 0; j < vFaces.size(); ++j) {
+            if (!isIncident[vFaces[j]]) {
+                isIncident[vFaces[j]] = 1;
+                incidentFaces.push_back(vFaces[j]);
+            }
+        }
+    }
+    gatherAffectedBaseFaces(incidentFaces,
+        Sdc::SchemeTypeTraits::GetLocalNeighborhoodSize(_subdivType) ? 1 : 0,
+        affectedFaces);
+}
+
 //
 //  Local utility functions for selecting features in faces for adaptive refinement:
 //
@@ -669,7 +859,8 @@ namespace {
 //
 void
 TopologyRefiner::selectFeatureAdaptiveComponents(Vtr::internal::SparseSelector& selector,
-                                                 internal::FeatureMask const & featureMask) {
+                                                 internal::FeatureMask const & featureMask,
+                                                 ConstIndexArray facesToRefine) {
 
     Vtr::internal::Level const& level = selector.getRefinement().parent();
     int levelDepth = level.getDepth();
@@ -682,9 +873,14 @@ TopologyRefiner::selectFeatureAdaptiveComponents(Vtr::internal::SparseSelector&
     int neighborhood    = Sdc::SchemeTypeTraits::GetLocalNeighborhoodSize(_subdivType);
 
     //
-    //  Inspect each face and the properties tagged at all of its corners:
+    //  Inspect each face (or each of those given) and the properties tagged at
+    //  all of its corners:
     //
-    for (Vtr::Index face = 0; face < level.getNumFaces(); ++face) {
+    int numFacesToRefine = facesToRefine.size() ? facesToRefine.size() : level.getNumFaces();
+
+    for (int faceToRefine = 0; faceToRefine < numFacesToRefine; ++faceToRefine) {
+
+        Vtr::Index face = facesToRefine.size() ? facesToRefine[faceToRefine] : faceToRefine;
 
         if (level.isFaceHole(face)) {
             continue;
@@ -715,6 +911,26 @@ TopologyRefiner::selectFeatureAdaptiveComponents(Vtr::internal::SparseSelector&
                 }
                 continue;
             }
+
+            //
+            //  When only a subset of the faces is inspected, the irregular faces
+            //  outside of it are not -- so select a regular face of the subset
+            //  here if it is in the neighborhood of such a face:
+            //
+            if (facesToRefine.size() && (neighborhood > 0)) {
+                bool isNextToIrregularFace = false;
+                for (int i = 0; !isNextToIrregularFace && (i < faceVerts.size()); ++i) {
+                    ConstIndexArray fVertFaces = level.getVertexFaces(faceVerts[i]);
+                    for (int j = 0; !isNextToIrregularFace && (j < fVertFaces.size()); ++j) {
+                        isNextToIrregularFace = !level.isFaceHole(fVertFaces[j]) &&
+                            (level.getFaceVertices(fVertFaces[j]).size() != regularFaceSize);
+                    }
+                }
+                if (isNextToIrregularFace) {
+                    selector.selectFace(face);
+                    continue;
+                }
+            }
         }
 
         //
@@ -119,14 +119,17 @@ public:
         UniformOptions(int level) :
             refinementLevel(level),
             orderVerticesFromFacesFirst(false),
-            fullTopologyInLastLevel(false) { }
+            fullTopologyInLastLevel(false),
+            useMultipleThreads(false) { }
 
         unsigned int refinementLevel:4,             ///< Number of refinement iterations
                      orderVerticesFromFacesFirst:1, ///< Order child vertices from faces first
                                                     ///< instead of child vertices of vertices
-                     fullTopologyInLastLevel:1;     ///< Skip topological relationships in the last
+                     fullTopologyInLastLevel:1,     ///< Skip topological relationships in the last
                                                     ///< level of refinement that are not needed for
                                                     ///< interpolation (keep false if using limit).
+                     useMultipleThreads:1;          ///< Distribute the refinement of each level
+                                                    ///< across threads (requires OpenMP)
     };
 
     /// \brief Refine the topology uniformly
@@ -157,7 +160,8 @@ public:
             useSingleCreasePatch(false),
             useInfSharpPatch(false),
             considerFVarChannels(false),
-            orderVerticesFromFacesFirst(false) { }
+            orderVerticesFromFacesFirst(false),
+            useMultipleThreads(false) { }
 
         unsigned int isolationLevel:4;              ///< Number of iterations applied to isolate
                                                     ///< extraordinary vertices and creases
@@ -171,17 +175,79 @@ public:
                                                     ///< isolate when irregular features present
         unsigned int orderVerticesFromFacesFirst:1; ///< Order child vertices from faces first
                                                     ///< instead of child vertices of vertices
+        unsigned int useMultipleThreads:1;          ///< Distribute the refinement of each level
+                                                    ///< across threads (requires OpenMP)
     };
 
     /// \brief Feature Adaptive topology refinement (restricted to scheme Catmark)
     ///
-    /// @param options   Options controlling adaptive refinement
+    /// @param options            Options controlling adaptive refinement
+    ///
+    /// @param baseFacesToRefine  Base faces considered for refinement (all
+    ///                           the base faces if empty) -- along with the
+    ///                           faces sharing a vertex with them, whose
+    ///                           refinement affects their patches.  The
+    ///                           features of other faces are ignored, other
+    ///                           faces being only refined as required by the
+    ///                           neighborhood of the selected ones.  Patches
+    ///                           for the selected faces, identical to those
+    ///                           of a full refinement, are then obtained by
+    ///                           passing them to PatchTableFactory::Create().
     ///
-    void RefineAdaptive(AdaptiveOptions options);
+    void RefineAdaptive(AdaptiveOptions options,
+                        ConstIndexArray baseFacesToRefine = ConstIndexArray());
 
     /// \brief Returns the options specified on refinement
     AdaptiveOptions GetAdaptiveOptions() const { return _adaptiveOptions; }
 
+    /// \brief Gathers the base faces affected by an edit of the given ones
+    ///
+    /// Following a local edit of the base mesh (faces added, removed or
+    /// re-connected), only the refinement and the patches of the base faces
+    /// near the edited faces change:  those sharing a vertex with them, and
+    /// those whose edges may be split by the refinement of the former.
+    /// Passing these faces to RefineAdaptive() and PatchTableFactory::Create()
+    /// regenerates their patches at a cost proportional to the size of the
+    /// edit.
+    ///
+    /// Existing tables are not updated:  the regenerated patches form a
+    /// separate table whose control vertices are those of the region's
+    /// refiner, and only their PatchParams (face ids) are shared with tables
+    /// of the whole mesh.  No remapping of refined vertices or of stencils
+    /// is provided.
+    ///
+    /// @param editedFaces    Base faces of this refiner that were edited, or
+    ///                       that bordered faces removed by the edit
+    ///
+    /// @param affectedFaces  Returned base faces, in increasing order
+    ///
+    void GetAffectedBaseFaces(ConstIndexArray editedFaces,
+                              std::vector<Index> & affectedFaces) const;
+
+    /// \brief Assigns new sharpness values to base edges and vertices
+    ///
+    /// The sharpness and dependent tags of the base level are updated in
+    /// place, avoiding the reconstruction of the base level by the factory.
+    /// Any refinement must have been removed with Unrefine() -- it is then
+    /// re-applied, possibly only to the returned faces (see
+    /// GetAffectedBaseFaces()).  Not supported with face-varying channels,
+    /// whose topology depends on the sharpness.
+    ///
+    /// @param edges            Base edges to sharpen
+    ///
+    /// @param edgeSharpness    New sharpness of each of the edges
+    ///
+    /// @param vertices         Base vertices to sharpen
+    ///
+    /// @param vertexSharpness  New sharpness of each of the vertices
+    ///
+    /// @param affectedFaces    Returned base faces whose refinement and
+    ///                         patches are affected, in increasing order
+    ///
+    void SetBaseSharpness(ConstIndexArray edges, float const * edgeSharpness,
+                          ConstIndexArray vertices, float const * vertexSharpness,
+                          std::vector<Index> & affectedFaces);
+
     /// \brief Unrefine the topology, keeping only the base level.
     void Unrefine();
 
@@ -212,7 +278,8 @@ protected:
     friend class PatchTableBuilder;
     friend class PatchBuilder;
     friend class PtexIndices;
-    friend class PrimvarRefiner;
+    template <typename REAL>
+    friend class PrimvarRefinerReal;
 
     Vtr::internal::Level & getLevel(int l) { return *_levels[l]; }
     Vtr::internal::Level const & getLevel(int l) const { return *_levels[l]; }
@@ -227,7 +294,11 @@ private:
     TopologyRefiner & operator=(TopologyRefiner const &) { return *this; }
 
     void selectFeatureAdaptiveComponents(Vtr::internal::SparseSelector& selector,
-                                         internal::FeatureMask const & mask);
+                                         internal::FeatureMask const & mask,
+                                         ConstIndexArray facesToRefine);
+
+    void gatherAffectedBaseFaces(std::vector<Index> & faces, int numRings,
+                                 std::vector<Index> & affectedFaces) const;
 
     void initializeInventory();
     void updateInventory(Vtr::internal::Level const & newLevel);
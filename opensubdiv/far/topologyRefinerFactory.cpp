@@ -119,13 +119,14 @@ TopologyRefinerFactoryBase::prepareComponentTopologySizing(TopologyRefiner& refi
 
 bool
 TopologyRefinerFactoryBase::prepareComponentTopologyAssignment(TopologyRefiner& refiner, bool fullValidation,
-                                                               TopologyCallback callback, void const * callbackData) {
+                                                               TopologyCallback callback, void const * callbackData,
+                                                               bool useMultipleThreads) {
 
     Vtr::internal::Level& baseLevel = refiner.getLevel(0);
 
     bool completeMissingTopology = (baseLevel.getNumEdges() == 0);
     if (completeMissingTopology) {
-        if (! baseLevel.completeTopologyFromFaceVertices()) {
+        if (! baseLevel.completeTopologyFromFaceVertices(useMultipleThreads)) {
             char msg[1024];
             snprintf(msg, 1024, "Failure in TopologyRefinerFactory<>::Create() -- "
                     "vertex with valence %d > %d max.",
@@ -168,21 +169,31 @@ TopologyRefinerFactoryBase::prepareComponentTagsAndSharpness(TopologyRefiner& re
     //  Since both involve traversing the edge and vertex lists and noting the presence of
     //  boundaries -- best to do both at once...
     //
-    Vtr::internal::Level&  baseLevel = refiner.getLevel(0);
+    //  Process the Edge tags first, as Vertex tags (notably the Rule) are dependent on
+    //  properties of their incident edges.
+    //
+    prepareEdgeTagsAndSharpness(refiner, Vtr::ConstIndexArray());
+    prepareVertexTagsAndSharpness(refiner, Vtr::ConstIndexArray());
+    return true;
+}
 
-    Sdc::Options options = refiner.GetSchemeOptions();
-    Sdc::Crease  creasing(options);
+//
+//  Tagging and sharpening of all edges and vertices, or of those given (when their
+//  sharpness is updated in an existing base level):
+//
+void
+TopologyRefinerFactoryBase::prepareEdgeTagsAndSharpness(TopologyRefiner& refiner,
+                                                        Vtr::ConstIndexArray edges) {
+
+    Vtr::internal::Level&  baseLevel = refiner.getLevel(0);
 
-    bool makeBoundaryFacesHoles = (options.GetVtxBoundaryInterpolation() == Sdc::Options::VTX_BOUNDARY_NONE
-                                && Sdc::SchemeTypeTraits::GetLocalNeighborhoodSize(refiner.GetSchemeType()) > 0);
-    bool sharpenCornerVerts     = (options.GetVtxBoundaryInterpolation() == Sdc::Options::VTX_BOUNDARY_EDGE_AND_CORNER);
     bool sharpenNonManFeatures  = true; //(options.GetNonManifoldInterpolation() == Sdc::Options::NON_MANIFOLD_SHARP);
 
-    //
-    //  Process the Edge tags first, as Vertex tags (notably the Rule) are dependent on
-    //  properties of their incident edges.
-    //
-    for (Vtr::Index eIndex = 0; eIndex < baseLevel.getNumEdges(); ++eIndex) {
+    int numEdges = edges.size() ? edges.size() : baseLevel.getNumEdges();
+
+    for (int i = 0; i < numEdges; ++i) {
+        Vtr::Index eIndex = edges.size() ? edges[i] : i;
+
         Vtr::internal::Level::ETag& eTag       = baseLevel.getEdgeTag(eIndex);
         float&                      eSharpness = baseLevel.getEdgeSharpness(eIndex);
 
@@ -193,6 +204,21 @@ TopologyRefinerFactoryBase::prepareComponentTagsAndSharpness(TopologyRefiner& re
         eTag._infSharp  = Sdc::Crease::IsInfinite(eSharpness);
         eTag._semiSharp = Sdc::Crease::IsSharp(eSharpness) && !eTag._infSharp;
     }
+}
+
+void
+TopologyRefinerFactoryBase::prepareVertexTagsAndSharpness(TopologyRefiner& refiner,
+                                                          Vtr::ConstIndexArray vertices) {
+
+    Vtr::internal::Level&  baseLevel = refiner.getLevel(0);
+
+    Sdc::Options options = refiner.GetSchemeOptions();
+    Sdc::Crease  creasing(options);
+
+    bool makeBoundaryFacesHoles = (options.GetVtxBoundaryInterpolation() == Sdc::Options::VTX_BOUNDARY_NONE
+                                && Sdc::SchemeTypeTraits::GetLocalNeighborhoodSize(refiner.GetSchemeType()) > 0);
+    bool sharpenCornerVerts     = (options.GetVtxBoundaryInterpolation() == Sdc::Options::VTX_BOUNDARY_EDGE_AND_CORNER);
+    bool sharpenNonManFeatures  = true; //(options.GetNonManifoldInterpolation() == Sdc::Options::NON_MANIFOLD_SHARP);
 
     //
     //  Process the Vertex tags now -- for some tags (semi-sharp and its rule) we need
@@ -201,7 +227,11 @@ TopologyRefinerFactoryBase::prepareComponentTagsAndSharpness(TopologyRefiner& re
     int schemeRegularInteriorValence = Sdc::SchemeTypeTraits::GetRegularVertexValence(refiner.GetSchemeType());
     int schemeRegularBoundaryValence = schemeRegularInteriorValence / 2;
 
-    for (Vtr::Index vIndex = 0; vIndex < baseLevel.getNumVertices(); ++vIndex) {
+    int numVertices = vertices.size() ? vertices.size() : baseLevel.getNumVertices();
+
+    for (int vertex = 0; vertex < numVertices; ++vertex) {
+        Vtr::Index vIndex = vertices.size() ? vertices[vertex] : vertex;
+
         Vtr::internal::Level::VTag& vTag       = baseLevel.getVertexTag(vIndex);
         float&                      vSharpness = baseLevel.getVertexSharpness(vIndex);
 
@@ -328,7 +358,6 @@ TopologyRefinerFactoryBase::prepareComponentTagsAndSharpness(TopologyRefiner& re
             }
         }
     }
-    return true;
 }
 
 bool
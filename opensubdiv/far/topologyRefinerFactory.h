@@ -55,9 +55,19 @@ protected:
 
     static bool prepareComponentTopologySizing(TopologyRefiner& refiner);
     static bool prepareComponentTopologyAssignment(TopologyRefiner& refiner, bool fullValidation,
-                                                   TopologyCallback callback, void const * callbackData);
+                                                   TopologyCallback callback, void const * callbackData,
+                                                   bool useMultipleThreads = false);
     static bool prepareComponentTagsAndSharpness(TopologyRefiner& refiner);
     static bool prepareFaceVaryingChannels(TopologyRefiner& refiner);
+
+    //
+    //  Tagging of a subset of the base edges or vertices (all if empty) -- also used
+    //  by the TopologyRefiner to update the sharpness of an existing base level:
+    //
+    static void prepareEdgeTagsAndSharpness(TopologyRefiner& refiner, Vtr::ConstIndexArray edges);
+    static void prepareVertexTagsAndSharpness(TopologyRefiner& refiner, Vtr::ConstIndexArray vertices);
+
+    friend class TopologyRefiner;
 };
 
 
@@ -86,7 +96,8 @@ public:
         Options(Sdc::SchemeType sdcType = Sdc::SCHEME_CATMARK, Sdc::Options sdcOptions = Sdc::Options()) :
             schemeType(sdcType),
             schemeOptions(sdcOptions),
-            validateFullTopology(false) { }
+            validateFullTopology(false),
+            useMultipleThreads(false) { }
 
         Sdc::SchemeType schemeType;             ///< The subdivision scheme type identifier
         Sdc::Options    schemeOptions;          ///< The full set of options for the scheme,
@@ -94,6 +105,10 @@ public:
         unsigned int validateFullTopology : 1;  ///< Apply more extensive validation of
                                                 ///< the constructed topology -- intended
                                                 ///< for debugging.
+        unsigned int useMultipleThreads   : 1;  ///< Distribute the completion of topology
+                                                ///< from face-vertices across threads
+                                                ///< (requires OpenMP), the resulting
+                                                ///< topology is identical
     };
 
     /// \brief Instantiates a TopologyRefiner from client-provided topological
@@ -362,7 +377,8 @@ TopologyRefinerFactory<MESH>::populateBaseLevel(TopologyRefiner& refiner, MESH c
     void const *     userData = &mesh;
         
     if (! assignComponentTopology(refiner, mesh)) return false;
-    if (! prepareComponentTopologyAssignment(refiner, validate, callback, userData)) return false;
+    if (! prepareComponentTopologyAssignment(refiner, validate, callback, userData,
+                                             options.useMultipleThreads)) return false;
 
     //
     //  User assigned and internal tagging of components -- an optional specialization for
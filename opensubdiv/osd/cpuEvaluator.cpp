@@ -24,7 +24,6 @@
 
 #include "../osd/cpuEvaluator.h"
 #include "../osd/cpuKernel.h"
-#include "../far/patchBasis.h"
 
 #include <cstdlib>
 
@@ -53,6 +52,124 @@ CpuEvaluator::EvalStencils(const float *src, BufferDescriptor const &srcDesc,
     return true;
 }
 
+/* static */
+bool
+CpuEvaluator::EvalStencils(const double *src, BufferDescriptor const &srcDesc,
+                           double *dst,       BufferDescriptor const &dstDesc,
+                           const int * sizes,
+                           const int * offsets,
+                           const int * indices,
+                           const double * weights,
+                           int start, int end) {
+
+    if (end <= start) return true;
+    if (srcDesc.length != dstDesc.length) return false;
+
+    // XXX: we can probably expand cpuKernel.cpp to here.
+    CpuEvalStencils(src, srcDesc, dst, dstDesc,
+                    sizes, offsets, indices, weights, start, end);
+
+    return true;
+}
+
+/* static */
+bool
+CpuEvaluator::EvalStencils(const float *src, BufferDescriptor const &srcDesc,
+                           float *dst,       BufferDescriptor const &dstDesc,
+                           Far::CompressedStencilTable const *stencilTable,
+                           int start, int end) {
+
+    if (end <= start) return true;
+    if (srcDesc.length != dstDesc.length) return false;
+
+    CpuComputeCompressedStencilKernel(src + srcDesc.offset, srcDesc.stride,
+        dst + dstDesc.offset, dstDesc.stride,
+        dstDesc.length, *stencilTable, start, end);
+
+    return true;
+}
+
+/* static */
+bool
+CpuEvaluator::EvalModifiedStencils(const float *src, BufferDescriptor const &srcDesc,
+                                   float *dst,       BufferDescriptor const &dstDesc,
+                                   const int * sizes,
+                                   const int * offsets,
+                                   const int * indices,
+                                   const float * weights,
+                                   const int * stencils, int numStencils) {
+
+    if (srcDesc.length != dstDesc.length) return false;
+
+    // evaluate each run of consecutive stencils with the regular kernel,
+    // which writes the results of a range from the start of the destination
+    for (int i = 0; i < numStencils; ) {
+        int start = stencils[i], end = start + 1;
+        while ((++i < numStencils) && (stencils[i] == end)) {
+            ++end;
+        }
+        CpuEvalStencils(src, srcDesc, dst + start * dstDesc.stride, dstDesc,
+                        sizes, offsets, indices, weights, start, end);
+    }
+    return true;
+}
+
+/* static */
+bool
+CpuEvaluator::EvalModifiedStencils(const float *src, BufferDescriptor const &srcDesc,
+                                   float *dst,       BufferDescriptor const &dstDesc,
+                                   float *du,        BufferDescriptor const &duDesc,
+                                   float *dv,        BufferDescriptor const &dvDesc,
+                                   const int * sizes,
+                                   const int * offsets,
+                                   const int * indices,
+                                   const float * weights,
+                                   const float * duWeights,
+                                   const float * dvWeights,
+                                   const int * stencils, int numStencils) {
+
+    if (dst && srcDesc.length != dstDesc.length) return false;
+    if (du && srcDesc.length != duDesc.length) return false;
+    if (dv && srcDesc.length != dvDesc.length) return false;
+
+    for (int i = 0; i < numStencils; ) {
+        int start = stencils[i], end = start + 1;
+        while ((++i < numStencils) && (stencils[i] == end)) {
+            ++end;
+        }
+        CpuEvalStencils(src, srcDesc,
+                        dst ? dst + start * dstDesc.stride : 0, dstDesc,
+                        du  ? du  + start * duDesc.stride  : 0, duDesc,
+                        dv  ? dv  + start * dvDesc.stride  : 0, dvDesc,
+                        sizes, offsets, indices,
+                        weights, duWeights, dvWeights,
+                        start, end);
+    }
+    return true;
+}
+
+/* static */
+bool
+CpuEvaluator::EvalStencilFrames(const float * const *srcFrames,
+                                BufferDescriptor const &srcDesc,
+                                float * const *dstFrames,
+                                BufferDescriptor const &dstDesc,
+                                int numFrames,
+                                const int * sizes,
+                                const int * offsets,
+                                const int * indices,
+                                const float * weights,
+                                int start, int end) {
+
+    if (end <= start || numFrames <= 0) return true;
+    if (srcDesc.length != dstDesc.length) return false;
+
+    CpuEvalStencilFrames(srcFrames, srcDesc, dstFrames, dstDesc, numFrames,
+                         sizes, offsets, indices, weights, start, end);
+
+    return true;
+}
+
 /* static */
 bool
 CpuEvaluator::EvalStencils(const float *src, BufferDescriptor const &srcDesc,
@@ -67,9 +184,38 @@ CpuEvaluator::EvalStencils(const float *src, BufferDescriptor const &srcDesc,
                            const float * dvWeights,
                            int start, int end) {
     if (end <= start) return true;
-    if (srcDesc.length != dstDesc.length) return false;
-    if (srcDesc.length != duDesc.length) return false;
-    if (srcDesc.length != dvDesc.length) return false;
+    if (dst && srcDesc.length != dstDesc.length) return false;
+    if (du && srcDesc.length != duDesc.length) return false;
+    if (dv && srcDesc.length != dvDesc.length) return false;
+
+    CpuEvalStencils(src, srcDesc,
+                    dst, dstDesc,
+                    du,  duDesc,
+                    dv,  dvDesc,
+                    sizes, offsets, indices,
+                    weights, duWeights, dvWeights,
+                    start, end);
+
+    return true;
+}
+
+/* static */
+bool
+CpuEvaluator::EvalStencils(const double *src, BufferDescriptor const &srcDesc,
+                           double *dst,       BufferDescriptor const &dstDesc,
+                           double *du,        BufferDescriptor const &duDesc,
+                           double *dv,        BufferDescriptor const &dvDesc,
+                           const int * sizes,
+                           const int * offsets,
+                           const int * indices,
+                           const double * weights,
+                           const double * duWeights,
+                           const double * dvWeights,
+                           int start, int end) {
+    if (end <= start) return true;
+    if (dst && srcDesc.length != dstDesc.length) return false;
+    if (du && srcDesc.length != duDesc.length) return false;
+    if (dv && srcDesc.length != dvDesc.length) return false;
 
     CpuEvalStencils(src, srcDesc,
                     dst, dstDesc,
@@ -102,12 +248,12 @@ CpuEvaluator::EvalStencils(const float *src, BufferDescriptor const &srcDesc,
                            const float * dvvWeights,
                            int start, int end) {
     if (end <= start) return true;
-    if (srcDesc.length != dstDesc.length) return false;
-    if (srcDesc.length != duDesc.length) return false;
-    if (srcDesc.length != dvDesc.length) return false;
-    if (srcDesc.length != duuDesc.length) return false;
-    if (srcDesc.length != duvDesc.length) return false;
-    if (srcDesc.length != dvvDesc.length) return false;
+    if (dst && srcDesc.length != dstDesc.length) return false;
+    if (du && srcDesc.length != duDesc.length) return false;
+    if (dv && srcDesc.length != dvDesc.length) return false;
+    if (duu && srcDesc.length != duuDesc.length) return false;
+    if (duv && srcDesc.length != duvDesc.length) return false;
+    if (dvv && srcDesc.length != dvvDesc.length) return false;
 
     CpuEvalStencils(src, srcDesc,
                     dst, dstDesc,
@@ -124,34 +270,99 @@ CpuEvaluator::EvalStencils(const float *src, BufferDescriptor const &srcDesc,
     return true;
 }
 
-template <typename T>
-struct BufferAdapter {
-    BufferAdapter(T *p, int length, int stride) :
-        _p(p), _length(length), _stride(stride) { }
-    void Clear() {
-        for (int i = 0; i < _length; ++i) _p[i] = 0;
-    }
-    void AddWithWeight(T const *src, float w) {
-        if (_p) {
-            for (int i = 0; i < _length; ++i) {
-                _p[i] += src[i] * w;
-            }
-        }
-    }
-    const T *operator[] (int index) const {
-        return _p + _stride * index;
-    }
-    BufferAdapter<T> & operator ++() {
-        if (_p) {
-            _p += _stride;
-        }
-        return *this;
-    }
+/* static */
+bool
+CpuEvaluator::EvalStencils(const double *src, BufferDescriptor const &srcDesc,
+                           double *dst,       BufferDescriptor const &dstDesc,
+                           double *du,        BufferDescriptor const &duDesc,
+                           double *dv,        BufferDescriptor const &dvDesc,
+                           double *duu,       BufferDescriptor const &duuDesc,
+                           double *duv,       BufferDescriptor const &duvDesc,
+                           double *dvv,       BufferDescriptor const &dvvDesc,
+                           const int * sizes,
+                           const int * offsets,
+                           const int * indices,
+                           const double * weights,
+                           const double * duWeights,
+                           const double * dvWeights,
+                           const double * duuWeights,
+                           const double * duvWeights,
+                           const double * dvvWeights,
+                           int start, int end) {
+    if (end <= start) return true;
+    if (dst && srcDesc.length != dstDesc.length) return false;
+    if (du && srcDesc.length != duDesc.length) return false;
+    if (dv && srcDesc.length != dvDesc.length) return false;
+    if (duu && srcDesc.length != duuDesc.length) return false;
+    if (duv && srcDesc.length != duvDesc.length) return false;
+    if (dvv && srcDesc.length != dvvDesc.length) return false;
 
-    T *_p;
-    int _length;
-    int _stride;
-};
+    CpuEvalStencils(src, srcDesc,
+                    dst, dstDesc,
+                    du,  duDesc,
+                    dv,  dvDesc,
+                    duu, duuDesc,
+                    duv, duvDesc,
+                    dvv, dvvDesc,
+                    sizes, offsets, indices,
+                    weights, duWeights, dvWeights,
+                    duuWeights, duvWeights, dvvWeights,
+                    start, end);
+
+    return true;
+}
+
+/* static */
+bool
+CpuEvaluator::EvalStencilNormals(const float *src, BufferDescriptor const &srcDesc,
+                                 float *dst,       BufferDescriptor const &dstDesc,
+                                 float *normal,    BufferDescriptor const &normalDesc,
+                                 const int * sizes,
+                                 const int * offsets,
+                                 const int * indices,
+                                 const float * weights,
+                                 const float * duWeights,
+                                 const float * dvWeights,
+                                 int start, int end) {
+    if (end <= start) return true;
+    if (dst && srcDesc.length != dstDesc.length) return false;
+    if (! normal || srcDesc.length < 3 || normalDesc.length != 3) return false;
+
+    CpuEvalStencilNormals(src, srcDesc,
+                          dst,    dstDesc,
+                          normal, normalDesc,
+                          sizes, offsets, indices,
+                          weights, duWeights, dvWeights,
+                          start, end);
+
+    return true;
+}
+
+/* static */
+bool
+CpuEvaluator::EvalStencilNormals(const double *src, BufferDescriptor const &srcDesc,
+                                 double *dst,       BufferDescriptor const &dstDesc,
+                                 double *normal,    BufferDescriptor const &normalDesc,
+                                 const int * sizes,
+                                 const int * offsets,
+                                 const int * indices,
+                                 const double * weights,
+                                 const double * duWeights,
+                                 const double * dvWeights,
+                                 int start, int end) {
+    if (end <= start) return true;
+    if (dst && srcDesc.length != dstDesc.length) return false;
+    if (! normal || srcDesc.length < 3 || normalDesc.length != 3) return false;
+
+    CpuEvalStencilNormals(src, srcDesc,
+                          dst,    dstDesc,
+                          normal, normalDesc,
+                          sizes, offsets, indices,
+                          weights, duWeights, dvWeights,
+                          start, end);
+
+    return true;
+}
 
 /* static */
 bool
@@ -162,64 +373,22 @@ CpuEvaluator::EvalPatches(const float *src, BufferDescriptor const &srcDesc,
                           const PatchArray *patchArrays,
                           const int *patchIndexBuffer,
                           const PatchParam *patchParamBuffer) {
-    if (src) {
-        src += srcDesc.offset;
-    } else {
-        return false;
-    }
-    if (dst) {
-        dst += dstDesc.offset;
-        if (srcDesc.length != dstDesc.length) return false;
-    } else {
-        return false;
-    }
-
-    BufferAdapter<const float> srcT(src, srcDesc.length, srcDesc.stride);
-    BufferAdapter<float>       dstT(dst, dstDesc.length, dstDesc.stride);
-
-    float wP[20], wDs[20], wDt[20];
-
-    for (int i = 0; i < numPatchCoords; ++i) {
-        PatchCoord const &coord = patchCoords[i];
-        PatchArray const &array = patchArrays[coord.handle.arrayIndex];
-
-        Far::PatchParam const & param =
-            patchParamBuffer[coord.handle.patchIndex];
-        int patchType = param.IsRegular()
-            ? Far::PatchDescriptor::REGULAR
-            : array.GetPatchType();
-
-        int numControlVertices = 0;
-        if (patchType == Far::PatchDescriptor::REGULAR) {
-            Far::internal::GetBSplineWeights(param,
-                                             coord.s, coord.t, wP, wDs, wDt);
-            numControlVertices = 16;
-        } else if (patchType == Far::PatchDescriptor::GREGORY_BASIS) {
-            Far::internal::GetGregoryWeights(param,
-                                             coord.s, coord.t, wP, wDs, wDt);
-            numControlVertices = 20;
-        } else if (patchType == Far::PatchDescriptor::QUADS) {
-            Far::internal::GetBilinearWeights(param,
-                                              coord.s, coord.t, wP, wDs, wDt);
-            numControlVertices = 4;
-        } else {
-            assert(0);
-            return false;
-        }
-
-        int indexStride = Far::PatchDescriptor(array.GetPatchType()).GetNumControlVertices();
-        int indexBase = array.GetIndexBase() + indexStride *
-                (coord.handle.patchIndex - array.GetPrimitiveIdBase());
-
-        const int *cvs = &patchIndexBuffer[indexBase];
+    if (! src) return false;
+    if (! dst) return false;
+    if (srcDesc.length != dstDesc.length) return false;
 
-        dstT.Clear();
-        for (int j = 0; j < numControlVertices; ++j) {
-            dstT.AddWithWeight(srcT[cvs[j]], wP[j]);
-        }
-        ++dstT;
-    }
-    return true;
+    if (numPatchCoords <= 0) return true;
+
+    return CpuEvalPatches(src, srcDesc,
+                          dst, dstDesc,
+                          NULL, BufferDescriptor(),
+                          NULL, BufferDescriptor(),
+                          NULL, BufferDescriptor(),
+                          NULL, BufferDescriptor(),
+                          NULL, BufferDescriptor(),
+                          patchCoords, patchArrays,
+                          patchIndexBuffer, patchParamBuffer,
+                          0, numPatchCoords);
 }
 
 /* static */
@@ -233,77 +402,23 @@ CpuEvaluator::EvalPatches(const float *src, BufferDescriptor const &srcDesc,
                           const PatchArray *patchArrays,
                           const int *patchIndexBuffer,
                           const PatchParam *patchParamBuffer) {
-    if (src) {
-        src += srcDesc.offset;
-    } else {
-        return false;
-    }
-    if (dst) {
-        if (srcDesc.length != dstDesc.length) return false;
-        dst += dstDesc.offset;
-    }
-    if (du) {
-        du  += duDesc.offset;
-        if (srcDesc.length != duDesc.length) return false;
-    }
-    if (dv) {
-        dv  += dvDesc.offset;
-        if (srcDesc.length != dvDesc.length) return false;
-    }
-
-    BufferAdapter<const float> srcT(src, srcDesc.length, srcDesc.stride);
-    BufferAdapter<float>       dstT(dst, dstDesc.length, dstDesc.stride);
-    BufferAdapter<float>        duT(du,  duDesc.length,  duDesc.stride);
-    BufferAdapter<float>        dvT(dv,  dvDesc.length,  dvDesc.stride);
-
-    float wP[20], wDs[20], wDt[20];
-
-    for (int i = 0; i < numPatchCoords; ++i) {
-        PatchCoord const &coord = patchCoords[i];
-        PatchArray const &array = patchArrays[coord.handle.arrayIndex];
-
-        Far::PatchParam const & param =
-            patchParamBuffer[coord.handle.patchIndex];
-        int patchType = param.IsRegular()
-            ? Far::PatchDescriptor::REGULAR
-            : array.GetPatchType();
-
-        int numControlVertices = 0;
-        if (patchType == Far::PatchDescriptor::REGULAR) {
-            Far::internal::GetBSplineWeights(param,
-                                             coord.s, coord.t, wP, wDs, wDt);
-            numControlVertices = 16;
-        } else if (patchType == Far::PatchDescriptor::GREGORY_BASIS) {
-            Far::internal::GetGregoryWeights(param,
-                                             coord.s, coord.t, wP, wDs, wDt);
-            numControlVertices = 20;
-        } else if (patchType == Far::PatchDescriptor::QUADS) {
-            Far::internal::GetBilinearWeights(param,
-                                              coord.s, coord.t, wP, wDs, wDt);
-            numControlVertices = 4;
-        } else {
-            assert(0);
-        }
-
-        int indexStride = Far::PatchDescriptor(array.GetPatchType()).GetNumControlVertices();
-        int indexBase = array.GetIndexBase() + indexStride *
-                (coord.handle.patchIndex - array.GetPrimitiveIdBase());
-
-        const int *cvs = &patchIndexBuffer[indexBase];
-
-        dstT.Clear();
-        duT.Clear();
-        dvT.Clear();
-        for (int j = 0; j < numControlVertices; ++j) {
-            dstT.AddWithWeight(srcT[cvs[j]], wP[j]);
-            duT.AddWithWeight (srcT[cvs[j]], wDs[j]);
-            dvT.AddWithWeight (srcT[cvs[j]], wDt[j]);
-        }
-        ++dstT;
-        ++duT;
-        ++dvT;
-    }
-    return true;
+    if (! src) return false;
+    if (dst && srcDesc.length != dstDesc.length) return false;
+    if (du  && srcDesc.length != duDesc.length)  return false;
+    if (dv  && srcDesc.length != dvDesc.length)  return false;
+
+    if (numPatchCoords <= 0) return true;
+
+    return CpuEvalPatches(src, srcDesc,
+                          dst, dstDesc,
+                          du,  duDesc,
+                          dv,  dvDesc,
+                          NULL, BufferDescriptor(),
+                          NULL, BufferDescriptor(),
+                          NULL, BufferDescriptor(),
+                          patchCoords, patchArrays,
+                          patchIndexBuffer, patchParamBuffer,
+                          0, numPatchCoords);
 }
 
 /* static */
@@ -320,107 +435,28 @@ CpuEvaluator::EvalPatches(const float *src, BufferDescriptor const &srcDesc,
                           const PatchArray *patchArrays,
                           const int *patchIndexBuffer,
                           const PatchParam *patchParamBuffer) {
-    if (src) {
-        src += srcDesc.offset;
-    } else {
-        return false;
-    }
-    if (dst) {
-        if (srcDesc.length != dstDesc.length) return false;
-        dst += dstDesc.offset;
-    }
-    if (du) {
-        du  += duDesc.offset;
-        if (srcDesc.length != duDesc.length) return false;
-    }
-    if (dv) {
-        dv  += dvDesc.offset;
-        if (srcDesc.length != dvDesc.length) return false;
-    }
-    if (duu) {
-        duu += duuDesc.offset;
-        if (srcDesc.length != duuDesc.length) return false;
-    }
-    if (duv) {
-        duv += duvDesc.offset;
-        if (srcDesc.length != duvDesc.length) return false;
-    }
-    if (dvv) {
-        dvv += dvvDesc.offset;
-        if (srcDesc.length != dvvDesc.length) return false;
-    }
-
-    BufferAdapter<const float> srcT(src, srcDesc.length, srcDesc.stride);
-    BufferAdapter<float>       dstT(dst, dstDesc.length, dstDesc.stride);
-    BufferAdapter<float>       duT(du,   duDesc.length,  duDesc.stride);
-    BufferAdapter<float>       dvT(dv,   dvDesc.length,  dvDesc.stride);
-    BufferAdapter<float>       duuT(duu, duuDesc.length, duuDesc.stride);
-    BufferAdapter<float>       duvT(duv, duvDesc.length, duvDesc.stride);
-    BufferAdapter<float>       dvvT(dvv, dvvDesc.length, dvvDesc.stride);
-
-    float wP[20], wDu[20], wDv[20], wDuu[20], wDuv[20], wDvv[20];
-
-    for (int i = 0; i < numPatchCoords; ++i) {
-        PatchCoord const &coord = patchCoords[i];
-        PatchArray const &array = patchArrays[coord.handle.arrayIndex];
-
-        Far::PatchParam const & param =
-            patchParamBuffer[coord.handle.patchIndex];
-        int patchType = param.IsRegular()
-            ? Far::PatchDescriptor::REGULAR
-            : array.GetPatchType();
-
-        int numControlVertices = 0;
-        if (patchType == Far::PatchDescriptor::REGULAR) {
-            Far::internal::GetBSplineWeights(param,
-                                             coord.s, coord.t, wP, wDu, wDv,
-                                             wDuu, wDuv, wDvv);
-            numControlVertices = 16;
-        } else if (patchType == Far::PatchDescriptor::GREGORY_BASIS) {
-            Far::internal::GetGregoryWeights(param,
-                                             coord.s, coord.t, wP, wDu, wDv,
-                                             wDuu, wDuv, wDvv);
-            numControlVertices = 20;
-        } else if (patchType == Far::PatchDescriptor::QUADS) {
-            Far::internal::GetBilinearWeights(param,
-                                              coord.s, coord.t, wP, wDu, wDv,
-                                              wDuu, wDuv, wDvv);
-            numControlVertices = 4;
-        } else {
-            assert(0);
-        }
-
-        int indexStride = Far::PatchDescriptor(array.GetPatchType()).GetNumControlVertices();
-        int indexBase = array.GetIndexBase() + indexStride *
-                (coord.handle.patchIndex - array.GetPrimitiveIdBase());
-
-        const int *cvs = &patchIndexBuffer[indexBase];
-
-        dstT.Clear();
-        duT.Clear();
-        dvT.Clear();
-        duuT.Clear();
-        duvT.Clear();
-        dvvT.Clear();
-        for (int j = 0; j < numControlVertices; ++j) {
-            dstT.AddWithWeight(srcT[cvs[j]], wP[j]);
-            duT.AddWithWeight (srcT[cvs[j]], wDu[j]);
-            dvT.AddWithWeight (srcT[cvs[j]], wDv[j]);
-            duuT.AddWithWeight (srcT[cvs[j]], wDuu[j]);
-            duvT.AddWithWeight (srcT[cvs[j]], wDuv[j]);
-            dvvT.AddWithWeight (srcT[cvs[j]], wDvv[j]);
-        }
-        ++dstT;
-        ++duT;
-        ++dvT;
-        ++duuT;
-        ++duvT;
-        ++dvvT;
-    }
-    return true;
+    if (! src) return false;
+    if (dst && srcDesc.length != dstDesc.length) return false;
+    if (du  && srcDesc.length != duDesc.length)  return false;
+    if (dv  && srcDesc.length != dvDesc.length)  return false;
+    if (duu && srcDesc.length != duuDesc.length) return false;
+    if (duv && srcDesc.length != duvDesc.length) return false;
+    if (dvv && srcDesc.length != dvvDesc.length) return false;
+
+    if (numPatchCoords <= 0) return true;
+
+    return CpuEvalPatches(src, srcDesc,
+                          dst, dstDesc,
+                          du,  duDesc,
+                          dv,  dvDesc,
+                          duu, duuDesc,
+                          duv, duvDesc,
+                          dvv, dvvDesc,
+                          patchCoords, patchArrays,
+                          patchIndexBuffer, patchParamBuffer,
+                          0, numPatchCoords);
 }
 
-
 }  // end namespace Osd
 
 }  // end namespace OPENSUBDIV_VERSION
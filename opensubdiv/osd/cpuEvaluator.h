@@ -28,8 +28,11 @@
 #include "../version.h"
 #include "../osd/bufferDescriptor.h"
 #include "../osd/types.h"
+#include "../far/compressedStencilTable.h"
+#include "../far/stencilDependencyTable.h"
 
 #include <cstddef>
+#include <vector>
 
 namespace OpenSubdiv {
 namespace OPENSUBDIV_VERSION {
@@ -114,7 +117,9 @@ public:
     ///
     /// @param weights        pointer to the weights buffer of the stencil table
     ///
-    /// @param start          start index of stencil table
+    /// @param start          start index of stencil table. The result of
+    ///                       stencil i is written at (i - start) in the
+    ///                       output buffers
     ///
     /// @param end            end index of stencil table
     ///
@@ -127,6 +132,18 @@ public:
         const float * weights,
         int start, int end);
 
+    /// \brief Double precision variant of the above, e.g. for stencil
+    ///        tables built with Far::StencilTableFactoryReal<double>.
+    ///
+    static bool EvalStencils(
+        const double *src, BufferDescriptor const &srcDesc,
+        double *dst,       BufferDescriptor const &dstDesc,
+        const int * sizes,
+        const int * offsets,
+        const int * indices,
+        const double * weights,
+        int start, int end);
+
     /// \brief Generic static eval stencils function with derivatives.
     ///        This function has a same signature as other device kernels
     ///        have so that it can be called in the same way from OsdMesh
@@ -194,6 +211,9 @@ public:
     /// \brief Static eval stencils function with derivatives, which takes
     ///        raw CPU pointers for input and output.
     ///
+    /// All the outputs are accumulated in a single pass over the stencils,
+    /// and any of the output pointers may be null to skip its evaluation.
+    ///
     /// @param src            Input primvar pointer. An offset of srcDesc
     ///                       will be applied internally (i.e. the pointer
     ///                       should not include the offset)
@@ -227,7 +247,9 @@ public:
     ///
     /// @param dvWeights      pointer to the dv-weights buffer of the stencil table
     ///
-    /// @param start          start index of stencil table
+    /// @param start          start index of stencil table. The result of
+    ///                       stencil i is written at (i - start) in the
+    ///                       output buffers
     ///
     /// @param end            end index of stencil table
     ///
@@ -244,6 +266,22 @@ public:
         const float * dvWeights,
         int start, int end);
 
+    /// \brief Double precision variant of the above, e.g. for stencil
+    ///        tables built with Far::StencilTableFactoryReal<double>.
+    ///
+    static bool EvalStencils(
+        const double *src, BufferDescriptor const &srcDesc,
+        double *dst,       BufferDescriptor const &dstDesc,
+        double *du,        BufferDescriptor const &duDesc,
+        double *dv,        BufferDescriptor const &dvDesc,
+        const int * sizes,
+        const int * offsets,
+        const int * indices,
+        const double * weights,
+        const double * duWeights,
+        const double * dvWeights,
+        int start, int end);
+
     /// \brief Generic static eval stencils function with derivatives.
     ///        This function has a same signature as other device kernels
     ///        have so that it can be called in the same way from OsdMesh
@@ -338,6 +376,9 @@ public:
     /// \brief Static eval stencils function with derivatives, which takes
     ///        raw CPU pointers for input and output.
     ///
+    /// All the outputs are accumulated in a single pass over the stencils,
+    /// and any of the output pointers may be null to skip its evaluation.
+    ///
     /// @param src            Input primvar pointer. An offset of srcDesc
     ///                       will be applied internally (i.e. the pointer
     ///                       should not include the offset)
@@ -392,7 +433,9 @@ public:
     ///
     /// @param dvvWeights     pointer to the dvv-weights buffer of the stencil table
     ///
-    /// @param start          start index of stencil table
+    /// @param start          start index of stencil table. The result of
+    ///                       stencil i is written at (i - start) in the
+    ///                       output buffers
     ///
     /// @param end            end index of stencil table
     ///
@@ -415,6 +458,570 @@ public:
         const float * dvvWeights,
         int start, int end);
 
+    /// \brief Double precision variant of the above, e.g. for stencil
+    ///        tables built with Far::StencilTableFactoryReal<double>.
+    ///
+    static bool EvalStencils(
+        const double *src, BufferDescriptor const &srcDesc,
+        double *dst,       BufferDescriptor const &dstDesc,
+        double *du,        BufferDescriptor const &duDesc,
+        double *dv,        BufferDescriptor const &dvDesc,
+        double *duu,       BufferDescriptor const &duuDesc,
+        double *duv,       BufferDescriptor const &duvDesc,
+        double *dvv,       BufferDescriptor const &dvvDesc,
+        const int * sizes,
+        const int * offsets,
+        const int * indices,
+        const double * weights,
+        const double * duWeights,
+        const double * dvWeights,
+        const double * duuWeights,
+        const double * duvWeights,
+        const double * dvvWeights,
+        int start, int end);
+
+    /// \brief Generic static eval stencils function writing normals instead
+    ///        of the derivatives, e.g. for surface frames at limit locations.
+    ///
+    /// @param srcBuffer      Input primvar buffer.
+    ///                       must have BindCpuBuffer() method returning a
+    ///                       const float pointer for read
+    ///
+    /// @param srcDesc        vertex buffer descriptor for the input buffer
+    ///                       (the normals are computed from its first three
+    ///                       elements)
+    ///
+    /// @param dstBuffer      Output primvar buffer (optional)
+    ///                       must have BindCpuBuffer() method returning a
+    ///                       float pointer for write
+    ///
+    /// @param dstDesc        vertex buffer descriptor for the output buffer
+    ///
+    /// @param normalBuffer   Output buffer of the normalized cross products of
+    ///                       the derivatives wrt u and v
+    ///                       must have BindCpuBuffer() method returning a
+    ///                       float pointer for write
+    ///
+    /// @param normalDesc     vertex buffer descriptor for the normalBuffer
+    ///                       (length 3)
+    ///
+    /// @param stencilTable   Far::LimitStencilTable or equivalent
+    ///
+    /// @param instance       not used in the cpu kernel
+    ///                       (declared as a typed pointer to prevent
+    ///                        undesirable template resolution)
+    ///
+    /// @param deviceContext  not used in the cpu kernel
+    ///
+    template <typename SRC_BUFFER, typename DST_BUFFER, typename STENCIL_TABLE>
+    static bool EvalStencilNormals(
+        SRC_BUFFER *srcBuffer,    BufferDescriptor const &srcDesc,
+        DST_BUFFER *dstBuffer,    BufferDescriptor const &dstDesc,
+        DST_BUFFER *normalBuffer, BufferDescriptor const &normalDesc,
+        STENCIL_TABLE const *stencilTable,
+        const CpuEvaluator *instance = NULL,
+        void * deviceContext = NULL) {
+
+        (void)instance;       // unused
+        (void)deviceContext;  // unused
+
+        return EvalStencilNormals(srcBuffer->BindCpuBuffer(), srcDesc,
+                                  dstBuffer ? dstBuffer->BindCpuBuffer() : 0,
+                                  dstDesc,
+                                  normalBuffer->BindCpuBuffer(), normalDesc,
+                                  &stencilTable->GetSizes()[0],
+                                  &stencilTable->GetOffsets()[0],
+                                  &stencilTable->GetControlIndices()[0],
+                                  &stencilTable->GetWeights()[0],
+                                  &stencilTable->GetDuWeights()[0],
+                                  &stencilTable->GetDvWeights()[0],
+                                  /*start = */ 0,
+                                  /*end   = */ stencilTable->GetNumStencils());
+    }
+
+    /// \brief Static eval stencils function writing normals instead of the
+    ///        derivatives, which takes raw CPU pointers for input and output.
+    ///
+    /// The points and the derivatives the normals are computed from are
+    /// accumulated in a single pass over the stencils, the derivatives never
+    /// being written out.
+    ///
+    /// @param src            Input primvar pointer. An offset of srcDesc
+    ///                       will be applied internally (i.e. the pointer
+    ///                       should not include the offset)
+    ///
+    /// @param srcDesc        vertex buffer descriptor for the input buffer
+    ///                       (the normals are computed from its first three
+    ///                       elements)
+    ///
+    /// @param dst            Output primvar pointer (may be null). An offset
+    ///                       of dstDesc will be applied internally.
+    ///
+    /// @param dstDesc        vertex buffer descriptor for the output buffer
+    ///
+    /// @param normal         Output pointer of the normalized normals. An
+    ///                       offset of normalDesc will be applied internally.
+    ///
+    /// @param normalDesc     vertex buffer descriptor for the normals
+    ///                       (length 3)
+    ///
+    /// @param sizes          pointer to the sizes buffer of the stencil table
+    ///
+    /// @param offsets        pointer to the offsets buffer of the stencil table
+    ///
+    /// @param indices        pointer to the indices buffer of the stencil table
+    ///
+    /// @param weights        pointer to the weights buffer of the stencil table
+    ///
+    /// @param duWeights      pointer to the du-weights buffer of the stencil table
+    ///
+    /// @param dvWeights      pointer to the dv-weights buffer of the stencil table
+    ///
+    /// @param start          start index of stencil table. The result of
+    ///                       stencil i is written at (i - start) in the
+    ///                       output buffers
+    ///
+    /// @param end            end index of stencil table
+    ///
+    static bool EvalStencilNormals(
+        const float *src, BufferDescriptor const &srcDesc,
+        float *dst,       BufferDescriptor const &dstDesc,
+        float *normal,    BufferDescriptor const &normalDesc,
+        const int * sizes,
+        const int * offsets,
+        const int * indices,
+        const float * weights,
+        const float * duWeights,
+        const float * dvWeights,
+        int start, int end);
+
+    /// \brief Double precision variant of the above, e.g. for stencil
+    ///        tables built with Far::StencilTableFactoryReal<double>.
+    ///
+    static bool EvalStencilNormals(
+        const double *src, BufferDescriptor const &srcDesc,
+        double *dst,       BufferDescriptor const &dstDesc,
+        double *normal,    BufferDescriptor const &normalDesc,
+        const int * sizes,
+        const int * offsets,
+        const int * indices,
+        const double * weights,
+        const double * duWeights,
+        const double * dvWeights,
+        int start, int end);
+
+    /// ----------------------------------------------------------------------
+    ///
+    ///   Stencil evaluations with CompressedStencilTable
+    ///
+    /// ----------------------------------------------------------------------
+
+    /// \brief Generic static eval stencils function for compressed stencil
+    ///        tables, whose indices and weights are decoded on the fly.
+    ///
+    /// @param srcBuffer      Input primvar buffer.
+    ///                       must have BindCpuBuffer() method returning a
+    ///                       const float pointer for read
+    ///
+    /// @param srcDesc        vertex buffer descriptor for the input buffer
+    ///
+    /// @param dstBuffer      Output primvar buffer
+    ///                       must have BindCpuBuffer() method returning a
+    ///                       float pointer for write
+    ///
+    /// @param dstDesc        vertex buffer descriptor for the output buffer
+    ///
+    /// @param stencilTable   Far::CompressedStencilTable
+    ///
+    /// @param instance       not used in the cpu kernel
+    ///                       (declared as a typed pointer to prevent
+    ///                        undesirable template resolution)
+    ///
+    /// @param deviceContext  not used in the cpu kernel
+    ///
+    template <typename SRC_BUFFER, typename DST_BUFFER>
+    static bool EvalStencils(
+        SRC_BUFFER *srcBuffer, BufferDescriptor const &srcDesc,
+        DST_BUFFER *dstBuffer, BufferDescriptor const &dstDesc,
+        Far::CompressedStencilTable const *stencilTable,
+        const CpuEvaluator *instance = NULL,
+        void * deviceContext = NULL) {
+
+        (void)instance;       // unused
+        (void)deviceContext;  // unused
+
+        return EvalStencils(srcBuffer->BindCpuBuffer(), srcDesc,
+                            dstBuffer->BindCpuBuffer(), dstDesc,
+                            stencilTable,
+                            /*start = */ 0,
+                            /*end   = */ stencilTable->GetNumStencils());
+    }
+
+    /// \brief Static eval stencils function for compressed stencil tables
+    ///        which takes raw CPU pointers for input and output.
+    ///
+    /// @param src            Input primvar pointer. An offset of srcDesc
+    ///                       will be applied internally (i.e. the pointer
+    ///                       should not include the offset)
+    ///
+    /// @param srcDesc        vertex buffer descriptor for the input buffer
+    ///
+    /// @param dst            Output primvar pointer. An offset of dstDesc
+    ///                       will be applied internally.
+    ///
+    /// @param dstDesc        vertex buffer descriptor for the output buffer
+    ///
+    /// @param stencilTable   Far::CompressedStencilTable
+    ///
+    /// @param start          start index of stencil table. The result of
+    ///                       stencil i is written at (i - start) in the
+    ///                       output buffers
+    ///
+    /// @param end            end index of stencil table
+    ///
+    static bool EvalStencils(
+        const float *src, BufferDescriptor const &srcDesc,
+        float *dst,       BufferDescriptor const &dstDesc,
+        Far::CompressedStencilTable const *stencilTable,
+        int start, int end);
+
+    /// ----------------------------------------------------------------------
+    ///
+    ///   Stencil evaluations of modified control vertices
+    ///
+    /// ----------------------------------------------------------------------
+
+    /// \brief Generic static eval stencils function re-evaluating only the
+    ///        stencils affected by modified control vertices. The results of
+    ///        the other stencils are left untouched in the output buffer.
+    ///
+    /// @param srcBuffer      Input primvar buffer.
+    ///                       must have BindCpuBuffer() method returning a
+    ///                       const float pointer for read
+    ///
+    /// @param srcDesc        vertex buffer descriptor for the input buffer
+    ///
+    /// @param dstBuffer      Output primvar buffer
+    ///                       must have BindCpuBuffer() method returning a
+    ///                       float pointer for write
+    ///
+    /// @param dstDesc        vertex buffer descriptor for the output buffer
+    ///
+    /// @param stencilTable   Far::StencilTable or equivalent
+    ///
+    /// @param dependencies   Far::StencilDependencyTable of the stencil table
+    ///
+    /// @param controlVertices     indices of the modified control vertices
+    ///
+    /// @param numControlVertices  number of modified control vertices
+    ///
+    /// @param instance       not used in the cpu kernel
+    ///                       (declared as a typed pointer to prevent
+    ///                        undesirable template resolution)
+    ///
+    /// @param deviceContext  not used in the cpu kernel
+    ///
+    template <typename SRC_BUFFER, typename DST_BUFFER, typename STENCIL_TABLE>
+    static bool EvalModifiedStencils(
+        SRC_BUFFER *srcBuffer, BufferDescriptor const &srcDesc,
+        DST_BUFFER *dstBuffer, BufferDescriptor const &dstDesc,
+        STENCIL_TABLE const *stencilTable,
+        Far::StencilDependencyTable const *dependencies,
+        Far::Index const *controlVertices, int numControlVertices,
+        const CpuEvaluator *instance = NULL,
+        void * deviceContext = NULL) {
+
+        (void)instance;       // unused
+        (void)deviceContext;  // unused
+
+        std::vector<Far::Index> stencils;
+        if (dependencies->GetAffectedStencils(
+                controlVertices, numControlVertices, stencils) == 0)
+            return true;
+
+        return EvalModifiedStencils(srcBuffer->BindCpuBuffer(), srcDesc,
+                                    dstBuffer->BindCpuBuffer(), dstDesc,
+                                    &stencilTable->GetSizes()[0],
+                                    &stencilTable->GetOffsets()[0],
+                                    &stencilTable->GetControlIndices()[0],
+                                    &stencilTable->GetWeights()[0],
+                                    &stencils[0], (int)stencils.size());
+    }
+
+    /// \brief Static eval stencils function evaluating a subset of the
+    ///        stencils, which takes raw CPU pointers for input and output.
+    ///
+    /// @param src            Input primvar pointer. An offset of srcDesc
+    ///                       will be applied internally (i.e. the pointer
+    ///                       should not include the offset)
+    ///
+    /// @param srcDesc        vertex buffer descriptor for the input buffer
+    ///
+    /// @param dst            Output primvar pointer. An offset of dstDesc
+    ///                       will be applied internally.
+    ///
+    /// @param dstDesc        vertex buffer descriptor for the output buffer
+    ///
+    /// @param sizes          pointer to the sizes buffer of the stencil table
+    ///
+    /// @param offsets        pointer to the offsets buffer of the stencil table
+    ///
+    /// @param indices        pointer to the indices buffer of the stencil table
+    ///
+    /// @param weights        pointer to the weights buffer of the stencil table
+    ///
+    /// @param stencils       indices of the stencils to evaluate, in
+    ///                       increasing order (runs of consecutive stencils
+    ///                       are evaluated together)
+    ///
+    /// @param numStencils    number of stencils to evaluate
+    ///
+    static bool EvalModifiedStencils(
+        const float *src, BufferDescriptor const &srcDesc,
+        float *dst,       BufferDescriptor const &dstDesc,
+        const int * sizes,
+        const int * offsets,
+        const int * indices,
+        const float * weights,
+        const int * stencils, int numStencils);
+
+    /// \brief Generic static eval stencils function with derivatives
+    ///        re-evaluating only the stencils affected by modified control
+    ///        vertices, e.g. for limit stencil tables.
+    ///
+    /// @param srcBuffer      Input primvar buffer.
+    ///                       must have BindCpuBuffer() method returning a
+    ///                       const float pointer for read
+    ///
+    /// @param srcDesc        vertex buffer descriptor for the input buffer
+    ///
+    /// @param dstBuffer      Output primvar buffer
+    ///                       must have BindCpuBuffer() method returning a
+    ///                       float pointer for write
+    ///
+    /// @param dstDesc        vertex buffer descriptor for the output buffer
+    ///
+    /// @param duBuffer       Output buffer derivative wrt u
+    ///                       must have BindCpuBuffer() method returning a
+    ///                       float pointer for write
+    ///
+    /// @param duDesc         vertex buffer descriptor for the duBuffer
+    ///
+    /// @param dvBuffer       Output buffer derivative wrt v
+    ///                       must have BindCpuBuffer() method returning a
+    ///                       float pointer for write
+    ///
+    /// @param dvDesc         vertex buffer descriptor for the dvBuffer
+    ///
+    /// @param stencilTable   Far::LimitStencilTable or equivalent
+    ///
+    /// @param dependencies   Far::StencilDependencyTable of the stencil table
+    ///
+    /// @param controlVertices     indices of the modified control vertices
+    ///
+    /// @param numControlVertices  number of modified control vertices
+    ///
+    /// @param instance       not used in the cpu kernel
+    ///                       (declared as a typed pointer to prevent
+    ///                        undesirable template resolution)
+    ///
+    /// @param deviceContext  not used in the cpu kernel
+    ///
+    template <typename SRC_BUFFER, typename DST_BUFFER, typename STENCIL_TABLE>
+    static bool EvalModifiedStencils(
+        SRC_BUFFER *srcBuffer, BufferDescriptor const &srcDesc,
+        DST_BUFFER *dstBuffer, BufferDescriptor const &dstDesc,
+        DST_BUFFER *duBuffer,  BufferDescriptor const &duDesc,
+        DST_BUFFER *dvBuffer,  BufferDescriptor const &dvDesc,
+        STENCIL_TABLE const *stencilTable,
+        Far::StencilDependencyTable const *dependencies,
+        Far::Index const *controlVertices, int numControlVertices,
+        const CpuEvaluator *instance = NULL,
+        void * deviceContext = NULL) {
+
+        (void)instance;       // unused
+        (void)deviceContext;  // unused
+
+        std::vector<Far::Index> stencils;
+        if (dependencies->GetAffectedStencils(
+                controlVertices, numControlVertices, stencils) == 0)
+            return true;
+
+        return EvalModifiedStencils(srcBuffer->BindCpuBuffer(), srcDesc,
+                                    dstBuffer->BindCpuBuffer(), dstDesc,
+                                    duBuffer->BindCpuBuffer(),  duDesc,
+                                    dvBuffer->BindCpuBuffer(),  dvDesc,
+                                    &stencilTable->GetSizes()[0],
+                                    &stencilTable->GetOffsets()[0],
+                                    &stencilTable->GetControlIndices()[0],
+                                    &stencilTable->GetWeights()[0],
+                                    &stencilTable->GetDuWeights()[0],
+                                    &stencilTable->GetDvWeights()[0],
+                                    &stencils[0], (int)stencils.size());
+    }
+
+    /// \brief Static eval stencils function with derivatives evaluating a
+    ///        subset of the stencils, which takes raw CPU pointers for input
+    ///        and output.
+    ///
+    /// @param src            Input primvar pointer. An offset of srcDesc
+    ///                       will be applied internally (i.e. the pointer
+    ///                       should not include the offset)
+    ///
+    /// @param srcDesc        vertex buffer descriptor for the input buffer
+    ///
+    /// @param dst            Output primvar pointer. An offset of dstDesc
+    ///                       will be applied internally.
+    ///
+    /// @param dstDesc        vertex buffer descriptor for the output buffer
+    ///
+    /// @param du             Output pointer derivative wrt u. An offset of
+    ///                       duDesc will be applied internally.
+    ///
+    /// @param duDesc         vertex buffer descriptor for the duBuffer
+    ///
+    /// @param dv             Output pointer derivative wrt v. An offset of
+    ///                       dvDesc will be applied internally.
+    ///
+    /// @param dvDesc         vertex buffer descriptor for the dvBuffer
+    ///
+    /// @param sizes          pointer to the sizes buffer of the stencil table
+    ///
+    /// @param offsets        pointer to the offsets buffer of the stencil table
+    ///
+    /// @param indices        pointer to the indices buffer of the stencil table
+    ///
+    /// @param weights        pointer to the weights buffer of the stencil table
+    ///
+    /// @param duWeights      pointer to the du-weights buffer of the stencil table
+    ///
+    /// @param dvWeights      pointer to the dv-weights buffer of the stencil table
+    ///
+    /// @param stencils       indices of the stencils to evaluate, in
+    ///                       increasing order
+    ///
+    /// @param numStencils    number of stencils to evaluate
+    ///
+    static bool EvalModifiedStencils(
+        const float *src, BufferDescriptor const &srcDesc,
+        float *dst,       BufferDescriptor const &dstDesc,
+        float *du,        BufferDescriptor const &duDesc,
+        float *dv,        BufferDescriptor const &dvDesc,
+        const int * sizes,
+        const int * offsets,
+        const int * indices,
+        const float * weights,
+        const float * duWeights,
+        const float * dvWeights,
+        const int * stencils, int numStencils);
+
+    /// ----------------------------------------------------------------------
+    ///
+    ///   Stencil evaluations over several frames
+    ///
+    /// ----------------------------------------------------------------------
+
+    /// \brief Generic static eval stencils function applying the stencil
+    ///        table to several frames of primvar data at once, e.g. to bake
+    ///        an animation. Each block of stencils is applied to all the
+    ///        frames while its indices and weights are in cache, which is
+    ///        faster than calling EvalStencils() once per frame.
+    ///
+    /// @param srcBuffers     Input primvar buffers, one per frame.
+    ///                       must have BindCpuBuffer() method returning a
+    ///                       const float pointer for read
+    ///
+    /// @param srcDesc        vertex buffer descriptor for the input buffers
+    ///
+    /// @param dstBuffers     Output primvar buffers, one per frame.
+    ///                       must have BindCpuBuffer() method returning a
+    ///                       float pointer for write
+    ///
+    /// @param dstDesc        vertex buffer descriptor for the output buffers
+    ///
+    /// @param numFrames      number of input and output buffers
+    ///
+    /// @param stencilTable   Far::StencilTable or equivalent
+    ///
+    /// @param instance       not used in the cpu kernel
+    ///                       (declared as a typed pointer to prevent
+    ///                        undesirable template resolution)
+    ///
+    /// @param deviceContext  not used in the cpu kernel
+    ///
+    template <typename SRC_BUFFER, typename DST_BUFFER, typename STENCIL_TABLE>
+    static bool EvalStencilFrames(
+        SRC_BUFFER * const *srcBuffers, BufferDescriptor const &srcDesc,
+        DST_BUFFER * const *dstBuffers, BufferDescriptor const &dstDesc,
+        int numFrames,
+        STENCIL_TABLE const *stencilTable,
+        const CpuEvaluator *instance = NULL,
+        void * deviceContext = NULL) {
+
+        (void)instance;       // unused
+        (void)deviceContext;  // unused
+
+        if (stencilTable->GetNumStencils() == 0 || numFrames <= 0)
+            return false;
+
+        std::vector<const float *> src(numFrames);
+        std::vector<float *>       dst(numFrames);
+        for (int frame = 0; frame < numFrames; ++frame) {
+            src[frame] = srcBuffers[frame]->BindCpuBuffer();
+            dst[frame] = dstBuffers[frame]->BindCpuBuffer();
+        }
+
+        return EvalStencilFrames(&src[0], srcDesc,
+                                 &dst[0], dstDesc,
+                                 numFrames,
+                                 &stencilTable->GetSizes()[0],
+                                 &stencilTable->GetOffsets()[0],
+                                 &stencilTable->GetControlIndices()[0],
+                                 &stencilTable->GetWeights()[0],
+                                 /*start = */ 0,
+                                 /*end   = */ stencilTable->GetNumStencils());
+    }
+
+    /// \brief Static multi-frame eval stencils function which takes raw CPU
+    ///        pointers for input and output.
+    ///
+    /// @param srcFrames      Input primvar pointers, one per frame. An offset
+    ///                       of srcDesc will be applied internally (i.e. the
+    ///                       pointers should not include the offset)
+    ///
+    /// @param srcDesc        vertex buffer descriptor for the input buffers
+    ///
+    /// @param dstFrames      Output primvar pointers, one per frame. An
+    ///                       offset of dstDesc will be applied internally.
+    ///
+    /// @param dstDesc        vertex buffer descriptor for the output buffers
+    ///
+    /// @param numFrames      number of input and output pointers
+    ///
+    /// @param sizes          pointer to the sizes buffer of the stencil table
+    ///
+    /// @param offsets        pointer to the offsets buffer of the stencil table
+    ///
+    /// @param indices        pointer to the indices buffer of the stencil table
+    ///
+    /// @param weights        pointer to the weights buffer of the stencil table
+    ///
+    /// @param start          start index of stencil table. The result of
+    ///                       stencil i is written at (i - start) in the
+    ///                       output buffers
+    ///
+    /// @param end            end index of stencil table
+    ///
+    static bool EvalStencilFrames(
+        const float * const *srcFrames, BufferDescriptor const &srcDesc,
+        float * const *dstFrames,       BufferDescriptor const &dstDesc,
+        int numFrames,
+        const int * sizes,
+        const int * offsets,
+        const int * indices,
+        const float * weights,
+        int start, int end);
+
     /// ----------------------------------------------------------------------
     ///
     ///   Limit evaluations with PatchTable
@@ -24,12 +24,39 @@
 
 #include "../osd/cpuKernel.h"
 #include "../osd/bufferDescriptor.h"
+#include "../osd/types.h"
+#include "../far/compressedStencilTable.h"
+#include "../far/patchBasis.h"
 
+#include <algorithm>
 #include <cassert>
 #include <cmath>
 #include <cstdlib>
 #include <vector>
 
+//
+// The SIMD stencil kernels are compiled with per-function target attributes
+// so that the library itself does not require any ISA specific compiler
+// flags : the widest kernel supported by the running CPU is then selected
+// at runtime.
+//
+#if defined(__x86_64__) || defined(_M_X64)
+    #if defined(__clang__) || (defined(__GNUC__) && (__GNUC__ >= 5))
+        #define OSD_CPU_KERNEL_X86_SIMD
+        #define OSD_TARGET(isa) __attribute__((target(isa)))
+    #elif defined(_MSC_VER) && (_MSC_VER >= 1910)
+        #define OSD_CPU_KERNEL_X86_SIMD
+        #define OSD_TARGET(isa)
+    #endif
+#endif
+
+#if defined(OSD_CPU_KERNEL_X86_SIMD)
+    #include <immintrin.h>
+    #if defined(_MSC_VER) && !defined(__clang__)
+        #include <intrin.h>
+    #endif
+#endif
+
 namespace OpenSubdiv {
 namespace OPENSUBDIV_VERSION {
 
@@ -41,15 +68,9 @@ elementAtIndex(T * src, int index, BufferDescriptor const &desc) {
     return src + index * desc.stride;
 }
 
+template <typename REAL>
 static inline void
-clear(float *dst, BufferDescriptor const &desc) {
-
-    assert(dst);
-    memset(dst, 0, desc.length*sizeof(float));
-}
-
-static inline void
-addWithWeight(float *dst, const float *src, int srcIndex, float weight,
+addWithWeight(REAL *dst, const REAL *src, int srcIndex, REAL weight,
               BufferDescriptor const &desc) {
 
     assert(src && dst);
@@ -59,13 +80,353 @@ addWithWeight(float *dst, const float *src, int srcIndex, float weight,
     }
 }
 
+template <typename REAL>
 static inline void
-copy(float *dst, int dstIndex, const float *src, BufferDescriptor const &desc) {
+copy(REAL *dst, int dstIndex, const REAL *src, BufferDescriptor const &desc) {
 
     assert(src && dst);
 
     dst = elementAtIndex(dst, dstIndex, desc);
-    memcpy(dst, src, desc.length*sizeof(float));
+    memcpy(dst, src, desc.length*sizeof(REAL));
+}
+
+//
+// Scalar stencil kernel
+//
+static void
+computeStencilKernelScalar(float const * src, int srcStride,
+                           float * dst, int dstStride, int length,
+                           int const * sizes,
+                           int const * indices,
+                           float const * weights,
+                           int start, int end) {
+
+    if (length == 4 && srcStride == 4 && dstStride == 4) {
+        ComputeStencilKernel<4>(src, dst, sizes, indices, weights, start, end);
+        return;
+    } else if (length == 8 && srcStride == 8 && dstStride == 8) {
+        ComputeStencilKernel<8>(src, dst, sizes, indices, weights, start, end);
+        return;
+    }
+
+    float * result = (float*)alloca(length * sizeof(float));
+
+    for (int i=start; i<end; ++i) {
+
+        memset(result, 0, length*sizeof(float));
+
+        for (int j=0; j<sizes[i]; ++j, ++indices, ++weights) {
+            float const * s = src + (*indices)*srcStride;
+            for (int k=0; k<length; ++k) {
+                result[k] += s[k] * (*weights);
+            }
+        }
+        memcpy(dst + i*dstStride, result, length*sizeof(float));
+    }
+}
+
+#if defined(OSD_CPU_KERNEL_X86_SIMD)
+
+//
+// Source rows of the next stencil are prefetched while the current one is
+// accumulated : the gathers are the main source of stalls on large meshes,
+// where control vertices referenced by a stencil are rarely contiguous.
+//
+static inline void
+prefetchStencilSources(float const * src, int srcStride,
+                       int const * indices, int size) {
+    for (int j=0; j<size; ++j) {
+        _mm_prefetch((char const *)(src + indices[j]*srcStride), _MM_HINT_T0);
+    }
+}
+
+//
+// SSE2 stencil kernel (4 lanes, partial lanes are loaded / stored with
+// scalar moves so that no memory past the end of a row is touched)
+//
+OSD_TARGET("sse2") static inline __m128
+loadPartialSSE(float const * p, int n) {
+    switch (n) {
+        case 1 : return _mm_set_ps(0.0f, 0.0f, 0.0f, p[0]);
+        case 2 : return _mm_set_ps(0.0f, 0.0f, p[1], p[0]);
+        case 3 : return _mm_set_ps(0.0f, p[2], p[1], p[0]);
+        default: return _mm_loadu_ps(p);
+    }
+}
+
+OSD_TARGET("sse2") static inline void
+storePartialSSE(float * p, __m128 v, int n) {
+    if (n >= 4) {
+        _mm_storeu_ps(p, v);
+    } else {
+        float tmp[4];
+        _mm_storeu_ps(tmp, v);
+        for (int k=0; k<n; ++k) p[k] = tmp[k];
+    }
+}
+
+OSD_TARGET("sse2") static void
+computeStencilKernelSSE(float const * src, int srcStride,
+                        float * dst, int dstStride, int length,
+                        int const * sizes,
+                        int const * indices,
+                        float const * weights,
+                        int start, int end) {
+
+    for (int i=start; i<end; ++i) {
+
+        int size = sizes[i];
+
+        if (i+1 < end) {
+            prefetchStencilSources(src, srcStride, indices+size, sizes[i+1]);
+        }
+
+        float * d = dst + i*dstStride;
+        for (int k=0; k<length; k+=4) {
+            int n = length - k;
+
+            __m128 result = _mm_setzero_ps();
+            for (int j=0; j<size; ++j) {
+                __m128 s = loadPartialSSE(src + indices[j]*srcStride + k, n);
+                result = _mm_add_ps(result,
+                    _mm_mul_ps(s, _mm_set1_ps(weights[j])));
+            }
+            storePartialSSE(d + k, result, n);
+        }
+        indices += size;
+        weights += size;
+    }
+}
+
+//
+// AVX2 stencil kernel (8 lanes, FMA accumulation, masked tail lanes)
+//
+static int const g_laneMasks[16] = {
+    -1, -1, -1, -1, -1, -1, -1, -1,
+     0,  0,  0,  0,  0,  0,  0,  0
+};
+
+OSD_TARGET("avx2,fma") static inline __m256i
+getLaneMaskAVX2(int n) {
+    return _mm256_loadu_si256((__m256i const *)(g_laneMasks + 8 - (n<8 ? n : 8)));
+}
+
+OSD_TARGET("avx2,fma") static void
+computeStencilKernelAVX2(float const * src, int srcStride,
+                         float * dst, int dstStride, int length,
+                         int const * sizes,
+                         int const * indices,
+                         float const * weights,
+                         int start, int end) {
+
+    __m256i mask0 = getLaneMaskAVX2(length),
+            mask1 = getLaneMaskAVX2(length-8);
+
+    for (int i=start; i<end; ++i) {
+
+        int size = sizes[i];
+
+        if (i+1 < end) {
+            prefetchStencilSources(src, srcStride, indices+size, sizes[i+1]);
+        }
+
+        float * d = dst + i*dstStride;
+        if (length <= 8) {
+            __m256 result = _mm256_setzero_ps();
+            for (int j=0; j<size; ++j) {
+                float const * s = src + indices[j]*srcStride;
+                result = _mm256_fmadd_ps(_mm256_maskload_ps(s, mask0),
+                    _mm256_set1_ps(weights[j]), result);
+            }
+            _mm256_maskstore_ps(d, mask0, result);
+        } else if (length <= 16) {
+            // two independent accumulation chains per source row
+            __m256 result0 = _mm256_setzero_ps(),
+                   result1 = _mm256_setzero_ps();
+            for (int j=0; j<size; ++j) {
+                float const * s = src + indices[j]*srcStride;
+                __m256 w = _mm256_set1_ps(weights[j]);
+                result0 = _mm256_fmadd_ps(_mm256_loadu_ps(s), w, result0);
+                result1 = _mm256_fmadd_ps(
+                    _mm256_maskload_ps(s+8, mask1), w, result1);
+            }
+            _mm256_storeu_ps(d, result0);
+            _mm256_maskstore_ps(d+8, mask1, result1);
+        } else {
+            for (int k=0; k<length; k+=8) {
+                __m256i mask = getLaneMaskAVX2(length-k);
+                __m256 result = _mm256_setzero_ps();
+                for (int j=0; j<size; ++j) {
+                    float const * s = src + indices[j]*srcStride + k;
+                    result = _mm256_fmadd_ps(_mm256_maskload_ps(s, mask),
+                        _mm256_set1_ps(weights[j]), result);
+                }
+                _mm256_maskstore_ps(d+k, mask, result);
+            }
+        }
+        indices += size;
+        weights += size;
+    }
+}
+
+//
+// AVX-512 stencil kernel (16 lanes, FMA accumulation, masked tail lanes)
+//
+OSD_TARGET("avx512f,avx2,fma") static void
+computeStencilKernelAVX512(float const * src, int srcStride,
+                           float * dst, int dstStride, int length,
+                           int const * sizes,
+                           int const * indices,
+                           float const * weights,
+                           int start, int end) {
+
+    // narrow primvars (positions, normals...) do not fill 16 lanes and
+    // run faster through the 8 lanes kernel
+    if (length <= 8) {
+        computeStencilKernelAVX2(src, srcStride, dst, dstStride, length,
+                                 sizes, indices, weights, start, end);
+        return;
+    }
+
+    for (int i=start; i<end; ++i) {
+
+        int size = sizes[i];
+
+        if (i+1 < end) {
+            prefetchStencilSources(src, srcStride, indices+size, sizes[i+1]);
+        }
+
+        float * d = dst + i*dstStride;
+        for (int k=0; k<length; k+=16) {
+            int n = length - k;
+            __mmask16 mask = (__mmask16)(n >= 16 ? 0xffff : ((1 << n) - 1));
+
+            __m512 result = _mm512_setzero_ps();
+            for (int j=0; j<size; ++j) {
+                float const * s = src + indices[j]*srcStride + k;
+                result = _mm512_fmadd_ps(_mm512_maskz_loadu_ps(mask, s),
+                    _mm512_set1_ps(weights[j]), result);
+            }
+            _mm512_mask_storeu_ps(d+k, mask, result);
+        }
+        indices += size;
+        weights += size;
+    }
+}
+
+static CpuKernelIsa
+detectKernelIsa() {
+
+#if defined(_MSC_VER) && !defined(__clang__)
+    int info[4];
+    __cpuid(info, 0);
+    int maxLeaf = info[0];
+
+    __cpuid(info, 1);
+    bool hasFMA     = (info[2] & (1 << 12)) != 0,
+         hasOSXSAVE = (info[2] & (1 << 27)) != 0,
+         hasAVX     = (info[2] & (1 << 28)) != 0;
+
+    bool hasAVX2 = false,
+         hasAVX512F = false;
+    if (maxLeaf >= 7) {
+        __cpuidex(info, 7, 0);
+        hasAVX2    = (info[1] & (1 <<  5)) != 0;
+        hasAVX512F = (info[1] & (1 << 16)) != 0;
+    }
+
+    // the OS must also save the extended register state on context switches
+    unsigned long long xcr0 = (hasOSXSAVE && hasAVX) ? _xgetbv(0) : 0;
+    bool ymmState = (xcr0 & 0x06) == 0x06,
+         zmmState = (xcr0 & 0xe6) == 0xe6;
+
+    if (hasAVX512F && zmmState) return CPU_KERNEL_ISA_AVX512;
+    if (hasAVX2 && hasFMA && ymmState) return CPU_KERNEL_ISA_AVX2;
+    return CPU_KERNEL_ISA_SSE;
+#else
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) return CPU_KERNEL_ISA_AVX512;
+    if (__builtin_cpu_supports("avx2") &&
+        __builtin_cpu_supports("fma")) return CPU_KERNEL_ISA_AVX2;
+    return CPU_KERNEL_ISA_SSE;
+#endif
+}
+
+#else
+
+static CpuKernelIsa
+detectKernelIsa() {
+    return CPU_KERNEL_ISA_SCALAR;
+}
+
+#endif
+
+//
+// Kernel dispatch
+//
+typedef void (*StencilKernelFunction)(float const *, int, float *, int, int,
+    int const *, int const *, float const *, int, int);
+
+static int g_supportedKernelIsa = -1,
+           g_kernelIsa = -1;
+
+static StencilKernelFunction g_stencilKernel = 0;
+
+static StencilKernelFunction
+getStencilKernelFunction(CpuKernelIsa isa) {
+    switch (isa) {
+#if defined(OSD_CPU_KERNEL_X86_SIMD)
+        case CPU_KERNEL_ISA_AVX512 : return computeStencilKernelAVX512;
+        case CPU_KERNEL_ISA_AVX2   : return computeStencilKernelAVX2;
+        case CPU_KERNEL_ISA_SSE    : return computeStencilKernelSSE;
+#endif
+        default : return computeStencilKernelScalar;
+    }
+}
+
+CpuKernelIsa
+CpuGetSupportedKernelIsa() {
+    // benign race : every thread computes the same value
+    if (g_supportedKernelIsa < 0) {
+        g_supportedKernelIsa = detectKernelIsa();
+    }
+    return (CpuKernelIsa)g_supportedKernelIsa;
+}
+
+void
+CpuSetKernelIsa(CpuKernelIsa isa) {
+    CpuKernelIsa supported = CpuGetSupportedKernelIsa();
+    if (isa > supported) isa = supported;
+    if (isa < CPU_KERNEL_ISA_SCALAR) isa = CPU_KERNEL_ISA_SCALAR;
+
+    g_stencilKernel = getStencilKernelFunction(isa);
+    g_kernelIsa = isa;
+}
+
+CpuKernelIsa
+CpuGetKernelIsa() {
+    if (g_kernelIsa < 0) {
+        CpuSetKernelIsa(CpuGetSupportedKernelIsa());
+    }
+    return (CpuKernelIsa)g_kernelIsa;
+}
+
+void
+CpuComputeStencilKernel(float const * vertexSrc, int srcStride,
+                        float * vertexDst, int dstStride,
+                        int length,
+                        int const * sizes,
+                        int const * indices,
+                        float const * weights,
+                        int start, int end) {
+
+    StencilKernelFunction kernel = g_stencilKernel;
+    if (! kernel) {
+        kernel = getStencilKernelFunction(CpuGetKernelIsa());
+    }
+
+    kernel(vertexSrc, srcStride, vertexDst, dstStride, length,
+           sizes, indices, weights, start, end);
 }
 
 void
@@ -88,87 +449,436 @@ CpuEvalStencils(float const * src, BufferDescriptor const &srcDesc,
     src += srcDesc.offset;
     dst += dstDesc.offset;
 
-    if (srcDesc.length == 4 && dstDesc.length == 4 &&
-        srcDesc.stride == 4 && dstDesc.stride == 4) {
+    // results are written at (index - start), as in the other kernels
+    CpuComputeStencilKernel(src, srcDesc.stride, dst, dstDesc.stride,
+                            dstDesc.length, sizes, indices, weights,
+                            0, end - start);
+}
 
-        // SIMD fast path for aligned primvar data (4 floats)
-        ComputeStencilKernel<4>(src, dst,
-            sizes, indices, weights, start,  end);
+void
+CpuEvalStencilFrames(float const * const * src, BufferDescriptor const &srcDesc,
+                     float * const * dst,       BufferDescriptor const &dstDesc,
+                     int numFrames,
+                     int const * sizes,
+                     int const * offsets,
+                     int const * indices,
+                     float const * weights,
+                     int start, int end) {
 
-    } else if (srcDesc.length == 8 && dstDesc.length == 8 &&
-               srcDesc.stride == 8 && dstDesc.stride == 8) {
+    assert(start>=0 && start<end);
 
-        // SIMD fast path for aligned primvar data (8 floats)
-        ComputeStencilKernel<8>(src, dst,
-            sizes, indices, weights, start,  end);
-    } else {
+    if (start>0) {
+        sizes += start;
+        indices += offsets[start];
+        weights += offsets[start];
+    }
 
-        // Slow path for non-aligned data
+    std::vector<float const *> srcFrames(numFrames);
+    std::vector<float *>       dstFrames(numFrames);
+    for (int frame = 0; frame < numFrames; ++frame) {
+        srcFrames[frame] = src[frame] + srcDesc.offset;
+        dstFrames[frame] = dst[frame] + dstDesc.offset;
+    }
+
+    CpuComputeStencilFramesKernel(&srcFrames[0], srcDesc.stride,
+                                  &dstFrames[0], dstDesc.stride,
+                                  dstDesc.length, numFrames,
+                                  sizes, indices, weights, 0, end - start);
+}
 
-        float * result = (float*)alloca(srcDesc.length * sizeof(float));
+void
+CpuComputeCompressedStencilKernel(float const * vertexSrc, int srcStride,
+                                  float * vertexDst, int dstStride,
+                                  int length,
+                                  Far::CompressedStencilTable const & stencilTable,
+                                  int start, int end) {
 
-        int nstencils = end-start;
-        for (int i=0; i<nstencils; ++i, ++sizes) {
+    int blockSize = Far::CompressedStencilTable::GetBlockSize(),
+        maxBlockElements = std::max(1, stencilTable.GetMaxBlockElements());
 
-            clear(result, srcDesc);
+    std::vector<int>   sizes(blockSize),
+                       indices(maxBlockElements);
+    std::vector<float> weights(maxBlockElements);
 
-            for (int j=0; j<*sizes; ++j) {
-                addWithWeight(result, src, *indices++, *weights++, srcDesc);
-            }
+    for (int first = start; first < end; ) {
 
-            copy(dst, i, result, dstDesc);
-        }
+        // decode up to the end of the block of the first stencil
+        int last = std::min(end, (first / blockSize + 1) * blockSize);
+
+        stencilTable.DecodeStencils(first, last,
+                                    &sizes[0], &indices[0], &weights[0]);
+
+        CpuComputeStencilKernel(vertexSrc, srcStride,
+                                vertexDst + (first - start) * dstStride, dstStride,
+                                length, &sizes[0], &indices[0], &weights[0],
+                                0, last - first);
+        first = last;
     }
 }
 
 void
-CpuEvalStencils(float const * src, BufferDescriptor const &srcDesc,
-                float * dst,       BufferDescriptor const &dstDesc,
-                float * dstDu,     BufferDescriptor const &dstDuDesc,
-                float * dstDv,     BufferDescriptor const &dstDvDesc,
-                int const * sizes,
-                int const * offsets,
-                int const * indices,
-                float const * weights,
-                float const * duWeights,
-                float const * dvWeights,
-                int start, int end) {
-    if (start > 0) {
+CpuComputeStencilFramesKernel(float const * const * vertexSrc, int srcStride,
+                              float * const * vertexDst, int dstStride,
+                              int length, int numFrames,
+                              int const * sizes,
+                              int const * indices,
+                              float const * weights,
+                              int start, int end) {
+
+    // Number of stencil coefficients per block : their indices and weights
+    // (16KB) are then applied to every frame from the L1 cache.
+    int const blockElements = 2048;
+
+    StencilKernelFunction kernel = g_stencilKernel;
+    if (! kernel) {
+        kernel = getStencilKernelFunction(CpuGetKernelIsa());
+    }
+
+    for (int first = start; first < end; ) {
+
+        // gather whole stencils up to the size of a block
+        int last = first, numElements = 0;
+        do {
+            numElements += sizes[last++];
+        } while ((last < end) && (numElements + sizes[last] <= blockElements));
+
+        for (int frame = 0; frame < numFrames; ++frame) {
+            kernel(vertexSrc[frame], srcStride, vertexDst[frame], dstStride,
+                   length, sizes, indices, weights, first, last);
+        }
+        indices += numElements;
+        weights += numElements;
+        first = last;
+    }
+}
+
+template <typename REAL>
+static void
+evalStencils(REAL const * src, BufferDescriptor const &srcDesc,
+             REAL * dst,       BufferDescriptor const &dstDesc,
+             int const * sizes,
+             int const * offsets,
+             int const * indices,
+             REAL const * weights,
+             int start, int end) {
+
+    assert(start>=0 && start<end);
+
+    if (start>0) {
         sizes += start;
         indices += offsets[start];
         weights += offsets[start];
-        duWeights += offsets[start];
-        dvWeights += offsets[start];
     }
 
     src += srcDesc.offset;
     dst += dstDesc.offset;
-    dstDu += dstDuDesc.offset;
-    dstDv += dstDvDesc.offset;
 
-    int nOutLength = dstDesc.length + dstDuDesc.length + dstDvDesc.length;
-    float * result   = (float*)alloca(nOutLength * sizeof(float));
-    float * resultDu = result + dstDesc.length;
-    float * resultDv = resultDu + dstDuDesc.length;
+    REAL * result = (REAL*)alloca(dstDesc.length * sizeof(REAL));
 
     int nStencils = end - start;
     for (int i = 0; i < nStencils; ++i, ++sizes) {
 
-        // clear
-        memset(result, 0, nOutLength * sizeof(float));
+        memset(result, 0, dstDesc.length * sizeof(REAL));
 
-        for (int j=0; j<*sizes; ++j) {
-            addWithWeight(result,   src, *indices, *weights++,   srcDesc);
-            addWithWeight(resultDu, src, *indices, *duWeights++, srcDesc);
-            addWithWeight(resultDv, src, *indices, *dvWeights++, srcDesc);
-            ++indices;
+        for (int j=0; j<*sizes; ++j, ++indices, ++weights) {
+            addWithWeight(result, src, *indices, *weights, srcDesc);
         }
-        copy(dst,   i, result, dstDesc);
-        copy(dstDu, i, resultDu, dstDuDesc);
-        copy(dstDv, i, resultDv, dstDvDesc);
+        copy(dst, i, result, dstDesc);
     }
 }
 
+//
+// Limit stencil kernels : the point and derivative values requested (i.e.
+// those given a destination) are accumulated together, in a single pass
+// over the stencils reading each element of a control vertex once for all
+// of them. Normals are computed from the first three elements of the 'u'
+// and 'v' derivatives, which are then accumulated without being written.
+//
+template <typename REAL>
+struct LimitStencilOutputs {
+
+    LimitStencilOutputs() : size(0) { }
+
+    // Adds an output if either a destination is given or it is needed by
+    // another one, returning its index (-1 if not added)
+    int Add(REAL * dst, BufferDescriptor const &desc, REAL const * w,
+            bool needed=false) {
+        if (! (dst || needed)) return -1;
+        dsts[size] = dst ? dst + desc.offset : 0;
+        strides[size] = desc.stride;
+        weights[size] = w;
+        return size++;
+    }
+
+    int          size;
+    REAL *       dsts[6];
+    int          strides[6];
+    REAL const * weights[6];
+};
+
+template <typename REAL, int NUM_OUTPUTS>
+static void
+accumulateLimitStencil(REAL * result, REAL const * src, int srcStride,
+                       int length, int size, int const * indices,
+                       REAL const * const * weights) {
+
+    for (int j=0; j<size; ++j) {
+        REAL const * s = src + indices[j]*srcStride;
+
+        REAL w[NUM_OUTPUTS];
+        for (int o=0; o<NUM_OUTPUTS; ++o) {
+            w[o] = weights[o][j];
+        }
+        for (int k=0; k<length; ++k) {
+            REAL value = s[k];
+            for (int o=0; o<NUM_OUTPUTS; ++o) {
+                result[o*length + k] += value * w[o];
+            }
+        }
+    }
+}
+
+#if defined(OSD_CPU_KERNEL_X86_SIMD)
+
+//
+// SSE2 limit stencil kernel : the elements of the control vertices are
+// accumulated 4 lanes at a time, each row being loaded once in a register
+// for all the outputs
+//
+template <int NUM_OUTPUTS>
+OSD_TARGET("sse2") static void
+accumulateLimitStencilSSE(float * result, float const * src, int srcStride,
+                          int length, int size, int const * indices,
+                          float const * const * weights) {
+
+    for (int k=0; k<length; k+=4) {
+        int n = length - k;
+
+        __m128 r[NUM_OUTPUTS];
+        for (int o=0; o<NUM_OUTPUTS; ++o) {
+            r[o] = _mm_setzero_ps();
+        }
+        for (int j=0; j<size; ++j) {
+            __m128 s = loadPartialSSE(src + indices[j]*srcStride + k, n);
+            for (int o=0; o<NUM_OUTPUTS; ++o) {
+                r[o] = _mm_add_ps(r[o],
+                    _mm_mul_ps(s, _mm_set1_ps(weights[o][j])));
+            }
+        }
+        for (int o=0; o<NUM_OUTPUTS; ++o) {
+            storePartialSSE(result + o*length + k, r[o], n);
+        }
+    }
+}
+
+#endif
+
+template <typename REAL>
+struct LimitStencilAccumulator {
+
+    typedef void (*Function)(REAL *, REAL const *, int, int, int,
+        int const *, REAL const * const *);
+
+    static Function GetScalar(int numOutputs) {
+        switch (numOutputs) {
+            case 1 : return accumulateLimitStencil<REAL, 1>;
+            case 2 : return accumulateLimitStencil<REAL, 2>;
+            case 3 : return accumulateLimitStencil<REAL, 3>;
+            case 4 : return accumulateLimitStencil<REAL, 4>;
+            case 5 : return accumulateLimitStencil<REAL, 5>;
+            case 6 : return accumulateLimitStencil<REAL, 6>;
+            default : return 0;
+        }
+    }
+
+    static Function Get(int numOutputs) {
+        return GetScalar(numOutputs);
+    }
+};
+
+#if defined(OSD_CPU_KERNEL_X86_SIMD)
+
+template <>
+LimitStencilAccumulator<float>::Function
+LimitStencilAccumulator<float>::Get(int numOutputs) {
+    if (CpuGetKernelIsa() >= CPU_KERNEL_ISA_SSE) {
+        switch (numOutputs) {
+            case 1 : return accumulateLimitStencilSSE<1>;
+            case 2 : return accumulateLimitStencilSSE<2>;
+            case 3 : return accumulateLimitStencilSSE<3>;
+            case 4 : return accumulateLimitStencilSSE<4>;
+            case 5 : return accumulateLimitStencilSSE<5>;
+            case 6 : return accumulateLimitStencilSSE<6>;
+            default : return 0;
+        }
+    }
+    return GetScalar(numOutputs);
+}
+
+#endif
+
+template <typename REAL>
+static void
+evalLimitStencils(REAL const * src, BufferDescriptor const &srcDesc,
+                  LimitStencilOutputs<REAL> & outputs,
+                  REAL * dstNormal, BufferDescriptor const &dstNormalDesc,
+                  int duOutput, int dvOutput,
+                  int const * sizes,
+                  int const * offsets,
+                  int const * indices,
+                  int start, int end) {
+
+    typename LimitStencilAccumulator<REAL>::Function accumulate =
+        LimitStencilAccumulator<REAL>::Get(outputs.size);
+    if (! accumulate) return;
+
+    if (start > 0) {
+        sizes += start;
+        indices += offsets[start];
+        for (int o=0; o<outputs.size; ++o) {
+            outputs.weights[o] += offsets[start];
+        }
+    }
+
+    src += srcDesc.offset;
+    if (dstNormal) {
+        dstNormal += dstNormalDesc.offset;
+    }
+
+    int length = srcDesc.length;
+    REAL * result = (REAL*)alloca(outputs.size * length * sizeof(REAL));
+
+    int nStencils = end - start;
+    for (int i = 0; i < nStencils; ++i, ++sizes) {
+
+        memset(result, 0, outputs.size * length * sizeof(REAL));
+
+        accumulate(result, src, srcDesc.stride, length, *sizes, indices,
+                   outputs.weights);
+
+        indices += *sizes;
+        for (int o=0; o<outputs.size; ++o) {
+            outputs.weights[o] += *sizes;
+
+            if (outputs.dsts[o]) {
+                memcpy(outputs.dsts[o] + i*outputs.strides[o],
+                       result + o*length, length*sizeof(REAL));
+            }
+        }
+
+        if (dstNormal) {
+            REAL const * du = result + duOutput*length,
+                       * dv = result + dvOutput*length;
+            REAL n[3] = { du[1]*dv[2] - du[2]*dv[1],
+                          du[2]*dv[0] - du[0]*dv[2],
+                          du[0]*dv[1] - du[1]*dv[0] };
+            REAL len = std::sqrt(n[0]*n[0] + n[1]*n[1] + n[2]*n[2]);
+            if (len > 0) {
+                n[0] /= len;
+                n[1] /= len;
+                n[2] /= len;
+            }
+            memcpy(dstNormal + i*dstNormalDesc.stride, n, 3*sizeof(REAL));
+        }
+    }
+}
+
+template <typename REAL>
+static void
+evalStencils(REAL const * src, BufferDescriptor const &srcDesc,
+             REAL * dst,       BufferDescriptor const &dstDesc,
+             REAL * dstDu,     BufferDescriptor const &dstDuDesc,
+             REAL * dstDv,     BufferDescriptor const &dstDvDesc,
+             int const * sizes,
+             int const * offsets,
+             int const * indices,
+             REAL const * weights,
+             REAL const * duWeights,
+             REAL const * dvWeights,
+             int start, int end) {
+
+    LimitStencilOutputs<REAL> outputs;
+    outputs.Add(dst,   dstDesc,   weights);
+    outputs.Add(dstDu, dstDuDesc, duWeights);
+    outputs.Add(dstDv, dstDvDesc, dvWeights);
+
+    evalLimitStencils(src, srcDesc, outputs, (REAL *)0, BufferDescriptor(),
+                      -1, -1, sizes, offsets, indices, start, end);
+}
+
+template <typename REAL>
+static void
+evalStencils(REAL const * src, BufferDescriptor const &srcDesc,
+             REAL * dst,       BufferDescriptor const &dstDesc,
+             REAL * dstDu,     BufferDescriptor const &dstDuDesc,
+             REAL * dstDv,     BufferDescriptor const &dstDvDesc,
+             REAL * dstDuu,    BufferDescriptor const &dstDuuDesc,
+             REAL * dstDuv,    BufferDescriptor const &dstDuvDesc,
+             REAL * dstDvv,    BufferDescriptor const &dstDvvDesc,
+             int const * sizes,
+             int const * offsets,
+             int const * indices,
+             REAL const * weights,
+             REAL const * duWeights,
+             REAL const * dvWeights,
+             REAL const * duuWeights,
+             REAL const * duvWeights,
+             REAL const * dvvWeights,
+             int start, int end) {
+
+    LimitStencilOutputs<REAL> outputs;
+    outputs.Add(dst,    dstDesc,    weights);
+    outputs.Add(dstDu,  dstDuDesc,  duWeights);
+    outputs.Add(dstDv,  dstDvDesc,  dvWeights);
+    outputs.Add(dstDuu, dstDuuDesc, duuWeights);
+    outputs.Add(dstDuv, dstDuvDesc, duvWeights);
+    outputs.Add(dstDvv, dstDvvDesc, dvvWeights);
+
+    evalLimitStencils(src, srcDesc, outputs, (REAL *)0, BufferDescriptor(),
+                      -1, -1, sizes, offsets, indices, start, end);
+}
+
+template <typename REAL>
+static void
+evalStencilNormals(REAL const * src, BufferDescriptor const &srcDesc,
+                   REAL * dst,       BufferDescriptor const &dstDesc,
+                   REAL * dstNormal, BufferDescriptor const &dstNormalDesc,
+                   int const * sizes,
+                   int const * offsets,
+                   int const * indices,
+                   REAL const * weights,
+                   REAL const * duWeights,
+                   REAL const * dvWeights,
+                   int start, int end) {
+
+    LimitStencilOutputs<REAL> outputs;
+    outputs.Add(dst, dstDesc, weights);
+    int duOutput = outputs.Add(0, BufferDescriptor(), duWeights, true),
+        dvOutput = outputs.Add(0, BufferDescriptor(), dvWeights, true);
+
+    evalLimitStencils(src, srcDesc, outputs, dstNormal, dstNormalDesc,
+                      duOutput, dvOutput, sizes, offsets, indices, start, end);
+}
+
+void
+CpuEvalStencils(float const * src, BufferDescriptor const &srcDesc,
+                float * dst,       BufferDescriptor const &dstDesc,
+                float * dstDu,     BufferDescriptor const &dstDuDesc,
+                float * dstDv,     BufferDescriptor const &dstDvDesc,
+                int const * sizes,
+                int const * offsets,
+                int const * indices,
+                float const * weights,
+                float const * duWeights,
+                float const * dvWeights,
+                int start, int end) {
+
+    evalStencils(src, srcDesc, dst, dstDesc,
+                 dstDu, dstDuDesc, dstDv, dstDvDesc,
+                 sizes, offsets, indices,
+                 weights, duWeights, dvWeights, start, end);
+}
+
 void
 CpuEvalStencils(float const * src, BufferDescriptor const &srcDesc,
                 float * dst,       BufferDescriptor const &dstDesc,
@@ -187,56 +897,269 @@ CpuEvalStencils(float const * src, BufferDescriptor const &srcDesc,
                 float const * duvWeights,
                 float const * dvvWeights,
                 int start, int end) {
-    if (start > 0) {
-        sizes += start;
-        indices += offsets[start];
-        weights += offsets[start];
-        duWeights += offsets[start];
-        dvWeights += offsets[start];
-        duuWeights += offsets[start];
-        duvWeights += offsets[start];
-        dvvWeights += offsets[start];
-    }
+
+    evalStencils(src, srcDesc, dst, dstDesc,
+                 dstDu, dstDuDesc, dstDv, dstDvDesc,
+                 dstDuu, dstDuuDesc, dstDuv, dstDuvDesc, dstDvv, dstDvvDesc,
+                 sizes, offsets, indices,
+                 weights, duWeights, dvWeights,
+                 duuWeights, duvWeights, dvvWeights, start, end);
+}
+
+void
+CpuEvalStencilNormals(float const * src, BufferDescriptor const &srcDesc,
+                      float * dst,       BufferDescriptor const &dstDesc,
+                      float * dstNormal, BufferDescriptor const &dstNormalDesc,
+                      int const * sizes,
+                      int const * offsets,
+                      int const * indices,
+                      float const * weights,
+                      float const * duWeights,
+                      float const * dvWeights,
+                      int start, int end) {
+
+    evalStencilNormals(src, srcDesc, dst, dstDesc, dstNormal, dstNormalDesc,
+                       sizes, offsets, indices,
+                       weights, duWeights, dvWeights, start, end);
+}
+
+//
+// Double precision variants -- these use the generic scalar kernels
+//
+void
+CpuEvalStencils(double const * src, BufferDescriptor const &srcDesc,
+                double * dst,       BufferDescriptor const &dstDesc,
+                int const * sizes,
+                int const * offsets,
+                int const * indices,
+                double const * weights,
+                int start, int end) {
+
+    evalStencils(src, srcDesc, dst, dstDesc,
+                 sizes, offsets, indices, weights, start, end);
+}
+
+void
+CpuEvalStencils(double const * src, BufferDescriptor const &srcDesc,
+                double * dst,       BufferDescriptor const &dstDesc,
+                double * dstDu,     BufferDescriptor const &dstDuDesc,
+                double * dstDv,     BufferDescriptor const &dstDvDesc,
+                int const * sizes,
+                int const * offsets,
+                int const * indices,
+                double const * weights,
+                double const * duWeights,
+                double const * dvWeights,
+                int start, int end) {
+
+    evalStencils(src, srcDesc, dst, dstDesc,
+                 dstDu, dstDuDesc, dstDv, dstDvDesc,
+                 sizes, offsets, indices,
+                 weights, duWeights, dvWeights, start, end);
+}
+
+void
+CpuEvalStencils(double const * src, BufferDescriptor const &srcDesc,
+                double * dst,       BufferDescriptor const &dstDesc,
+                double * dstDu,     BufferDescriptor const &dstDuDesc,
+                double * dstDv,     BufferDescriptor const &dstDvDesc,
+                double * dstDuu,    BufferDescriptor const &dstDuuDesc,
+                double * dstDuv,    BufferDescriptor const &dstDuvDesc,
+                double * dstDvv,    BufferDescriptor const &dstDvvDesc,
+                int const * sizes,
+                int const * offsets,
+                int const * indices,
+                double const * weights,
+                double const * duWeights,
+                double const * dvWeights,
+                double const * duuWeights,
+                double const * duvWeights,
+                double const * dvvWeights,
+                int start, int end) {
+
+    evalStencils(src, srcDesc, dst, dstDesc,
+                 dstDu, dstDuDesc, dstDv, dstDvDesc,
+                 dstDuu, dstDuuDesc, dstDuv, dstDuvDesc, dstDvv, dstDvvDesc,
+                 sizes, offsets, indices,
+                 weights, duWeights, dvWeights,
+                 duuWeights, duvWeights, dvvWeights, start, end);
+}
+
+void
+CpuEvalStencilNormals(double const * src, BufferDescriptor const &srcDesc,
+                      double * dst,       BufferDescriptor const &dstDesc,
+                      double * dstNormal, BufferDescriptor const &dstNormalDesc,
+                      int const * sizes,
+                      int const * offsets,
+                      int const * indices,
+                      double const * weights,
+                      double const * duWeights,
+                      double const * dvWeights,
+                      int start, int end) {
+
+    evalStencilNormals(src, srcDesc, dst, dstDesc, dstNormal, dstNormalDesc,
+                       sizes, offsets, indices,
+                       weights, duWeights, dvWeights, start, end);
+}
+
+//
+// Patch evaluation kernel
+//
+bool
+CpuEvalPatches(float const * src, BufferDescriptor const &srcDesc,
+               float * dst,       BufferDescriptor const &dstDesc,
+               float * dstDu,     BufferDescriptor const &dstDuDesc,
+               float * dstDv,     BufferDescriptor const &dstDvDesc,
+               float * dstDuu,    BufferDescriptor const &dstDuuDesc,
+               float * dstDuv,    BufferDescriptor const &dstDuvDesc,
+               float * dstDvv,    BufferDescriptor const &dstDvvDesc,
+               PatchCoord const * patchCoords,
+               PatchArray const * patchArrays,
+               int const * patchIndexBuffer,
+               PatchParam const * patchParamBuffer,
+               int start, int end) {
+
+    int const N = Far::internal::BASIS_BATCH_SIZE;
 
     src += srcDesc.offset;
-    dst += dstDesc.offset;
-    dstDu += dstDuDesc.offset;
-    dstDv += dstDvDesc.offset;
-    dstDuu += dstDuuDesc.offset;
-    dstDuv += dstDuvDesc.offset;
-    dstDvv += dstDvvDesc.offset;
-
-    int nOutLength = dstDesc.length + dstDuDesc.length + dstDvDesc.length
-                   + dstDuuDesc.length + dstDuvDesc.length + dstDvvDesc.length;
-    float * result   = (float*)alloca(nOutLength * sizeof(float));
-    float * resultDu = result + dstDesc.length;
-    float * resultDv = resultDu + dstDuDesc.length;
-    float * resultDuu = resultDv + dstDvDesc.length;
-    float * resultDuv = resultDuu + dstDuuDesc.length;
-    float * resultDvv = resultDuv + dstDuvDesc.length;
 
-    int nStencils = end - start;
-    for (int i = 0; i < nStencils; ++i, ++sizes) {
+    //  The position and derivatives are accumulated alike from the weights
+    //  of the corresponding basis:
+    int const numOutputs = 6;
+
+    float * outputs[numOutputs] = { dst, dstDu, dstDv, dstDuu, dstDuv, dstDvv };
+    BufferDescriptor const * outputDescs[numOutputs] = {
+        &dstDesc, &dstDuDesc, &dstDvDesc, &dstDuuDesc, &dstDuvDesc, &dstDvvDesc };
+
+    for (int o = 0; o < numOutputs; ++o) {
+        if (outputs[o]) {
+            outputs[o] += outputDescs[o]->offset;
+        }
+    }
+
+    bool computeDeriv2 = dstDuu || dstDuv || dstDvv,
+         computeDeriv1 = dstDu || dstDv || computeDeriv2;
+
+    float weights[numOutputs][20 * N];
+
+    float * wP   = weights[0],
+          * wDu  = computeDeriv1 ? weights[1] : 0,
+          * wDv  = computeDeriv1 ? weights[2] : 0,
+          * wDuu = computeDeriv2 ? weights[3] : 0,
+          * wDuv = computeDeriv2 ? weights[4] : 0,
+          * wDvv = computeDeriv2 ? weights[5] : 0;
+
+    Far::PatchParam params[N];
+    float s[N],
+          t[N];
+    int const * cvs[N];
+
+    //  Compact the requested outputs, so that the control vertices of each
+    //  point are read once for all of them:
+    int numActive = 0,
+        activeOutputs[numOutputs],
+        resultLength = 0;
+    for (int o = 0; o < numOutputs; ++o) {
+        if (outputs[o]) {
+            activeOutputs[numActive++] = o;
+            resultLength += outputDescs[o]->length;
+        }
+    }
+    float * result = (float*)alloca(resultLength * sizeof(float));
 
-        // clear
-        memset(result, 0, nOutLength * sizeof(float));
-
-        for (int j=0; j<*sizes; ++j) {
-            addWithWeight(result,   src, *indices, *weights++,   srcDesc);
-            addWithWeight(resultDu, src, *indices, *duWeights++, srcDesc);
-            addWithWeight(resultDv, src, *indices, *dvWeights++, srcDesc);
-            addWithWeight(resultDuu, src, *indices, *duuWeights++, srcDesc);
-            addWithWeight(resultDuv, src, *indices, *duvWeights++, srcDesc);
-            addWithWeight(resultDvv, src, *indices, *dvvWeights++, srcDesc);
-            ++indices;
-        }
-        copy(dst,   i, result, dstDesc);
-        copy(dstDu, i, resultDu, dstDuDesc);
-        copy(dstDv, i, resultDv, dstDvDesc);
-        copy(dstDuu, i, resultDuu, dstDuuDesc);
-        copy(dstDuv, i, resultDuv, dstDuvDesc);
-        copy(dstDvv, i, resultDvv, dstDvvDesc);
+    bool success = true;
+
+    for (int i = start; i < end; ) {
+
+        //  Gather the following coordinates on patches of the same type:
+        int patchType = -1,
+            numPoints = 0;
+        for ( ; (numPoints < N) && (i + numPoints < end); ++numPoints) {
+            PatchCoord const &coord = patchCoords[i + numPoints];
+            PatchArray const &array = patchArrays[coord.handle.arrayIndex];
+
+            Far::PatchParam const & param =
+                patchParamBuffer[coord.handle.patchIndex];
+            int type = param.IsRegular()
+                ? Far::PatchDescriptor::REGULAR
+                : array.GetPatchType();
+
+            if (numPoints == 0) {
+                patchType = type;
+            } else if (type != patchType) {
+                break;
+            }
+
+            int indexStride = Far::PatchDescriptor(array.GetPatchType()).GetNumControlVertices();
+            int indexBase = array.GetIndexBase() + indexStride *
+                    (coord.handle.patchIndex - array.GetPrimitiveIdBase());
+
+            params[numPoints] = param;
+            s[numPoints] = coord.s;
+            t[numPoints] = coord.t;
+            cvs[numPoints] = &patchIndexBuffer[indexBase];
+        }
+
+        //  Only the B-spline and bilinear bases are batched -- Gregory basis
+        //  weights are evaluated per point below (contiguous, stride 1):
+        int numControlVertices = 0,
+            weightStride = N;
+        if (patchType == Far::PatchDescriptor::REGULAR) {
+            Far::internal::GetBSplineWeights(numPoints, params, s, t,
+                                             wP, wDu, wDv, wDuu, wDuv, wDvv);
+            numControlVertices = 16;
+        } else if (patchType == Far::PatchDescriptor::GREGORY_BASIS) {
+            numControlVertices = 20;
+            weightStride = 1;
+        } else if (patchType == Far::PatchDescriptor::QUADS) {
+            Far::internal::GetBilinearWeights(numPoints, params, s, t,
+                                              wP, wDu, wDv, wDuu, wDuv, wDvv);
+            numControlVertices = 4;
+        } else {
+            success = false;
+            i += numPoints;
+            continue;
+        }
+
+        for (int k = 0; k < numPoints; ++k) {
+
+            int lane = k;
+            if (weightStride == 1) {
+                Far::internal::GetGregoryWeights(params[k], s[k], t[k],
+                                                 wP, wDu, wDv, wDuu, wDuv, wDvv);
+                lane = 0;
+            }
+
+            for (int e = 0; e < resultLength; ++e) {
+                result[e] = 0.0f;
+            }
+            for (int j = 0; j < numControlVertices; ++j) {
+                float const * srcValues = src + cvs[k][j] * srcDesc.stride;
+
+                float * r = result;
+                for (int a = 0; a < numActive; ++a) {
+                    int o = activeOutputs[a],
+                        length = outputDescs[o]->length;
+                    float weight = weights[o][j * weightStride + lane];
+                    for (int e = 0; e < length; ++e) {
+                        r[e] += srcValues[e] * weight;
+                    }
+                    r += length;
+                }
+            }
+
+            float const * r = result;
+            for (int a = 0; a < numActive; ++a) {
+                int o = activeOutputs[a],
+                    length = outputDescs[o]->length;
+                memcpy(outputs[o] + (i + k) * outputDescs[o]->stride, r,
+                       length * sizeof(float));
+                r += length;
+            }
+        }
+        i += numPoints;
     }
+    return success;
 }
 
 }  // end namespace Osd
@@ -31,10 +31,23 @@
 namespace OpenSubdiv {
 namespace OPENSUBDIV_VERSION {
 
+namespace Far {
+    class CompressedStencilTable;
+}
+
 namespace Osd {
 
 struct BufferDescriptor;
+struct PatchArray;
+struct PatchCoord;
+struct PatchParam;
 
+//
+// Stencil kernels of the CPU evaluator : the source and destination pointers
+// do not include the buffer descriptor offsets, and the results of stencil i
+// in [start, end) are written at (i - start) in the destination buffers, as
+// in the OMP kernels. The TBB and GPU kernels write them at index i instead.
+//
 void
 CpuEvalStencils(float const * src, BufferDescriptor const &srcDesc,
                 float * dst,       BufferDescriptor const &dstDesc,
@@ -44,6 +57,26 @@ CpuEvalStencils(float const * src, BufferDescriptor const &srcDesc,
                 float const * weights,
                 int start, int end);
 
+//
+// Multi-frame stencil kernel : applies the stencils to each of the numFrames
+// pairs of source and destination buffers, sharing the descriptors.
+//
+void
+CpuEvalStencilFrames(float const * const * src, BufferDescriptor const &srcDesc,
+                     float * const * dst,       BufferDescriptor const &dstDesc,
+                     int numFrames,
+                     int const * sizes,
+                     int const * offsets,
+                     int const * indices,
+                     float const * weights,
+                     int start, int end);
+
+//
+// Limit stencil kernels : the destinations may be null to skip their
+// evaluation. The normal kernel writes the normalized cross product of the
+// first three elements of the 'u' and 'v' derivatives instead of the
+// derivatives themselves.
+//
 void
 CpuEvalStencils(float const * src, BufferDescriptor const &srcDesc,
                 float * dst,       BufferDescriptor const &dstDesc,
@@ -76,6 +109,176 @@ CpuEvalStencils(float const * src, BufferDescriptor const &srcDesc,
                 float const * dvvWeights,
                 int start, int end);
 
+void
+CpuEvalStencilNormals(float const * src, BufferDescriptor const &srcDesc,
+                      float * dst,       BufferDescriptor const &dstDesc,
+                      float * dstNormal, BufferDescriptor const &dstNormalDesc,
+                      int const * sizes,
+                      int const * offsets,
+                      int const * indices,
+                      float const * weights,
+                      float const * duWeights,
+                      float const * dvWeights,
+                      int start, int end);
+
+//
+// Double precision variants, e.g. for tables built with
+// Far::StencilTableFactoryReal<double>
+//
+
+void
+CpuEvalStencils(double const * src, BufferDescriptor const &srcDesc,
+                double * dst,       BufferDescriptor const &dstDesc,
+                int const * sizes,
+                int const * offsets,
+                int const * indices,
+                double const * weights,
+                int start, int end);
+
+void
+CpuEvalStencils(double const * src, BufferDescriptor const &srcDesc,
+                double * dst,       BufferDescriptor const &dstDesc,
+                double * dstDu,     BufferDescriptor const &dstDuDesc,
+                double * dstDv,     BufferDescriptor const &dstDvDesc,
+                int const * sizes,
+                int const * offsets,
+                int const * indices,
+                double const * weights,
+                double const * duWeights,
+                double const * dvWeights,
+                int start, int end);
+
+void
+CpuEvalStencils(double const * src, BufferDescriptor const &srcDesc,
+                double * dst,       BufferDescriptor const &dstDesc,
+                double * dstDu,     BufferDescriptor const &dstDuDesc,
+                double * dstDv,     BufferDescriptor const &dstDvDesc,
+                double * dstDuu,    BufferDescriptor const &dstDuuDesc,
+                double * dstDuv,    BufferDescriptor const &dstDuvDesc,
+                double * dstDvv,    BufferDescriptor const &dstDvvDesc,
+                int const * sizes,
+                int const * offsets,
+                int const * indices,
+                double const * weights,
+                double const * duWeights,
+                double const * dvWeights,
+                double const * duuWeights,
+                double const * duvWeights,
+                double const * dvvWeights,
+                int start, int end);
+
+void
+CpuEvalStencilNormals(double const * src, BufferDescriptor const &srcDesc,
+                      double * dst,       BufferDescriptor const &dstDesc,
+                      double * dstNormal, BufferDescriptor const &dstNormalDesc,
+                      int const * sizes,
+                      int const * offsets,
+                      int const * indices,
+                      double const * weights,
+                      double const * duWeights,
+                      double const * dvWeights,
+                      int start, int end);
+
+//
+// Patch evaluation kernel
+//
+
+/// \brief Evaluates the limit (and optionally derivatives) at the patch
+///        coordinates [start, end)
+///
+/// Consecutive coordinates on patches of the same type are evaluated in
+/// batches, the basis weights of a batch being computed together (see
+/// Far::internal::BASIS_BATCH_SIZE). Any of the destination buffers can be
+/// NULL. The result of coordinate i is written at index i of the destination
+/// buffers. Returns false if a patch type is not supported.
+///
+bool
+CpuEvalPatches(float const * src, BufferDescriptor const &srcDesc,
+               float * dst,       BufferDescriptor const &dstDesc,
+               float * dstDu,     BufferDescriptor const &dstDuDesc,
+               float * dstDv,     BufferDescriptor const &dstDvDesc,
+               float * dstDuu,    BufferDescriptor const &dstDuuDesc,
+               float * dstDuv,    BufferDescriptor const &dstDuvDesc,
+               float * dstDvv,    BufferDescriptor const &dstDvvDesc,
+               PatchCoord const * patchCoords,
+               PatchArray const * patchArrays,
+               int const * patchIndexBuffer,
+               PatchParam const * patchParamBuffer,
+               int start, int end);
+
+//
+// Runtime dispatched SIMD stencil kernel
+//
+
+/// \brief Instruction sets the CPU stencil kernel can be dispatched to
+enum CpuKernelIsa {
+    CPU_KERNEL_ISA_SCALAR = 0,  ///< portable C++ loops
+    CPU_KERNEL_ISA_SSE,         ///< 4-wide SSE2
+    CPU_KERNEL_ISA_AVX2,        ///< 8-wide AVX2 + FMA
+    CPU_KERNEL_ISA_AVX512       ///< 16-wide AVX-512F
+};
+
+/// \brief Returns the widest instruction set supported by both this build
+///        and the running CPU
+CpuKernelIsa CpuGetSupportedKernelIsa();
+
+/// \brief Returns the instruction set currently used by the stencil kernel
+CpuKernelIsa CpuGetKernelIsa();
+
+/// \brief Restricts the stencil kernel to the given instruction set (the
+///        request is clamped to CpuGetSupportedKernelIsa()). Mostly useful to
+///        compare kernels in tests and benchmarks.
+void CpuSetKernelIsa(CpuKernelIsa isa);
+
+/// \brief Applies the stencils [start, end) to the source primvar data
+///
+/// The source and destination pointers are expected to already include
+/// their buffer descriptor offsets. 'sizes' is indexed by stencil index,
+/// while 'indices' and 'weights' point to the coefficients of stencil
+/// 'start'. The result of stencil i is written at vertexDst + i * dstStride.
+///
+void
+CpuComputeStencilKernel(float const * vertexSrc, int srcStride,
+                        float * vertexDst, int dstStride,
+                        int length,
+                        int const * sizes,
+                        int const * indices,
+                        float const * weights,
+                        int start, int end);
+
+/// \brief Applies the stencils [start, end) of a compressed stencil table
+///        to the source primvar data
+///
+/// The stencils are decoded block by block into small buffers to which
+/// CpuComputeStencilKernel() is applied. The source and destination pointers
+/// are expected to already include their buffer descriptor offsets. The
+/// result of stencil i is written at vertexDst + (i - start) * dstStride.
+///
+void
+CpuComputeCompressedStencilKernel(float const * vertexSrc, int srcStride,
+                                  float * vertexDst, int dstStride,
+                                  int length,
+                                  Far::CompressedStencilTable const & stencilTable,
+                                  int start, int end);
+
+/// \brief Applies the stencils [start, end) to several frames of source
+///        primvar data, e.g. to bake an animation
+///
+/// The stencils are processed in blocks small enough for their indices and
+/// weights to remain in cache while CpuComputeStencilKernel() applies them
+/// to each of the numFrames pairs (vertexSrc[f], vertexDst[f]) in turn,
+/// rather than streaming the whole table once per frame. The pointers and
+/// results are otherwise as in CpuComputeStencilKernel().
+///
+void
+CpuComputeStencilFramesKernel(float const * const * vertexSrc, int srcStride,
+                              float * const * vertexDst, int dstStride,
+                              int length, int numFrames,
+                              int const * sizes,
+                              int const * indices,
+                              float const * weights,
+                              int start, int end);
+
 //
 // SIMD ICC optimization of the stencil kernel
 //
@@ -24,7 +24,10 @@
 
 #include "../osd/ompEvaluator.h"
 #include "../osd/ompKernel.h"
+#include "../osd/cpuKernel.h"
 #include "../far/patchBasis.h"
+
+#include <algorithm>
 #include <omp.h>
 
 namespace OpenSubdiv {
@@ -53,6 +56,43 @@ OmpEvaluator::EvalStencils(
     return true;
 }
 
+/* static */
+bool
+OmpEvaluator::EvalStencils(
+    const float *src, BufferDescriptor const &srcDesc,
+    float *dst,       BufferDescriptor const &dstDesc,
+    Far::CompressedStencilTable const *stencilTable,
+    int start, int end) {
+
+    if (end <= start) return true;
+    if (srcDesc.length != dstDesc.length) return false;
+
+    OmpEvalStencils(src, srcDesc, dst, dstDesc, *stencilTable, start, end);
+
+    return true;
+}
+
+/* static */
+bool
+OmpEvaluator::EvalStencilFrames(
+    const float * const *srcFrames, BufferDescriptor const &srcDesc,
+    float * const *dstFrames,       BufferDescriptor const &dstDesc,
+    int numFrames,
+    const int * sizes,
+    const int * offsets,
+    const int * indices,
+    const float * weights,
+    int start, int end) {
+
+    if (end <= start || numFrames <= 0) return true;
+    if (srcDesc.length != dstDesc.length) return false;
+
+    OmpEvalStencilFrames(srcFrames, srcDesc, dstFrames, dstDesc, numFrames,
+                         sizes, offsets, indices, weights, start, end);
+
+    return true;
+}
+
 /* static */
 bool
 OmpEvaluator::EvalStencils(
@@ -128,35 +168,44 @@ OmpEvaluator::EvalStencils(
     return true;
 }
 
-template <typename T>
-struct BufferAdapter {
-    BufferAdapter(T *p, int length, int stride) :
-        _p(p), _length(length), _stride(stride) { }
-    void Clear() {
-        for (int i = 0; i < _length; ++i) _p[i] = 0;
-    }
-    void AddWithWeight(T const *src, float w) {
-        if (_p) {
-            // TODO: derivatives.
-            for (int i = 0; i < _length; ++i) {
-                _p[i] += src[i] * w;
-            }
-        }
-    }
-    const T *operator[] (int index) const {
-        return _p + _stride * index;
-    }
-    BufferAdapter<T> & operator ++() {
-        if (_p) {
-            _p += _stride;
-        }
-        return *this;
+//
+//  Patches are evaluated by blocks of coordinates distributed across threads,
+//  each block being evaluated in batches by the CPU kernel:
+//
+static bool
+ompEvalPatches(const float *src, BufferDescriptor const &srcDesc,
+               float *dst,       BufferDescriptor const &dstDesc,
+               float *du,        BufferDescriptor const &duDesc,
+               float *dv,        BufferDescriptor const &dvDesc,
+               float *duu,       BufferDescriptor const &duuDesc,
+               float *duv,       BufferDescriptor const &duvDesc,
+               float *dvv,       BufferDescriptor const &dvvDesc,
+               int numPatchCoords,
+               PatchCoord const *patchCoords,
+               PatchArray const *patchArrays,
+               const int *patchIndexBuffer,
+               PatchParam const *patchParamBuffer) {
+
+    int const blockSize = 8 * Far::internal::BASIS_BATCH_SIZE;
+
+    int numBlocks = (numPatchCoords + blockSize - 1) / blockSize;
+
+    bool success = true;
+
+#pragma omp parallel for reduction(&&:success)
+    for (int block = 0; block < numBlocks; ++block) {
+        int start = block * blockSize,
+            end = std::min(start + blockSize, numPatchCoords);
+
+        success = CpuEvalPatches(src, srcDesc,
+                                 dst, dstDesc, du, duDesc, dv, dvDesc,
+                                 duu, duuDesc, duv, duvDesc, dvv, dvvDesc,
+                                 patchCoords, patchArrays,
+                                 patchIndexBuffer, patchParamBuffer,
+                                 start, end) && success;
     }
-
-    T *_p;
-    int _length;
-    int _stride;
-};
+    return success;
+}
 
 /* static */
 bool
@@ -169,54 +218,17 @@ OmpEvaluator::EvalPatches(
     const int *patchIndexBuffer,
     const PatchParam *patchParamBuffer){
 
-    src += srcDesc.offset;
-    if (dst) dst += dstDesc.offset;
-    else return false;
-    BufferAdapter<const float> srcT(src, srcDesc.length, srcDesc.stride);
-
-#pragma omp parallel for
-    for (int i = 0; i < numPatchCoords; ++i) {
-        BufferAdapter<float> dstT(dst + dstDesc.stride*i, dstDesc.length, dstDesc.stride);
-
-        float wP[20], wDs[20], wDt[20];
-        PatchCoord const &coord = patchCoords[i];
-        PatchArray const &array = patchArrays[coord.handle.arrayIndex];
-
-        Far::PatchParam const & param =
-            patchParamBuffer[coord.handle.patchIndex];
-        int patchType = param.IsRegular()
-            ? Far::PatchDescriptor::REGULAR
-            : array.GetPatchType();
-
-        int numControlVertices = 0;
-        if (patchType == Far::PatchDescriptor::REGULAR) {
-            Far::internal::GetBSplineWeights(param,
-                                             coord.s, coord.t, wP, wDs, wDt);
-            numControlVertices = 16;
-        } else if (patchType == Far::PatchDescriptor::GREGORY_BASIS) {
-            Far::internal::GetGregoryWeights(param,
-                                             coord.s, coord.t, wP, wDs, wDt);
-            numControlVertices = 20;
-        } else if (patchType == Far::PatchDescriptor::QUADS) {
-            Far::internal::GetBilinearWeights(param,
-                                              coord.s, coord.t, wP, wDs, wDt);
-            numControlVertices = 4;
-        } else {
-            continue;
-        }
-
-        int indexStride = Far::PatchDescriptor(array.GetPatchType()).GetNumControlVertices();
-        int indexBase = array.GetIndexBase() + indexStride *
-                (coord.handle.patchIndex - array.GetPrimitiveIdBase());
-
-        const int *cvs = &patchIndexBuffer[indexBase];
-
-        dstT.Clear();
-        for (int j = 0; j < numControlVertices; ++j) {
-            dstT.AddWithWeight(srcT[cvs[j]], wP[j]);
-        }
-    }
-    return true;
+    if (! dst) return false;
+
+    return ompEvalPatches(src, srcDesc,
+                          dst, dstDesc,
+                          NULL, BufferDescriptor(),
+                          NULL, BufferDescriptor(),
+                          NULL, BufferDescriptor(),
+                          NULL, BufferDescriptor(),
+                          NULL, BufferDescriptor(),
+                          numPatchCoords, patchCoords, patchArrays,
+                          patchIndexBuffer, patchParamBuffer);
 }
 
 /* static */
@@ -232,65 +244,15 @@ OmpEvaluator::EvalPatches(
     const int *patchIndexBuffer,
     PatchParam const *patchParamBuffer) {
 
-    src += srcDesc.offset;
-    if (dst) dst += dstDesc.offset;
-    if (du)  du += duDesc.offset;
-    if (dv)  dv += dvDesc.offset;
-
-    BufferAdapter<const float> srcT(src, srcDesc.length, srcDesc.stride);
-
-#pragma omp parallel for
-    for (int i = 0; i < numPatchCoords; ++i) {
-        float wP[20], wDu[20], wDv[20];
-        BufferAdapter<float> dstT(dst + dstDesc.stride*i, dstDesc.length, dstDesc.stride);
-        BufferAdapter<float> duT(du   + duDesc.stride*i, duDesc.length, duDesc.stride);
-        BufferAdapter<float> dvT(dv   + dvDesc.stride*i, dvDesc.length, dvDesc.stride);
-
-        PatchCoord const &coord = patchCoords[i];
-        PatchArray const &array = patchArrays[coord.handle.arrayIndex];
-
-        Far::PatchParam const & param =
-            patchParamBuffer[coord.handle.patchIndex];
-        int patchType = param.IsRegular()
-            ? Far::PatchDescriptor::REGULAR
-            : array.GetPatchType();
-
-        int numControlVertices = 0;
-        if (patchType == Far::PatchDescriptor::REGULAR) {
-            Far::internal::GetBSplineWeights(param,
-                                             coord.s, coord.t, wP, wDu, wDv);
-            numControlVertices = 16;
-        } else if (patchType == Far::PatchDescriptor::GREGORY_BASIS) {
-            Far::internal::GetGregoryWeights(param,
-                                             coord.s, coord.t, wP, wDu, wDv);
-            numControlVertices = 20;
-        } else if (patchType == Far::PatchDescriptor::QUADS) {
-            Far::internal::GetBilinearWeights(param,
-                                              coord.s, coord.t, wP, wDu, wDv);
-            numControlVertices = 4;
-        } else {
-            continue;
-        }
-
-        int indexStride = Far::PatchDescriptor(array.GetPatchType()).GetNumControlVertices();
-        int indexBase = array.GetIndexBase() + indexStride *
-                (coord.handle.patchIndex - array.GetPrimitiveIdBase());
-
-        const int *cvs = &patchIndexBuffer[indexBase];
-
-        dstT.Clear();
-        duT.Clear();
-        dvT.Clear();
-        for (int j = 0; j < numControlVertices; ++j) {
-            dstT.AddWithWeight(srcT[cvs[j]], wP[j]);
-            duT.AddWithWeight(srcT[cvs[j]], wDu[j]);
-            dvT.AddWithWeight(srcT[cvs[j]], wDv[j]);
-        }
-        ++dstT;
-        ++duT;
-        ++dvT;
-    }
-    return true;
+    return ompEvalPatches(src, srcDesc,
+                          dst, dstDesc,
+                          du,  duDesc,
+                          dv,  dvDesc,
+                          NULL, BufferDescriptor(),
+                          NULL, BufferDescriptor(),
+                          NULL, BufferDescriptor(),
+                          numPatchCoords, patchCoords, patchArrays,
+                          patchIndexBuffer, patchParamBuffer);
 }
 
 /* static */
@@ -309,83 +271,15 @@ OmpEvaluator::EvalPatches(
     const int *patchIndexBuffer,
     PatchParam const *patchParamBuffer) {
 
-    src += srcDesc.offset;
-    if (dst) dst += dstDesc.offset;
-    if (du)  du += duDesc.offset;
-    if (dv)  dv += dvDesc.offset;
-    if (duu) duu += duuDesc.offset;
-    if (duv) duv += duvDesc.offset;
-    if (dvv) dvv += dvvDesc.offset;
-
-    BufferAdapter<const float> srcT(src, srcDesc.length, srcDesc.stride);
-
-#pragma omp parallel for
-    for (int i = 0; i < numPatchCoords; ++i) {
-        float wP[20], wDu[20], wDv[20], wDuu[20], wDuv[20], wDvv[20];
-        BufferAdapter<float> dstT(dst + dstDesc.stride*i, dstDesc.length, dstDesc.stride);
-        BufferAdapter<float> duT(du   + duDesc.stride*i, duDesc.length, duDesc.stride);
-        BufferAdapter<float> dvT(dv   + dvDesc.stride*i, dvDesc.length, dvDesc.stride);
-        BufferAdapter<float> duuT(duu + duuDesc.stride*i, duuDesc.length, duuDesc.stride);
-        BufferAdapter<float> duvT(duv + duvDesc.stride*i, duvDesc.length, duvDesc.stride);
-        BufferAdapter<float> dvvT(dvv + dvvDesc.stride*i, dvvDesc.length, dvvDesc.stride);
-
-        PatchCoord const &coord = patchCoords[i];
-        PatchArray const &array = patchArrays[coord.handle.arrayIndex];
-
-        Far::PatchParam const & param =
-            patchParamBuffer[coord.handle.patchIndex];
-        int patchType = param.IsRegular()
-            ? Far::PatchDescriptor::REGULAR
-            : array.GetPatchType();
-
-        int numControlVertices = 0;
-        if (patchType == Far::PatchDescriptor::REGULAR) {
-            Far::internal::GetBSplineWeights(param,
-                                             coord.s, coord.t, wP,
-                                             wDu, wDv, wDuu, wDuv, wDvv);
-            numControlVertices = 16;
-        } else if (patchType == Far::PatchDescriptor::GREGORY_BASIS) {
-            Far::internal::GetGregoryWeights(param,
-                                             coord.s, coord.t, wP,
-                                             wDu, wDv, wDuu, wDuv, wDvv);
-            numControlVertices = 20;
-        } else if (patchType == Far::PatchDescriptor::QUADS) {
-            Far::internal::GetBilinearWeights(param,
-                                              coord.s, coord.t, wP,
-                                              wDu, wDv, wDuu, wDuv, wDvv);
-            numControlVertices = 4;
-        } else {
-            continue;
-        }
-
-        int indexStride = Far::PatchDescriptor(array.GetPatchType()).GetNumControlVertices();
-        int indexBase = array.GetIndexBase() + indexStride *
-                (coord.handle.patchIndex - array.GetPrimitiveIdBase());
-
-        const int *cvs = &patchIndexBuffer[indexBase];
-
-        dstT.Clear();
-        duT.Clear();
-        dvT.Clear();
-        duuT.Clear();
-        duvT.Clear();
-        dvvT.Clear();
-        for (int j = 0; j < numControlVertices; ++j) {
-            dstT.AddWithWeight(srcT[cvs[j]], wP[j]);
-            duT.AddWithWeight(srcT[cvs[j]], wDu[j]);
-            dvT.AddWithWeight(srcT[cvs[j]], wDv[j]);
-            duuT.AddWithWeight(srcT[cvs[j]], wDuu[j]);
-            duvT.AddWithWeight(srcT[cvs[j]], wDuv[j]);
-            dvvT.AddWithWeight(srcT[cvs[j]], wDvv[j]);
-        }
-        ++dstT;
-        ++duT;
-        ++dvT;
-        ++duuT;
-        ++duvT;
-        ++dvvT;
-    }
-    return true;
+    return ompEvalPatches(src, srcDesc,
+                          dst, dstDesc,
+                          du,  duDesc,
+                          dv,  dvDesc,
+                          duu, duuDesc,
+                          duv, duvDesc,
+                          dvv, dvvDesc,
+                          numPatchCoords, patchCoords, patchArrays,
+                          patchIndexBuffer, patchParamBuffer);
 }
 
 
@@ -23,8 +23,11 @@
 //
 
 #include "../osd/ompKernel.h"
+#include "../osd/cpuKernel.h"
 #include "../osd/bufferDescriptor.h"
+#include "../far/compressedStencilTable.h"
 
+#include <algorithm>
 #include <cassert>
 #include <cstdlib>
 #include <omp.h>
@@ -70,8 +73,35 @@ copy(float *dst, int dstIndex, const float *src,
 }
 
 
-// XXXX manuelk this should be optimized further by using SIMD - considering
-//              OMP is somewhat obsolete - this is probably not worth it.
+void
+OmpEvalStencils(float const * src, BufferDescriptor const &srcDesc,
+                float * dst,       BufferDescriptor const &dstDesc,
+                Far::CompressedStencilTable const & stencilTable,
+                int start, int end) {
+    start = (start > 0 ? start : 0);
+
+    src += srcDesc.offset;
+    dst += dstDesc.offset;
+
+    // Chunks are aligned on the blocks of the table, so that each thread
+    // decodes whole blocks, and results are written at (index - start).
+    int const chunkSize = 4 * Far::CompressedStencilTable::GetBlockSize();
+
+    int firstChunk = start / chunkSize,
+        numChunks = (end + chunkSize - 1) / chunkSize - firstChunk;
+
+#pragma omp parallel for
+    for (int chunk = 0; chunk < numChunks; ++chunk) {
+
+        int first = std::max(start, (firstChunk + chunk) * chunkSize),
+            last = std::min(end, (firstChunk + chunk + 1) * chunkSize);
+
+        CpuComputeCompressedStencilKernel(src, srcDesc.stride,
+            dst + (first - start) * dstDesc.stride, dstDesc.stride,
+            dstDesc.length, stencilTable, first, last);
+    }
+}
+
 void
 OmpEvalStencils(float const * src, BufferDescriptor const &srcDesc,
                 float * dst,       BufferDescriptor const &dstDesc,
@@ -81,36 +111,70 @@ OmpEvalStencils(float const * src, BufferDescriptor const &srcDesc,
                 float const * weights,
                 int start, int end) {
     start = (start > 0 ? start : 0);
-    
+
     src += srcDesc.offset;
     dst += dstDesc.offset;
 
-    int numThreads = omp_get_max_threads();
-    int n = end - start;
+    // Stencils are distributed in contiguous chunks so that each thread runs
+    // the runtime dispatched SIMD kernel (see cpuKernel.h) over its range.
+    // Sizes are rebased so that results are written at (index - start),
+    // as in the other OMP kernels.
+    int const chunkSize = 256;
 
-    float * result = (float*)alloca(srcDesc.length * numThreads * sizeof(float));
+    int n = end - start;
+    int numChunks = (n + chunkSize - 1) / chunkSize;
 
 #pragma omp parallel for
-    for (int i = 0; i < n; ++i) {
+    for (int chunk = 0; chunk < numChunks; ++chunk) {
 
-        int index = i + start; // Stencil index
+        int first = chunk * chunkSize,
+            last = std::min(first + chunkSize, n);
 
-        // Get thread-local pointers
-        int const           * threadIndices = indices + offsets[index];
-        float const         * threadWeights = weights + offsets[index];
+        int offset = offsets[first + start];
 
-        int threadId = omp_get_thread_num();
+        CpuComputeStencilKernel(src, srcDesc.stride, dst, dstDesc.stride,
+            dstDesc.length, sizes + start, indices + offset, weights + offset,
+            first, last);
+    }
+}
 
-        float * threadResult = result + threadId*srcDesc.length;
+void
+OmpEvalStencilFrames(float const * const * src, BufferDescriptor const &srcDesc,
+                     float * const * dst,       BufferDescriptor const &dstDesc,
+                     int numFrames,
+                     int const * sizes,
+                     int const * offsets,
+                     int const * indices,
+                     float const * weights,
+                     int start, int end) {
+    start = (start > 0 ? start : 0);
 
-        clear(threadResult, dstDesc);
+    std::vector<float const *> srcFrames(numFrames);
+    std::vector<float *>       dstFrames(numFrames);
+    for (int frame = 0; frame < numFrames; ++frame) {
+        srcFrames[frame] = src[frame] + srcDesc.offset;
+        dstFrames[frame] = dst[frame] + dstDesc.offset;
+    }
 
-        for (int j=0; j<(int)sizes[index]; ++j) {
-            addWithWeight(threadResult, src,
-                threadIndices[j], threadWeights[j], srcDesc);
-        }
+    // Same distribution as the single frame kernel above : each thread
+    // applies its chunk of stencils to all the frames.
+    int const chunkSize = 256;
 
-        copy(dst, i, threadResult, dstDesc);
+    int n = end - start;
+    int numChunks = (n + chunkSize - 1) / chunkSize;
+
+#pragma omp parallel for
+    for (int chunk = 0; chunk < numChunks; ++chunk) {
+
+        int first = chunk * chunkSize,
+            last = std::min(first + chunkSize, n);
+
+        int offset = offsets[first + start];
+
+        CpuComputeStencilFramesKernel(&srcFrames[0], srcDesc.stride,
+            &dstFrames[0], dstDesc.stride, dstDesc.length, numFrames,
+            sizes + start, indices + offset, weights + offset,
+            first, last);
     }
 }
 
@@ -30,10 +30,20 @@
 namespace OpenSubdiv {
 namespace OPENSUBDIV_VERSION {
 
+namespace Far {
+    class CompressedStencilTable;
+}
+
 namespace Osd {
 
 struct BufferDescriptor;
 
+void
+OmpEvalStencils(float const * src, BufferDescriptor const &srcDesc,
+                float * dst,       BufferDescriptor const &dstDesc,
+                Far::CompressedStencilTable const & stencilTable,
+                int start, int end);
+
 void
 OmpEvalStencils(float const * src, BufferDescriptor const &srcDesc,
                 float * dst,       BufferDescriptor const &dstDesc,
@@ -43,6 +53,16 @@ OmpEvalStencils(float const * src, BufferDescriptor const &srcDesc,
                 float const * weights,
                 int start, int end);
 
+void
+OmpEvalStencilFrames(float const * const * src, BufferDescriptor const &srcDesc,
+                     float * const * dst,       BufferDescriptor const &dstDesc,
+                     int numFrames,
+                     int const * sizes,
+                     int const * offsets,
+                     int const * indices,
+                     float const * weights,
+                     int start, int end);
+
 void
 OmpEvalStencils(float const * src, BufferDescriptor const &srcDesc,
                 float * dst,       BufferDescriptor const &dstDesc,
@@ -51,6 +51,27 @@ TbbEvaluator::EvalStencils(
     return true;
 }
 
+/* static */
+bool
+TbbEvaluator::EvalStencilFrames(
+    const float * const *srcFrames, BufferDescriptor const &srcDesc,
+    float * const *dstFrames,       BufferDescriptor const &dstDesc,
+    int numFrames,
+    const int * sizes,
+    const int * offsets,
+    const int * indices,
+    const float * weights,
+    int start, int end) {
+
+    if (end <= start || numFrames <= 0) return true;
+    if (srcDesc.length != dstDesc.length) return false;
+
+    TbbEvalStencilFrames(srcFrames, srcDesc, dstFrames, dstDesc, numFrames,
+                         sizes, offsets, indices, weights, start, end);
+
+    return true;
+}
+
 /* static */
 bool
 TbbEvaluator::EvalStencils(
@@ -30,6 +30,7 @@
 #include "../osd/types.h"
 
 #include <cstddef>
+#include <vector>
 
 namespace OpenSubdiv {
 namespace OPENSUBDIV_VERSION {
@@ -114,7 +115,9 @@ public:
     ///
     /// @param weights        pointer to the weights buffer of the stencil table
     ///
-    /// @param start          start index of stencil table
+    /// @param start          start index of stencil table. The result of
+    ///                       stencil i is written at index i in the output
+    ///                       buffers
     ///
     /// @param end            end index of stencil table
     ///
@@ -227,7 +230,9 @@ public:
     ///
     /// @param dvWeights      pointer to the dv-weights buffer of the stencil table
     ///
-    /// @param start          start index of stencil table
+    /// @param start          start index of stencil table. The result of
+    ///                       stencil i is written at index i in the output
+    ///                       buffers
     ///
     /// @param end            end index of stencil table
     ///
@@ -392,7 +397,9 @@ public:
     ///
     /// @param dvvWeights     pointer to the dvv-weights buffer of the stencil table
     ///
-    /// @param start          start index of stencil table
+    /// @param start          start index of stencil table. The result of
+    ///                       stencil i is written at index i in the output
+    ///                       buffers
     ///
     /// @param end            end index of stencil table
     ///
@@ -415,6 +422,112 @@ public:
         const float * dvvWeights,
         int start, int end);
 
+    /// ----------------------------------------------------------------------
+    ///
+    ///   Stencil evaluations over several frames
+    ///
+    /// ----------------------------------------------------------------------
+
+    /// \brief Generic static eval stencils function applying the stencil
+    ///        table to several frames of primvar data at once, e.g. to bake
+    ///        an animation. Each thread applies its range of stencils to all
+    ///        the frames while their indices and weights are in cache.
+    ///
+    /// @param srcBuffers     Input primvar buffers, one per frame.
+    ///                       must have BindCpuBuffer() method returning a
+    ///                       const float pointer for read
+    ///
+    /// @param srcDesc        vertex buffer descriptor for the input buffers
+    ///
+    /// @param dstBuffers     Output primvar buffers, one per frame.
+    ///                       must have BindCpuBuffer() method returning a
+    ///                       float pointer for write
+    ///
+    /// @param dstDesc        vertex buffer descriptor for the output buffers
+    ///
+    /// @param numFrames      number of input and output buffers
+    ///
+    /// @param stencilTable   Far::StencilTable or equivalent
+    ///
+    /// @param instance       not used in the tbb kernel
+    ///                       (declared as a typed pointer to prevent
+    ///                        undesirable template resolution)
+    ///
+    /// @param deviceContext  not used in the tbb kernel
+    ///
+    template <typename SRC_BUFFER, typename DST_BUFFER, typename STENCIL_TABLE>
+    static bool EvalStencilFrames(
+        SRC_BUFFER * const *srcBuffers, BufferDescriptor const &srcDesc,
+        DST_BUFFER * const *dstBuffers, BufferDescriptor const &dstDesc,
+        int numFrames,
+        STENCIL_TABLE const *stencilTable,
+        TbbEvaluator const *instance = NULL,
+        void * deviceContext = NULL) {
+
+        (void)instance;       // unused
+        (void)deviceContext;  // unused
+
+        if (stencilTable->GetNumStencils() == 0 || numFrames <= 0)
+            return false;
+
+        std::vector<const float *> src(numFrames);
+        std::vector<float *>       dst(numFrames);
+        for (int frame = 0; frame < numFrames; ++frame) {
+            src[frame] = srcBuffers[frame]->BindCpuBuffer();
+            dst[frame] = dstBuffers[frame]->BindCpuBuffer();
+        }
+
+        return EvalStencilFrames(&src[0], srcDesc,
+                                 &dst[0], dstDesc,
+                                 numFrames,
+                                 &stencilTable->GetSizes()[0],
+                                 &stencilTable->GetOffsets()[0],
+                                 &stencilTable->GetControlIndices()[0],
+                                 &stencilTable->GetWeights()[0],
+                                 /*start = */ 0,
+                                 /*end   = */ stencilTable->GetNumStencils());
+    }
+
+    /// \brief Static multi-frame eval stencils function which takes raw CPU
+    ///        pointers for input and output.
+    ///
+    /// @param srcFrames      Input primvar pointers, one per frame. An offset
+    ///                       of srcDesc will be applied internally (i.e. the
+    ///                       pointers should not include the offset)
+    ///
+    /// @param srcDesc        vertex buffer descriptor for the input buffers
+    ///
+    /// @param dstFrames      Output primvar pointers, one per frame. An
+    ///                       offset of dstDesc will be applied internally.
+    ///
+    /// @param dstDesc        vertex buffer descriptor for the output buffers
+    ///
+    /// @param numFrames      number of input and output pointers
+    ///
+    /// @param sizes          pointer to the sizes buffer of the stencil table
+    ///
+    /// @param offsets        pointer to the offsets buffer of the stencil table
+    ///
+    /// @param indices        pointer to the indices buffer of the stencil table
+    ///
+    /// @param weights        pointer to the weights buffer of the stencil table
+    ///
+    /// @param start          start index of stencil table. The result of
+    ///                       stencil i is written at index i in the output
+    ///                       buffers
+    ///
+    /// @param end            end index of stencil table
+    ///
+    static bool EvalStencilFrames(
+        const float * const *srcFrames, BufferDescriptor const &srcDesc,
+        float * const *dstFrames,       BufferDescriptor const &dstDesc,
+        int numFrames,
+        const int * sizes,
+        const int * offsets,
+        const int * indices,
+        const float * weights,
+        int start, int end);
+
     /// ----------------------------------------------------------------------
     ///
     ///   Limit evaluations with PatchTable
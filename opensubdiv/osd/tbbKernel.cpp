@@ -26,11 +26,11 @@
 #include "../osd/tbbKernel.h"
 #include "../osd/types.h"
 #include "../osd/bufferDescriptor.h"
-#include "../far/patchBasis.h"
 
 #include <cassert>
 #include <cstdlib>
 #include <tbb/parallel_for.h>
+#include <vector>
 
 namespace OpenSubdiv {
 namespace OPENSUBDIV_VERSION {
@@ -39,41 +39,6 @@ namespace Osd {
 
 #define grain_size  200
 
-template <class T> T *
-elementAtIndex(T * src, int index, BufferDescriptor const &desc) {
-
-    return src + index * desc.stride;
-}
-
-static inline void
-clear(float *dst, BufferDescriptor const &desc) {
-
-    assert(dst);
-    memset(dst, 0, desc.length*sizeof(float));
-}
-
-static inline void
-addWithWeight(float *dst, const float *src, int srcIndex, float weight,
-              BufferDescriptor const &desc) {
-
-    assert(src && dst);
-    src = elementAtIndex(src, srcIndex, desc);
-    for (int k = 0; k < desc.length; ++k) {
-        dst[k] += src[k] * weight;
-    }
-}
-
-static inline void
-copy(float *dst, int dstIndex, const float *src,
-     BufferDescriptor const &desc) {
-
-    assert(src && dst);
-
-    dst = elementAtIndex(dst, dstIndex, desc);
-    memcpy(dst, src, desc.length*sizeof(float));
-}
-
-
 class TBBStencilKernel {
 
     BufferDescriptor _srcDesc;
@@ -113,50 +78,12 @@ public:
     }
 
     void operator() (tbb::blocked_range<int> const &r) const {
-#define USE_SIMD
-#ifdef USE_SIMD
-        if (_srcDesc.length==4 && _srcDesc.stride==4 && _dstDesc.stride==4) {
-
-            // SIMD fast path for aligned primvar data (4 floats)
-            int offset = _offsets[r.begin()];
-            ComputeStencilKernel<4>(_vertexSrc, _vertexDst,
-                _sizes, _indices+offset, _weights+offset, r.begin(), r.end());
-
-        } else if (_srcDesc.length==8 && _srcDesc.stride==4 && _dstDesc.stride==4) {
-
-            // SIMD fast path for aligned primvar data (8 floats)
-            int offset = _offsets[r.begin()];
-            ComputeStencilKernel<8>(_vertexSrc, _vertexDst,
-                _sizes, _indices+offset, _weights+offset, r.begin(), r.end());
-
-        } else {
-#else
-        {
-#endif
-            int const * sizes = _sizes;
-            int const * indices = _indices;
-            float const * weights = _weights;
-
-            if (r.begin()>0) {
-                sizes += r.begin();
-                indices += _offsets[r.begin()];
-                weights += _offsets[r.begin()];
-            }
-
-            // Slow path for non-aligned data
-            float * result = (float*)alloca(_srcDesc.length * sizeof(float));
-
-            for (int i=r.begin(); i<r.end(); ++i, ++sizes) {
-
-                clear(result, _dstDesc);
-
-                for (int j=0; j<*sizes; ++j) {
-                    addWithWeight(result, _vertexSrc, *indices++, *weights++, _srcDesc);
-                }
-
-                copy(_vertexDst, i, result, _dstDesc);
-            }
-        }
+
+        // runtime dispatched SIMD kernel (see cpuKernel.h)
+        int offset = _offsets[r.begin()];
+        CpuComputeStencilKernel(_vertexSrc, _srcDesc.stride,
+            _vertexDst, _dstDesc.stride, _dstDesc.length,
+            _sizes, _indices+offset, _weights+offset, r.begin(), r.end());
     }
 };
 
@@ -180,6 +107,83 @@ TbbEvalStencils(float const * src, BufferDescriptor const &srcDesc,
     tbb::parallel_for(range, kernel);
 }
 
+class TBBStencilFramesKernel {
+
+    BufferDescriptor _srcDesc;
+    BufferDescriptor _dstDesc;
+    float const * const * _vertexSrc;
+    float * const * _vertexDst;
+    int _numFrames;
+
+    int const * _sizes;
+    int const * _offsets,
+              * _indices;
+    float const * _weights;
+
+public:
+    TBBStencilFramesKernel(float const * const *src, BufferDescriptor srcDesc,
+                           float * const *dst,       BufferDescriptor dstDesc,
+                           int numFrames,
+                           int const * sizes, int const * offsets,
+                           int const * indices, float const * weights) :
+         _srcDesc(srcDesc),
+         _dstDesc(dstDesc),
+         _vertexSrc(src),
+         _vertexDst(dst),
+         _numFrames(numFrames),
+         _sizes(sizes),
+         _offsets(offsets),
+         _indices(indices),
+         _weights(weights) { }
+
+    TBBStencilFramesKernel(TBBStencilFramesKernel const & other) {
+        _srcDesc    = other._srcDesc;
+        _dstDesc    = other._dstDesc;
+        _sizes      = other._sizes;
+        _offsets    = other._offsets;
+        _indices    = other._indices;
+        _weights    = other._weights;
+        _vertexSrc  = other._vertexSrc;
+        _vertexDst  = other._vertexDst;
+        _numFrames  = other._numFrames;
+    }
+
+    void operator() (tbb::blocked_range<int> const &r) const {
+
+        // applies the range of stencils to all the frames (see cpuKernel.h)
+        int offset = _offsets[r.begin()];
+        CpuComputeStencilFramesKernel(_vertexSrc, _srcDesc.stride,
+            _vertexDst, _dstDesc.stride, _dstDesc.length, _numFrames,
+            _sizes, _indices+offset, _weights+offset, r.begin(), r.end());
+    }
+};
+
+void
+TbbEvalStencilFrames(float const * const * src, BufferDescriptor const &srcDesc,
+                     float * const * dst,       BufferDescriptor const &dstDesc,
+                     int numFrames,
+                     int const * sizes,
+                     int const * offsets,
+                     int const * indices,
+                     float const * weights,
+                     int start, int end) {
+
+    std::vector<float const *> srcFrames(numFrames);
+    std::vector<float *>       dstFrames(numFrames);
+    for (int frame = 0; frame < numFrames; ++frame) {
+        srcFrames[frame] = src[frame] + srcDesc.offset;
+        dstFrames[frame] = dst[frame] + dstDesc.offset;
+    }
+
+    TBBStencilFramesKernel kernel(&srcFrames[0], srcDesc,
+                                  &dstFrames[0], dstDesc, numFrames,
+                                  sizes, offsets, indices, weights);
+
+    tbb::blocked_range<int> range(start, end, grain_size);
+
+    tbb::parallel_for(range, kernel);
+}
+
 void
 TbbEvalStencils(float const * src, BufferDescriptor const &srcDesc,
                 float * dst,       BufferDescriptor const &dstDesc,
@@ -295,35 +299,6 @@ TbbEvalStencils(float const * src, BufferDescriptor const &srcDesc,
 
 // ---------------------------------------------------------------------------
 
-template <typename T>
-struct BufferAdapter {
-    BufferAdapter(T *p, int length, int stride) :
-        _p(p), _length(length), _stride(stride) { }
-    void Clear() {
-        for (int i = 0; i < _length; ++i) _p[i] = 0;
-    }
-    void AddWithWeight(T const *src, float w) {
-        if (_p) {
-            for (int i = 0; i < _length; ++i) {
-                _p[i] += src[i] * w;
-            }
-        }
-    }
-    const T *operator[] (int index) const {
-        return _p + _stride * index;
-    }
-    BufferAdapter<T> & operator ++() {
-        if (_p) {
-            _p += _stride;
-        }
-        return *this;
-    }
-
-    T *_p;
-    int _length;
-    int _stride;
-};
-
 class TbbEvalPatchesKernel {
     BufferDescriptor _srcDesc;
     BufferDescriptor _dstDesc;
@@ -372,225 +347,17 @@ public:
     }
 
     void operator() (tbb::blocked_range<int> const &r) const {
-        if (_dstDu == NULL && _dstDv == NULL) {
-            compute(r);
-        } else if (_dstDuu == NULL && _dstDuv == NULL && _dstDvv == NULL) {
-            computeWith1stDerivative(r);
-        } else {
-            computeWith2ndDerivative(r);
-        }
-    }
-
-    void compute(tbb::blocked_range<int> const &r) const {
-        float wP[20], wDu[20], wDv[20];
-        BufferAdapter<const float> srcT(_src + _srcDesc.offset,
-                                        _srcDesc.length,
-                                        _srcDesc.stride);
-        BufferAdapter<float> dstT(_dst + _dstDesc.offset
-                                       + r.begin() * _dstDesc.stride,
-                                  _dstDesc.length,
-                                  _dstDesc.stride);
-
-
-        for (int i = r.begin(); i < r.end(); ++i) {
-            PatchCoord const &coord = _patchCoords[i];
-            PatchArray const &array = _patchArrayBuffer[coord.handle.arrayIndex];
-
-            Far::PatchParam const & param =
-                _patchParamBuffer[coord.handle.patchIndex];
-            int patchType = param.IsRegular()
-                ? Far::PatchDescriptor::REGULAR
-                : array.GetPatchType();
-
-            int numControlVertices = 0;
-            if (patchType == Far::PatchDescriptor::REGULAR) {
-                Far::internal::GetBSplineWeights(param,
-                                                 coord.s, coord.t, wP,
-                                                 wDu, wDv);
-                numControlVertices = 16;
-            } else if (patchType == Far::PatchDescriptor::GREGORY_BASIS) {
-                Far::internal::GetGregoryWeights(param,
-                                                 coord.s, coord.t, wP,
-                                                 wDu, wDv);
-                numControlVertices = 20;
-            } else if (patchType == Far::PatchDescriptor::QUADS) {
-                Far::internal::GetBilinearWeights(param,
-                                                  coord.s, coord.t, wP,
-                                                  wDu, wDv);
-                numControlVertices = 4;
-            } else {
-                assert(0);
-            }
-
-            int indexStride = Far::PatchDescriptor(array.GetPatchType()).GetNumControlVertices();
-            int indexBase = array.GetIndexBase() + indexStride *
-                    (coord.handle.patchIndex - array.GetPrimitiveIdBase());
-
-            const int *cvs = &_patchIndexBuffer[indexBase];
-
-            dstT.Clear();
-            for (int j = 0; j < numControlVertices; ++j) {
-                dstT.AddWithWeight(srcT[cvs[j]], wP[j]);
-            }
-            ++dstT;
-        }
-    }
-
-    void computeWith1stDerivative(tbb::blocked_range<int> const &r) const {
-        float wP[20], wDu[20], wDv[20];
-        BufferAdapter<const float> srcT(_src + _srcDesc.offset,
-                                        _srcDesc.length,
-                                        _srcDesc.stride);
-        BufferAdapter<float> dstT(_dst + _dstDesc.offset
-                                       + r.begin() * _dstDesc.stride,
-                                  _dstDesc.length,
-                                  _dstDesc.stride);
-        BufferAdapter<float> dstDuT(_dstDu + _dstDuDesc.offset
-                                       + r.begin() * _dstDuDesc.stride,
-                                    _dstDuDesc.length,
-                                    _dstDuDesc.stride);
-        BufferAdapter<float> dstDvT(_dstDv + _dstDvDesc.offset
-                                       + r.begin() * _dstDvDesc.stride,
-                                    _dstDvDesc.length,
-                                    _dstDvDesc.stride);
-
-        for (int i = r.begin(); i < r.end(); ++i) {
-            PatchCoord const &coord = _patchCoords[i];
-            PatchArray const &array = _patchArrayBuffer[coord.handle.arrayIndex];
-
-            Far::PatchParam const & param =
-                _patchParamBuffer[coord.handle.patchIndex];
-            int patchType = param.IsRegular()
-                ? Far::PatchDescriptor::REGULAR
-                : array.GetPatchType();
-
-            int numControlVertices = 0;
-            if (patchType == Far::PatchDescriptor::REGULAR) {
-                Far::internal::GetBSplineWeights(param,
-                                                 coord.s, coord.t, wP,
-                                                 wDu, wDv);
-                numControlVertices = 16;
-            } else if (patchType == Far::PatchDescriptor::GREGORY_BASIS) {
-                Far::internal::GetGregoryWeights(param,
-                                                 coord.s, coord.t, wP,
-                                                 wDu, wDv);
-                numControlVertices = 20;
-            } else if (patchType == Far::PatchDescriptor::QUADS) {
-                Far::internal::GetBilinearWeights(param,
-                                                  coord.s, coord.t,
-                                                  wP, wDu, wDv);
-                numControlVertices = 4;
-            } else {
-                assert(0);
-            }
-
-            int indexStride = Far::PatchDescriptor(array.GetPatchType()).GetNumControlVertices();
-            int indexBase = array.GetIndexBase() + indexStride *
-                    (coord.handle.patchIndex - array.GetPrimitiveIdBase());
-
-            const int *cvs = &_patchIndexBuffer[indexBase];
-
-            dstT.Clear();
-            dstDuT.Clear();
-            dstDvT.Clear();
-            for (int j = 0; j < numControlVertices; ++j) {
-                dstT.AddWithWeight(srcT[cvs[j]], wP[j]);
-                dstDuT.AddWithWeight(srcT[cvs[j]], wDu[j]);
-                dstDvT.AddWithWeight(srcT[cvs[j]], wDv[j]);
-            }
-            ++dstT;
-            ++dstDuT;
-            ++dstDvT;
-        }
-    }
-
-    void computeWith2ndDerivative(tbb::blocked_range<int> const &r) const {
-        float wP[20], wDu[20], wDv[20], wDuu[20], wDuv[20], wDvv[20];
-        BufferAdapter<const float> srcT(_src + _srcDesc.offset,
-                                        _srcDesc.length,
-                                        _srcDesc.stride);
-        BufferAdapter<float> dstT(_dst + _dstDesc.offset
-                                       + r.begin() * _dstDesc.stride,
-                                  _dstDesc.length,
-                                  _dstDesc.stride);
-        BufferAdapter<float> dstDuT(_dstDu + _dstDuDesc.offset
-                                       + r.begin() * _dstDuDesc.stride,
-                                  _dstDuDesc.length,
-                                  _dstDuDesc.stride);
-        BufferAdapter<float> dstDvT(_dstDv + _dstDvDesc.offset
-                                       + r.begin() * _dstDvDesc.stride,
-                                  _dstDvDesc.length,
-                                  _dstDvDesc.stride);
-        BufferAdapter<float> dstDuuT(_dstDuu + _dstDuuDesc.offset
-                                       + r.begin() * _dstDuuDesc.stride,
-                                  _dstDuuDesc.length,
-                                  _dstDuuDesc.stride);
-        BufferAdapter<float> dstDuvT(_dstDuv + _dstDuvDesc.offset
-                                       + r.begin() * _dstDuvDesc.stride,
-                                  _dstDuvDesc.length,
-                                  _dstDuvDesc.stride);
-        BufferAdapter<float> dstDvvT(_dstDvv + _dstDvvDesc.offset
-                                       + r.begin() * _dstDvvDesc.stride,
-                                  _dstDvvDesc.length,
-                                  _dstDvvDesc.stride);
-
-        for (int i = r.begin(); i < r.end(); ++i) {
-            PatchCoord const &coord = _patchCoords[i];
-            PatchArray const &array = _patchArrayBuffer[coord.handle.arrayIndex];
-
-            Far::PatchParam const & param =
-                _patchParamBuffer[coord.handle.patchIndex];
-            int patchType = param.IsRegular()
-                ? Far::PatchDescriptor::REGULAR
-                : array.GetPatchType();
-
-            int numControlVertices = 0;
-            if (patchType == Far::PatchDescriptor::REGULAR) {
-                Far::internal::GetBSplineWeights(param,
-                                                 coord.s, coord.t, wP,
-                                                 wDu, wDv, wDuu, wDuv, wDvv);
-                numControlVertices = 16;
-            } else if (patchType == Far::PatchDescriptor::GREGORY_BASIS) {
-                Far::internal::GetGregoryWeights(param,
-                                                 coord.s, coord.t, wP,
-                                                 wDu, wDv, wDuu, wDuv, wDvv);
-                numControlVertices = 20;
-            } else if (patchType == Far::PatchDescriptor::QUADS) {
-                Far::internal::GetBilinearWeights(param,
-                                                  coord.s, coord.t, wP,
-                                                 wDu, wDv, wDuu, wDuv, wDvv);
-                numControlVertices = 4;
-            } else {
-                assert(0);
-            }
-
-            int indexStride = Far::PatchDescriptor(array.GetPatchType()).GetNumControlVertices();
-            int indexBase = array.GetIndexBase() + indexStride *
-                    (coord.handle.patchIndex - array.GetPrimitiveIdBase());
-
-            const int *cvs = &_patchIndexBuffer[indexBase];
-
-            dstT.Clear();
-            dstDuT.Clear();
-            dstDvT.Clear();
-            dstDuuT.Clear();
-            dstDuvT.Clear();
-            dstDvvT.Clear();
-            for (int j = 0; j < numControlVertices; ++j) {
-                dstT.AddWithWeight(srcT[cvs[j]], wP[j]);
-                dstDuT.AddWithWeight(srcT[cvs[j]], wDu[j]);
-                dstDvT.AddWithWeight(srcT[cvs[j]], wDv[j]);
-                dstDuuT.AddWithWeight(srcT[cvs[j]], wDuu[j]);
-                dstDuvT.AddWithWeight(srcT[cvs[j]], wDuv[j]);
-                dstDvvT.AddWithWeight(srcT[cvs[j]], wDvv[j]);
-            }
-            ++dstT;
-            ++dstDuT;
-            ++dstDvT;
-            ++dstDuuT;
-            ++dstDuvT;
-            ++dstDvvT;
-        }
+        // evaluated in batches of coordinates by the CPU kernel
+        CpuEvalPatches(_src, _srcDesc,
+                       _dst, _dstDesc,
+                       _dstDu, _dstDuDesc,
+                       _dstDv, _dstDvDesc,
+                       _dstDuu, _dstDuuDesc,
+                       _dstDuv, _dstDuvDesc,
+                       _dstDvv, _dstDvvDesc,
+                       _patchCoords, _patchArrayBuffer,
+                       _patchIndexBuffer, _patchParamBuffer,
+                       r.begin(), r.end());
     }
 };
 
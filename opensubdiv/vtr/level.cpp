@@ -1652,7 +1652,7 @@ Level::findEdge(Index v0Index, Index v1Index) const {
 }
 
 bool
-Level::completeTopologyFromFaceVertices() {
+Level::completeTopologyFromFaceVertices(bool useMultipleThreads) {
 
     //
     //  It's assumed (a pre-condition) that face-vertices have been fully specified and that we
@@ -1673,6 +1673,15 @@ Level::completeTopologyFromFaceVertices() {
     this->resizeFaces(fCount);
     this->resizeEdges(0);
 
+    //
+    //  When using multiple threads, first attempt to identify the edges by sorting pairs of
+    //  face-vertices (see below) -- which does not deal with edges repeated within a face
+    //  and leaves those to the incremental construction that follows:
+    //
+    if (useMultipleThreads && this->completeTopologyFromSortedFaceVertices(true)) {
+        return (_maxValence <= VALENCE_LIMIT);
+    }
+
     //
     //  Resize face-edges to match face-verts and reserve for edges based on an estimate:
     //
@@ -1825,8 +1834,284 @@ Level::completeTopologyFromFaceVertices() {
     return true;
 }
 
+//
+//  Completes the topology as above by identifying the edges from sorted pairs of face-
+//  vertices, i.e. without searching the incident edges of each vertex for every face,
+//  with the loops over components distributed across threads when requested.
+//
+//  The resulting topology is identical to that of the incremental construction:  edges are
+//  numbered and oriented by their first occurrence in the faces and all incident members
+//  are in the order in which they would have been appended.  Meshes with degenerate edges
+//  or with edges repeated within a face (which lead to multiple instances of an edge) are
+//  not supported, and false is returned for them before anything is modified.
+//
+namespace {
+    //
+    //  Each face-vertex and the next vertex of its face define a "half-edge", which are
+    //  grouped by their lower vertex and then sorted by the other to gather those of each
+    //  edge (in the order of the face-vertices):
+    //
+    struct HalfEdge {
+        Index _otherVert;
+        Index _faceVert;
+
+        bool operator<(HalfEdge const & other) const {
+            return (_otherVert < other._otherVert) ||
+                   ((_otherVert == other._otherVert) && (_faceVert < other._faceVert));
+        }
+    };
+
+    inline int
+    getHalfEdgeRunEnd(HalfEdge const * halfEdges, int begin, int end) {
+        int runEnd = begin + 1;
+        while ((runEnd < end) && (halfEdges[runEnd]._otherVert == halfEdges[begin]._otherVert)) {
+            ++ runEnd;
+        }
+        return runEnd;
+    }
+}
+
+bool
+Level::completeTopologyFromSortedFaceVertices(bool useMultipleThreads) {
+
+    int vCount  = this->getNumVertices();
+    int fCount  = this->getNumFaces();
+    int fvCount = this->getNumFaceVerticesTotal();
+
+    //
+    //  Identify the face and next vertex of each face-vertex, failing if any edge is
+    //  degenerate:
+    //
+    IndexVector fvFaces(fvCount);
+    IndexVector fvNextVerts(fvCount);
+
+    int degenerateEdgeCount = 0;
+
+#ifdef OPENSUBDIV_HAS_OPENMP
+    #pragma omp parallel for reduction(+:degenerateEdgeCount) if (useMultipleThreads)
+#endif
+    for (Index fIndex = 0; fIndex < fCount; ++fIndex) {
+        ConstIndexArray fVerts   = this->getFaceVertices(fIndex);
+        int             fvOffset = this->getOffsetOfFaceVertices(fIndex);
+
+        for (int i = 0; i < fVerts.size(); ++i) {
+            Index v1Index = fVerts[(i+1) % fVerts.size()];
+
+            fvFaces[fvOffset + i]     = fIndex;
+            fvNextVerts[fvOffset + i] = v1Index;
+
+            degenerateEdgeCount += (fVerts[i] == v1Index);
+        }
+    }
+    if (degenerateEdgeCount > 0) return false;
+
+    //
+    //  Group the half-edges by their lower vertex (preserving the order of face-vertices)
+    //  and sort those of each vertex.  The first half-edge of each run with the same other
+    //  vertex "leads" the edge, and the edge is repeated within a face if two successive
+    //  half-edges of a run share a face:
+    //
+    IndexVector           vHalfEdgeOffsets(vCount + 1, 0);
+    std::vector<HalfEdge> halfEdges(fvCount);
+
+    for (int fv = 0; fv < fvCount; ++fv) {
+        ++ vHalfEdgeOffsets[std::min(_faceVertIndices[fv], fvNextVerts[fv]) + 1];
+    }
+    for (Index vIndex = 0; vIndex < vCount; ++vIndex) {
+        vHalfEdgeOffsets[vIndex + 1] += vHalfEdgeOffsets[vIndex];
+    }
+    IndexVector vHalfEdgeCursors(vHalfEdgeOffsets.begin(), vHalfEdgeOffsets.end() - 1);
+    for (int fv = 0; fv < fvCount; ++fv) {
+        Index v0Index = _faceVertIndices[fv];
+        Index v1Index = fvNextVerts[fv];
+
+        HalfEdge & halfEdge = halfEdges[vHalfEdgeCursors[std::min(v0Index, v1Index)]++];
+        halfEdge._otherVert = std::max(v0Index, v1Index);
+        halfEdge._faceVert  = fv;
+    }
+
+    IndexVector fvLeaders(fvCount);
+
+    int repeatedEdgeCount = 0;
+
+#ifdef OPENSUBDIV_HAS_OPENMP
+    #pragma omp parallel for reduction(+:repeatedEdgeCount) if (useMultipleThreads)
+#endif
+    for (Index vIndex = 0; vIndex < vCount; ++vIndex) {
+        HalfEdge * vHalfEdges = &halfEdges[0] + vHalfEdgeOffsets[vIndex];
+        int        vHalfEdgeCount = vHalfEdgeOffsets[vIndex + 1] - vHalfEdgeOffsets[vIndex];
+
+        std::sort(vHalfEdges, vHalfEdges + vHalfEdgeCount);
+
+        for (int i = 0; i < vHalfEdgeCount; ) {
+            int runEnd = getHalfEdgeRunEnd(vHalfEdges, i, vHalfEdgeCount);
+
+            Index leader = vHalfEdges[i]._faceVert;
+            fvLeaders[leader] = leader;
+            for (int j = i + 1; j < runEnd; ++j) {
+                fvLeaders[vHalfEdges[j]._faceVert] = leader;
+
+                repeatedEdgeCount += (fvFaces[vHalfEdges[j]._faceVert] ==
+                                      fvFaces[vHalfEdges[j-1]._faceVert]);
+            }
+            i = runEnd;
+        }
+    }
+    if (repeatedEdgeCount > 0) return false;
+
+    //
+    //  Number the edges in the order of their leading half-edges, from which they are also
+    //  oriented, and assign the face-edges:
+    //
+    this->_faceEdgeIndices.resize(fvCount);
+
+    int eCount = 0;
+    for (int fv = 0; fv < fvCount; ++fv) {
+        if (fvLeaders[fv] == fv) {
+            _faceEdgeIndices[fv] = eCount ++;
+        }
+    }
+    this->resizeEdges(eCount);
+    this->_edgeVertIndices.resize(2 * eCount);
+
+#ifdef OPENSUBDIV_HAS_OPENMP
+    #pragma omp parallel for if (useMultipleThreads)
+#endif
+    for (Index fv = 0; fv < fvCount; ++fv) {
+        if (fvLeaders[fv] == fv) {
+            Index eIndex = _faceEdgeIndices[fv];
+
+            _edgeVertIndices[2*eIndex]   = _faceVertIndices[fv];
+            _edgeVertIndices[2*eIndex+1] = fvNextVerts[fv];
+        } else {
+            _faceEdgeIndices[fv] = _faceEdgeIndices[fvLeaders[fv]];
+        }
+    }
+
+    //
+    //  Edge-faces -- the faces of the half-edges of each edge.  An edge is non-manifold if
+    //  it has more than two faces, or two faces with the same orientation:
+    //
+#ifdef OPENSUBDIV_HAS_OPENMP
+    #pragma omp parallel for if (useMultipleThreads)
+#endif
+    for (Index vIndex = 0; vIndex < vCount; ++vIndex) {
+        HalfEdge const * vHalfEdges = &halfEdges[0] + vHalfEdgeOffsets[vIndex];
+        int              vHalfEdgeCount = vHalfEdgeOffsets[vIndex + 1] - vHalfEdgeOffsets[vIndex];
+
+        for (int i = 0; i < vHalfEdgeCount; ) {
+            int runEnd = getHalfEdgeRunEnd(vHalfEdges, i, vHalfEdgeCount);
+
+            Index eIndex = _faceEdgeIndices[vHalfEdges[i]._faceVert];
+            _edgeFaceCountsAndOffsets[2*eIndex] = runEnd - i;
+            i = runEnd;
+        }
+    }
+
+    int maxEdgeFaces = 0;
+    for (Index eIndex = 0, offset = 0; eIndex < eCount; ++eIndex) {
+        int count = _edgeFaceCountsAndOffsets[2*eIndex];
+
+        _edgeFaceCountsAndOffsets[2*eIndex+1] = offset;
+        offset += count;
+        maxEdgeFaces = std::max(maxEdgeFaces, count);
+    }
+    this->_edgeFaceIndices.resize(fvCount);
+
+#ifdef OPENSUBDIV_HAS_OPENMP
+    #pragma omp parallel for if (useMultipleThreads)
+#endif
+    for (Index vIndex = 0; vIndex < vCount; ++vIndex) {
+        HalfEdge const * vHalfEdges = &halfEdges[0] + vHalfEdgeOffsets[vIndex];
+        int              vHalfEdgeCount = vHalfEdgeOffsets[vIndex + 1] - vHalfEdgeOffsets[vIndex];
+
+        for (int i = 0; i < vHalfEdgeCount; ) {
+            int runEnd = getHalfEdgeRunEnd(vHalfEdges, i, vHalfEdgeCount);
+
+            Index      eIndex = _faceEdgeIndices[vHalfEdges[i]._faceVert];
+            IndexArray eFaces = this->getEdgeFaces(eIndex);
+            for (int j = i; j < runEnd; ++j) {
+                eFaces[j - i] = fvFaces[vHalfEdges[j]._faceVert];
+            }
+            if ((eFaces.size() > 2) || ((eFaces.size() == 2) &&
+                    (_faceVertIndices[vHalfEdges[i]._faceVert] ==
+                     _faceVertIndices[vHalfEdges[i+1]._faceVert]))) {
+                _edgeTags[eIndex]._nonManifold = true;
+            }
+            i = runEnd;
+        }
+    }
+
+    //
+    //  Vert-faces and vert-edges -- in the order of the face-vertices and of the edges:
+    //
+    int maxVertFaces = 0;
+    int maxVertEdges = 0;
+
+    IndexVector vCursors(vCount, 0);
+
+    for (int fv = 0; fv < fvCount; ++fv) {
+        ++ vCursors[_faceVertIndices[fv]];
+    }
+    for (Index vIndex = 0, offset = 0; vIndex < vCount; ++vIndex) {
+        _vertFaceCountsAndOffsets[2*vIndex]   = vCursors[vIndex];
+        _vertFaceCountsAndOffsets[2*vIndex+1] = offset;
+        vCursors[vIndex] = offset;
+        offset += _vertFaceCountsAndOffsets[2*vIndex];
+        maxVertFaces = std::max(maxVertFaces, _vertFaceCountsAndOffsets[2*vIndex]);
+    }
+    this->_vertFaceIndices.resize(fvCount);
+    for (int fv = 0; fv < fvCount; ++fv) {
+        _vertFaceIndices[vCursors[_faceVertIndices[fv]]++] = fvFaces[fv];
+    }
+
+    std::fill(vCursors.begin(), vCursors.end(), 0);
+    for (int ev = 0; ev < 2 * eCount; ++ev) {
+        ++ vCursors[_edgeVertIndices[ev]];
+    }
+    for (Index vIndex = 0, offset = 0; vIndex < vCount; ++vIndex) {
+        _vertEdgeCountsAndOffsets[2*vIndex]   = vCursors[vIndex];
+        _vertEdgeCountsAndOffsets[2*vIndex+1] = offset;
+        vCursors[vIndex] = offset;
+        offset += _vertEdgeCountsAndOffsets[2*vIndex];
+        maxVertEdges = std::max(maxVertEdges, _vertEdgeCountsAndOffsets[2*vIndex]);
+    }
+    this->_vertEdgeIndices.resize(2 * eCount);
+    for (int ev = 0; ev < 2 * eCount; ++ev) {
+        _vertEdgeIndices[vCursors[_edgeVertIndices[ev]]++] = ev >> 1;
+    }
+
+    //
+    //  Assign the maximum relation counts and test for valence overflow as above (leaving
+    //  the caller to report the failure), then tag the vertices of non-manifold edges and
+    //  orient the incident components:
+    //
+    _maxEdgeFaces = maxEdgeFaces;
+
+    assert(_maxValence > 0);
+    _maxValence = std::max(maxVertFaces, _maxValence);
+    _maxValence = std::max(maxVertEdges, _maxValence);
+
+    if (_maxValence > VALENCE_LIMIT) {
+        return true;
+    }
+
+    for (Index eIndex = 0; eIndex < eCount; ++eIndex) {
+        if (_edgeTags[eIndex]._nonManifold) {
+            _vertTags[_edgeVertIndices[2*eIndex]]._nonManifold   = true;
+            _vertTags[_edgeVertIndices[2*eIndex+1]]._nonManifold = true;
+        }
+    }
+
+    orientIncidentComponents(useMultipleThreads);
+
+    populateLocalIndices(useMultipleThreads);
+
+    return true;
+}
+
 void
-Level::populateLocalIndices() {
+Level::populateLocalIndices(bool useMultipleThreads) {
 
     //
     //  We have three sets of local indices -- edge-faces, vert-faces and vert-edges:
@@ -1838,6 +2123,9 @@ Level::populateLocalIndices() {
     this->_vertEdgeLocalIndices.resize(this->_vertEdgeIndices.size());
     this->_edgeFaceLocalIndices.resize(this->_edgeFaceIndices.size());
 
+#ifdef OPENSUBDIV_HAS_OPENMP
+    #pragma omp parallel for if (useMultipleThreads)
+#endif
     for (Index vIndex = 0; vIndex < vCount; ++vIndex) {
         IndexArray      vFaces   = this->getVertexFaces(vIndex);
         LocalIndexArray vInFaces = this->getVertexFaceLocalIndices(vIndex);
@@ -1861,6 +2149,9 @@ Level::populateLocalIndices() {
         }
     }
 
+#ifdef OPENSUBDIV_HAS_OPENMP
+    #pragma omp parallel for if (useMultipleThreads)
+#endif
     for (Index vIndex = 0; vIndex < vCount; ++vIndex) {
         IndexArray      vEdges   = this->getVertexEdges(vIndex);
         LocalIndexArray vInEdges = this->getVertexEdgeLocalIndices(vIndex);
@@ -1878,9 +2169,14 @@ Level::populateLocalIndices() {
                 vInEdges[i] = (i && (vEdges[i] == vEdges[i-1]));
             }
         }
-        _maxValence = std::max(_maxValence, vEdges.size());
+    }
+    for (Index vIndex = 0; vIndex < vCount; ++vIndex) {
+        _maxValence = std::max(_maxValence, this->getNumVertexEdges(vIndex));
     }
 
+#ifdef OPENSUBDIV_HAS_OPENMP
+    #pragma omp parallel for if (useMultipleThreads)
+#endif
     for (Index eIndex = 0; eIndex < eCount; ++eIndex) {
         IndexArray      eFaces   = this->getEdgeFaces(eIndex);
         LocalIndexArray eInFaces = this->getEdgeFaceLocalIndices(eIndex);
@@ -1906,10 +2202,13 @@ Level::populateLocalIndices() {
 }
 
 void
-Level::orientIncidentComponents() {
+Level::orientIncidentComponents(bool useMultipleThreads) {
 
     int vCount = getNumVertices();
 
+#ifdef OPENSUBDIV_HAS_OPENMP
+    #pragma omp parallel for if (useMultipleThreads)
+#endif
     for (Index vIndex = 0; vIndex < vCount; ++vIndex) {
         Level::VTag & vTag = _vertTags[vIndex];
         if (!vTag._nonManifold) {
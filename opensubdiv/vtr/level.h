@@ -438,14 +438,15 @@ public:
     //  it necessary to write code to define and orient all relations -- and most
     //  of that seemed best placed here.
     //
-    bool completeTopologyFromFaceVertices();
+    bool completeTopologyFromFaceVertices(bool useMultipleThreads = false);
     Index findEdge(Index v0, Index v1, ConstIndexArray v0Edges) const;
 
     //  Methods supporting the above:
-    void orientIncidentComponents();
+    bool completeTopologyFromSortedFaceVertices(bool useMultipleThreads);
+    void orientIncidentComponents(bool useMultipleThreads = false);
     bool orderVertexFacesAndEdges(Index vIndex, Index* vFaces, Index* vEdges) const;
     bool orderVertexFacesAndEdges(Index vIndex);
-    void populateLocalIndices();
+    void populateLocalIndices(bool useMultipleThreads = false);
 
     IndexArray shareFaceVertCountsAndOffsets() const;
 
@@ -115,6 +115,9 @@ QuadRefinement::populateFaceVertexCountsAndOffsets() {
 
     _child->_faceVertCountsAndOffsets.resize(_child->getNumFaces() * 2);
 
+#ifdef OPENSUBDIV_HAS_OPENMP
+    #pragma omp parallel for if (_parallel)
+#endif
     for (int i = 0; i < _child->getNumFaces(); ++i) {
         _child->_faceVertCountsAndOffsets[i*2 + 0] = 4;
         _child->_faceVertCountsAndOffsets[i*2 + 1] = i << 2;
@@ -134,6 +137,9 @@ QuadRefinement::populateFaceVerticesFromParentFaces() {
     //  for its face-verts from the child vertices of the parent face, its edges
     //  and its vertices.
     //
+#ifdef OPENSUBDIV_HAS_OPENMP
+    #pragma omp parallel for if (_parallel)
+#endif
     for (Index pFace = 0; pFace < _parent->getNumFaces(); ++pFace) {
         ConstIndexArray pFaceVerts = _parent->getFaceVertices(pFace),
                         pFaceEdges = _parent->getFaceEdges(pFace),
@@ -205,6 +211,9 @@ QuadRefinement::populateFaceEdgesFromParentFaces() {
     //  The two remaining edges per child faces are perpendicular to these prev/next
     //  edges and share the child vertex of the parent face.
     //
+#ifdef OPENSUBDIV_HAS_OPENMP
+    #pragma omp parallel for if (_parallel)
+#endif
     for (Index pFace = 0; pFace < _parent->getNumFaces(); ++pFace) {
         ConstIndexArray pFaceVerts = _parent->getFaceVertices(pFace),
                         pFaceEdges = _parent->getFaceEdges(pFace),
@@ -293,6 +302,9 @@ QuadRefinement::populateEdgeVerticesFromParentFaces() {
     //  to all.  The second vertex is the child vertex of the parent edge to
     //  which the new child edge is perpendicular.
     //
+#ifdef OPENSUBDIV_HAS_OPENMP
+    #pragma omp parallel for if (_parallel)
+#endif
     for (Index pFace = 0; pFace < _parent->getNumFaces(); ++pFace) {
         ConstIndexArray pFaceEdges      = _parent->getFaceEdges(pFace),
                         pFaceChildEdges = getFaceChildEdges(pFace);
@@ -318,6 +330,9 @@ QuadRefinement::populateEdgeVerticesFromParentEdges() {
     //  to both.  The second vertex is the child vertex of the vertex at the
     //  end of the parent edge.
     //
+#ifdef OPENSUBDIV_HAS_OPENMP
+    #pragma omp parallel for if (_parallel)
+#endif
     for (Index pEdge = 0; pEdge < _parent->getNumEdges(); ++pEdge) {
         ConstIndexArray pEdgeVerts = _parent->getEdgeVertices(pEdge),
                         pEdgeChildren = getEdgeChildEdges(pEdge);
@@ -376,9 +391,17 @@ QuadRefinement::populateEdgeFaceRelation() {
     // update _maxEdgeFaces.
     _child->_maxEdgeFaces = _parent->_maxEdgeFaces;
 
+    if (_parallel) {
+        reserveEdgeFaceCountsAndOffsets();
+    }
+
     populateEdgeFacesFromParentFaces();
     populateEdgeFacesFromParentEdges();
 
+    if (_parallel) {
+        compactEdgeFaceCountsAndOffsets();
+    }
+
     //  Revise the over-allocated estimate based on what is used (as indicated in the
     //  count/offset for the last vertex) and trim the index vector accordingly:
     childEdgeFaceIndexSizeEstimate = _child->getNumEdgeFaces(_child->getNumEdges()-1) +
@@ -402,6 +425,9 @@ QuadRefinement::populateEdgeFacesFromParentFaces() {
     //  orientation of child faces within their parent depends on it being a quad
     //  or not.
     //
+#ifdef OPENSUBDIV_HAS_OPENMP
+    #pragma omp parallel for if (_parallel)
+#endif
     for (Index pFace = 0; pFace < _parent->getNumFaces(); ++pFace) {
         ConstIndexArray pFaceChildFaces = getFaceChildFaces(pFace),
                         pFaceChildEdges = getFaceChildEdges(pFace);
@@ -414,7 +440,7 @@ QuadRefinement::populateEdgeFacesFromParentFaces() {
                 //
                 //  Reserve enough edge-faces, populate and trim as needed:
                 //
-                _child->resizeEdgeFaces(cEdge, 2);
+                if (!_parallel) _child->resizeEdgeFaces(cEdge, 2);
 
                 IndexArray      cEdgeFaces  = _child->getEdgeFaces(cEdge);
                 LocalIndexArray cEdgeInFace = _child->getEdgeFaceLocalIndices(cEdge);
@@ -446,9 +472,12 @@ QuadRefinement::populateEdgeFacesFromParentEdges() {
 
     //
     //  Note -- the edge-face counts/offsets vector is not known
-    //  ahead of time and is populated incrementally, so we cannot
-    //  thread this yet...
+    //  ahead of time and is populated incrementally, unless it was
+    //  reserved in advance to populate this concurrently...
     //
+#ifdef OPENSUBDIV_HAS_OPENMP
+    #pragma omp parallel for if (_parallel)
+#endif
     for (Index pEdge = 0; pEdge < _parent->getNumEdges(); ++pEdge) {
         ConstIndexArray pEdgeChildEdges = getEdgeChildEdges(pEdge);
         if (!IndexIsValid(pEdgeChildEdges[0]) && !IndexIsValid(pEdgeChildEdges[1])) continue;
@@ -462,7 +491,7 @@ QuadRefinement::populateEdgeFacesFromParentEdges() {
             if (!IndexIsValid(cEdge)) continue;
 
             //  Reserve enough edge-faces, populate and trim as needed:
-            _child->resizeEdgeFaces(cEdge, pEdgeFaces.size());
+            if (!_parallel) _child->resizeEdgeFaces(cEdge, pEdgeFaces.size());
 
             IndexArray      cEdgeFaces  = _child->getEdgeFaces(cEdge);
             LocalIndexArray cEdgeInFace = _child->getEdgeFaceLocalIndices(cEdge);
@@ -509,6 +538,7 @@ QuadRefinement::populateEdgeFacesFromParentEdges() {
 //      - sparse refinement poses challenges with allocation here:
 //          - we need to update the counts/offsets as we populate
 //          - note this imposes ordering constraints and inhibits concurrency
+//            (unless counts/offsets are reserved in advance when refining in parallel)
 //
 void
 QuadRefinement::populateVertexFaceRelation() {
@@ -539,6 +569,10 @@ QuadRefinement::populateVertexFaceRelation() {
     _child->_vertFaceIndices.resize(         childVertFaceIndexSizeEstimate);
     _child->_vertFaceLocalIndices.resize(    childVertFaceIndexSizeEstimate);
 
+    if (_parallel) {
+        reserveVertexFaceCountsAndOffsets();
+    }
+
     if (getFirstChildVertexFromVertices() == 0) {
         populateVertexFacesFromParentVertices();
         populateVertexFacesFromParentFaces();
@@ -549,6 +583,10 @@ QuadRefinement::populateVertexFaceRelation() {
         populateVertexFacesFromParentVertices();
     }
 
+    if (_parallel) {
+        compactVertexFaceCountsAndOffsets();
+    }
+
     //  Revise the over-allocated estimate based on what is used (as indicated in the
     //  count/offset for the last vertex) and trim the index vectors accordingly:
     childVertFaceIndexSizeEstimate = _child->getNumVertexFaces(_child->getNumVertices()-1) +
@@ -560,6 +598,9 @@ QuadRefinement::populateVertexFaceRelation() {
 void
 QuadRefinement::populateVertexFacesFromParentFaces() {
 
+#ifdef OPENSUBDIV_HAS_OPENMP
+    #pragma omp parallel for if (_parallel)
+#endif
     for (int pFace = 0; pFace < _parent->getNumFaces(); ++pFace) {
         int cVert = _faceChildVertIndex[pFace];
         if (!IndexIsValid(cVert)) continue;
@@ -570,7 +611,7 @@ QuadRefinement::populateVertexFacesFromParentFaces() {
         //
         //  Reserve enough vert-faces, populate and trim to the actual size:
         //
-        _child->resizeVertexFaces(cVert, pFaceSize);
+        if (!_parallel) _child->resizeVertexFaces(cVert, pFaceSize);
 
         IndexArray      cVertFaces  = _child->getVertexFaces(cVert);
         LocalIndexArray cVertInFace = _child->getVertexFaceLocalIndices(cVert);
@@ -595,6 +636,9 @@ QuadRefinement::populateVertexFacesFromParentFaces() {
 void
 QuadRefinement::populateVertexFacesFromParentEdges() {
 
+#ifdef OPENSUBDIV_HAS_OPENMP
+    #pragma omp parallel for if (_parallel)
+#endif
     for (int pEdge = 0; pEdge < _parent->getNumEdges(); ++pEdge) {
         int cVert = _edgeChildVertIndex[pEdge];
         if (!IndexIsValid(cVert)) continue;
@@ -605,7 +649,7 @@ QuadRefinement::populateVertexFacesFromParentEdges() {
         //
         //  Reserve enough vert-faces, populate and trim to the actual size:
         //
-        _child->resizeVertexFaces(cVert, 2 * pEdgeFaces.size());
+        if (!_parallel) _child->resizeVertexFaces(cVert, 2 * pEdgeFaces.size());
 
         IndexArray      cVertFaces  = _child->getVertexFaces(cVert);
         LocalIndexArray cVertInFace = _child->getVertexFaceLocalIndices(cVert);
@@ -647,6 +691,9 @@ QuadRefinement::populateVertexFacesFromParentEdges() {
 void
 QuadRefinement::populateVertexFacesFromParentVertices() {
 
+#ifdef OPENSUBDIV_HAS_OPENMP
+    #pragma omp parallel for if (_parallel)
+#endif
     for (int pVert = 0; pVert < _parent->getNumVertices(); ++pVert) {
         int cVert = _vertChildVertIndex[pVert];
         if (!IndexIsValid(cVert)) continue;
@@ -657,7 +704,7 @@ QuadRefinement::populateVertexFacesFromParentVertices() {
         //
         //  Reserve enough vert-faces, populate and trim to the actual size:
         //
-        _child->resizeVertexFaces(cVert, pVertFaces.size());
+        if (!_parallel) _child->resizeVertexFaces(cVert, pVertFaces.size());
 
         IndexArray      cVertFaces  = _child->getVertexFaces(cVert);
         LocalIndexArray cVertInFace = _child->getVertexFaceLocalIndices(cVert);
@@ -692,6 +739,7 @@ QuadRefinement::populateVertexFacesFromParentVertices() {
 //      - sparse refinement poses challenges with allocation here:
 //          - we need to update the counts/offsets as we populate
 //          - note this imposes ordering constraints and inhibits concurrency
+//            (unless counts/offsets are reserved in advance when refining in parallel)
 //
 void
 QuadRefinement::populateVertexEdgeRelation() {
@@ -726,6 +774,10 @@ QuadRefinement::populateVertexEdgeRelation() {
     _child->_vertEdgeIndices.resize(         childVertEdgeIndexSizeEstimate);
     _child->_vertEdgeLocalIndices.resize(    childVertEdgeIndexSizeEstimate);
 
+    if (_parallel) {
+        reserveVertexEdgeCountsAndOffsets();
+    }
+
     if (getFirstChildVertexFromVertices() == 0) {
         populateVertexEdgesFromParentVertices();
         populateVertexEdgesFromParentFaces();
@@ -736,6 +788,10 @@ QuadRefinement::populateVertexEdgeRelation() {
         populateVertexEdgesFromParentVertices();
     }
 
+    if (_parallel) {
+        compactVertexEdgeCountsAndOffsets();
+    }
+
     //  Revise the over-allocated estimate based on what is used (as indicated in the
     //  count/offset for the last vertex) and trim the index vectors accordingly:
     childVertEdgeIndexSizeEstimate = _child->getNumVertexEdges(_child->getNumVertices()-1) +
@@ -747,6 +803,9 @@ QuadRefinement::populateVertexEdgeRelation() {
 void
 QuadRefinement::populateVertexEdgesFromParentFaces() {
 
+#ifdef OPENSUBDIV_HAS_OPENMP
+    #pragma omp parallel for if (_parallel)
+#endif
     for (int pFace = 0; pFace < _parent->getNumFaces(); ++pFace) {
         int cVert = _faceChildVertIndex[pFace];
         if (!IndexIsValid(cVert)) continue;
@@ -757,7 +816,7 @@ QuadRefinement::populateVertexEdgesFromParentFaces() {
         //
         //  Reserve enough vert-edges, populate and trim to the actual size:
         //
-        _child->resizeVertexEdges(cVert, pFaceVerts.size());
+        if (!_parallel) _child->resizeVertexEdges(cVert, pFaceVerts.size());
 
         IndexArray      cVertEdges  = _child->getVertexEdges(cVert);
         LocalIndexArray cVertInEdge = _child->getVertexEdgeLocalIndices(cVert);
@@ -795,6 +854,9 @@ QuadRefinement::populateVertexEdgesFromParentEdges() {
     //  face.  We then swap the second and third (and possibly the first two) so
     //  that we have the desired origin sequence beginning [edge, face, edge, ...]
     //
+#ifdef OPENSUBDIV_HAS_OPENMP
+    #pragma omp parallel for if (_parallel)
+#endif
     for (int pEdge = 0; pEdge < _parent->getNumEdges(); ++pEdge) {
         int cVert = _edgeChildVertIndex[pEdge];
         if (!IndexIsValid(cVert)) continue;
@@ -808,7 +870,7 @@ QuadRefinement::populateVertexEdgesFromParentEdges() {
         //
         //  Reserve enough vert-edges, populate and trim to the actual size:
         //
-        _child->resizeVertexEdges(cVert, pEdgeFaces.size() + 2);
+        if (!_parallel) _child->resizeVertexEdges(cVert, pEdgeFaces.size() + 2);
 
         IndexArray      cVertEdges  = _child->getVertexEdges(cVert);
         LocalIndexArray cVertInEdge = _child->getVertexEdgeLocalIndices(cVert);
@@ -869,6 +931,9 @@ QuadRefinement::populateVertexEdgesFromParentEdges() {
 void
 QuadRefinement::populateVertexEdgesFromParentVertices() {
 
+#ifdef OPENSUBDIV_HAS_OPENMP
+    #pragma omp parallel for if (_parallel)
+#endif
     for (int pVert = 0; pVert < _parent->getNumVertices(); ++pVert) {
         int cVert = _vertChildVertIndex[pVert];
         if (!IndexIsValid(cVert)) continue;
@@ -879,7 +944,7 @@ QuadRefinement::populateVertexEdgesFromParentVertices() {
         //
         //  Reserve enough vert-edges, populate and trim to the actual size:
         //
-        _child->resizeVertexEdges(cVert, pVertEdges.size());
+        if (!_parallel) _child->resizeVertexEdges(cVert, pVertEdges.size());
 
         IndexArray      cVertEdges  = _child->getVertexEdges(cVert);
         LocalIndexArray cVertInEdge = _child->getVertexEdgeLocalIndices(cVert);
@@ -31,6 +31,7 @@
 #include "../vtr/fvarRefinement.h"
 #include "../vtr/stackBuffer.h"
 
+#include <algorithm>
 #include <cassert>
 #include <cstdio>
 #include <utility>
@@ -52,6 +53,7 @@ Refinement::Refinement(Level const & parentArg, Level & childArg, Sdc::Options c
     _regFaceSize(-1),
     _uniform(false),
     _faceVertsFirst(false),
+    _parallel(false),
     _childFaceFromFaceCount(0),
     _childEdgeFromFaceCount(0),
     _childEdgeFromEdgeCount(0),
@@ -113,6 +115,10 @@ Refinement::initializeSparseSelectionTags() {
 //      - subdivide the sharpness values in the child Level
 //      - subdivide face-varying channels in the child Level
 //
+//  When the "parallel" option is set, the loops over parent or child components within
+//  each of these steps are distributed across threads (when OpenMP is available).  The
+//  steps themselves remain sequential as each depends on the results of the previous.
+//
 void
 Refinement::refine(Options refineOptions) {
 
@@ -121,6 +127,7 @@ Refinement::refine(Options refineOptions) {
 
     _uniform        = !refineOptions._sparse;
     _faceVertsFirst =  refineOptions._faceVertsFirst;
+    _parallel       =  refineOptions._parallel;
 
     //  We may soon have an option here to suppress refinement of FVar channels...
     bool refineOptions_ignoreFVarChannels = false;
@@ -641,9 +648,12 @@ Refinement::populateFaceTagsFromParentFaces() {
     //
     //  Tags for faces originating from faces are inherited from the parent face:
     //
-    Index cFace    = getFirstChildFaceFromFaces();
-    Index cFaceEnd = cFace + getNumChildFacesFromFaces();
-    for ( ; cFace < cFaceEnd; ++cFace) {
+    Index cFaceBegin = getFirstChildFaceFromFaces();
+    Index cFaceEnd   = cFaceBegin + getNumChildFacesFromFaces();
+#ifdef OPENSUBDIV_HAS_OPENMP
+    #pragma omp parallel for if (_parallel)
+#endif
+    for (Index cFace = cFaceBegin; cFace < cFaceEnd; ++cFace) {
         _child->_faceTags[cFace] = _parent->_faceTags[_childFaceParentIndex[cFace]];
     }
 }
@@ -677,9 +687,12 @@ Refinement::populateEdgeTagsFromParentEdges() {
     //
     //  Tags for edges originating from edges are inherited from the parent edge:
     //
-    Index cEdge    = getFirstChildEdgeFromEdges();
-    Index cEdgeEnd = cEdge + getNumChildEdgesFromEdges();
-    for ( ; cEdge < cEdgeEnd; ++cEdge) {
+    Index cEdgeBegin = getFirstChildEdgeFromEdges();
+    Index cEdgeEnd   = cEdgeBegin + getNumChildEdgesFromEdges();
+#ifdef OPENSUBDIV_HAS_OPENMP
+    #pragma omp parallel for if (_parallel)
+#endif
+    for (Index cEdge = cEdgeBegin; cEdge < cEdgeEnd; ++cEdge) {
         _child->_edgeTags[cEdge] = _parent->_edgeTags[_childEdgeParentIndex[cEdge]];
     }
 }
@@ -694,7 +707,11 @@ Refinement::populateVertexTagVectors() {
     populateVertexTagsFromParentVertices();
 
     if (!_uniform) {
-        for (Index cVert = 0; cVert < _child->getNumVertices(); ++cVert) {
+        int numChildVerts = _child->getNumVertices();
+#ifdef OPENSUBDIV_HAS_OPENMP
+        #pragma omp parallel for if (_parallel)
+#endif
+        for (Index cVert = 0; cVert < numChildVerts; ++cVert) {
             if (_childVertexTag[cVert]._incomplete) {
                 _child->_vertTags[cVert]._incomplete = true;
             }
@@ -715,15 +732,21 @@ Refinement::populateVertexTagsFromParentFaces() {
     vTag.clear();
     vTag._rule = Sdc::Crease::RULE_SMOOTH;
 
-    Index cVert    = getFirstChildVertexFromFaces();
-    Index cVertEnd = cVert + getNumChildVerticesFromFaces();
+    Index cVertBegin = getFirstChildVertexFromFaces();
+    Index cVertEnd   = cVertBegin + getNumChildVerticesFromFaces();
 
     if (_parent->_depth > 0) {
-        for ( ; cVert < cVertEnd; ++cVert) {
+#ifdef OPENSUBDIV_HAS_OPENMP
+        #pragma omp parallel for if (_parallel)
+#endif
+        for (Index cVert = cVertBegin; cVert < cVertEnd; ++cVert) {
             _child->_vertTags[cVert] = vTag;
         }
     } else {
-        for ( ; cVert < cVertEnd; ++cVert) {
+#ifdef OPENSUBDIV_HAS_OPENMP
+        #pragma omp parallel for if (_parallel)
+#endif
+        for (Index cVert = cVertBegin; cVert < cVertEnd; ++cVert) {
             _child->_vertTags[cVert] = vTag;
 
             if (_parent->getNumFaceVertices(_childVertexParentIndex[cVert]) != _regFaceSize) {
@@ -739,17 +762,21 @@ Refinement::populateVertexTagsFromParentEdges() {
     //  Tags for vertices originating from edges are initialized according to the tags
     //  of the parent edge:
     //
-    Level::VTag vTag;
-    vTag.clear();
-
-    for (Index pEdge = 0; pEdge < _parent->getNumEdges(); ++pEdge) {
+    int numParentEdges = _parent->getNumEdges();
+#ifdef OPENSUBDIV_HAS_OPENMP
+    #pragma omp parallel for if (_parallel)
+#endif
+    for (Index pEdge = 0; pEdge < numParentEdges; ++pEdge) {
         Index cVert = _edgeChildVertIndex[pEdge];
         if (!IndexIsValid(cVert)) continue;
 
-        //  From the cleared local VTag, we just need to assign properties dependent
+        //  From a cleared local VTag, we just need to assign properties dependent
         //  on the parent edge:
         Level::ETag const& pEdgeTag = _parent->_edgeTags[pEdge];
 
+        Level::VTag vTag;
+        vTag.clear();
+
         vTag._nonManifold    = pEdgeTag._nonManifold;
         vTag._boundary       = pEdgeTag._boundary;
         vTag._semiSharpEdges = pEdgeTag._semiSharp;
@@ -769,9 +796,12 @@ Refinement::populateVertexTagsFromParentVertices() {
     //
     //  Tags for vertices originating from vertices are inherited from the parent vertex:
     //
-    Index cVert    = getFirstChildVertexFromVertices();
-    Index cVertEnd = cVert + getNumChildVerticesFromVertices();
-    for ( ; cVert < cVertEnd; ++cVert) {
+    Index cVertBegin = getFirstChildVertexFromVertices();
+    Index cVertEnd   = cVertBegin + getNumChildVerticesFromVertices();
+#ifdef OPENSUBDIV_HAS_OPENMP
+    #pragma omp parallel for if (_parallel)
+#endif
+    for (Index cVert = cVertBegin; cVert < cVertEnd; ++cVert) {
         _child->_vertTags[cVert] = _parent->_vertTags[_childVertexParentIndex[cVert]];
     }
 }
@@ -828,6 +858,197 @@ Refinement::subdivideTopology(Relations const& applyTo) {
     _child->_maxValence = std::max(_parent->_maxValence, maxRegularValence);
 }
 
+//
+//  Methods supporting the concurrent population of the relations of variable size:
+//
+//  When populated sequentially, the counts/offsets of the edge-face, vertex-face and
+//  vertex-edge relations are assigned incrementally -- each child component reserves
+//  what it may need immediately after the one preceding it and then trims that to what
+//  was actually used.  That ordering inhibits concurrency, so when refining in parallel
+//  the same reserved counts (which depend only on the parent) are assigned up front,
+//  each component is populated within its reserved range, and the ranges are compacted
+//  afterwards to remove what was trimmed.  The result is identical to the sequential
+//  population.
+//
+namespace {
+    int
+    accumulateCountsAndOffsets(std::vector<Index> & countsAndOffsets, int & maxCount) {
+
+        int numComponents = (int)countsAndOffsets.size() / 2;
+
+        Index offset = 0;
+        for (int i = 0; i < numComponents; ++i) {
+            int count = countsAndOffsets[2*i];
+
+            countsAndOffsets[2*i + 1] = offset;
+            offset += count;
+
+            maxCount = std::max(maxCount, count);
+        }
+        return offset;
+    }
+
+    void
+    compactCountsAndOffsets(std::vector<Index> & countsAndOffsets,
+                            std::vector<Index> & indices,
+                            std::vector<LocalIndex> & localIndices) {
+
+        int numComponents = (int)countsAndOffsets.size() / 2;
+
+        //  Offsets only ever decrease here, so copying in order is safe:
+        Index nextOffset = 0;
+        for (int i = 0; i < numComponents; ++i) {
+            int   count  = countsAndOffsets[2*i];
+            Index offset = countsAndOffsets[2*i + 1];
+
+            if (offset != nextOffset) {
+                std::copy(indices.begin() + offset, indices.begin() + offset + count,
+                          indices.begin() + nextOffset);
+                std::copy(localIndices.begin() + offset, localIndices.begin() + offset + count,
+                          localIndices.begin() + nextOffset);
+                countsAndOffsets[2*i + 1] = nextOffset;
+            }
+            nextOffset += count;
+        }
+    }
+}
+
+void
+Refinement::reserveEdgeFaceCountsAndOffsets() {
+
+    std::vector<Index> & countsAndOffsets = _child->_edgeFaceCountsAndOffsets;
+
+    //  Child edges of faces have at most two incident faces while those of edges have
+    //  at most as many as their parent edge:
+    Index cEdgeBegin = getFirstChildEdgeFromFaces();
+    Index cEdgeEnd   = cEdgeBegin + getNumChildEdgesFromFaces();
+#ifdef OPENSUBDIV_HAS_OPENMP
+    #pragma omp parallel for if (_parallel)
+#endif
+    for (Index cEdge = cEdgeBegin; cEdge < cEdgeEnd; ++cEdge) {
+        countsAndOffsets[2*cEdge] = 2;
+    }
+
+    cEdgeBegin = getFirstChildEdgeFromEdges();
+    cEdgeEnd   = cEdgeBegin + getNumChildEdgesFromEdges();
+#ifdef OPENSUBDIV_HAS_OPENMP
+    #pragma omp parallel for if (_parallel)
+#endif
+    for (Index cEdge = cEdgeBegin; cEdge < cEdgeEnd; ++cEdge) {
+        countsAndOffsets[2*cEdge] = _parent->getNumEdgeFaces(_childEdgeParentIndex[cEdge]);
+    }
+
+    int totalSize = accumulateCountsAndOffsets(countsAndOffsets, _child->_maxEdgeFaces);
+    assert(totalSize <= (int)_child->_edgeFaceIndices.size());
+    (void)totalSize;
+}
+
+void
+Refinement::reserveVertexFaceCountsAndOffsets() {
+
+    std::vector<Index> & countsAndOffsets = _child->_vertFaceCountsAndOffsets;
+
+    //  Each face incident a parent edge contributes two child faces to the child vertex
+    //  of the edge when quad-splitting and three when tri-splitting:
+    int facesPerEdgeFace = (_splitType == Sdc::SPLIT_TO_QUADS) ? 2 : 3;
+
+    Index cVertBegin = getFirstChildVertexFromFaces();
+    Index cVertEnd   = cVertBegin + getNumChildVerticesFromFaces();
+#ifdef OPENSUBDIV_HAS_OPENMP
+    #pragma omp parallel for if (_parallel)
+#endif
+    for (Index cVert = cVertBegin; cVert < cVertEnd; ++cVert) {
+        countsAndOffsets[2*cVert] = _parent->getNumFaceVertices(_childVertexParentIndex[cVert]);
+    }
+
+    cVertBegin = getFirstChildVertexFromEdges();
+    cVertEnd   = cVertBegin + getNumChildVerticesFromEdges();
+#ifdef OPENSUBDIV_HAS_OPENMP
+    #pragma omp parallel for if (_parallel)
+#endif
+    for (Index cVert = cVertBegin; cVert < cVertEnd; ++cVert) {
+        Index pEdge = _childVertexParentIndex[cVert];
+
+        countsAndOffsets[2*cVert] = facesPerEdgeFace * _parent->getNumEdgeFaces(pEdge);
+    }
+
+    cVertBegin = getFirstChildVertexFromVertices();
+    cVertEnd   = cVertBegin + getNumChildVerticesFromVertices();
+#ifdef OPENSUBDIV_HAS_OPENMP
+    #pragma omp parallel for if (_parallel)
+#endif
+    for (Index cVert = cVertBegin; cVert < cVertEnd; ++cVert) {
+        countsAndOffsets[2*cVert] = _parent->getNumVertexFaces(_childVertexParentIndex[cVert]);
+    }
+
+    int maxVertFaces = 0;
+    int totalSize = accumulateCountsAndOffsets(countsAndOffsets, maxVertFaces);
+    assert(totalSize <= (int)_child->_vertFaceIndices.size());
+    (void)totalSize;
+}
+
+void
+Refinement::reserveVertexEdgeCountsAndOffsets() {
+
+    std::vector<Index> & countsAndOffsets = _child->_vertEdgeCountsAndOffsets;
+
+    //  Similarly each face incident a parent edge contributes one or two child edges
+    //  to the child vertex of the edge (in addition to the two child edges of the edge):
+    int edgesPerEdgeFace = (_splitType == Sdc::SPLIT_TO_QUADS) ? 1 : 2;
+
+    Index cVertBegin = getFirstChildVertexFromFaces();
+    Index cVertEnd   = cVertBegin + getNumChildVerticesFromFaces();
+#ifdef OPENSUBDIV_HAS_OPENMP
+    #pragma omp parallel for if (_parallel)
+#endif
+    for (Index cVert = cVertBegin; cVert < cVertEnd; ++cVert) {
+        countsAndOffsets[2*cVert] = _parent->getNumFaceVertices(_childVertexParentIndex[cVert]);
+    }
+
+    cVertBegin = getFirstChildVertexFromEdges();
+    cVertEnd   = cVertBegin + getNumChildVerticesFromEdges();
+#ifdef OPENSUBDIV_HAS_OPENMP
+    #pragma omp parallel for if (_parallel)
+#endif
+    for (Index cVert = cVertBegin; cVert < cVertEnd; ++cVert) {
+        Index pEdge = _childVertexParentIndex[cVert];
+
+        countsAndOffsets[2*cVert] = 2 + edgesPerEdgeFace * _parent->getNumEdgeFaces(pEdge);
+    }
+
+    cVertBegin = getFirstChildVertexFromVertices();
+    cVertEnd   = cVertBegin + getNumChildVerticesFromVertices();
+#ifdef OPENSUBDIV_HAS_OPENMP
+    #pragma omp parallel for if (_parallel)
+#endif
+    for (Index cVert = cVertBegin; cVert < cVertEnd; ++cVert) {
+        countsAndOffsets[2*cVert] = _parent->getNumVertexEdges(_childVertexParentIndex[cVert]);
+    }
+
+    int totalSize = accumulateCountsAndOffsets(countsAndOffsets, _child->_maxValence);
+    assert(totalSize <= (int)_child->_vertEdgeIndices.size());
+    (void)totalSize;
+}
+
+void
+Refinement::compactEdgeFaceCountsAndOffsets() {
+
+    compactCountsAndOffsets(_child->_edgeFaceCountsAndOffsets,
+                            _child->_edgeFaceIndices, _child->_edgeFaceLocalIndices);
+}
+void
+Refinement::compactVertexFaceCountsAndOffsets() {
+
+    compactCountsAndOffsets(_child->_vertFaceCountsAndOffsets,
+                            _child->_vertFaceIndices, _child->_vertFaceLocalIndices);
+}
+void
+Refinement::compactVertexEdgeCountsAndOffsets() {
+
+    compactCountsAndOffsets(_child->_vertEdgeCountsAndOffsets,
+                            _child->_vertEdgeIndices, _child->_vertEdgeLocalIndices);
+}
+
 
 //
 //  Methods to subdivide sharpness values:
@@ -880,14 +1101,13 @@ Refinement::subdivideEdgeSharpness() {
     //  non-trivial creasing method like Chaikin is used.  This is not being
     //  done now but is worth considering...
     //
-    internal::StackBuffer<float,16> pVertEdgeSharpness;
-    if (!creasing.IsUniform()) {
-        pVertEdgeSharpness.Reserve(_parent->getMaxValence());
-    }
+    Index cEdgeBegin = getFirstChildEdgeFromEdges();
+    Index cEdgeEnd   = cEdgeBegin + getNumChildEdgesFromEdges();
 
-    Index cEdge    = getFirstChildEdgeFromEdges();
-    Index cEdgeEnd = cEdge + getNumChildEdgesFromEdges();
-    for ( ; cEdge < cEdgeEnd; ++cEdge) {
+#ifdef OPENSUBDIV_HAS_OPENMP
+    #pragma omp parallel for if (_parallel)
+#endif
+    for (Index cEdge = cEdgeBegin; cEdge < cEdgeEnd; ++cEdge) {
         float&       cSharpness = _child->_edgeSharpness[cEdge];
         Level::ETag& cEdgeTag   = _child->_edgeTags[cEdge];
 
@@ -904,6 +1124,9 @@ Refinement::subdivideEdgeSharpness() {
                 Index           pVert      = pEdgeVerts[_childEdgeTag[cEdge]._indexInParent];
                 ConstIndexArray pVertEdges = _parent->getVertexEdges(pVert);
 
+                //  Local to each edge (and so to each thread):
+                internal::StackBuffer<float,16> pVertEdgeSharpness(pVertEdges.size());
+
                 for (int i = 0; i < pVertEdges.size(); ++i) {
                     pVertEdgeSharpness[i] = _parent->_edgeSharpness[pVertEdges[i]];
                 }
@@ -933,6 +1156,9 @@ Refinement::subdivideVertexSharpness() {
     Index cVertBegin = getFirstChildVertexFromVertices();
     Index cVertEnd   = cVertBegin + getNumChildVerticesFromVertices();
 
+#ifdef OPENSUBDIV_HAS_OPENMP
+    #pragma omp parallel for if (_parallel)
+#endif
     for (Index cVert = cVertBegin; cVert < cVertEnd; ++cVert) {
         float&       cSharpness = _child->_vertSharpness[cVert];
         Level::VTag& cVertTag   = _child->_vertTags[cVert];
@@ -966,6 +1192,9 @@ Refinement::reclassifySemisharpVertices() {
     Index vertFromEdgeBegin = getFirstChildVertexFromEdges();
     Index vertFromEdgeEnd   = vertFromEdgeBegin + getNumChildVerticesFromEdges();
 
+#ifdef OPENSUBDIV_HAS_OPENMP
+    #pragma omp parallel for if (_parallel)
+#endif
     for (Index cVert = vertFromEdgeBegin; cVert < vertFromEdgeEnd; ++cVert) {
         Level::VTag& cVertTag = _child->_vertTags[cVert];
         if (!cVertTag._semiSharpEdges) continue;
@@ -1004,6 +1233,9 @@ Refinement::reclassifySemisharpVertices() {
     Index vertFromVertBegin = getFirstChildVertexFromVertices();
     Index vertFromVertEnd   = vertFromVertBegin + getNumChildVerticesFromVertices();
 
+#ifdef OPENSUBDIV_HAS_OPENMP
+    #pragma omp parallel for if (_parallel)
+#endif
     for (Index cVert = vertFromVertBegin; cVert < vertFromVertEnd; ++cVert) {
         Index pVert = _childVertexParentIndex[cVert];
         Level::VTag const& pVertTag = _parent->_vertTags[pVert];
@@ -1069,6 +1301,13 @@ Refinement::subdivideFVarChannels() {
 
     int channelCount = _parent->getNumFVarChannels();
 
+    //  Channels are independent of each other and so may be refined concurrently:
+    _child->_fvarChannels.resize(channelCount, 0);
+    this->_fvarChannels.resize(channelCount, 0);
+
+#ifdef OPENSUBDIV_HAS_OPENMP
+    #pragma omp parallel for schedule(dynamic) if (_parallel && (channelCount > 1))
+#endif
     for (int channel = 0; channel < channelCount; ++channel) {
         FVarLevel* parentFVar = _parent->_fvarChannels[channel];
 
@@ -1077,8 +1316,8 @@ Refinement::subdivideFVarChannels() {
 
         refineFVar->applyRefinement();
 
-        _child->_fvarChannels.push_back(childFVar);
-        this->_fvarChannels.push_back(refineFVar);
+        _child->_fvarChannels[channel] = childFVar;
+        this->_fvarChannels[channel]   = refineFVar;
     }
 }
 
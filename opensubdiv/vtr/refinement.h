@@ -107,12 +107,14 @@ public:
     struct Options {
         Options() : _sparse(false),
                     _faceVertsFirst(false),
-                    _minimalTopology(false)
+                    _minimalTopology(false),
+                    _parallel(false)
                     { }
 
         unsigned int _sparse          : 1;
         unsigned int _faceVertsFirst  : 1;
         unsigned int _minimalTopology : 1;
+        unsigned int _parallel        : 1;
 
         //  Still under consideration:
         //unsigned int _childToParentMap : 1;
@@ -305,6 +307,16 @@ public:
     virtual void populateVertexFaceRelation() = 0;
     virtual void populateVertexEdgeRelation() = 0;
 
+    //  When populating concurrently, the counts/offsets of the relations of variable
+    //  size are reserved in advance and the results compacted once populated:
+    void reserveEdgeFaceCountsAndOffsets();
+    void reserveVertexFaceCountsAndOffsets();
+    void reserveVertexEdgeCountsAndOffsets();
+
+    void compactEdgeFaceCountsAndOffsets();
+    void compactVertexFaceCountsAndOffsets();
+    void compactVertexEdgeCountsAndOffsets();
+
     //
     //  Methods involved in subdividing and inspecting sharpness values:
     //
@@ -340,6 +352,7 @@ protected:
     //  Determined by the refinement options:
     bool _uniform;
     bool _faceVertsFirst;
+    bool _parallel;
 
     //
     //  Inventory and ordering of the types of child components:
@@ -132,6 +132,9 @@ TriRefinement::populateFaceVertexCountsAndOffsets() {
 
     _child->_faceVertCountsAndOffsets.resize(_child->getNumFaces() * 2, 3);
 
+#ifdef OPENSUBDIV_HAS_OPENMP
+    #pragma omp parallel for if (_parallel)
+#endif
     for (int i = 0; i < _child->getNumFaces(); ++i) {
         _child->_faceVertCountsAndOffsets[i*2 + 1] = i * 3;
     }
@@ -140,7 +143,10 @@ TriRefinement::populateFaceVertexCountsAndOffsets() {
 void
 TriRefinement::populateFaceVerticesFromParentFaces() {
 
-   for (Index pFace = 0; pFace < _parent->getNumFaces(); ++pFace) {
+#ifdef OPENSUBDIV_HAS_OPENMP
+    #pragma omp parallel for if (_parallel)
+#endif
+    for (Index pFace = 0; pFace < _parent->getNumFaces(); ++pFace) {
         ConstIndexArray pFaceVerts = _parent->getFaceVertices(pFace),
                         pFaceEdges = _parent->getFaceEdges(pFace),
                         pFaceChildren = getFaceChildFaces(pFace);
@@ -216,6 +222,9 @@ TriRefinement::populateFaceEdgeRelation() {
 void
 TriRefinement::populateFaceEdgesFromParentFaces() {
 
+#ifdef OPENSUBDIV_HAS_OPENMP
+    #pragma omp parallel for if (_parallel)
+#endif
     for (Index pFace = 0; pFace < _parent->getNumFaces(); ++pFace) {
         ConstIndexArray pFaceVerts = _parent->getFaceVertices(pFace),
                         pFaceEdges = _parent->getFaceEdges(pFace),
@@ -288,6 +297,9 @@ TriRefinement::populateEdgeVertexRelation() {
 void
 TriRefinement::populateEdgeVerticesFromParentFaces() {
 
+#ifdef OPENSUBDIV_HAS_OPENMP
+    #pragma omp parallel for if (_parallel)
+#endif
     for (Index pFace = 0; pFace < _parent->getNumFaces(); ++pFace) {
         ConstIndexArray pFaceEdges      = _parent->getFaceEdges(pFace),
                         pFaceChildEdges = getFaceChildEdges(pFace);
@@ -324,6 +336,9 @@ TriRefinement::populateEdgeVerticesFromParentFaces() {
 void
 TriRefinement::populateEdgeVerticesFromParentEdges() {
 
+#ifdef OPENSUBDIV_HAS_OPENMP
+    #pragma omp parallel for if (_parallel)
+#endif
     for (Index pEdge = 0; pEdge < _parent->getNumEdges(); ++pEdge) {
         ConstIndexArray pEdgeVerts      = _parent->getEdgeVertices(pEdge),
                         pEdgeChildEdges = getEdgeChildEdges(pEdge);
@@ -372,9 +387,17 @@ TriRefinement::populateEdgeFaceRelation() {
     // update _maxEdgeFaces.
     _child->_maxEdgeFaces = _parent->_maxEdgeFaces;
 
+    if (_parallel) {
+        reserveEdgeFaceCountsAndOffsets();
+    }
+
     populateEdgeFacesFromParentFaces();
     populateEdgeFacesFromParentEdges();
 
+    if (_parallel) {
+        compactEdgeFaceCountsAndOffsets();
+    }
+
     //  Revise the over-allocated estimate based on what is used (as indicated in the
     //  count/offset for the last vertex) and trim the index vector accordingly:
     childEdgeFaceIndexSizeEstimate = _child->getNumEdgeFaces(_child->getNumEdges()-1) +
@@ -386,6 +409,9 @@ TriRefinement::populateEdgeFaceRelation() {
 void
 TriRefinement::populateEdgeFacesFromParentFaces() {
 
+#ifdef OPENSUBDIV_HAS_OPENMP
+    #pragma omp parallel for if (_parallel)
+#endif
     for (Index pFace = 0; pFace < _parent->getNumFaces(); ++pFace) {
         ConstIndexArray pFaceChildFaces = getFaceChildFaces(pFace),
                         pFaceChildEdges = getFaceChildEdges(pFace);
@@ -401,7 +427,7 @@ TriRefinement::populateEdgeFacesFromParentFaces() {
             Index cEdge = pFaceChildEdges[j];
             if (IndexIsValid(cEdge)) {
                 //  Reserve enough edge-faces, populate and trim as needed:
-                _child->resizeEdgeFaces(cEdge, 2);
+                if (!_parallel) _child->resizeEdgeFaces(cEdge, 2);
 
                 IndexArray      cEdgeFaces  = _child->getEdgeFaces(cEdge);
                 LocalIndexArray cEdgeInFace = _child->getEdgeFaceLocalIndices(cEdge);
@@ -426,6 +452,9 @@ TriRefinement::populateEdgeFacesFromParentFaces() {
 void
 TriRefinement::populateEdgeFacesFromParentEdges() {
 
+#ifdef OPENSUBDIV_HAS_OPENMP
+    #pragma omp parallel for if (_parallel)
+#endif
     for (Index pEdge = 0; pEdge < _parent->getNumEdges(); ++pEdge) {
         ConstIndexArray pEdgeChildEdges = getEdgeChildEdges(pEdge);
         if (!IndexIsValid(pEdgeChildEdges[0]) && !IndexIsValid(pEdgeChildEdges[1])) continue;
@@ -441,7 +470,7 @@ TriRefinement::populateEdgeFacesFromParentEdges() {
             //
             //  Reserve enough edge-faces, populate and trim as needed:
             //
-            _child->resizeEdgeFaces(cEdge, pEdgeFaces.size());
+            if (!_parallel) _child->resizeEdgeFaces(cEdge, pEdgeFaces.size());
 
             IndexArray      cEdgeFaces  = _child->getEdgeFaces(cEdge);
             LocalIndexArray cEdgeInFace = _child->getEdgeFaceLocalIndices(cEdge);
@@ -502,6 +531,7 @@ TriRefinement::populateEdgeFacesFromParentEdges() {
 //      - sparse refinement poses challenges with allocation here:
 //          - we need to update the counts/offsets as we populate
 //          - note this imposes ordering constraints and inhibits concurrency
+//            (unless counts/offsets are reserved in advance when refining in parallel)
 //
 void
 TriRefinement::populateVertexFaceRelation() {
@@ -518,6 +548,10 @@ TriRefinement::populateVertexFaceRelation() {
     _child->_vertFaceIndices.resize(         childVertFaceIndexSizeEstimate);
     _child->_vertFaceLocalIndices.resize(    childVertFaceIndexSizeEstimate);
 
+    if (_parallel) {
+        reserveVertexFaceCountsAndOffsets();
+    }
+
     //  Remember -- no vertices-from-faces to consider here (until N-gon support)
     if (getFirstChildVertexFromVertices() == 0) {
         populateVertexFacesFromParentVertices();
@@ -527,6 +561,10 @@ TriRefinement::populateVertexFaceRelation() {
         populateVertexFacesFromParentVertices();
     }
 
+    if (_parallel) {
+        compactVertexFaceCountsAndOffsets();
+    }
+
     //  Revise the over-allocated estimate based on what is used (as indicated in the
     //  count/offset for the last vertex) and trim the index vectors accordingly:
     childVertFaceIndexSizeEstimate = _child->getNumVertexFaces(_child->getNumVertices()-1) +
@@ -538,6 +576,9 @@ TriRefinement::populateVertexFaceRelation() {
 void
 TriRefinement::populateVertexFacesFromParentEdges() {
 
+#ifdef OPENSUBDIV_HAS_OPENMP
+    #pragma omp parallel for if (_parallel)
+#endif
     for (Index pEdge = 0; pEdge < _parent->getNumEdges(); ++pEdge) {
         Index cVert = _edgeChildVertIndex[pEdge];
         if (!IndexIsValid(cVert)) continue;
@@ -546,9 +587,10 @@ TriRefinement::populateVertexFacesFromParentEdges() {
         ConstLocalIndexArray pEdgeInFace = _parent->getEdgeFaceLocalIndices(pEdge);
 
         //
-        //  Reserve enough vert-faces, populate and trim to the actual size:
+        //  Reserve enough vert-faces (up to three per incident face), populate and
+        //  trim to the actual size:
         //
-        _child->resizeVertexFaces(cVert, 2 * pEdgeFaces.size());
+        if (!_parallel) _child->resizeVertexFaces(cVert, 3 * pEdgeFaces.size());
 
         IndexArray      cVertFaces  = _child->getVertexFaces(cVert);
         LocalIndexArray cVertInFace = _child->getVertexFaceLocalIndices(cVert);
@@ -606,6 +648,9 @@ TriRefinement::populateVertexFacesFromParentEdges() {
 void
 TriRefinement::populateVertexFacesFromParentVertices() {
 
+#ifdef OPENSUBDIV_HAS_OPENMP
+    #pragma omp parallel for if (_parallel)
+#endif
     for (Index pVert = 0; pVert < _parent->getNumVertices(); ++pVert) {
         Index cVert = _vertChildVertIndex[pVert];
         if (!IndexIsValid(cVert)) continue;
@@ -619,7 +664,7 @@ TriRefinement::populateVertexFacesFromParentVertices() {
         //
         //  Reserve enough vert-faces, populate and trim to the actual size:
         //
-        _child->resizeVertexFaces(cVert, pVertFaces.size());
+        if (!_parallel) _child->resizeVertexFaces(cVert, pVertFaces.size());
 
         IndexArray      cVertFaces  = _child->getVertexFaces(cVert);
         LocalIndexArray cVertInFace = _child->getVertexFaceLocalIndices(cVert);
@@ -647,6 +692,7 @@ TriRefinement::populateVertexFacesFromParentVertices() {
 //      - sparse refinement poses challenges with allocation here:
 //          - we need to update the counts/offsets as we populate
 //          - note this imposes ordering constraints and inhibits concurrency
+//            (unless counts/offsets are reserved in advance when refining in parallel)
 //
 void
 TriRefinement::populateVertexEdgeRelation() {
@@ -679,6 +725,10 @@ TriRefinement::populateVertexEdgeRelation() {
     _child->_vertEdgeIndices.resize(         childVertEdgeIndexSizeEstimate);
     _child->_vertEdgeLocalIndices.resize(    childVertEdgeIndexSizeEstimate);
 
+    if (_parallel) {
+        reserveVertexEdgeCountsAndOffsets();
+    }
+
     if (getFirstChildVertexFromVertices() == 0) {
         populateVertexEdgesFromParentVertices();
         populateVertexEdgesFromParentEdges();
@@ -687,6 +737,10 @@ TriRefinement::populateVertexEdgeRelation() {
         populateVertexEdgesFromParentVertices();
     }
 
+    if (_parallel) {
+        compactVertexEdgeCountsAndOffsets();
+    }
+
     //  Revise the over-allocated estimate based on what is used (as indicated in the
     //  count/offset for the last vertex) and trim the index vectors accordingly:
     childVertEdgeIndexSizeEstimate = _child->getNumVertexEdges(_child->getNumVertices()-1) +
@@ -698,6 +752,9 @@ TriRefinement::populateVertexEdgeRelation() {
 void
 TriRefinement::populateVertexEdgesFromParentEdges() {
 
+#ifdef OPENSUBDIV_HAS_OPENMP
+    #pragma omp parallel for if (_parallel)
+#endif
     for (Index pEdge = 0; pEdge < _parent->getNumEdges(); ++pEdge) {
         Index cVert = _edgeChildVertIndex[pEdge];
         if (!IndexIsValid(cVert)) continue;
@@ -712,9 +769,10 @@ TriRefinement::populateVertexEdgesFromParentEdges() {
                         pEdgeChildEdges = getEdgeChildEdges(pEdge);
 
         //
-        //  Reserve enough vert-edges, populate and trim to the actual size:
+        //  Reserve enough vert-edges (two interior to each incident face), populate
+        //  and trim to the actual size:
         //
-        _child->resizeVertexEdges(cVert, pEdgeFaces.size() + 2);
+        if (!_parallel) _child->resizeVertexEdges(cVert, 2 * pEdgeFaces.size() + 2);
 
         IndexArray      cVertEdges  = _child->getVertexEdges(cVert);
         LocalIndexArray cVertInEdge = _child->getVertexEdgeLocalIndices(cVert);
@@ -791,6 +849,9 @@ TriRefinement::populateVertexEdgesFromParentEdges() {
 void
 TriRefinement::populateVertexEdgesFromParentVertices() {
 
+#ifdef OPENSUBDIV_HAS_OPENMP
+    #pragma omp parallel for if (_parallel)
+#endif
     for (Index pVert = 0; pVert < _parent->getNumVertices(); ++pVert) {
         Index cVert = _vertChildVertIndex[pVert];
         if (!IndexIsValid(cVert)) continue;
@@ -804,7 +865,7 @@ TriRefinement::populateVertexEdgesFromParentVertices() {
         //
         //  Reserve enough vert-edges, populate and trim to the actual size:
         //
-        _child->resizeVertexEdges(cVert, pVertEdges.size());
+        if (!_parallel) _child->resizeVertexEdges(cVert, pVertEdges.size());
 
         IndexArray      cVertEdges  = _child->getVertexEdges(cVert);
         LocalIndexArray cVertInEdge = _child->getVertexEdgeLocalIndices(cVert);
@@ -0,0 +1,160 @@
+//
+//   Copyright 2015 Pixar
+//
+//   Licensed under the Apache License, Version 2.0 (the "Apache License")
+//   with the following modification; you may not use this file except in
+//   compliance with the Apache License and the following modification to it:
+//   Section 6. Trademarks. is deleted and replaced with:
+//
+//   6. Trademarks. This License does not grant permission to use the trade
+//      names, trademarks, service marks, or product names of the Licensor
+//      and its affiliates, except as required to comply with Section 4(c) of
+//      the License and to reproduce the content of the NOTICE file.
+//
+//   You may obtain a copy of the Apache License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the Apache License with the above modification is
+//   distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//   KIND, either express or implied. See the Apache License for the specific
+//   language governing permissions and limitations under the Apache License.
+//
+
+#ifndef FAR_CMP_UTILS_H
+#define FAR_CMP_UTILS_H
+
+#include <far/topologyRefiner.h>
+#include <far/patchTable.h>
+#include <far/stencilTable.h>
+
+#include <algorithm>
+#include <cstring>
+
+//------------------------------------------------------------------------------
+//
+//  Exact comparisons of Far topology and tables, e.g. of those built with and
+//  without multiple threads:
+//
+
+template <typename T>
+inline bool
+SameArrays(OpenSubdiv::Vtr::ConstArray<T> a, OpenSubdiv::Vtr::ConstArray<T> b) {
+
+    return (a.size() == b.size()) && std::equal(a.begin(), a.end(), b.begin());
+}
+
+inline bool
+SameStencils(OpenSubdiv::Far::StencilTableReal<float> const * a,
+             OpenSubdiv::Far::StencilTableReal<float> const * b) {
+
+    return a->GetNumControlVertices() == b->GetNumControlVertices() &&
+           a->GetSizes() == b->GetSizes() &&
+           a->GetOffsets() == b->GetOffsets() &&
+           a->GetControlIndices() == b->GetControlIndices() &&
+           a->GetWeights() == b->GetWeights();
+}
+
+inline bool
+SameLimitStencils(OpenSubdiv::Far::LimitStencilTable const * a,
+                  OpenSubdiv::Far::LimitStencilTable const * b) {
+
+    return SameStencils(a, b) &&
+           a->GetDuWeights() == b->GetDuWeights() &&
+           a->GetDvWeights() == b->GetDvWeights();
+}
+
+inline bool
+SamePatchTables(OpenSubdiv::Far::PatchTable const * a,
+                OpenSubdiv::Far::PatchTable const * b) {
+
+    typedef OpenSubdiv::Far::PatchParam      PatchParam;
+    typedef OpenSubdiv::Far::PatchParamTable PatchParamTable;
+    typedef OpenSubdiv::Far::StencilTable    StencilTable;
+
+    PatchParamTable const & aParams = a->GetPatchParamTable(),
+                          & bParams = b->GetPatchParamTable();
+    if ((aParams.size() != bParams.size()) || (! aParams.empty() &&
+        memcmp(&aParams[0], &bParams[0], aParams.size() * sizeof(PatchParam)))) {
+        return false;
+    }
+
+    StencilTable const * aStencils = a->GetLocalPointStencilTable(),
+                       * bStencils = b->GetLocalPointStencilTable();
+
+    return a->GetPatchControlVerticesTable() == b->GetPatchControlVerticesTable() &&
+           a->GetSharpnessIndexTable() == b->GetSharpnessIndexTable() &&
+           a->GetSharpnessValues() == b->GetSharpnessValues() &&
+           ((aStencils && bStencils) ? SameStencils(aStencils, bStencils)
+                                     : (aStencils == bStencils));
+}
+
+inline bool
+SameLevels(OpenSubdiv::Far::TopologyLevel const & a,
+           OpenSubdiv::Far::TopologyLevel const & b) {
+
+    if ((a.GetNumFaces() != b.GetNumFaces()) ||
+        (a.GetNumEdges() != b.GetNumEdges()) ||
+        (a.GetNumVertices() != b.GetNumVertices())) {
+        return false;
+    }
+    for (int f = 0; f < a.GetNumFaces(); ++f) {
+        if (!SameArrays(a.GetFaceVertices(f), b.GetFaceVertices(f)) ||
+            !SameArrays(a.GetFaceEdges(f), b.GetFaceEdges(f)) ||
+            (a.IsFaceHole(f) != b.IsFaceHole(f))) {
+            return false;
+        }
+    }
+    for (int e = 0; e < a.GetNumEdges(); ++e) {
+        if (!SameArrays(a.GetEdgeVertices(e), b.GetEdgeVertices(e)) ||
+            !SameArrays(a.GetEdgeFaces(e), b.GetEdgeFaces(e)) ||
+            (a.GetEdgeSharpness(e) != b.GetEdgeSharpness(e)) ||
+            (a.IsEdgeNonManifold(e) != b.IsEdgeNonManifold(e))) {
+            return false;
+        }
+    }
+    for (int v = 0; v < a.GetNumVertices(); ++v) {
+        if (!SameArrays(a.GetVertexFaces(v), b.GetVertexFaces(v)) ||
+            !SameArrays(a.GetVertexEdges(v), b.GetVertexEdges(v)) ||
+            (a.GetVertexSharpness(v) != b.GetVertexSharpness(v)) ||
+            (a.GetVertexRule(v) != b.GetVertexRule(v)) ||
+            (a.IsVertexNonManifold(v) != b.IsVertexNonManifold(v))) {
+            return false;
+        }
+    }
+    if (a.GetNumFVarChannels() != b.GetNumFVarChannels()) {
+        return false;
+    }
+    for (int c = 0; c < a.GetNumFVarChannels(); ++c) {
+        if (a.GetNumFVarValues(c) != b.GetNumFVarValues(c)) {
+            return false;
+        }
+        for (int f = 0; f < a.GetNumFaces(); ++f) {
+            if (!SameArrays(a.GetFaceFVarValues(f, c), b.GetFaceFVarValues(f, c))) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+inline bool
+SameRefiners(OpenSubdiv::Far::TopologyRefiner const * a,
+             OpenSubdiv::Far::TopologyRefiner const * b) {
+
+    if ((a->GetNumLevels() != b->GetNumLevels()) ||
+        (a->GetMaxValence() != b->GetMaxValence())) {
+        return false;
+    }
+    for (int level = 0; level < a->GetNumLevels(); ++level) {
+        if (!SameLevels(a->GetLevel(level), b->GetLevel(level))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+//------------------------------------------------------------------------------
+
+#endif /* FAR_CMP_UTILS_H */
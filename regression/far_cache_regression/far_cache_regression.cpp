@@ -0,0 +1,221 @@
+//
+//   Copyright 2015 Pixar
+//
+//   Licensed under the Apache License, Version 2.0 (the "Apache License")
+//   with the following modification; you may not use this file except in
+//   compliance with the Apache License and the following modification to it:
+//   Section 6. Trademarks. is deleted and replaced with:
+//
+//   6. Trademarks. This License does not grant permission to use the trade
+//      names, trademarks, service marks, or product names of the Licensor
+//      and its affiliates, except as required to comply with Section 4(c) of
+//      the License and to reproduce the content of the NOTICE file.
+//
+//   You may obtain a copy of the Apache License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the Apache License with the above modification is
+//   distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//   KIND, either express or implied. See the Apache License for the specific
+//   language governing permissions and limitations under the Apache License.
+//
+
+#include <cstdio>
+#include <numeric>
+#include <vector>
+
+#include <far/topologyCache.h>
+
+#include "../../regression/common/far_utils.h"
+
+#include "init_shapes.h"
+
+//
+// Regression testing of Far::TopologyCache : identical topologies must share
+// an entry, including when acquired concurrently, and released entries are
+// evicted least recently used first.
+//
+// Notes:
+// - only shapes of the Catmark scheme are tested (adaptive refinement), the
+//   high valence poles being left out to keep the test short
+//
+
+using namespace OpenSubdiv;
+
+//------------------------------------------------------------------------------
+static char const *
+checkEntries(Far::TopologyDescriptor const & desc,
+             Far::TopologyCache::Options const & options) {
+
+    Far::TopologyCache cache;
+
+    Far::TopologyCache::Entry const * entry = cache.Acquire(desc, options);
+    if ((entry == 0) || (entry->GetRefiner() == 0) ||
+        (entry->GetPatchTable() == 0) || (entry->GetStencilTable() == 0)) {
+        cache.Release(entry);
+        return "failed to acquire topology";
+    }
+    cache.Release(entry);
+
+    //  A released entry is reused:
+    Far::TopologyCache::Entry const * hit = cache.Acquire(desc, options);
+    cache.Release(hit);
+    if (hit != entry) {
+        return "cached topology not reused";
+    }
+    cache.Clear();
+
+    //  A copy of the topology is a cache hit (keys are compared by value):
+    std::vector<int> vertsPerFace(desc.numVertsPerFace,
+                                  desc.numVertsPerFace + desc.numFaces);
+    std::vector<int> vertIndices(desc.vertIndicesPerFace,
+        desc.vertIndicesPerFace + std::accumulate(
+            vertsPerFace.begin(), vertsPerFace.end(), 0));
+
+    Far::TopologyDescriptor copy = desc;
+    copy.numVertsPerFace = &vertsPerFace[0];
+    copy.vertIndicesPerFace = &vertIndices[0];
+
+    if (Far::TopologyCache::GetHash(desc, options) !=
+        Far::TopologyCache::GetHash(copy, options)) {
+        return "equal topologies hashed differently";
+    }
+
+    //  Entries built concurrently for the same topology are merged:
+    int const numAcquires = 8;
+    Far::TopologyCache::Entry const * entries[numAcquires];
+#ifdef OPENSUBDIV_HAS_OPENMP
+    #pragma omp parallel for
+#endif
+    for (int i = 0; i < numAcquires; ++i) {
+        entries[i] = cache.Acquire((i & 1) ? copy : desc, options);
+    }
+
+    bool same = (entries[0] != 0) && (cache.GetNumEntries() == 1);
+    for (int i = 0; i < numAcquires; ++i) {
+        same = same && (entries[i] == entries[0]);
+    }
+
+    //  Acquired entries are not evicted:
+    cache.Clear();
+    same = same && (cache.GetNumEntries() == 1);
+    for (int i = 0; i < numAcquires; ++i) {
+        cache.Release(entries[i]);
+    }
+    cache.Clear();
+    same = same && (cache.GetNumEntries() == 0);
+
+    return same ? 0 : "identical topologies acquired different entries";
+}
+
+static char const *
+checkEviction(Far::TopologyDescriptor const & desc) {
+
+    //  Options for distinct (and inexpensive) entries of the topology:
+    Far::TopologyCache::Options options[4];
+    for (int i = 0; i < 4; ++i) {
+        options[i].adaptive = false;
+        options[i].generatePatchTable = false;
+        options[i].generateStencilTable = false;
+        options[i].uniformOptions.refinementLevel = 1;
+        options[i].uniformOptions.orderVerticesFromFacesFirst = (i & 1) != 0;
+        options[i].uniformOptions.fullTopologyInLastLevel = (i & 2) != 0;
+    }
+
+    int const maxUnusedEntries = 2;
+    Far::TopologyCache cache(maxUnusedEntries);
+
+    for (int i = 0; i < 4; ++i) {
+        cache.Release(cache.Acquire(desc, options[i]));
+    }
+    if (cache.GetNumEntries() != maxUnusedEntries) {
+        return "unused topologies not evicted";
+    }
+
+    //  The most recently used entries are kept -- acquiring them again
+    //  must not add entries:
+    Far::TopologyCache::Entry const * entry3 = cache.Acquire(desc, options[3]);
+    Far::TopologyCache::Entry const * entry2 = cache.Acquire(desc, options[2]);
+    bool kept = (cache.GetNumEntries() == maxUnusedEntries);
+    cache.Release(entry2);
+    cache.Release(entry3);
+
+    //  A new entry evicts the least recently used one (the third):
+    cache.Release(cache.Acquire(desc, options[0]));
+    kept = kept && (cache.GetNumEntries() == maxUnusedEntries);
+
+    entry2 = cache.Acquire(desc, options[2]);
+    kept = kept && (cache.GetNumEntries() == maxUnusedEntries);
+    entry3 = cache.Acquire(desc, options[3]);
+    kept = kept && (cache.GetNumEntries() == maxUnusedEntries + 1);
+    cache.Release(entry3);
+    cache.Release(entry2);
+    kept = kept && (cache.GetNumEntries() == maxUnusedEntries);
+
+    cache.Clear();
+    kept = kept && (cache.GetNumEntries() == 0);
+
+    return kept ? 0 : "least recently used topologies not evicted";
+}
+
+//------------------------------------------------------------------------------
+static int
+checkShape(Shape const & shape, std::string const & name, int maxlevel) {
+
+    static char const * schemes[] = { "Bilinear", "Catmark", "Loop" };
+    printf("- %-25s ( %-8s ): \n", name.c_str(), schemes[shape.scheme]);
+
+    Far::TopologyDescriptor desc;
+    desc.numVertices = (int)shape.verts.size() / 3;
+    desc.numFaces = (int)shape.nvertsPerFace.size();
+    desc.numVertsPerFace = &shape.nvertsPerFace[0];
+    desc.vertIndicesPerFace = &shape.faceverts[0];
+    desc.isLeftHanded = shape.isLeftHanded;
+
+    Far::TopologyCache::Options options;
+    options.schemeType = GetSdcType(shape);
+    options.schemeOptions = GetSdcOptions(shape);
+    options.adaptiveOptions.isolationLevel = maxlevel;
+    options.patchTableOptions.SetEndCapType(
+        Far::PatchTableFactory::Options::ENDCAP_GREGORY_BASIS);
+
+    char const * error = checkEntries(desc, options);
+    if (! error) error = checkEviction(desc);
+
+    if (error) {
+        printf("  %s\n", error);
+        return 1;
+    }
+    printf("  success !\n");
+    return 0;
+}
+
+//------------------------------------------------------------------------------
+int main(int /* argc */, char ** /* argv */) {
+
+    int levels=2, total=0;
+
+    initShapes();
+
+    for (int i=0; i<(int)g_shapes.size(); ++i) {
+        ShapeDesc const & desc = g_shapes[i];
+
+        Shape * shape = Shape::parseObj(desc.data.c_str(), desc.scheme,
+            desc.isLeftHanded);
+        if (shape) {
+            total+=checkShape(*shape, desc.name, levels);
+        }
+        delete shape;
+    }
+
+    if (total==0)
+      printf("All tests passed.\n");
+    else
+      printf("Total failures : %d\n", total);
+
+    return total ? 1 : 0;
+}
+
+//------------------------------------------------------------------------------
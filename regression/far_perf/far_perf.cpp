@@ -22,108 +22,1338 @@
 //   language governing permissions and limitations under the Apache License.
 //
 
+#include <algorithm>
 #include <cassert>
 #include <cstdio>
+#include <cstdlib>
+#include <cstring>
 #include <fstream>
 #include <sstream>
 
+#include <opensubdiv/far/compressedStencilTable.h>
+#include <opensubdiv/far/patchMap.h>
+#include <opensubdiv/far/patchTableFactory.h>
 #include <opensubdiv/far/primvarRefiner.h>
+#include <opensubdiv/far/ptexIndices.h>
+#include <opensubdiv/far/stencilDependencyTable.h>
 #include <opensubdiv/far/stencilTableFactory.h>
-#include <opensubdiv/far/patchTableFactory.h>
+#include <opensubdiv/far/stencilTableView.h>
+#include <opensubdiv/far/tableSerializer.h>
+#include <opensubdiv/far/topologyCache.h>
+#include <opensubdiv/osd/cpuEvaluator.h>
+#include <opensubdiv/osd/cpuPatchTable.h>
+#include <opensubdiv/osd/cpuVertexBuffer.h>
+#ifdef OPENSUBDIV_HAS_OPENMP
+    #include <opensubdiv/osd/ompEvaluator.h>
+#endif
+#ifdef OPENSUBDIV_HAS_TBB
+    #include <opensubdiv/osd/tbbEvaluator.h>
+#endif
 #include "../../regression/common/far_utils.h"
-// XXX: revisit the directory structure for examples/tests
-#include "../../examples/common/stopwatch.h"
 
 #include "init_shapes.h"
+#include "perfSuite.h"
+
+using namespace OpenSubdiv;
 
 //------------------------------------------------------------------------------
-static void
-doPerf(const Shape *shape, int maxlevel, int endCapType)
-{
-    using namespace OpenSubdiv;
+static std::string
+getBenchmarkName(char const * prefix, ShapeDesc const & shapeDesc, int level) {
+    std::ostringstream name;
+    name << prefix << "/" << shapeDesc.name << "/level:" << level;
+    return name.str();
+}
+
+//------------------------------------------------------------------------------
+//
+//  Topology and tables of a shape shared by the benchmarks below, each of
+//  which builds the subset it requires in Setup():
+//
+struct ShapeData {
+
+    enum Content {
+        REFINER         = 0x1,
+        STENCILS        = 0x2 | REFINER,
+        PATCHES         = 0x4 | REFINER,
+        ALL_STENCILS    = 0x8 | STENCILS | PATCHES  // with local points
+    };
+
+    ShapeData() : shape(0), refiner(0), stencils(0), patchTable(0) { }
+
+    ~ShapeData() { Clear(); }
+
+    void Build(ShapeDesc const & shapeDesc, int level, int endCapType, int content) {
+
+        shape = Shape::parseObj(shapeDesc.data.c_str(), shapeDesc.scheme,
+            shapeDesc.isLeftHanded);
+
+        if ((content & REFINER) == 0) return;
+
+        refiner = createRefiner(*shape);
+        refiner->RefineAdaptive(Far::TopologyRefiner::AdaptiveOptions(level));
+
+        if ((content & STENCILS) == STENCILS) {
+            stencils = Far::StencilTableFactory::Create(*refiner);
+        }
+
+        if ((content & PATCHES) == PATCHES) {
+            Far::PatchTableFactory::Options options(level);
+            options.SetEndCapType(
+                (Far::PatchTableFactory::Options::EndCapType)endCapType);
+            patchTable = Far::PatchTableFactory::Create(*refiner, options);
+        }
+
+        if (((content & ALL_STENCILS) == ALL_STENCILS) &&
+            patchTable->GetLocalPointStencilTable()) {
+            if (Far::StencilTable const * stencilsWithLocalPoints =
+                Far::StencilTableFactory::AppendLocalPointStencilTable(
+                    *refiner, stencils, patchTable->GetLocalPointStencilTable())) {
+                delete stencils;
+                stencils = stencilsWithLocalPoints;
+            }
+        }
+    }
+
+    void Clear() {
+        delete patchTable;
+        delete stencils;
+        delete refiner;
+        delete shape;
+        patchTable = 0;
+        stencils = 0;
+        refiner = 0;
+        shape = 0;
+    }
+
+    static Far::TopologyRefiner * createRefiner(Shape const & shape,
+                                               bool useMultipleThreads = false) {
+        Sdc::Options sdcOptions = GetSdcOptions(shape);
+        Far::TopologyRefinerFactory<Shape>::Options options(
+            GetSdcType(shape), sdcOptions);
+        options.useMultipleThreads = useMultipleThreads;
+        return Far::TopologyRefinerFactory<Shape>::Create(shape, options);
+    }
+
+    Shape const *                 shape;
+    Far::TopologyRefiner *        refiner;
+    Far::StencilTable const *     stencils;
+    Far::PatchTable const *       patchTable;
+};
+
+//
+//  Base class of the benchmarks of a shape at a given level:
+//
+class ShapeBenchmark : public PerfBenchmark {
+public:
+    ShapeBenchmark(char const * name, ShapeDesc const & shapeDesc,
+                   int level, int endCapType, int content) :
+        PerfBenchmark(getBenchmarkName(name, shapeDesc, level)),
+        _shapeDesc(shapeDesc), _level(level), _endCapType(endCapType),
+        _content(content) { }
+
+    virtual void Setup() { _data.Build(_shapeDesc, _level, _endCapType, _content); }
+
+    virtual void TearDown() { _data.Clear(); }
+
+protected:
+    ShapeDesc const & _shapeDesc;
+
+    int _level,
+        _endCapType,
+        _content;
+
+    ShapeData _data;
+};
+
+//------------------------------------------------------------------------------
+//  Topology refinement:
+//
+class TopologyRefinerFactoryBenchmark : public ShapeBenchmark {
+public:
+    TopologyRefinerFactoryBenchmark(ShapeDesc const & shapeDesc,
+                                    bool useMultipleThreads) :
+        ShapeBenchmark(useMultipleThreads ?
+            "TopologyRefinerFactory::Create(threaded)" :
+            "TopologyRefinerFactory::Create", shapeDesc, 0, 0, 0),
+        _useMultipleThreads(useMultipleThreads) { }
+
+    virtual void Run(PerfState & state) {
+        while (state.KeepRunning()) {
+            Far::TopologyRefiner * refiner =
+                ShapeData::createRefiner(*_data.shape, _useMultipleThreads);
+
+            state.PauseTiming();
+            delete refiner;
+            state.ResumeTiming();
+        }
+    }
+
+private:
+    bool _useMultipleThreads;
+};
 
-    Sdc::SchemeType type = OpenSubdiv::Sdc::SCHEME_CATMARK;
+class RefineUniformBenchmark : public ShapeBenchmark {
+public:
+    RefineUniformBenchmark(ShapeDesc const & shapeDesc, int level) :
+        ShapeBenchmark("TopologyRefiner::RefineUniform", shapeDesc, level, 0, 0) { }
 
-    Sdc::Options sdcOptions;
-    sdcOptions.SetVtxBoundaryInterpolation(Sdc::Options::VTX_BOUNDARY_EDGE_ONLY);
+    virtual void Run(PerfState & state) {
+        while (state.KeepRunning()) {
+            state.PauseTiming();
+            Far::TopologyRefiner * refiner = ShapeData::createRefiner(*_data.shape);
+            state.ResumeTiming();
 
-    Stopwatch s;
+            refiner->RefineUniform(Far::TopologyRefiner::UniformOptions(_level));
 
-    // ----------------------------------------------------------------------
-    // Instantiate a FarTopologyRefiner from the descriptor and refine
-    s.Start();
-    Far::TopologyRefiner * refiner = Far::TopologyRefinerFactory<Shape>::Create(
-        *shape, Far::TopologyRefinerFactory<Shape>::Options(type, sdcOptions));
-    {
-        Far::TopologyRefiner::AdaptiveOptions options(maxlevel);
-        refiner->RefineAdaptive(options);
+            state.PauseTiming();
+            delete refiner;
+            state.ResumeTiming();
+        }
+    }
+};
+
+//
+//  Adaptive refinement of all the base faces, or of a region made of the
+//  first eighth of them:
+//
+class RefineAdaptiveBenchmark : public ShapeBenchmark {
+public:
+    RefineAdaptiveBenchmark(ShapeDesc const & shapeDesc, int level,
+                            bool refineRegion) :
+        ShapeBenchmark(refineRegion ? "TopologyRefiner::RefineAdaptive(region)" :
+            "TopologyRefiner::RefineAdaptive", shapeDesc, level, 0, 0),
+        _refineRegion(refineRegion) { }
+
+    virtual void Run(PerfState & state) {
+
+        std::vector<Far::Index> region;
+        if (_refineRegion) {
+            int numFaces = _data.shape->GetNumFaces();
+            for (int face = 0; face < std::max(1, numFaces / 8); ++face) {
+                region.push_back(face);
+            }
+        }
+
+        while (state.KeepRunning()) {
+            state.PauseTiming();
+            Far::TopologyRefiner * refiner = ShapeData::createRefiner(*_data.shape);
+            state.ResumeTiming();
+
+            refiner->RefineAdaptive(Far::TopologyRefiner::AdaptiveOptions(_level),
+                Far::ConstIndexArray(region.empty() ? 0 : &region[0], (int)region.size()));
+
+            state.PauseTiming();
+            delete refiner;
+            state.ResumeTiming();
+        }
+    }
+
+private:
+    bool _refineRegion;
+};
+
+//
+//  Regeneration of the refinement and the patches after a local edit of the
+//  base mesh -- of all the base faces, or of those affected by an edit of a
+//  single face:
+//
+class RefineEditBenchmark : public ShapeBenchmark {
+public:
+    RefineEditBenchmark(ShapeDesc const & shapeDesc, int level, int endCapType,
+                        bool refineAffected) :
+        ShapeBenchmark(refineAffected ?
+            "TopologyRefiner::RefineAdaptive+PatchTableFactory::Create(edit)" :
+            "TopologyRefiner::RefineAdaptive+PatchTableFactory::Create",
+            shapeDesc, level, endCapType, 0),
+        _refineAffected(refineAffected) { }
+
+    virtual void Run(PerfState & state) {
+
+        Far::PatchTableFactory::Options options(_level);
+        options.SetEndCapType((Far::PatchTableFactory::Options::EndCapType)_endCapType);
+
+        Far::Index editedFace = _data.shape->GetNumFaces() / 2;
+
+        std::vector<Far::Index> affected;
+
+        while (state.KeepRunning()) {
+            Far::TopologyRefiner * refiner = ShapeData::createRefiner(*_data.shape);
+
+            if (_refineAffected) {
+                refiner->GetAffectedBaseFaces(Far::ConstIndexArray(&editedFace, 1), affected);
+            }
+            Far::ConstIndexArray faces(affected.empty() ? 0 : &affected[0],
+                                       (int)affected.size());
+
+            refiner->RefineAdaptive(Far::TopologyRefiner::AdaptiveOptions(_level), faces);
+
+            Far::PatchTable const * patchTable =
+                Far::PatchTableFactory::Create(*refiner, options, faces);
+
+            state.PauseTiming();
+            delete patchTable;
+            delete refiner;
+            state.ResumeTiming();
+        }
     }
 
-    s.Stop();
-    double timeRefine = s.GetElapsed();
+private:
+    bool _refineAffected;
+};
+
+//
+//  Regeneration of the refinement and the patches affected by a change of
+//  sharpness of a single base edge, updated in place in the base level:
+//
+class SharpnessEditBenchmark : public ShapeBenchmark {
+public:
+    SharpnessEditBenchmark(ShapeDesc const & shapeDesc, int level, int endCapType) :
+        ShapeBenchmark("TopologyRefiner::SetBaseSharpness+RefineAdaptive+PatchTableFactory::Create(edit)",
+            shapeDesc, level, endCapType, 0) { }
+
+    virtual void Run(PerfState & state) {
+
+        Far::PatchTableFactory::Options options(_level);
+        options.SetEndCapType((Far::PatchTableFactory::Options::EndCapType)_endCapType);
+
+        //  the sharpness cannot be updated in the presence of face-varying
+        //  channels, so build the refiner without them:
+        Shape * shape = Shape::parseObj(_shapeDesc.data.c_str(), _shapeDesc.scheme,
+            _shapeDesc.isLeftHanded);
+        shape->uvs.clear();
+        shape->faceuvs.clear();
+
+        Far::TopologyRefiner * refiner = ShapeData::createRefiner(*shape);
+
+        Far::Index editedEdge = refiner->GetLevel(0).GetNumEdges() / 2;
+        float      sharpness  = 0.0f;
+
+        std::vector<Far::Index> affected;
+
+        while (state.KeepRunning()) {
+            refiner->Unrefine();
+
+            sharpness = (sharpness == 0.0f) ? 2.0f : 0.0f;
+            refiner->SetBaseSharpness(Far::ConstIndexArray(&editedEdge, 1), &sharpness,
+                                      Far::ConstIndexArray(), 0, affected);
+
+            Far::ConstIndexArray faces(affected.empty() ? 0 : &affected[0],
+                                       (int)affected.size());
+
+            refiner->RefineAdaptive(Far::TopologyRefiner::AdaptiveOptions(_level), faces);
+
+            Far::PatchTable const * patchTable =
+                Far::PatchTableFactory::Create(*refiner, options, faces);
+
+            state.PauseTiming();
+            delete patchTable;
+            state.ResumeTiming();
+        }
+        delete refiner;
+        delete shape;
+    }
+};
+
+//------------------------------------------------------------------------------
+//  Primvar interpolation -- of a primvar class or of a raw buffer:
+//
+class PrimvarRefinerBenchmark : public ShapeBenchmark {
+public:
+    enum Mode { SERIAL, THREADED, RAW };
+
+    PrimvarRefinerBenchmark(ShapeDesc const & shapeDesc, int level, Mode mode) :
+        ShapeBenchmark(mode == SERIAL ? "PrimvarRefiner::Interpolate" :
+            (mode == THREADED ? "PrimvarRefiner::Interpolate(threaded)" :
+                                "PrimvarRefiner::Interpolate(raw)"),
+            shapeDesc, level, 0, ShapeData::REFINER),
+        _mode(mode) { }
+
+    virtual void Run(PerfState & state) {
+
+        std::vector<Vertex> vertices;
+        while (state.KeepRunning()) {
+            interpolate(vertices, _mode);
+        }
+    }
+
+private:
+    struct Vertex {
+        void Clear() { p[0] = p[1] = p[2] = 0.0f; }
+        void AddWithWeight(Vertex const & src, float weight) {
+            p[0] += weight * src.p[0];
+            p[1] += weight * src.p[1];
+            p[2] += weight * src.p[2];
+        }
+        float p[3];
+    };
+
+    void interpolate(std::vector<Vertex> & vertices, Mode mode) const {
+
+        Far::TopologyRefiner const & refiner = *_data.refiner;
+
+        vertices.resize(refiner.GetNumVerticesTotal());
+        memcpy(&vertices[0], &_data.shape->verts[0],
+            refiner.GetLevel(0).GetNumVertices() * sizeof(Vertex));
+
+        Far::PrimvarRefiner::Options options;
+        options.useMultipleThreads = (mode == THREADED);
+
+        Far::PrimvarRefiner primvarRefiner(refiner, options);
+
+        Far::PrimvarRefiner::BufferDescriptor desc(0, 3, 3);
+
+        Vertex * src = &vertices[0];
+        for (int level = 1; level <= refiner.GetMaxLevel(); ++level) {
+            Vertex * dst = src + refiner.GetLevel(level-1).GetNumVertices();
+            if (mode == RAW) {
+                primvarRefiner.Interpolate(level, src->p, desc, dst->p, desc);
+            } else {
+                primvarRefiner.Interpolate(level, src, dst);
+            }
+            src = dst;
+        }
+    }
+
+    Mode _mode;
+};
+
+//------------------------------------------------------------------------------
+//  Table factories:
+//
+class StencilTableFactoryBenchmark : public ShapeBenchmark {
+public:
+    StencilTableFactoryBenchmark(ShapeDesc const & shapeDesc, int level,
+                                 bool useMultipleThreads) :
+        ShapeBenchmark(useMultipleThreads ?
+            "StencilTableFactory::Create(threaded)" : "StencilTableFactory::Create",
+            shapeDesc, level, 0, ShapeData::REFINER),
+        _useMultipleThreads(useMultipleThreads) { }
+
+    virtual void Run(PerfState & state) {
 
-    // ----------------------------------------------------------------------
-    // Create stencil table
-    s.Start();
-    Far::StencilTable const * vertexStencils = NULL;
-    {
         Far::StencilTableFactory::Options options;
-        vertexStencils = Far::StencilTableFactory::Create(*refiner, options);
-    }
-    s.Stop();
-    double timeCreateStencil = s.GetElapsed();
-
-    // ----------------------------------------------------------------------
-    // Create patch table
-    s.Start();
-    Far::PatchTable const * patchTable = NULL;
-    {
-        Far::PatchTableFactory::Options poptions(maxlevel);
-        poptions.SetEndCapType((Far::PatchTableFactory::Options::EndCapType)endCapType);
-        patchTable = Far::PatchTableFactory::Create(*refiner, poptions);
-    }
-
-    s.Stop();
-    double timeCreatePatch = s.GetElapsed();
-
-    // ----------------------------------------------------------------------
-    // append local points to stencils
-    s.Start();
-    {
-        if (Far::StencilTable const *vertexStencilsWithLocalPoints =
-            Far::StencilTableFactory::AppendLocalPointStencilTable(
-                *refiner, vertexStencils,
-                patchTable->GetLocalPointStencilTable())) {
-            delete vertexStencils;
-            vertexStencils = vertexStencilsWithLocalPoints;
-        }
-    }
-    s.Stop();
-    double timeAppendStencil = s.GetElapsed();
-
-    // ---------------------------------------------------------------------
-    double timeTotal = s.GetTotalElapsed();
-
-    printf("TopologyRefiner::Refine     %f %5.2f%%\n",
-           timeRefine, timeRefine/timeTotal*100);
-    printf("StencilTableFactory::Create %f %5.2f%%\n",
-           timeCreateStencil, timeCreateStencil/timeTotal*100);
-    printf("PatchTableFactory::Create   %f %5.2f%%\n",
-           timeCreatePatch, timeCreatePatch/timeTotal*100);
-    printf("StencilTableFactory::Append %f %5.2f%%\n",
-           timeAppendStencil, timeAppendStencil/timeTotal*100);
-    printf("Total                       %f\n", timeTotal);
+        options.useMultipleThreads = _useMultipleThreads;
+
+        while (state.KeepRunning()) {
+            Far::StencilTable const * stencils =
+                Far::StencilTableFactory::Create(*_data.refiner, options);
+
+            state.PauseTiming();
+            delete stencils;
+            state.ResumeTiming();
+        }
+    }
+
+private:
+    bool _useMultipleThreads;
+};
+
+class PatchTableFactoryBenchmark : public ShapeBenchmark {
+public:
+    PatchTableFactoryBenchmark(ShapeDesc const & shapeDesc, int level, int endCapType,
+                               bool useMultipleThreads) :
+        ShapeBenchmark(useMultipleThreads ?
+            "PatchTableFactory::Create(threaded)" : "PatchTableFactory::Create",
+            shapeDesc, level, endCapType, ShapeData::REFINER),
+        _useMultipleThreads(useMultipleThreads) { }
+
+    virtual void Run(PerfState & state) {
+
+        Far::PatchTableFactory::Options options(_level);
+        options.SetEndCapType((Far::PatchTableFactory::Options::EndCapType)_endCapType);
+        options.useMultipleThreads = _useMultipleThreads;
+
+        while (state.KeepRunning()) {
+            Far::PatchTable const * patchTable =
+                Far::PatchTableFactory::Create(*_data.refiner, options);
+
+            state.PauseTiming();
+            delete patchTable;
+            state.ResumeTiming();
+        }
+    }
+
+private:
+    bool _useMultipleThreads;
+};
+
+class AppendLocalPointsBenchmark : public ShapeBenchmark {
+public:
+    AppendLocalPointsBenchmark(ShapeDesc const & shapeDesc, int level, int endCapType) :
+        ShapeBenchmark("StencilTableFactory::AppendLocalPointStencilTable",
+            shapeDesc, level, endCapType, ShapeData::STENCILS | ShapeData::PATCHES) { }
+
+    virtual void Run(PerfState & state) {
+        while (state.KeepRunning()) {
+            Far::StencilTable const * stencils =
+                Far::StencilTableFactory::AppendLocalPointStencilTable(
+                    *_data.refiner, _data.stencils,
+                    _data.patchTable->GetLocalPointStencilTable());
+
+            state.PauseTiming();
+            delete stencils;
+            state.ResumeTiming();
+        }
+    }
+};
+
+//
+//  Limit stencils are generated at a grid of locations on each ptex face:
+//
+static int const g_gridSize = 3;
+
+class LimitStencilTableFactoryBenchmark : public ShapeBenchmark {
+public:
+    LimitStencilTableFactoryBenchmark(char const * name,
+                                      ShapeDesc const & shapeDesc, int level,
+                                      int endCapType, int gridSize,
+                                      bool useMultipleThreads) :
+        ShapeBenchmark(name, shapeDesc, level, endCapType, ShapeData::PATCHES),
+        _gridSize(gridSize), _useMultipleThreads(useMultipleThreads),
+        _cvStencils(0) { }
+
+    virtual void Setup() {
+        ShapeBenchmark::Setup();
+
+        //  Stencils for the control vertices as expected by the factory :
+        //  including the coarse and local points
+        Far::StencilTableFactory::Options options;
+        options.generateControlVerts = true;
+        options.generateOffsets = true;
+        _cvStencils = Far::StencilTableFactory::Create(*_data.refiner, options);
+
+        if (Far::StencilTable const * localPointStencils =
+            _data.patchTable->GetLocalPointStencilTable()) {
+            Far::StencilTable const * stencils =
+                Far::StencilTableFactory::AppendLocalPointStencilTable(
+                    *_data.refiner, _cvStencils, localPointStencils);
+            delete _cvStencils;
+            _cvStencils = stencils;
+        }
+
+        for (int i = 0; i < _gridSize * _gridSize; ++i) {
+            _s.push_back((float)(i % _gridSize + 0.5f) / _gridSize);
+            _t.push_back((float)(i / _gridSize + 0.5f) / _gridSize);
+        }
+
+        int numPtexFaces = Far::PtexIndices(*_data.refiner).GetNumFaces();
+        _locations.resize(numPtexFaces);
+        for (int i = 0; i < numPtexFaces; ++i) {
+            _locations[i].ptexIdx = i;
+            _locations[i].numLocations = (int)_s.size();
+            _locations[i].s = &_s[0];
+            _locations[i].t = &_t[0];
+        }
+    }
+
+    virtual void Run(PerfState & state) {
+
+        Far::LimitStencilTableFactory::Options options;
+        options.useMultipleThreads = _useMultipleThreads;
+
+        while (state.KeepRunning()) {
+            Far::LimitStencilTable const * stencils =
+                Far::LimitStencilTableFactory::Create(*_data.refiner, _locations,
+                    _cvStencils, _data.patchTable, options);
+
+            state.PauseTiming();
+            delete stencils;
+            state.ResumeTiming();
+        }
+    }
+
+    virtual void TearDown() {
+        delete _cvStencils;
+        _cvStencils = 0;
+        _locations.clear();
+        _s.clear();
+        _t.clear();
+
+        ShapeBenchmark::TearDown();
+    }
+
+private:
+    int  _gridSize;
+    bool _useMultipleThreads;
+
+    Far::StencilTable const * _cvStencils;
+
+    std::vector<float> _s, _t;
+
+    Far::LimitStencilTableFactory::LocationArrayVec _locations;
+};
+
+//
+//  Stencil tables are written to and read back from a memory buffer:
+//
+class TableSerializerBenchmark : public ShapeBenchmark {
+public:
+    TableSerializerBenchmark(ShapeDesc const & shapeDesc, int level, int endCapType) :
+        ShapeBenchmark("TableSerializer::Write+ReadStencilTable",
+            shapeDesc, level, endCapType, ShapeData::ALL_STENCILS) { }
+
+    virtual void Run(PerfState & state) {
+
+        std::vector<char> buffer;
+        while (state.KeepRunning()) {
+            std::stringstream stream;
+            Far::TableSerializer::Write(stream, *_data.stencils);
+            Far::TableSerializer::ReadStream(stream, buffer);
+
+            Far::StencilTable const * stencils =
+                Far::TableSerializer::ReadStencilTable(&buffer[0], buffer.size());
+
+            state.PauseTiming();
+            delete stencils;
+            state.ResumeTiming();
+        }
+
+        char label[128];
+        snprintf(label, sizeof(label), "size:%dKB", (int)(buffer.size() / 1024));
+        state.SetLabel(label);
+    }
+};
+
+//
+//  Topologies are acquired from a Far::TopologyCache -- the timing is that of
+//  a cache hit:
+//
+class TopologyCacheBenchmark : public ShapeBenchmark {
+public:
+    TopologyCacheBenchmark(ShapeDesc const & shapeDesc, int level, int endCapType) :
+        ShapeBenchmark("TopologyCache::Acquire", shapeDesc, level, endCapType, 0) { }
+
+    virtual void Run(PerfState & state) {
+
+        Shape const & shape = *_data.shape;
+
+        Far::TopologyDescriptor desc;
+        desc.numVertices = (int)shape.verts.size() / 3;
+        desc.numFaces = (int)shape.nvertsPerFace.size();
+        desc.numVertsPerFace = &shape.nvertsPerFace[0];
+        desc.vertIndicesPerFace = &shape.faceverts[0];
+        desc.isLeftHanded = shape.isLeftHanded;
+
+        Far::TopologyCache::Options options;
+        options.schemeType = GetSdcType(shape);
+        options.schemeOptions = GetSdcOptions(shape);
+        options.adaptiveOptions.isolationLevel = _level;
+        options.patchTableOptions.SetEndCapType(
+            (Far::PatchTableFactory::Options::EndCapType)_endCapType);
+
+        Far::TopologyCache cache(2);
+
+        cache.Release(cache.Acquire(desc, options));
+
+        while (state.KeepRunning()) {
+            cache.Release(cache.Acquire(desc, options));
+        }
+        cache.Clear();
+    }
+};
+
+
+class PatchMapBenchmark : public ShapeBenchmark {
+public:
+    PatchMapBenchmark(ShapeDesc const & shapeDesc, int level, int endCapType) :
+        ShapeBenchmark("PatchMap::PatchMap", shapeDesc, level, endCapType,
+            ShapeData::PATCHES) { }
+
+    virtual void Run(PerfState & state) {
+        while (state.KeepRunning()) {
+            Far::PatchMap * patchMap = new Far::PatchMap(*_data.patchTable);
+
+            state.PauseTiming();
+            delete patchMap;
+            state.ResumeTiming();
+        }
+    }
+};
+
+//
+//  Patch queries at scattered locations -- one by one or batched:
+//
+class FindPatchBenchmark : public ShapeBenchmark {
+public:
+    enum Mode { SINGLE, BATCHED, BATCHED_THREADED };
+
+    FindPatchBenchmark(ShapeDesc const & shapeDesc, int level, int endCapType,
+                       Mode mode) :
+        ShapeBenchmark(mode == SINGLE ? "PatchMap::FindPatch" :
+            (mode == BATCHED ? "PatchMap::FindPatches" :
+                               "PatchMap::FindPatches (threaded)"),
+            shapeDesc, level, endCapType, ShapeData::PATCHES),
+        _mode(mode), _patchMap(0) { }
+
+    virtual void Setup() {
+        ShapeBenchmark::Setup();
+
+        _patchMap = new Far::PatchMap(*_data.patchTable);
+
+        int numPtexFaces = _data.patchTable->GetNumPtexFaces(),
+            numLocations = numPtexFaces * g_gridSize * g_gridSize;
+
+        srand(1);
+        _faces.resize(numLocations);
+        _u.resize(numLocations);
+        _v.resize(numLocations);
+        for (int i = 0; i < numLocations; ++i) {
+            _faces[i] = rand() % numPtexFaces;
+            _u[i] = (float)rand() / (float)RAND_MAX;
+            _v[i] = (float)rand() / (float)RAND_MAX;
+        }
+        _handles.resize(numLocations);
+    }
+
+    virtual void Run(PerfState & state) {
+        int numLocations = (int)_faces.size();
+        while (state.KeepRunning()) {
+            if (_mode == SINGLE) {
+                for (int i = 0; i < numLocations; ++i) {
+                    _handles[i] = _patchMap->FindPatch(_faces[i], _u[i], _v[i]);
+                }
+            } else {
+                _patchMap->FindPatches(numLocations, &_faces[0], &_u[0], &_v[0],
+                    &_handles[0], _mode == BATCHED_THREADED);
+            }
+        }
+    }
+
+    virtual void TearDown() {
+        delete _patchMap;
+        _patchMap = 0;
+        _faces.clear();
+        _u.clear();
+        _v.clear();
+        _handles.clear();
+
+        ShapeBenchmark::TearDown();
+    }
+
+private:
+    Mode               _mode;
+    Far::PatchMap *    _patchMap;
+    std::vector<int>   _faces;
+    std::vector<float> _u,
+                       _v;
+    std::vector<Far::PatchMap::Handle const *> _handles;
+};
+
+//------------------------------------------------------------------------------
+//  Evaluators:
+//
+//  Vertex data are laid out as in Osd::Mesh : control vertices followed by
+//  the refined and local points computed by the stencils.
+//
+class EvaluatorBenchmark : public ShapeBenchmark {
+public:
+    EvaluatorBenchmark(char const * name, ShapeDesc const & shapeDesc,
+                       int level, int endCapType) :
+        ShapeBenchmark(name, shapeDesc, level, endCapType, ShapeData::ALL_STENCILS),
+        _vertexBuffer(0), _valueBuffer(0), _patchTable(0) { }
+
+    //  Patch coordinates as expected by the evaluators:
+    struct PatchCoordBuffer {
+        void * BindCpuBuffer() { return &coords[0]; }
+
+        std::vector<Osd::PatchCoord> coords;
+    };
+
+    virtual void Setup() {
+        ShapeBenchmark::Setup();
+
+        int numControlVerts = _data.stencils->GetNumControlVertices(),
+            numVerts = numControlVerts + _data.stencils->GetNumStencils();
+
+        _vertexBuffer = Osd::CpuVertexBuffer::Create(3, numVerts);
+
+        std::vector<float> const & positions = _data.shape->verts;
+        _vertexBuffer->UpdateData(&positions[0], 0, numControlVerts);
+
+        _srcDesc = Osd::BufferDescriptor(0, 3, 3);
+        _dstDesc = Osd::BufferDescriptor(numControlVerts * 3, 3, 3);
+
+        Osd::CpuEvaluator::EvalStencils(_vertexBuffer, _srcDesc,
+            _vertexBuffer, _dstDesc, _data.stencils);
+
+        //  Patch coordinates at a grid of locations on each ptex face:
+        Far::PatchMap patchMap(*_data.patchTable);
+
+        int numPtexFaces = _data.patchTable->GetNumPtexFaces();
+        for (int face = 0; face < numPtexFaces; ++face) {
+            for (int i = 0; i < g_gridSize * g_gridSize; ++i) {
+                float s = (float)(i % g_gridSize + 0.5f) / g_gridSize,
+                      t = (float)(i / g_gridSize + 0.5f) / g_gridSize;
+
+                if (Far::PatchTable::PatchHandle const * handle =
+                    patchMap.FindPatch(face, s, t)) {
+                    _patchCoords.coords.push_back(Osd::PatchCoord(*handle, s, t));
+                }
+            }
+        }
+        _valueBuffer = Osd::CpuVertexBuffer::Create(3,
+            std::max(1, (int)_patchCoords.coords.size()));
+        _valueDesc = Osd::BufferDescriptor(0, 3, 3);
+
+        _patchTable = Osd::CpuPatchTable::Create(_data.patchTable);
+    }
+
+    virtual void TearDown() {
+        delete _patchTable;
+        delete _valueBuffer;
+        delete _vertexBuffer;
+        _patchTable = 0;
+        _valueBuffer = 0;
+        _vertexBuffer = 0;
+        _patchCoords.coords.clear();
+
+        ShapeBenchmark::TearDown();
+    }
+
+protected:
+    Osd::CpuVertexBuffer * _vertexBuffer,
+                         * _valueBuffer;
+    Osd::BufferDescriptor  _srcDesc,
+                           _dstDesc,
+                           _valueDesc;
+    Osd::CpuPatchTable *   _patchTable;
+    PatchCoordBuffer       _patchCoords;
+};
+
+template <class EVALUATOR>
+class EvalStencilsBenchmark : public EvaluatorBenchmark {
+public:
+    EvalStencilsBenchmark(char const * name, ShapeDesc const & shapeDesc,
+                          int level, int endCapType) :
+        EvaluatorBenchmark(name, shapeDesc, level, endCapType) { }
+
+    virtual void Run(PerfState & state) {
+        while (state.KeepRunning()) {
+            EVALUATOR::EvalStencils(_vertexBuffer, _srcDesc,
+                _vertexBuffer, _dstDesc, _data.stencils);
+        }
+    }
+};
+
+//  Stencils are evaluated through a view of the arrays of the table (see
+//  Far::StencilTableView):
+template <class EVALUATOR>
+class EvalStencilTableViewBenchmark : public EvaluatorBenchmark {
+public:
+    EvalStencilTableViewBenchmark(char const * name, ShapeDesc const & shapeDesc,
+                                  int level, int endCapType) :
+        EvaluatorBenchmark(name, shapeDesc, level, endCapType),
+        _viewBuffer(0) { }
+
+    virtual void Setup() {
+        EvaluatorBenchmark::Setup();
+
+        _view = Far::StencilTableView(*_data.stencils);
+
+        int numControlVerts = _data.stencils->GetNumControlVertices(),
+            numVerts = numControlVerts + _data.stencils->GetNumStencils();
+
+        _viewBuffer = Osd::CpuVertexBuffer::Create(3, numVerts);
+        _viewBuffer->UpdateData(_vertexBuffer->BindCpuBuffer(), 0, numControlVerts);
+    }
+
+    virtual void Run(PerfState & state) {
+        while (state.KeepRunning()) {
+            EVALUATOR::EvalStencils(_viewBuffer, _srcDesc,
+                _viewBuffer, _dstDesc, &_view);
+        }
+    }
+
+    virtual void TearDown() {
+        delete _viewBuffer;
+        _viewBuffer = 0;
+
+        EvaluatorBenchmark::TearDown();
+    }
+
+private:
+    Far::StencilTableView   _view;
+    Osd::CpuVertexBuffer *  _viewBuffer;
+};
+
+//  Stencils are compressed (see Far::CompressedStencilTable) and decoded by
+//  the evaluators -- the size of the compressed table is reported with the
+//  results:
+template <class EVALUATOR>
+class EvalCompressedStencilsBenchmark : public EvaluatorBenchmark {
+public:
+    EvalCompressedStencilsBenchmark(char const * name, ShapeDesc const & shapeDesc,
+        int level, int endCapType,
+        Far::CompressedStencilTable::WeightEncoding weightEncoding) :
+        EvaluatorBenchmark(name, shapeDesc, level, endCapType),
+        _weightEncoding(weightEncoding), _compressedStencils(0) { }
+
+    virtual void Setup() {
+        EvaluatorBenchmark::Setup();
+
+        Far::CompressedStencilTable::Options options;
+        options.weightEncoding = _weightEncoding;
+        _compressedStencils =
+            Far::CompressedStencilTable::Create(*_data.stencils, options);
+    }
+
+    virtual void Run(PerfState & state) {
+
+        Far::StencilTable const & stencils = *_data.stencils;
+        size_t size = (stencils.GetSizes().size() +
+                       stencils.GetOffsets().size() +
+                       stencils.GetControlIndices().size()) * sizeof(int) +
+                       stencils.GetWeights().size() * sizeof(float);
+
+        char label[128];
+        snprintf(label, sizeof(label), "size:%.0f%% weight_error:%.2g",
+            100.0 * _compressedStencils->GetMemoryUsage() / std::max(size, (size_t)1),
+            _compressedStencils->GetMaxWeightError());
+        state.SetLabel(label);
+
+        while (state.KeepRunning()) {
+            EVALUATOR::EvalStencils(_vertexBuffer, _srcDesc,
+                _vertexBuffer, _dstDesc, _compressedStencils);
+        }
+    }
+
+    virtual void TearDown() {
+        delete _compressedStencils;
+        _compressedStencils = 0;
+
+        EvaluatorBenchmark::TearDown();
+    }
+
+private:
+    Far::CompressedStencilTable::WeightEncoding _weightEncoding;
+    Far::CompressedStencilTable const *         _compressedStencils;
+};
+
+//  Stencils and control vertices are reordered for locality (see
+//  Far::StencilTableFactory::CreateReordered()):
+template <class EVALUATOR>
+class EvalReorderedStencilsBenchmark : public EvaluatorBenchmark {
+public:
+    EvalReorderedStencilsBenchmark(char const * name, ShapeDesc const & shapeDesc,
+                                   int level, int endCapType) :
+        EvaluatorBenchmark(name, shapeDesc, level, endCapType),
+        _reorderedStencils(0), _reorderedBuffer(0) { }
+
+    virtual void Setup() {
+        EvaluatorBenchmark::Setup();
+
+        _reorderedStencils = Far::StencilTableFactory::CreateReordered(
+            *_data.stencils, _stencilPermutation, &_vertexPermutation);
+
+        int numControlVerts = _reorderedStencils->GetNumControlVertices(),
+            numStencils = _reorderedStencils->GetNumStencils();
+
+        _reorderedBuffer = Osd::CpuVertexBuffer::Create(3,
+            numControlVerts + numStencils);
+
+        float const * positions = _vertexBuffer->BindCpuBuffer();
+        float * reordered = _reorderedBuffer->BindCpuBuffer();
+        for (int i = 0; i < numControlVerts; ++i) {
+            std::copy(positions + 3 * _vertexPermutation[i],
+                      positions + 3 * _vertexPermutation[i] + 3,
+                      reordered + 3 * i);
+        }
+    }
+
+    virtual void Run(PerfState & state) {
+        while (state.KeepRunning()) {
+            EVALUATOR::EvalStencils(_reorderedBuffer, _srcDesc,
+                _reorderedBuffer, _dstDesc, _reorderedStencils);
+        }
+    }
+
+    virtual void TearDown() {
+        delete _reorderedBuffer;
+        delete _reorderedStencils;
+        _reorderedBuffer = 0;
+        _reorderedStencils = 0;
+        _stencilPermutation.clear();
+        _vertexPermutation.clear();
+
+        EvaluatorBenchmark::TearDown();
+    }
+
+private:
+    Far::StencilTable const * _reorderedStencils;
+    Osd::CpuVertexBuffer *    _reorderedBuffer;
+    std::vector<Far::Index>   _stencilPermutation,
+                              _vertexPermutation;
+};
+
+//  A few control vertices are moved and only the stencils they affect are
+//  re-evaluated (see Far::StencilDependencyTable):
+class EvalModifiedStencilsBenchmark : public EvaluatorBenchmark {
+public:
+    EvalModifiedStencilsBenchmark(char const * name, ShapeDesc const & shapeDesc,
+                                  int level, int endCapType, int numModified) :
+        EvaluatorBenchmark(name, shapeDesc, level, endCapType),
+        _numModified(numModified), _dependencies(0) { }
+
+    virtual void Setup() {
+        EvaluatorBenchmark::Setup();
+
+        _dependencies = Far::StencilDependencyTable::Create(*_data.stencils);
+
+        //  Move the control vertices after the initial evaluation:
+        int numControlVerts = _data.stencils->GetNumControlVertices();
+
+        float * positions = _vertexBuffer->BindCpuBuffer();
+        for (int i = 0; i < std::min(_numModified, numControlVerts); ++i) {
+            _modified.push_back(i);
+            positions[3 * i] += 1.0f;
+        }
+    }
+
+    virtual void Run(PerfState & state) {
+
+        std::vector<Far::Index> affected;
+        char label[128];
+        snprintf(label, sizeof(label), "stencils:%d/%d",
+            _dependencies->GetAffectedStencils(
+                &_modified[0], (int)_modified.size(), affected),
+            _data.stencils->GetNumStencils());
+        state.SetLabel(label);
+
+        while (state.KeepRunning()) {
+            Osd::CpuEvaluator::EvalModifiedStencils(_vertexBuffer, _srcDesc,
+                _vertexBuffer, _dstDesc, _data.stencils,
+                _dependencies, &_modified[0], (int)_modified.size());
+        }
+    }
+
+    virtual void TearDown() {
+        delete _dependencies;
+        _dependencies = 0;
+        _modified.clear();
+
+        EvaluatorBenchmark::TearDown();
+    }
+
+private:
+    int                                 _numModified;
+    Far::StencilDependencyTable const * _dependencies;
+    std::vector<Far::Index>             _modified;
+};
+
+//  The stencils are applied to several frames of animated control vertices,
+//  either one frame at a time or all frames at once:
+static int const g_numFrames = 8;
+
+template <class EVALUATOR>
+class EvalStencilFramesBenchmark : public EvaluatorBenchmark {
+public:
+    EvalStencilFramesBenchmark(char const * name, ShapeDesc const & shapeDesc,
+                               int level, int endCapType, bool batched) :
+        EvaluatorBenchmark(name, shapeDesc, level, endCapType),
+        _batched(batched) { }
+
+    virtual void Setup() {
+        EvaluatorBenchmark::Setup();
+
+        int numControlVerts = _data.stencils->GetNumControlVertices(),
+            numVerts = numControlVerts + _data.stencils->GetNumStencils();
+
+        for (int frame = 0; frame < g_numFrames; ++frame) {
+            Osd::CpuVertexBuffer * buffer = Osd::CpuVertexBuffer::Create(3, numVerts);
+
+            float * positions = buffer->BindCpuBuffer();
+            std::copy(_data.shape->verts.begin(),
+                      _data.shape->verts.begin() + 3 * numControlVerts, positions);
+            for (int i = 0; i < numControlVerts; ++i) {
+                positions[3 * i + 1] += 0.1f * frame;
+            }
+            _frames.push_back(buffer);
+        }
+    }
+
+    virtual void Run(PerfState & state) {
+
+        char label[128];
+        snprintf(label, sizeof(label), "frames:%d", g_numFrames);
+        state.SetLabel(label);
+
+        while (state.KeepRunning()) {
+            if (_batched) {
+                EVALUATOR::EvalStencilFrames(&_frames[0], _srcDesc,
+                    &_frames[0], _dstDesc, g_numFrames, _data.stencils);
+            } else {
+                for (int frame = 0; frame < g_numFrames; ++frame) {
+                    EVALUATOR::EvalStencils(_frames[frame], _srcDesc,
+                        _frames[frame], _dstDesc, _data.stencils);
+                }
+            }
+        }
+    }
+
+    virtual void TearDown() {
+        for (int frame = 0; frame < (int)_frames.size(); ++frame) {
+            delete _frames[frame];
+        }
+        _frames.clear();
+
+        EvaluatorBenchmark::TearDown();
+    }
+
+private:
+    bool                                 _batched;
+    std::vector<Osd::CpuVertexBuffer *>  _frames;
+};
+
+//  Limit stencils with 1st derivatives at a grid of locations on each ptex
+//  face, evaluated one output at a time, all outputs together, or with the
+//  normals computed from the derivatives:
+class EvalLimitStencilsBenchmark : public EvaluatorBenchmark {
+public:
+    enum Mode { SEPARATE, FUSED, NORMALS };
+
+    EvalLimitStencilsBenchmark(ShapeDesc const & shapeDesc,
+                               int level, int endCapType, Mode mode) :
+        EvaluatorBenchmark(mode == SEPARATE ? "CpuEvaluator::EvalStencils(limit,separate)" :
+                           mode == FUSED ? "CpuEvaluator::EvalStencils(limit)" :
+                                           "CpuEvaluator::EvalStencilNormals(limit)",
+                           shapeDesc, level, endCapType),
+        _mode(mode), _limitStencils(0) { }
+
+    virtual void Setup() {
+        EvaluatorBenchmark::Setup();
+
+        for (int i = 0; i < g_gridSize * g_gridSize; ++i) {
+            _s.push_back((float)(i % g_gridSize + 0.5f) / g_gridSize);
+            _t.push_back((float)(i / g_gridSize + 0.5f) / g_gridSize);
+        }
+
+        int numPtexFaces = Far::PtexIndices(*_data.refiner).GetNumFaces();
+        Far::LimitStencilTableFactory::LocationArrayVec locations(numPtexFaces);
+        for (int i = 0; i < numPtexFaces; ++i) {
+            locations[i].ptexIdx = i;
+            locations[i].numLocations = (int)_s.size();
+            locations[i].s = &_s[0];
+            locations[i].t = &_t[0];
+        }
+        _limitStencils = Far::LimitStencilTableFactory::Create(
+            *_data.refiner, locations);
+
+        int numStencils = _limitStencils ? _limitStencils->GetNumStencils() : 0;
+        _values.resize(3 * numStencils);
+        _derivs.resize(6 * numStencils);
+    }
+
+    virtual void Run(PerfState & state) {
+
+        Far::LimitStencilTable const & stencils = *_limitStencils;
+        int numStencils = stencils.GetNumStencils();
+
+        //  limit stencils reference the control vertices only
+        float const * src = _vertexBuffer->BindCpuBuffer();
+        float * values = &_values[0],
+              * du = &_derivs[0],
+              * dv = &_derivs[3 * numStencils];
+
+        while (state.KeepRunning()) {
+            if (_mode == SEPARATE) {
+                evalSeparate(src, values, du, dv);
+            } else if (_mode == FUSED) {
+                Osd::CpuEvaluator::EvalStencils(src, _srcDesc,
+                    values, _valueDesc, du, _valueDesc, dv, _valueDesc,
+                    &stencils.GetSizes()[0], &stencils.GetOffsets()[0],
+                    &stencils.GetControlIndices()[0], &stencils.GetWeights()[0],
+                    &stencils.GetDuWeights()[0], &stencils.GetDvWeights()[0],
+                    0, numStencils);
+            } else {
+                Osd::CpuEvaluator::EvalStencilNormals(src, _srcDesc,
+                    values, _valueDesc, du, _valueDesc,
+                    &stencils.GetSizes()[0], &stencils.GetOffsets()[0],
+                    &stencils.GetControlIndices()[0], &stencils.GetWeights()[0],
+                    &stencils.GetDuWeights()[0], &stencils.GetDvWeights()[0],
+                    0, numStencils);
+            }
+        }
+    }
+
+    virtual void TearDown() {
+        delete _limitStencils;
+        _limitStencils = 0;
+        _values.clear();
+        _derivs.clear();
+        _s.clear();
+        _t.clear();
+
+        EvaluatorBenchmark::TearDown();
+    }
+
+private:
+    void evalSeparate(float const * src, float * values, float * du, float * dv) {
+        Far::LimitStencilTable const & stencils = *_limitStencils;
+
+        std::vector<float> const * weights[3] = { &stencils.GetWeights(),
+            &stencils.GetDuWeights(), &stencils.GetDvWeights() };
+        float * dsts[3] = { values, du, dv };
+
+        for (int i = 0; i < 3; ++i) {
+            Osd::CpuEvaluator::EvalStencils(src, _srcDesc,
+                dsts[i], _valueDesc,
+                &stencils.GetSizes()[0], &stencils.GetOffsets()[0],
+                &stencils.GetControlIndices()[0], &(*weights[i])[0],
+                0, stencils.GetNumStencils());
+        }
+    }
+
+    Mode                           _mode;
+    Far::LimitStencilTable const * _limitStencils;
+    std::vector<float>             _s, _t,
+                                   _values,
+                                   _derivs;
+};
+
+template <class EVALUATOR>
+class EvalPatchesBenchmark : public EvaluatorBenchmark {
+public:
+    EvalPatchesBenchmark(char const * name, ShapeDesc const & shapeDesc,
+                         int level, int endCapType) :
+        EvaluatorBenchmark(name, shapeDesc, level, endCapType) { }
+
+    virtual void Run(PerfState & state) {
+        while (state.KeepRunning()) {
+            EVALUATOR::EvalPatches(_vertexBuffer, _srcDesc,
+                _valueBuffer, _valueDesc,
+                (int)_patchCoords.coords.size(), &_patchCoords, _patchTable);
+        }
+    }
+};
+
+//------------------------------------------------------------------------------
+static void
+addBenchmarks(PerfSuite & suite, ShapeDesc const & shapeDesc, int level, int endCapType)
+{
+    if (level == 1) {
+        //  the base level is independent of the refinement level
+        suite.Add(new TopologyRefinerFactoryBenchmark(shapeDesc, false));
+        suite.Add(new TopologyRefinerFactoryBenchmark(shapeDesc, true));
+    }
+    suite.Add(new RefineUniformBenchmark(shapeDesc, level));
+    suite.Add(new RefineAdaptiveBenchmark(shapeDesc, level, false));
+    suite.Add(new RefineAdaptiveBenchmark(shapeDesc, level, true));
+    suite.Add(new PrimvarRefinerBenchmark(shapeDesc, level,
+        PrimvarRefinerBenchmark::SERIAL));
+    suite.Add(new PrimvarRefinerBenchmark(shapeDesc, level,
+        PrimvarRefinerBenchmark::THREADED));
+    suite.Add(new PrimvarRefinerBenchmark(shapeDesc, level,
+        PrimvarRefinerBenchmark::RAW));
+
+    suite.Add(new StencilTableFactoryBenchmark(shapeDesc, level, false));
+    suite.Add(new StencilTableFactoryBenchmark(shapeDesc, level, true));
+    suite.Add(new PatchTableFactoryBenchmark(shapeDesc, level, endCapType, false));
+    suite.Add(new PatchTableFactoryBenchmark(shapeDesc, level, endCapType, true));
+    suite.Add(new AppendLocalPointsBenchmark(shapeDesc, level, endCapType));
+    suite.Add(new TableSerializerBenchmark(shapeDesc, level, endCapType));
+    suite.Add(new TopologyCacheBenchmark(shapeDesc, level, endCapType));
+    suite.Add(new RefineEditBenchmark(shapeDesc, level, endCapType, false));
+    suite.Add(new RefineEditBenchmark(shapeDesc, level, endCapType, true));
+    suite.Add(new SharpnessEditBenchmark(shapeDesc, level, endCapType));
+    suite.Add(new LimitStencilTableFactoryBenchmark(
+        "LimitStencilTableFactory::Create", shapeDesc, level, endCapType,
+        g_gridSize, false));
+    //  large numbers of locations (e.g. scattering), serial and threaded:
+    suite.Add(new LimitStencilTableFactoryBenchmark(
+        "LimitStencilTableFactory::Create(16x16)",
+        shapeDesc, level, endCapType, 16, false));
+    suite.Add(new LimitStencilTableFactoryBenchmark(
+        "LimitStencilTableFactory::Create(16x16,threaded)",
+        shapeDesc, level, endCapType, 16, true));
+    suite.Add(new PatchMapBenchmark(shapeDesc, level, endCapType));
+    suite.Add(new FindPatchBenchmark(shapeDesc, level, endCapType,
+        FindPatchBenchmark::SINGLE));
+    suite.Add(new FindPatchBenchmark(shapeDesc, level, endCapType,
+        FindPatchBenchmark::BATCHED));
+    suite.Add(new FindPatchBenchmark(shapeDesc, level, endCapType,
+        FindPatchBenchmark::BATCHED_THREADED));
+
+    suite.Add(new EvalStencilsBenchmark<Osd::CpuEvaluator>(
+        "CpuEvaluator::EvalStencils", shapeDesc, level, endCapType));
+    suite.Add(new EvalStencilTableViewBenchmark<Osd::CpuEvaluator>(
+        "CpuEvaluator::EvalStencils(view)", shapeDesc, level, endCapType));
+    suite.Add(new EvalCompressedStencilsBenchmark<Osd::CpuEvaluator>(
+        "CpuEvaluator::EvalStencils(half)", shapeDesc, level, endCapType,
+        Far::CompressedStencilTable::WEIGHT_HALF));
+    suite.Add(new EvalCompressedStencilsBenchmark<Osd::CpuEvaluator>(
+        "CpuEvaluator::EvalStencils(fixed16)", shapeDesc, level, endCapType,
+        Far::CompressedStencilTable::WEIGHT_FIXED16));
+    suite.Add(new EvalReorderedStencilsBenchmark<Osd::CpuEvaluator>(
+        "CpuEvaluator::EvalStencils(reordered)", shapeDesc, level, endCapType));
+    suite.Add(new EvalModifiedStencilsBenchmark(
+        "CpuEvaluator::EvalModifiedStencils", shapeDesc, level, endCapType, 16));
+    suite.Add(new EvalStencilFramesBenchmark<Osd::CpuEvaluator>(
+        "CpuEvaluator::EvalStencils(frames)", shapeDesc, level, endCapType, false));
+    suite.Add(new EvalStencilFramesBenchmark<Osd::CpuEvaluator>(
+        "CpuEvaluator::EvalStencilFrames", shapeDesc, level, endCapType, true));
+    suite.Add(new EvalLimitStencilsBenchmark(shapeDesc, level, endCapType,
+        EvalLimitStencilsBenchmark::SEPARATE));
+    suite.Add(new EvalLimitStencilsBenchmark(shapeDesc, level, endCapType,
+        EvalLimitStencilsBenchmark::FUSED));
+    suite.Add(new EvalLimitStencilsBenchmark(shapeDesc, level, endCapType,
+        EvalLimitStencilsBenchmark::NORMALS));
+    suite.Add(new EvalPatchesBenchmark<Osd::CpuEvaluator>(
+        "CpuEvaluator::EvalPatches", shapeDesc, level, endCapType));
+#ifdef OPENSUBDIV_HAS_OPENMP
+    suite.Add(new EvalStencilsBenchmark<Osd::OmpEvaluator>(
+        "OmpEvaluator::EvalStencils", shapeDesc, level, endCapType));
+    suite.Add(new EvalStencilTableViewBenchmark<Osd::OmpEvaluator>(
+        "OmpEvaluator::EvalStencils(view)", shapeDesc, level, endCapType));
+    suite.Add(new EvalCompressedStencilsBenchmark<Osd::OmpEvaluator>(
+        "OmpEvaluator::EvalStencils(half)", shapeDesc, level, endCapType,
+        Far::CompressedStencilTable::WEIGHT_HALF));
+    suite.Add(new EvalReorderedStencilsBenchmark<Osd::OmpEvaluator>(
+        "OmpEvaluator::EvalStencils(reordered)", shapeDesc, level, endCapType));
+    suite.Add(new EvalStencilFramesBenchmark<Osd::OmpEvaluator>(
+        "OmpEvaluator::EvalStencils(frames)", shapeDesc, level, endCapType, false));
+    suite.Add(new EvalStencilFramesBenchmark<Osd::OmpEvaluator>(
+        "OmpEvaluator::EvalStencilFrames", shapeDesc, level, endCapType, true));
+    suite.Add(new EvalPatchesBenchmark<Osd::OmpEvaluator>(
+        "OmpEvaluator::EvalPatches", shapeDesc, level, endCapType));
+#endif
+#ifdef OPENSUBDIV_HAS_TBB
+    suite.Add(new EvalStencilsBenchmark<Osd::TbbEvaluator>(
+        "TbbEvaluator::EvalStencils", shapeDesc, level, endCapType));
+    suite.Add(new EvalStencilTableViewBenchmark<Osd::TbbEvaluator>(
+        "TbbEvaluator::EvalStencils(view)", shapeDesc, level, endCapType));
+    suite.Add(new EvalStencilFramesBenchmark<Osd::TbbEvaluator>(
+        "TbbEvaluator::EvalStencils(frames)", shapeDesc, level, endCapType, false));
+    suite.Add(new EvalStencilFramesBenchmark<Osd::TbbEvaluator>(
+        "TbbEvaluator::EvalStencilFrames", shapeDesc, level, endCapType, true));
+    suite.Add(new EvalPatchesBenchmark<Osd::TbbEvaluator>(
+        "TbbEvaluator::EvalPatches", shapeDesc, level, endCapType));
+#endif
 }
 
 //------------------------------------------------------------------------------
-int main(int argc, char **argv)
+static void
+usage(char const * program)
 {
-    using namespace OpenSubdiv;
+    printf("Usage: %s [options] [file.obj ...]\n"
+           "  -l <level>                        maximum refinement level (3)\n"
+           "  -e <bspline|gregory>              end-cap type (gregory)\n",
+           program);
+    PerfSuite::PrintUsage();
+}
 
-    int maxlevel = 8;
+//------------------------------------------------------------------------------
+int main(int argc, char **argv)
+{
+    int maxlevel = 3;
     std::string str;
     int endCapType = Far::PatchTableFactory::Options::ENDCAP_GREGORY_BASIS;
 
+    PerfSuite::Options suiteOptions;
+    if (!PerfSuite::ParseOptions(argc, argv, suiteOptions)) {
+        usage(argv[0]);
+        return 1;
+    }
+
     for (int i = 1; i < argc; ++i) {
         if (strstr(argv[i], ".obj")) {
             std::ifstream ifs(argv[i]);
@@ -149,23 +1379,28 @@ int main(int argc, char **argv)
                 return 1;
             }
         }
+        else if (!strcmp(argv[i], "-h")) {
+            usage(argv[0]);
+            return 0;
+        }
     }
 
     if (g_shapes.empty()) {
         initShapes();
     }
 
+    PerfSuite suite;
     for (int i = 0; i < (int)g_shapes.size(); ++i) {
-        Shape const * shape = Shape::parseObj(
-            g_shapes[i].data.c_str(),
-            g_shapes[i].scheme,
-            g_shapes[i].isLeftHanded);
-
         for (int lv = 1; lv <= maxlevel; ++lv) {
-            printf("---- %s, level %d ----\n", g_shapes[i].name.c_str(), lv);
-            doPerf(shape, lv, endCapType);
+            addBenchmarks(suite, g_shapes[i], lv, endCapType);
         }
     }
+
+    int numFailures = suite.Run(suiteOptions);
+    if (numFailures) {
+        printf("%d benchmark(s) failed or regressed\n", numFailures);
+    }
+    return numFailures ? 1 : 0;
 }
 
 //------------------------------------------------------------------------------
@@ -0,0 +1,343 @@
+//
+//   Copyright 2019 Pixar
+//
+//   Licensed under the Apache License, Version 2.0 (the "Apache License")
+//   with the following modification; you may not use this file except in
+//   compliance with the Apache License and the following modification to it:
+//   Section 6. Trademarks. is deleted and replaced with:
+//
+//   6. Trademarks. This License does not grant permission to use the trade
+//      names, trademarks, service marks, or product names of the Licensor
+//      and its affiliates, except as required to comply with Section 4(c) of
+//      the License and to reproduce the content of the NOTICE file.
+//
+//   You may obtain a copy of the Apache License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the Apache License with the above modification is
+//   distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//   KIND, either express or implied. See the Apache License for the specific
+//   language governing permissions and limitations under the Apache License.
+//
+
+#include "perfSuite.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+
+//------------------------------------------------------------------------------
+PerfState::PerfState(double minTime) :
+    _minTime(minTime), _iterations(0), _running(false) {
+}
+
+bool
+PerfState::KeepRunning() {
+
+    if (_running) {
+        _stopwatch.Stop();
+        _running = false;
+        ++_iterations;
+
+        if ((_stopwatch.GetTotalElapsed() >= _minTime) || !_error.empty()) {
+            return false;
+        }
+    }
+    _running = true;
+    _stopwatch.Start();
+    return true;
+}
+
+void
+PerfState::PauseTiming() {
+    if (_running) {
+        _stopwatch.Stop();
+        _running = false;
+    }
+}
+
+void
+PerfState::ResumeTiming() {
+    if (!_running) {
+        _running = true;
+        _stopwatch.Start();
+    }
+}
+
+//------------------------------------------------------------------------------
+PerfSuite::~PerfSuite() {
+    for (int i = 0; i < (int)_benchmarks.size(); ++i) {
+        delete _benchmarks[i];
+    }
+}
+
+void
+PerfSuite::PrintUsage() {
+    printf("  --benchmark_filter=<string>       run benchmarks containing <string>\n"
+           "  --benchmark_repetitions=<n>       repetitions of each benchmark (5)\n"
+           "  --benchmark_min_time=<seconds>    minimum time of a repetition (0.1)\n"
+           "  --benchmark_format=<text|json>    format of the printed results\n"
+           "  --benchmark_out=<file>            write the results as JSON to <file>\n"
+           "  --benchmark_baseline=<file>       compare with the JSON results in <file>\n"
+           "  --benchmark_threshold=<fraction>  slow down reported as a regression (0.1)\n");
+}
+
+bool
+PerfSuite::ParseOptions(int argc, char ** argv, Options & options) {
+
+    for (int i = 1; i < argc; ++i) {
+
+        char const * arg = argv[i];
+        char const * value = strchr(arg, '=');
+        if (strncmp(arg, "--benchmark_", 12) || (value == 0)) {
+            continue;
+        }
+        std::string name(arg, value++);
+
+        if (name == "--benchmark_filter") {
+            options.filter = value;
+        } else if (name == "--benchmark_repetitions") {
+            options.repetitions = std::max(1, atoi(value));
+        } else if (name == "--benchmark_min_time") {
+            options.minTime = atof(value);
+        } else if (name == "--benchmark_format") {
+            if (!strcmp(value, "json")) {
+                options.json = true;
+            } else if (!strcmp(value, "text")) {
+                options.json = false;
+            } else {
+                printf("Unknown format %s\n", value);
+                return false;
+            }
+        } else if (name == "--benchmark_out") {
+            options.outFile = value;
+        } else if (name == "--benchmark_baseline") {
+            options.baselineFile = value;
+        } else if (name == "--benchmark_threshold") {
+            options.threshold = atof(value);
+        } else {
+            printf("Unknown option %s\n", name.c_str());
+            return false;
+        }
+    }
+    return true;
+}
+
+void
+PerfSuite::runBenchmark(PerfBenchmark & benchmark, Options const & options,
+                        Result & result) {
+
+    std::vector<double> times;
+
+    benchmark.Setup();
+    for (int i = 0; i < options.repetitions; ++i) {
+
+        PerfState state(options.minTime);
+        benchmark.Run(state);
+
+        if (!state.GetError().empty()) {
+            result.error = state.GetError();
+            break;
+        }
+        if (state.GetIterations() > 0) {
+            times.push_back(state.GetElapsed() / state.GetIterations());
+        }
+        result.iterations = state.GetIterations();
+        result.label = state.GetLabel();
+    }
+    benchmark.TearDown();
+
+    int n = (int)times.size();
+
+    result.repetitions = n;
+    if (n == 0) return;
+
+    double sum = 0.0;
+    for (int i = 0; i < n; ++i) {
+        sum += times[i];
+    }
+    result.meanTime = sum / n;
+
+    double variance = 0.0;
+    for (int i = 0; i < n; ++i) {
+        variance += (times[i] - result.meanTime) * (times[i] - result.meanTime);
+    }
+    result.stddevTime = (n > 1) ? sqrt(variance / (n - 1)) : 0.0;
+
+    std::sort(times.begin(), times.end());
+    result.minTime = times[0];
+    result.medianTime = (n & 1) ? times[n/2] : 0.5 * (times[n/2 - 1] + times[n/2]);
+}
+
+int
+PerfSuite::Run(Options const & options) {
+
+    std::vector<std::string> baselineNames;
+    std::vector<double>      baselineTimes;
+    if (!options.baselineFile.empty() &&
+        !readBaseline(options.baselineFile, baselineNames, baselineTimes)) {
+        printf("Cannot read baseline %s\n", options.baselineFile.c_str());
+        return 1;
+    }
+
+    _results.clear();
+
+    int numFailures = 0;
+    for (int i = 0; i < (int)_benchmarks.size(); ++i) {
+
+        PerfBenchmark & benchmark = *_benchmarks[i];
+        if (!options.filter.empty() &&
+            (benchmark.GetName().find(options.filter) == std::string::npos)) {
+            continue;
+        }
+
+        Result result;
+        result.name = benchmark.GetName();
+        result.repetitions = result.iterations = 0;
+        result.meanTime = result.medianTime = result.stddevTime =
+            result.minTime = result.baselineTime = 0.0;
+
+        runBenchmark(benchmark, options, result);
+
+        for (int j = 0; j < (int)baselineNames.size(); ++j) {
+            if (baselineNames[j] == result.name) {
+                result.baselineTime = baselineTimes[j];
+                break;
+            }
+        }
+
+        if (!result.error.empty()) {
+            ++numFailures;
+        } else if ((result.baselineTime > 0.0) &&
+            (result.medianTime > result.baselineTime * (1.0 + options.threshold))) {
+            ++numFailures;
+        }
+
+        //  Print progressively as benchmarks can be long:
+        if (!options.json) {
+            writeText(stdout, result, options, _results.empty());
+        }
+        _results.push_back(result);
+    }
+
+    if (options.json) {
+        writeJSON(stdout);
+    }
+
+    if (!options.outFile.empty()) {
+        FILE * stream = fopen(options.outFile.c_str(), "w");
+        if (stream == 0) {
+            printf("Cannot write %s\n", options.outFile.c_str());
+            return numFailures + 1;
+        }
+        writeJSON(stream);
+        fclose(stream);
+    }
+    return numFailures;
+}
+
+void
+PerfSuite::writeText(FILE * stream, Result const & result,
+                     Options const & options, bool header) {
+
+    if (header) {
+        fprintf(stream, "%-72s %10s %12s %12s %12s %8s\n",
+            "Benchmark", "Iterations", "Median (ms)", "Mean (ms)", "Stddev (ms)", "Delta");
+    }
+
+    if (!result.error.empty()) {
+        fprintf(stream, "%-72s ERROR : %s\n", result.name.c_str(), result.error.c_str());
+        return;
+    }
+
+    fprintf(stream, "%-72s %10d %12.4f %12.4f %12.4f",
+        result.name.c_str(), result.iterations, result.medianTime * 1000.0,
+        result.meanTime * 1000.0, result.stddevTime * 1000.0);
+
+    if (result.baselineTime > 0.0) {
+        double delta = result.medianTime / result.baselineTime - 1.0;
+        fprintf(stream, " %+7.1f%%%s", delta * 100.0,
+            (delta > options.threshold) ? " REGRESSION" : "");
+    }
+    if (!result.label.empty()) {
+        fprintf(stream, "  %s", result.label.c_str());
+    }
+    fprintf(stream, "\n");
+    fflush(stream);
+}
+
+void
+PerfSuite::writeJSON(FILE * stream) const {
+
+    fprintf(stream, "{\n  \"benchmarks\": [\n");
+    for (int i = 0; i < (int)_results.size(); ++i) {
+        Result const & result = _results[i];
+
+        fprintf(stream, "    {\n");
+        fprintf(stream, "      \"name\": \"%s\",\n", result.name.c_str());
+        if (!result.error.empty()) {
+            fprintf(stream, "      \"error_message\": \"%s\",\n", result.error.c_str());
+        }
+        fprintf(stream, "      \"repetitions\": %d,\n", result.repetitions);
+        fprintf(stream, "      \"iterations\": %d,\n", result.iterations);
+        fprintf(stream, "      \"median_time\": %.9g,\n", result.medianTime);
+        fprintf(stream, "      \"mean_time\": %.9g,\n", result.meanTime);
+        fprintf(stream, "      \"stddev_time\": %.9g,\n", result.stddevTime);
+        fprintf(stream, "      \"min_time\": %.9g,\n", result.minTime);
+        if (result.baselineTime > 0.0) {
+            fprintf(stream, "      \"baseline_time\": %.9g,\n", result.baselineTime);
+        }
+        if (!result.label.empty()) {
+            fprintf(stream, "      \"label\": \"%s\",\n", result.label.c_str());
+        }
+        fprintf(stream, "      \"time_unit\": \"s\"\n");
+        fprintf(stream, "    }%s\n", (i + 1 < (int)_results.size()) ? "," : "");
+    }
+    fprintf(stream, "  ]\n}\n");
+}
+
+//
+//  Reads the name and median time of each benchmark from a file written by
+//  writeJSON() -- this is not a general JSON parser.
+//
+bool
+PerfSuite::readBaseline(std::string const & filename,
+                        std::vector<std::string> & names,
+                        std::vector<double> & times) {
+
+    std::ifstream ifs(filename.c_str());
+    if (!ifs) {
+        return false;
+    }
+
+    std::string line, name;
+    while (std::getline(ifs, line)) {
+
+        std::string::size_type key = line.find('"');
+        if (key == std::string::npos) continue;
+
+        std::string::size_type keyEnd = line.find('"', key + 1);
+        if (keyEnd == std::string::npos) continue;
+
+        std::string field = line.substr(key + 1, keyEnd - key - 1);
+        std::string::size_type colon = line.find(':', keyEnd);
+        if (colon == std::string::npos) continue;
+
+        if (field == "name") {
+            std::string::size_type begin = line.find('"', colon),
+                                   end = line.rfind('"');
+            if ((begin != std::string::npos) && (end > begin)) {
+                name = line.substr(begin + 1, end - begin - 1);
+            }
+        } else if ((field == "median_time") && !name.empty()) {
+            names.push_back(name);
+            times.push_back(atof(line.c_str() + colon + 1));
+            name.clear();
+        }
+    }
+    return true;
+}
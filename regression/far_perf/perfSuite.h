@@ -0,0 +1,179 @@
+//
+//   Copyright 2019 Pixar
+//
+//   Licensed under the Apache License, Version 2.0 (the "Apache License")
+//   with the following modification; you may not use this file except in
+//   compliance with the Apache License and the following modification to it:
+//   Section 6. Trademarks. is deleted and replaced with:
+//
+//   6. Trademarks. This License does not grant permission to use the trade
+//      names, trademarks, service marks, or product names of the Licensor
+//      and its affiliates, except as required to comply with Section 4(c) of
+//      the License and to reproduce the content of the NOTICE file.
+//
+//   You may obtain a copy of the Apache License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the Apache License with the above modification is
+//   distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//   KIND, either express or implied. See the Apache License for the specific
+//   language governing permissions and limitations under the Apache License.
+//
+
+#ifndef FAR_PERF_SUITE_H
+#define FAR_PERF_SUITE_H
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+// XXX: revisit the directory structure for examples/tests
+#include "../../examples/common/stopwatch.h"
+
+//
+//  A minimal benchmark harness :
+//
+//  Each benchmark is timed over a number of iterations until a minimum time
+//  has elapsed, and this is repeated to gather statistics on the time of an
+//  iteration.  Results are printed as text or written as JSON, and can be
+//  compared against the JSON results of a previous run to detect regressions.
+//
+
+//------------------------------------------------------------------------------
+class PerfState {
+
+public:
+    PerfState(double minTime);
+
+    /// \brief Returns true while more iterations are required, e.g.
+    ///
+    ///     while (state.KeepRunning()) { ... }
+    ///
+    bool KeepRunning();
+
+    /// \brief Excludes the work that follows from the timing (e.g. to reset
+    ///        data between iterations)
+    void PauseTiming();
+
+    /// \brief Resumes the timing after PauseTiming()
+    void ResumeTiming();
+
+    /// \brief Flags the benchmark as failed (e.g. invalid results)
+    void SetError(std::string const & message) { _error = message; }
+
+    /// \brief Attaches a short description to the results (e.g. sizes)
+    void SetLabel(std::string const & label) { _label = label; }
+
+    int GetIterations() const { return _iterations; }
+
+    double GetElapsed() const { return _stopwatch.GetTotalElapsed(); }
+
+    std::string const & GetError() const { return _error; }
+
+    std::string const & GetLabel() const { return _label; }
+
+private:
+    Stopwatch _stopwatch;
+
+    double _minTime;
+    int    _iterations;
+    bool   _running;
+
+    std::string _error,
+                _label;
+};
+
+//------------------------------------------------------------------------------
+class PerfBenchmark {
+
+public:
+    PerfBenchmark(std::string const & name) : _name(name) { }
+
+    virtual ~PerfBenchmark() { }
+
+    std::string const & GetName() const { return _name; }
+
+    /// \brief Prepares data shared by all repetitions (not timed)
+    virtual void Setup() { }
+
+    /// \brief Runs the timed loop of the benchmark
+    virtual void Run(PerfState & state) = 0;
+
+    /// \brief Releases data allocated in Setup()
+    virtual void TearDown() { }
+
+private:
+    std::string _name;
+};
+
+//------------------------------------------------------------------------------
+class PerfSuite {
+
+public:
+    struct Options {
+        Options() : repetitions(5), minTime(0.1), threshold(0.1), json(false) { }
+
+        int         repetitions;  // number of repetitions of each benchmark
+        double      minTime;      // minimum time (seconds) of a repetition
+        double      threshold;    // relative slow down reported as a regression
+
+        bool        json;         // print results as JSON rather than text
+
+        std::string filter,       // run only benchmarks containing the string
+                    outFile,      // also write the JSON results to a file
+                    baselineFile; // compare with the JSON results of a file
+    };
+
+    struct Result {
+        std::string name,
+                    error,
+                    label;
+
+        int         repetitions,
+                    iterations;     // iterations of the last repetition
+
+        double      meanTime,       // statistics of the time of an iteration
+                    medianTime,     // across repetitions (in seconds)
+                    stddevTime,
+                    minTime,
+                    baselineTime;   // median time of the baseline, if any
+    };
+
+public:
+    PerfSuite() { }
+
+    ~PerfSuite();
+
+    /// \brief Adds a benchmark -- the suite takes ownership
+    void Add(PerfBenchmark * benchmark) { _benchmarks.push_back(benchmark); }
+
+    /// \brief Parses the options of the suite from the command line, ignoring
+    ///        unknown arguments.  Returns false on malformed arguments.
+    static bool ParseOptions(int argc, char ** argv, Options & options);
+
+    /// \brief Prints the command line options of the suite
+    static void PrintUsage();
+
+    /// \brief Runs the benchmarks -- returns the number of failed benchmarks
+    ///        and of regressions wrt the baseline
+    int Run(Options const & options);
+
+private:
+    void runBenchmark(PerfBenchmark & benchmark, Options const & options,
+                      Result & result);
+
+    static void writeText(FILE * stream, Result const & result,
+                          Options const & options, bool header);
+    void writeJSON(FILE * stream) const;
+
+    static bool readBaseline(std::string const & filename,
+                             std::vector<std::string> & names,
+                             std::vector<double> & times);
+
+    std::vector<PerfBenchmark *> _benchmarks;
+    std::vector<Result>          _results;
+};
+
+#endif /* FAR_PERF_SUITE_H */
@@ -0,0 +1,272 @@
+//
+//   Copyright 2015 Pixar
+//
+//   Licensed under the Apache License, Version 2.0 (the "Apache License")
+//   with the following modification; you may not use this file except in
+//   compliance with the Apache License and the following modification to it:
+//   Section 6. Trademarks. is deleted and replaced with:
+//
+//   6. Trademarks. This License does not grant permission to use the trade
+//      names, trademarks, service marks, or product names of the Licensor
+//      and its affiliates, except as required to comply with Section 4(c) of
+//      the License and to reproduce the content of the NOTICE file.
+//
+//   You may obtain a copy of the Apache License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the Apache License with the above modification is
+//   distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//   KIND, either express or implied. See the Apache License for the specific
+//   language governing permissions and limitations under the Apache License.
+//
+
+#include <cstdio>
+#include <vector>
+
+#include <far/patchTableFactory.h>
+#include <far/ptexIndices.h>
+
+#include "../../regression/common/far_utils.h"
+
+#include "init_shapes.h"
+
+//
+// Regression testing of the adaptive refinement of a region of base faces :
+// the patches built for the region must be those of the full refinement.
+//
+// Local edits of a shape (a face made a hole) are also tested : the patches
+// of the base faces outside of those returned by GetAffectedBaseFaces() must
+// be unchanged, and refining the affected faces only must regenerate theirs.
+//
+// Notes:
+// - patches are compared by type and PatchParam -- the control vertices of
+//   tables built from different refiners are numbered differently
+//
+// - only shapes of the Catmark scheme are tested (adaptive refinement), the
+//   high valence poles being left out to keep the test short
+//
+
+using namespace OpenSubdiv;
+
+typedef std::vector<std::vector<unsigned int> > FacePatches;
+
+//------------------------------------------------------------------------------
+static Far::TopologyRefiner *
+createRefiner(Shape const & shape) {
+
+    return Far::TopologyRefinerFactory<Shape>::Create(shape,
+        Far::TopologyRefinerFactory<Shape>::Options(
+            GetSdcType(shape), GetSdcOptions(shape)));
+}
+
+//  Patches of each base face, i.e. the type and PatchParam of each patch with
+//  its ptex face given relative to the first of the base face:
+static void
+getFacePatches(Far::TopologyRefiner const & refiner,
+               Far::ConstIndexArray faces, int maxlevel,
+               FacePatches & facePatches) {
+
+    Far::PatchTableFactory::Options options(maxlevel);
+    options.SetEndCapType(Far::PatchTableFactory::Options::ENDCAP_GREGORY_BASIS);
+
+    Far::PatchTable const * patchTable =
+        Far::PatchTableFactory::Create(refiner, options, faces);
+
+    Far::TopologyLevel const & baseLevel = refiner.GetLevel(0);
+    Far::PtexIndices ptexIndices(refiner);
+
+    std::vector<Far::Index> ptexFaces(ptexIndices.GetNumFaces());
+    for (int face = 0; face < baseLevel.GetNumFaces(); ++face) {
+        int numVerts = baseLevel.GetFaceVertices(face).size(),
+            numPtexFaces = (numVerts == 4) ? 1 : numVerts;
+        for (int i = 0; i < numPtexFaces; ++i) {
+            ptexFaces[ptexIndices.GetFaceId(face) + i] = face;
+        }
+    }
+
+    facePatches.assign(baseLevel.GetNumFaces(), std::vector<unsigned int>());
+    for (int array = 0; array < patchTable->GetNumPatchArrays(); ++array) {
+        unsigned int type = patchTable->GetPatchArrayDescriptor(array).GetType();
+        for (int patch = 0; patch < patchTable->GetNumPatches(array); ++patch) {
+            Far::PatchParam param = patchTable->GetPatchParam(array, patch);
+
+            Far::Index face = ptexFaces[param.GetFaceId()];
+
+            std::vector<unsigned int> & patches = facePatches[face];
+            patches.push_back(type);
+            patches.push_back(param.GetFaceId() - ptexIndices.GetFaceId(face));
+            patches.push_back(param.GetTransition());
+            patches.push_back(param.field1);
+        }
+    }
+    delete patchTable;
+}
+
+//------------------------------------------------------------------------------
+//  Patches of the region built from the refinement of the region only must be
+//  those of the full refinement:
+static char const *
+checkRegion(Shape const & shape, std::vector<Far::Index> const & region,
+            int maxlevel) {
+
+    Far::TopologyRefiner * refiner = createRefiner(shape);
+    refiner->RefineAdaptive(Far::TopologyRefiner::AdaptiveOptions(maxlevel));
+
+    FacePatches patches;
+    getFacePatches(*refiner, Far::ConstIndexArray(), maxlevel, patches);
+    delete refiner;
+
+    Far::ConstIndexArray faces(&region[0], (int)region.size());
+
+    Far::TopologyRefiner * regionRefiner = createRefiner(shape);
+    regionRefiner->RefineAdaptive(
+        Far::TopologyRefiner::AdaptiveOptions(maxlevel), faces);
+
+    FacePatches regionPatches;
+    getFacePatches(*regionRefiner, faces, maxlevel, regionPatches);
+    delete regionRefiner;
+
+    std::vector<bool> inRegion(patches.size(), false);
+    for (int i = 0; i < (int)region.size(); ++i) {
+        inRegion[region[i]] = true;
+    }
+    for (int face = 0; face < (int)patches.size(); ++face) {
+        if (inRegion[face] ? (regionPatches[face] != patches[face])
+                           : !regionPatches[face].empty()) {
+            return "region patches mismatch";
+        }
+    }
+    return 0;
+}
+
+//------------------------------------------------------------------------------
+//  After an edit of a face (made a hole), the patches of the faces outside of
+//  the affected ones must be unchanged, and refining the affected faces only
+//  must regenerate their patches:
+static char const *
+checkEdit(Shape const & shape, Shape & editedShape, Far::Index editedFace,
+          int maxlevel) {
+
+    //  Affected faces are gathered before the edit:
+    Far::TopologyRefiner * refiner = createRefiner(shape);
+
+    std::vector<Far::Index> affectedFaces;
+    refiner->GetAffectedBaseFaces(Far::ConstIndexArray(&editedFace, 1), affectedFaces);
+
+    refiner->RefineAdaptive(Far::TopologyRefiner::AdaptiveOptions(maxlevel));
+
+    FacePatches patches;
+    getFacePatches(*refiner, Far::ConstIndexArray(), maxlevel, patches);
+    delete refiner;
+
+    //  Make the face a hole:
+    Shape::tag * hole = new Shape::tag;
+    hole->name = "hole";
+    hole->intargs.push_back(editedFace);
+    editedShape.tags.push_back(hole);
+
+    Far::TopologyRefiner * editedRefiner = createRefiner(editedShape);
+    editedRefiner->RefineAdaptive(Far::TopologyRefiner::AdaptiveOptions(maxlevel));
+
+    FacePatches editedPatches;
+    getFacePatches(*editedRefiner, Far::ConstIndexArray(), maxlevel, editedPatches);
+    delete editedRefiner;
+
+    //  Only the refinement of the affected faces of the edited shape:
+    Far::ConstIndexArray affected(&affectedFaces[0], (int)affectedFaces.size());
+
+    Far::TopologyRefiner * regionRefiner = createRefiner(editedShape);
+    regionRefiner->RefineAdaptive(
+        Far::TopologyRefiner::AdaptiveOptions(maxlevel), affected);
+
+    FacePatches regionPatches;
+    getFacePatches(*regionRefiner, affected, maxlevel, regionPatches);
+    delete regionRefiner;
+
+    editedShape.tags.pop_back();
+    delete hole;
+
+    std::vector<bool> isAffected(patches.size(), false);
+    for (int i = 0; i < (int)affectedFaces.size(); ++i) {
+        isAffected[affectedFaces[i]] = true;
+    }
+    for (int face = 0; face < (int)patches.size(); ++face) {
+        if (isAffected[face]) {
+            if (regionPatches[face] != editedPatches[face]) {
+                return "affected face patches not regenerated";
+            }
+        } else if (patches[face] != editedPatches[face]) {
+            return "patches changed outside of the affected faces";
+        }
+    }
+    return 0;
+}
+
+//------------------------------------------------------------------------------
+static int
+checkShape(ShapeDesc const & desc, int maxlevel) {
+
+    static char const * schemes[] = { "Bilinear", "Catmark", "Loop" };
+    printf("- %-25s ( %-8s ): \n", desc.name.c_str(), schemes[desc.scheme]);
+
+    Shape * shape = Shape::parseObj(desc.data.c_str(), desc.scheme,
+                                    desc.isLeftHanded);
+
+    //  Regions of a single face, of the first quarter of the faces and of
+    //  every other face:
+    int numFaces = shape->GetNumFaces();
+
+    std::vector<std::vector<Far::Index> > regions(3);
+    regions[0].push_back(numFaces / 2);
+    for (int face = 0; face < numFaces; ++face) {
+        if (face < (numFaces + 3) / 4) regions[1].push_back(face);
+        if ((face & 1) == 0) regions[2].push_back(face);
+    }
+
+    char const * error = 0;
+    for (int i = 0; !error && (i < (int)regions.size()); ++i) {
+        error = checkRegion(*shape, regions[i], maxlevel);
+    }
+
+    //  Edits of the first face and of one in the middle of the shape:
+    Shape * editedShape = Shape::parseObj(desc.data.c_str(), desc.scheme,
+                                          desc.isLeftHanded);
+
+    Far::Index editedFaces[] = { 0, numFaces / 2 };
+    for (int i = 0; !error && (i < 2); ++i) {
+        error = checkEdit(*shape, *editedShape, editedFaces[i], maxlevel);
+    }
+
+    delete editedShape;
+    delete shape;
+
+    if (error) {
+        printf("  %s\n", error);
+        return 1;
+    }
+    printf("  success !\n");
+    return 0;
+}
+
+//------------------------------------------------------------------------------
+int main(int /* argc */, char ** /* argv */) {
+
+    int levels=3, total=0;
+
+    initShapes();
+
+    for (int i=0; i<(int)g_shapes.size(); ++i) {
+        total+=checkShape(g_shapes[i], levels);
+    }
+
+    if (total==0)
+      printf("All tests passed.\n");
+    else
+      printf("Total failures : %d\n", total);
+
+    return total ? 1 : 0;
+}
+
+//------------------------------------------------------------------------------
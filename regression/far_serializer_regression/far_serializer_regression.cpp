@@ -0,0 +1,371 @@
+//
+//   Copyright 2015 Pixar
+//
+//   Licensed under the Apache License, Version 2.0 (the "Apache License")
+//   with the following modification; you may not use this file except in
+//   compliance with the Apache License and the following modification to it:
+//   Section 6. Trademarks. is deleted and replaced with:
+//
+//   6. Trademarks. This License does not grant permission to use the trade
+//      names, trademarks, service marks, or product names of the Licensor
+//      and its affiliates, except as required to comply with Section 4(c) of
+//      the License and to reproduce the content of the NOTICE file.
+//
+//   You may obtain a copy of the Apache License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the Apache License with the above modification is
+//   distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//   KIND, either express or implied. See the Apache License for the specific
+//   language governing permissions and limitations under the Apache License.
+//
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <sstream>
+#include <vector>
+
+#include <far/error.h>
+#include <far/patchTableFactory.h>
+#include <far/ptexIndices.h>
+#include <far/stencilTableFactory.h>
+#include <far/stencilTableView.h>
+#include <far/tableSerializer.h>
+
+#include "../../regression/common/far_cmp_utils.h"
+#include "../../regression/common/far_utils.h"
+
+#include "init_shapes.h"
+
+//
+// Regression testing of Far::TableSerializer : the stencil, limit stencil and
+// patch tables of each shape are written to and read back from a memory
+// buffer, and must match the original tables. Truncated or corrupted buffers
+// must be rejected.
+//
+// Notes:
+// - only shapes of the Catmark scheme are tested (adaptive refinement), the
+//   high valence poles being left out to keep the test short
+//
+
+using namespace OpenSubdiv;
+
+//------------------------------------------------------------------------------
+template <typename T>
+static bool
+sameArrays(std::vector<T> const & a, Vtr::ConstArray<T> b) {
+
+    return ((int)a.size() == b.size()) && std::equal(a.begin(), a.end(), b.begin());
+}
+
+//  The failures expected below are reported through Far::Error():
+static void
+ignoreError(Far::ErrorType, char const *) { }
+
+template <class TABLE>
+static void
+writeBuffer(TABLE const & table, std::vector<char> & buffer) {
+
+    std::stringstream stream;
+    Far::TableSerializer::Write(stream, table);
+    Far::TableSerializer::ReadStream(stream, buffer);
+}
+
+//  Returns a copy of the buffer with the first occurrence of an array of
+//  indices replaced by invalid ones:
+static std::vector<char>
+corrupt(std::vector<char> const & buffer, std::vector<Far::Index> const & indices) {
+
+    std::vector<char> corrupted(buffer);
+    if (! indices.empty()) {
+        char const * first = (char const *)&indices[0];
+        std::vector<char>::iterator it = std::search(corrupted.begin(),
+            corrupted.end(), first, first + indices.size() * sizeof(Far::Index));
+        if (it != corrupted.end()) {
+            std::vector<Far::Index> invalid(indices.size(), -2);
+            memcpy(&*it, &invalid[0], invalid.size() * sizeof(Far::Index));
+        }
+    }
+    return corrupted;
+}
+
+//  Returns a copy of the buffer with a word of one of its arrays replaced --
+//  arrays follow the header in sequence, each preceded by its own header and
+//  padded to the alignment:
+static std::vector<char>
+corrupt(std::vector<char> const & buffer, int arrayIndex, int element, int value) {
+
+    size_t const headerSize = 32,
+                 arrayHeaderSize = 16,
+                 alignment = Far::TableSerializer::ALIGNMENT;
+
+    size_t offset = headerSize;
+    for (int i = 0; i < arrayIndex; ++i) {
+        unsigned int arrayHeader[2];
+        memcpy(arrayHeader, &buffer[offset], sizeof(arrayHeader));
+        size_t arraySize = arrayHeader[0] * arrayHeader[1];
+        offset += arrayHeaderSize + (arraySize + alignment - 1) / alignment * alignment;
+    }
+    offset += arrayHeaderSize + element * sizeof(int);
+
+    std::vector<char> corrupted(buffer);
+    memcpy(&corrupted[offset], &value, sizeof(int));
+    return corrupted;
+}
+
+//------------------------------------------------------------------------------
+static char const *
+checkStencilTable(Far::TopologyRefiner const & refiner,
+                  Far::StencilTable const * table) {
+
+    std::vector<char> buffer;
+    writeBuffer(*table, buffer);
+
+    Far::StencilTable const * stencils =
+        Far::TableSerializer::ReadStencilTable(&buffer[0], buffer.size());
+    bool same = stencils && SameStencils(table, stencils);
+    delete stencils;
+    if (! same) {
+        return "stencil table round trip mismatch";
+    }
+
+    //  The view references the arrays in place and requires the buffer
+    //  to be aligned:
+    std::vector<double> aligned(buffer.size() / sizeof(double) + 1);
+    memcpy(&aligned[0], &buffer[0], buffer.size());
+
+    Far::StencilTableView view;
+    if (!Far::TableSerializer::ReadStencilTableView(
+            &aligned[0], buffer.size(), view) ||
+        (view.GetNumControlVertices() != table->GetNumControlVertices()) ||
+        !sameArrays(table->GetSizes(), view.GetSizes()) ||
+        !sameArrays(table->GetOffsets(), view.GetOffsets()) ||
+        !sameArrays(table->GetControlIndices(), view.GetControlIndices()) ||
+        !sameArrays(table->GetWeights(), view.GetWeights())) {
+        return "stencil table view mismatch";
+    }
+
+    //  Double precision tables are serialized separately:
+    Far::StencilTableReal<double> const * doubleTable =
+        Far::StencilTableFactoryReal<double>::Create(refiner);
+
+    std::vector<char> doubleBuffer;
+    writeBuffer(*doubleTable, doubleBuffer);
+
+    Far::StencilTableReal<double> const * doubleStencils =
+        Far::TableSerializer::ReadStencilTableReal<double>(
+            &doubleBuffer[0], doubleBuffer.size());
+
+    same = doubleStencils &&
+        (doubleStencils->GetSizes() == doubleTable->GetSizes()) &&
+        (doubleStencils->GetControlIndices() == doubleTable->GetControlIndices()) &&
+        (doubleStencils->GetWeights() == doubleTable->GetWeights()) &&
+        (Far::TableSerializer::ReadStencilTable(
+            &doubleBuffer[0], doubleBuffer.size()) == 0);
+    delete doubleStencils;
+    delete doubleTable;
+    if (! same) {
+        return "double stencil table round trip mismatch";
+    }
+
+    //  Truncated and corrupted buffers:
+    size_t truncatedSizes[] = { 0, 16, buffer.size() / 2,
+                                buffer.size() - Far::TableSerializer::ALIGNMENT };
+    for (int i = 0; i < 4; ++i) {
+        if (Far::TableSerializer::ReadStencilTable(&buffer[0], truncatedSizes[i])) {
+            return "truncated stencil table accepted";
+        }
+    }
+    //  (there is nothing to corrupt when the shape needs no refinement)
+    if (! table->GetControlIndices().empty()) {
+        std::vector<char> corrupted = corrupt(buffer, table->GetControlIndices());
+        if (Far::TableSerializer::ReadStencilTable(&corrupted[0], corrupted.size()) ||
+            Far::TableSerializer::ReadStencilTableView(&corrupted[0], corrupted.size(), view)) {
+            return "corrupted stencil table accepted";
+        }
+    }
+    return 0;
+}
+
+//
+//  Limit stencils are generated at a grid of locations on each ptex face:
+//
+static char const *
+checkLimitStencilTable(Far::TopologyRefiner const & refiner, int gridSize) {
+
+    std::vector<float> s, t;
+    for (int i = 0; i < gridSize * gridSize; ++i) {
+        s.push_back((float)(i % gridSize + 0.5f) / gridSize);
+        t.push_back((float)(i / gridSize + 0.5f) / gridSize);
+    }
+
+    int numPtexFaces = Far::PtexIndices(refiner).GetNumFaces();
+    Far::LimitStencilTableFactory::LocationArrayVec locations(numPtexFaces);
+    for (int i = 0; i < numPtexFaces; ++i) {
+        locations[i].ptexIdx = i;
+        locations[i].numLocations = (int)s.size();
+        locations[i].s = &s[0];
+        locations[i].t = &t[0];
+    }
+
+    Far::LimitStencilTable const * table =
+        Far::LimitStencilTableFactory::Create(refiner, locations);
+    if (table == 0) {
+        return "failed to create limit stencils";
+    }
+
+    std::vector<char> buffer;
+    writeBuffer(*table, buffer);
+
+    Far::LimitStencilTable const * stencils =
+        Far::TableSerializer::ReadLimitStencilTable(&buffer[0], buffer.size());
+
+    bool same = stencils && SameLimitStencils(table, stencils) &&
+        (Far::TableSerializer::GetTableType(&buffer[0], buffer.size()) ==
+            Far::TableSerializer::TABLE_LIMIT_STENCIL) &&
+        (Far::TableSerializer::ReadStencilTable(&buffer[0], buffer.size()) == 0) &&
+        (Far::TableSerializer::ReadLimitStencilTable(&buffer[0],
+            buffer.size() - Far::TableSerializer::ALIGNMENT) == 0);
+    delete stencils;
+    delete table;
+
+    return same ? 0 : "limit stencil table round trip mismatch";
+}
+
+static char const *
+checkPatchTable(Far::PatchTable const * table) {
+
+    std::vector<char> buffer;
+    writeBuffer(*table, buffer);
+
+    Far::PatchTable const * patchTable =
+        Far::TableSerializer::ReadPatchTable(&buffer[0], buffer.size());
+
+    bool same = patchTable && SamePatchTables(table, patchTable) &&
+        (patchTable->GetNumPatchArrays() == table->GetNumPatchArrays()) &&
+        (patchTable->GetNumPtexFaces() == table->GetNumPtexFaces()) &&
+        (patchTable->GetMaxValence() == table->GetMaxValence()) &&
+        SameArrays(patchTable->GetVaryingVertices(), table->GetVaryingVertices());
+    for (int i = 0; same && (i < table->GetNumPatchArrays()); ++i) {
+        same = (patchTable->GetPatchArrayDescriptor(i) ==
+                table->GetPatchArrayDescriptor(i)) &&
+               (patchTable->GetNumPatches(i) == table->GetNumPatches(i));
+    }
+    delete patchTable;
+    if (! same) {
+        return "patch table round trip mismatch";
+    }
+
+    std::vector<char> corrupted =
+        corrupt(buffer, table->GetPatchControlVerticesTable());
+    if (Far::TableSerializer::ReadPatchTable(&buffer[0],
+            buffer.size() - Far::TableSerializer::ALIGNMENT) ||
+        Far::TableSerializer::ReadPatchTable(&corrupted[0], corrupted.size())) {
+        return "truncated or corrupted patch table accepted";
+    }
+
+    //  Descriptors of patches without control vertices, in the scalars (the
+    //  varying descriptor), the patch arrays and each face-varying channel:
+    int const invalidTypes[] = { Far::PatchDescriptor::NON_PATCH,
+                                 Far::PatchDescriptor::LOOP, -1 };
+    for (int i = 0; i < 3; ++i) {
+        std::vector<std::vector<char> > corruptedDescriptors;
+        corruptedDescriptors.push_back(corrupt(buffer, 0, 2, invalidTypes[i]));
+        if (table->GetNumPatchArrays() > 0) {
+            corruptedDescriptors.push_back(corrupt(buffer, 1, 0, invalidTypes[i]));
+        }
+        for (int channel = 0; channel < table->GetNumFVarChannels(); ++channel) {
+            corruptedDescriptors.push_back(
+                corrupt(buffer, 9 + 3 * channel, 1, invalidTypes[i]));
+        }
+        for (int j = 0; j < (int)corruptedDescriptors.size(); ++j) {
+            std::vector<char> const & corruptedDescriptor = corruptedDescriptors[j];
+            if (Far::TableSerializer::ReadPatchTable(
+                    &corruptedDescriptor[0], corruptedDescriptor.size())) {
+                return "corrupted patch descriptor accepted";
+            }
+        }
+    }
+    return 0;
+}
+
+//------------------------------------------------------------------------------
+static int
+checkShape(Shape const & shape, std::string const & name, int maxlevel) {
+
+    static char const * schemes[] = { "Bilinear", "Catmark", "Loop" };
+    printf("- %-25s ( %-8s ): \n", name.c_str(), schemes[shape.scheme]);
+
+    Far::TopologyRefiner * refiner =
+        Far::TopologyRefinerFactory<Shape>::Create(shape,
+            Far::TopologyRefinerFactory<Shape>::Options(
+                GetSdcType(shape), GetSdcOptions(shape)));
+
+    refiner->RefineAdaptive(Far::TopologyRefiner::AdaptiveOptions(maxlevel));
+
+    Far::PatchTableFactory::Options options(maxlevel);
+    options.SetEndCapType(Far::PatchTableFactory::Options::ENDCAP_GREGORY_BASIS);
+    options.generateFVarTables = true;
+
+    Far::PatchTable const * patchTable =
+        Far::PatchTableFactory::Create(*refiner, options);
+
+    //  Stencils of the refined and local points:
+    Far::StencilTable const * stencils = Far::StencilTableFactory::Create(*refiner);
+    if (Far::StencilTable const * localPointStencils =
+        patchTable->GetLocalPointStencilTable()) {
+        Far::StencilTable const * stencilsWithLocalPoints =
+            Far::StencilTableFactory::AppendLocalPointStencilTable(
+                *refiner, stencils, localPointStencils);
+        delete stencils;
+        stencils = stencilsWithLocalPoints;
+    }
+
+    Far::SetErrorCallback(ignoreError);
+    char const * error = checkStencilTable(*refiner, stencils);
+    if (! error) error = checkLimitStencilTable(*refiner, 3);
+    if (! error) error = checkPatchTable(patchTable);
+    Far::SetErrorCallback(0);
+
+    delete stencils;
+    delete patchTable;
+    delete refiner;
+
+    if (error) {
+        printf("  %s\n", error);
+        return 1;
+    }
+    printf("  success !\n");
+    return 0;
+}
+
+//------------------------------------------------------------------------------
+int main(int /* argc */, char ** /* argv */) {
+
+    int levels=2, total=0;
+
+    initShapes();
+
+    for (int i=0; i<(int)g_shapes.size(); ++i) {
+        ShapeDesc const & desc = g_shapes[i];
+
+        Shape * shape = Shape::parseObj(desc.data.c_str(), desc.scheme,
+            desc.isLeftHanded);
+        if (shape) {
+            total+=checkShape(*shape, desc.name, levels);
+        }
+        delete shape;
+    }
+
+    if (total==0)
+      printf("All tests passed.\n");
+    else
+      printf("Total failures : %d\n", total);
+
+    return total ? 1 : 0;
+}
+
+//------------------------------------------------------------------------------
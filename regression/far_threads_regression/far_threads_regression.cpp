@@ -0,0 +1,332 @@
+//
+//   Copyright 2015 Pixar
+//
+//   Licensed under the Apache License, Version 2.0 (the "Apache License")
+//   with the following modification; you may not use this file except in
+//   compliance with the Apache License and the following modification to it:
+//   Section 6. Trademarks. is deleted and replaced with:
+//
+//   6. Trademarks. This License does not grant permission to use the trade
+//      names, trademarks, service marks, or product names of the Licensor
+//      and its affiliates, except as required to comply with Section 4(c) of
+//      the License and to reproduce the content of the NOTICE file.
+//
+//   You may obtain a copy of the Apache License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the Apache License with the above modification is
+//   distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//   KIND, either express or implied. See the Apache License for the specific
+//   language governing permissions and limitations under the Apache License.
+//
+
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#include <far/patchTableFactory.h>
+#include <far/primvarRefiner.h>
+#include <far/ptexIndices.h>
+#include <far/stencilTableFactory.h>
+
+#include "../../regression/common/far_cmp_utils.h"
+#include "../../regression/common/far_utils.h"
+
+#include "init_shapes.h"
+
+//
+// Regression testing matching the Far topology and tables built with multiple
+// threads to those built serially, including the uniform and adaptive
+// refinement of the topology.
+//
+// Notes:
+// - the threaded results are expected to be bitwise identical
+//
+// - adaptive refinement and the patch and limit stencil tables are only
+//   tested with the Catmark scheme
+//
+// - the high valence poles are left out to keep the test short
+//
+
+using namespace OpenSubdiv;
+
+//------------------------------------------------------------------------------
+static Far::TopologyRefiner *
+createRefiner(Shape const & shape, bool useMultipleThreads) {
+
+    Far::TopologyRefinerFactory<Shape>::Options options(
+        GetSdcType(shape), GetSdcOptions(shape));
+    options.useMultipleThreads = useMultipleThreads;
+
+    return Far::TopologyRefinerFactory<Shape>::Create(shape, options);
+}
+
+static void
+refine(Far::TopologyRefiner & refiner, int maxlevel, bool adaptive,
+       bool useMultipleThreads) {
+
+    if (adaptive) {
+        Far::TopologyRefiner::AdaptiveOptions options(maxlevel);
+        options.useMultipleThreads = useMultipleThreads;
+        refiner.RefineAdaptive(options);
+    } else {
+        //  (the last level is complete so that all of it can be compared)
+        Far::TopologyRefiner::UniformOptions options(maxlevel);
+        options.fullTopologyInLastLevel = true;
+        options.useMultipleThreads = useMultipleThreads;
+        refiner.RefineUniform(options);
+    }
+}
+
+//  Refines the shape serially and with multiple threads:
+static bool
+checkRefinement(Shape const & shape, int maxlevel, bool adaptive) {
+
+    Far::TopologyRefiner * serial = createRefiner(shape, false),
+                         * threaded = createRefiner(shape, false);
+
+    refine(*serial, maxlevel, adaptive, false);
+    refine(*threaded, maxlevel, adaptive, true);
+
+    bool same = SameRefiners(serial, threaded);
+
+    delete threaded;
+    delete serial;
+    return same;
+}
+
+//------------------------------------------------------------------------------
+struct Vertex {
+    void Clear() { p[0] = p[1] = p[2] = 0.0f; }
+    void AddWithWeight(Vertex const & src, float weight) {
+        p[0] += weight * src.p[0];
+        p[1] += weight * src.p[1];
+        p[2] += weight * src.p[2];
+    }
+    float p[3];
+};
+
+enum InterpolationMode { SERIAL, THREADED, RAW };
+
+static void
+interpolateVertices(Far::TopologyRefiner const & refiner, Shape const & shape,
+                    InterpolationMode mode, std::vector<Vertex> & vertices) {
+
+    vertices.resize(refiner.GetNumVerticesTotal());
+    memcpy(&vertices[0], &shape.verts[0],
+        refiner.GetLevel(0).GetNumVertices() * sizeof(Vertex));
+
+    Far::PrimvarRefiner::Options options;
+    options.useMultipleThreads = (mode == THREADED);
+
+    Far::PrimvarRefiner primvarRefiner(refiner, options);
+
+    Far::PrimvarRefiner::BufferDescriptor desc(0, 3, 3);
+
+    Vertex * src = &vertices[0];
+    for (int level = 1; level <= refiner.GetMaxLevel(); ++level) {
+        Vertex * dst = src + refiner.GetLevel(level-1).GetNumVertices();
+        if (mode == RAW) {
+            primvarRefiner.Interpolate(level, src->p, desc, dst->p, desc);
+        } else {
+            primvarRefiner.Interpolate(level, src, dst);
+        }
+        src = dst;
+    }
+}
+
+static bool
+checkPrimvars(Far::TopologyRefiner const & refiner, Shape const & shape) {
+
+    std::vector<Vertex> serial, threaded, raw;
+    interpolateVertices(refiner, shape, SERIAL, serial);
+    interpolateVertices(refiner, shape, THREADED, threaded);
+    interpolateVertices(refiner, shape, RAW, raw);
+
+    return (memcmp(&serial[0], &threaded[0], serial.size() * sizeof(Vertex)) == 0) &&
+           (memcmp(&serial[0], &raw[0], serial.size() * sizeof(Vertex)) == 0);
+}
+
+//------------------------------------------------------------------------------
+static bool
+checkStencils(Far::TopologyRefiner const & refiner) {
+
+    Far::StencilTableFactory::Options options;
+    Far::StencilTable const * serial =
+        Far::StencilTableFactory::Create(refiner, options);
+
+    options.useMultipleThreads = true;
+    Far::StencilTable const * threaded =
+        Far::StencilTableFactory::Create(refiner, options);
+
+    bool same = SameStencils(serial, threaded);
+
+    delete threaded;
+    delete serial;
+    return same;
+}
+
+static bool
+checkPatches(Far::TopologyRefiner const & refiner, int maxlevel,
+             Far::PatchTable const ** patchTable) {
+
+    Far::PatchTableFactory::Options options(maxlevel);
+    options.SetEndCapType(Far::PatchTableFactory::Options::ENDCAP_GREGORY_BASIS);
+
+    Far::PatchTable const * serial =
+        Far::PatchTableFactory::Create(refiner, options);
+
+    options.useMultipleThreads = true;
+    Far::PatchTable const * threaded =
+        Far::PatchTableFactory::Create(refiner, options);
+
+    bool same = SamePatchTables(serial, threaded);
+
+    delete threaded;
+    *patchTable = serial;
+    return same;
+}
+
+//
+//  Limit stencils are generated at a grid of locations on each ptex face:
+//
+static bool
+checkLimitStencils(Far::TopologyRefiner const & refiner,
+                   Far::PatchTable const * patchTable, int gridSize) {
+
+    //  Stencils for the control vertices as expected by the factory :
+    //  including the coarse and local points
+    Far::StencilTableFactory::Options options;
+    options.generateControlVerts = true;
+    options.generateOffsets = true;
+    Far::StencilTable const * cvStencils =
+        Far::StencilTableFactory::Create(refiner, options);
+
+    if (Far::StencilTable const * localPointStencils =
+        patchTable->GetLocalPointStencilTable()) {
+        Far::StencilTable const * stencils =
+            Far::StencilTableFactory::AppendLocalPointStencilTable(
+                refiner, cvStencils, localPointStencils);
+        delete cvStencils;
+        cvStencils = stencils;
+    }
+
+    std::vector<float> s, t;
+    for (int i = 0; i < gridSize * gridSize; ++i) {
+        s.push_back((float)(i % gridSize + 0.5f) / gridSize);
+        t.push_back((float)(i / gridSize + 0.5f) / gridSize);
+    }
+
+    int numPtexFaces = Far::PtexIndices(refiner).GetNumFaces();
+    Far::LimitStencilTableFactory::LocationArrayVec locations(numPtexFaces);
+    for (int i = 0; i < numPtexFaces; ++i) {
+        locations[i].ptexIdx = i;
+        locations[i].numLocations = (int)s.size();
+        locations[i].s = &s[0];
+        locations[i].t = &t[0];
+    }
+
+    Far::LimitStencilTableFactory::Options limitOptions;
+    Far::LimitStencilTable const * serial =
+        Far::LimitStencilTableFactory::Create(refiner, locations,
+            cvStencils, patchTable, limitOptions);
+
+    limitOptions.useMultipleThreads = true;
+    Far::LimitStencilTable const * threaded =
+        Far::LimitStencilTableFactory::Create(refiner, locations,
+            cvStencils, patchTable, limitOptions);
+
+    bool same = serial && threaded && SameLimitStencils(serial, threaded);
+
+    delete threaded;
+    delete serial;
+    delete cvStencils;
+    return same;
+}
+
+//------------------------------------------------------------------------------
+static int
+checkShape(Shape const & shape, std::string const & name, int maxlevel) {
+
+    static char const * schemes[] = { "Bilinear", "Catmark", "Loop" };
+    printf("- %-25s ( %-8s ): \n", name.c_str(), schemes[shape.scheme]);
+
+    int failureCount = 0;
+
+    Far::TopologyRefiner * refiner = createRefiner(shape, false),
+                         * threadedRefiner = createRefiner(shape, true);
+
+    if (! SameRefiners(refiner, threadedRefiner)) {
+        printf("  threaded base level mismatch\n");
+        ++failureCount;
+    }
+    delete threadedRefiner;
+
+    bool adaptive = (shape.scheme == kCatmark);
+    if (! checkRefinement(shape, maxlevel, false)) {
+        printf("  threaded uniform refinement mismatch\n");
+        ++failureCount;
+    }
+    if (adaptive && ! checkRefinement(shape, maxlevel, true)) {
+        printf("  threaded adaptive refinement mismatch\n");
+        ++failureCount;
+    }
+    refine(*refiner, maxlevel, adaptive, false);
+
+    if (! checkPrimvars(*refiner, shape)) {
+        printf("  threaded primvars mismatch\n");
+        ++failureCount;
+    }
+    if (! checkStencils(*refiner)) {
+        printf("  threaded stencils mismatch\n");
+        ++failureCount;
+    }
+    if (adaptive) {
+        Far::PatchTable const * patchTable = 0;
+        if (! checkPatches(*refiner, maxlevel, &patchTable)) {
+            printf("  threaded patch table mismatch\n");
+            ++failureCount;
+        }
+        if (! checkLimitStencils(*refiner, patchTable, 4)) {
+            printf("  threaded limit stencils mismatch\n");
+            ++failureCount;
+        }
+        delete patchTable;
+    }
+    delete refiner;
+
+    if (failureCount == 0) {
+        printf("  success !\n");
+    }
+    return failureCount;
+}
+
+//------------------------------------------------------------------------------
+int main(int /* argc */, char ** /* argv */) {
+
+    int levels=3, total=0;
+
+    initShapes();
+
+    for (int i=0; i<(int)g_shapes.size(); ++i) {
+        ShapeDesc const & desc = g_shapes[i];
+
+        Shape * shape = Shape::parseObj(desc.data.c_str(), desc.scheme,
+            desc.isLeftHanded);
+        if (shape) {
+            total+=checkShape(*shape, desc.name, levels);
+        }
+        delete shape;
+    }
+
+    if (total==0)
+      printf("All tests passed.\n");
+    else
+      printf("Total failures : %d\n", total);
+
+    return total ? 1 : 0;
+}
+
+//------------------------------------------------------------------------------
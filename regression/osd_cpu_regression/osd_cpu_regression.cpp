@@ -0,0 +1,546 @@
+//
+//   Copyright 2015 Pixar
+//
+//   Licensed under the Apache License, Version 2.0 (the "Apache License")
+//   with the following modification; you may not use this file except in
+//   compliance with the Apache License and the following modification to it:
+//   Section 6. Trademarks. is deleted and replaced with:
+//
+//   6. Trademarks. This License does not grant permission to use the trade
+//      names, trademarks, service marks, or product names of the Licensor
+//      and its affiliates, except as required to comply with Section 4(c) of
+//      the License and to reproduce the content of the NOTICE file.
+//
+//   You may obtain a copy of the Apache License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the Apache License with the above modification is
+//   distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//   KIND, either express or implied. See the Apache License for the specific
+//   language governing permissions and limitations under the Apache License.
+//
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+#include <far/compressedStencilTable.h>
+#include <far/patchMap.h>
+#include <far/patchTableFactory.h>
+#include <far/ptexIndices.h>
+#include <far/stencilDependencyTable.h>
+#include <far/stencilTableFactory.h>
+#include <far/stencilTableView.h>
+#include <osd/cpuEvaluator.h>
+#include <osd/cpuPatchTable.h>
+#include <osd/cpuVertexBuffer.h>
+#ifdef OPENSUBDIV_HAS_OPENMP
+    #include <osd/ompEvaluator.h>
+#endif
+#ifdef OPENSUBDIV_HAS_TBB
+    #include <osd/tbbEvaluator.h>
+#endif
+
+#include "../../regression/common/far_utils.h"
+
+#include "init_shapes.h"
+
+//
+// Regression testing of the CPU evaluators (Osd::CpuEvaluator and, when
+// available, Osd::OmpEvaluator and Osd::TbbEvaluator) : stencils evaluated
+// through views, compressed, reordered, partially or on several frames at
+// once, and the limit stencils and patches, are checked against a complete
+// evaluation of the stencil table with Osd::CpuEvaluator.
+//
+// Notes:
+// - only shapes of the Catmark scheme are tested (adaptive refinement), the
+//   high valence poles being left out to keep the test short
+//
+// - the evaluations using the same weights in the same order are expected to
+//   be bitwise identical, others are compared with a relative precision
+//
+#define PRECISION 1e-4f
+
+using namespace OpenSubdiv;
+
+//------------------------------------------------------------------------------
+static bool
+closeValues(float const * a, float const * b, int n, float precision) {
+
+    for (int i = 0; i < n; ++i) {
+        if (std::abs(a[i] - b[i]) > precision * std::max(1.0f, std::abs(b[i]))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+//------------------------------------------------------------------------------
+//
+//  Topology, tables and reference evaluation of a shape -- vertex data are
+//  laid out as in Osd::Mesh : control vertices followed by the refined and
+//  local points computed by the stencils:
+//
+struct EvalData {
+
+    EvalData(Shape const & shape, int maxlevel) : shape(shape) {
+
+        refiner = Far::TopologyRefinerFactory<Shape>::Create(shape,
+            Far::TopologyRefinerFactory<Shape>::Options(
+                GetSdcType(shape), GetSdcOptions(shape)));
+        refiner->RefineAdaptive(Far::TopologyRefiner::AdaptiveOptions(maxlevel));
+
+        Far::PatchTableFactory::Options options(maxlevel);
+        options.SetEndCapType(Far::PatchTableFactory::Options::ENDCAP_GREGORY_BASIS);
+        patchTable = Far::PatchTableFactory::Create(*refiner, options);
+
+        stencils = Far::StencilTableFactory::Create(*refiner);
+        if (Far::StencilTable const * localPointStencils =
+            patchTable->GetLocalPointStencilTable()) {
+            Far::StencilTable const * stencilsWithLocalPoints =
+                Far::StencilTableFactory::AppendLocalPointStencilTable(
+                    *refiner, stencils, localPointStencils);
+            delete stencils;
+            stencils = stencilsWithLocalPoints;
+        }
+
+        numControlVerts = stencils->GetNumControlVertices();
+        numVerts = numControlVerts + stencils->GetNumStencils();
+
+        srcDesc = Osd::BufferDescriptor(0, 3, 3);
+        dstDesc = Osd::BufferDescriptor(numControlVerts * 3, 3, 3);
+
+        vertexBuffer = createVertexBuffer(0.0f);
+    }
+
+    ~EvalData() {
+        delete vertexBuffer;
+        delete stencils;
+        delete patchTable;
+        delete refiner;
+    }
+
+    //  Returns a buffer of the control vertices, offset vertically, and of
+    //  the points computed from them:
+    Osd::CpuVertexBuffer * createVertexBuffer(float offset) const {
+
+        Osd::CpuVertexBuffer * buffer = Osd::CpuVertexBuffer::Create(3, numVerts);
+
+        float * positions = buffer->BindCpuBuffer();
+        std::copy(shape.verts.begin(),
+                  shape.verts.begin() + 3 * numControlVerts, positions);
+        for (int i = 0; i < numControlVerts; ++i) {
+            positions[3 * i + 1] += offset;
+        }
+        Osd::CpuEvaluator::EvalStencils(buffer, srcDesc, buffer, dstDesc, stencils);
+        return buffer;
+    }
+
+    bool sameVertices(Osd::CpuVertexBuffer * buffer) const {
+        return std::equal(buffer->BindCpuBuffer(),
+                          buffer->BindCpuBuffer() + 3 * numVerts,
+                          vertexBuffer->BindCpuBuffer());
+    }
+
+    Shape const &             shape;
+    Far::TopologyRefiner *    refiner;
+    Far::PatchTable const *   patchTable;
+    Far::StencilTable const * stencils;
+
+    int numControlVerts,
+        numVerts;
+
+    Osd::BufferDescriptor     srcDesc,
+                              dstDesc;
+    Osd::CpuVertexBuffer *    vertexBuffer;
+};
+
+//------------------------------------------------------------------------------
+//  Stencils are evaluated through a view of the arrays of the table (see
+//  Far::StencilTableView):
+template <class EVALUATOR>
+static bool
+checkStencilTableView(EvalData const & data) {
+
+    Far::StencilTableView view(*data.stencils);
+
+    Osd::CpuVertexBuffer * buffer = Osd::CpuVertexBuffer::Create(3, data.numVerts);
+    buffer->UpdateData(data.vertexBuffer->BindCpuBuffer(), 0, data.numControlVerts);
+
+    EVALUATOR::EvalStencils(buffer, data.srcDesc, buffer, data.dstDesc, &view);
+
+    bool same = data.sameVertices(buffer);
+    delete buffer;
+    return same;
+}
+
+//  Stencils are compressed (see Far::CompressedStencilTable) and decoded by
+//  the evaluators, within the weight error of the compressed table:
+template <class EVALUATOR>
+static bool
+checkCompressedStencils(EvalData const & data,
+    Far::CompressedStencilTable::WeightEncoding weightEncoding) {
+
+    Far::CompressedStencilTable::Options options;
+    options.weightEncoding = weightEncoding;
+    Far::CompressedStencilTable const * compressed =
+        Far::CompressedStencilTable::Create(*data.stencils, options);
+    if ((compressed == 0) ||
+        ((weightEncoding == Far::CompressedStencilTable::WEIGHT_FLOAT) &&
+         (compressed->GetMaxWeightError() != 0.0f))) {
+        delete compressed;
+        return false;
+    }
+
+    Osd::CpuVertexBuffer * buffer = Osd::CpuVertexBuffer::Create(3, data.numVerts);
+    buffer->UpdateData(data.vertexBuffer->BindCpuBuffer(), 0, data.numControlVerts);
+
+    EVALUATOR::EvalStencils(buffer, data.srcDesc, buffer, data.dstDesc, compressed);
+
+    //  points are combinations of unit-scale control vertices, the error of
+    //  each weight adding up over the stencil
+    std::vector<int> const & sizes = data.stencils->GetSizes();
+    int maxSize = sizes.empty() ? 0 : *std::max_element(sizes.begin(), sizes.end());
+
+    float precision = std::max(PRECISION, maxSize * compressed->GetMaxWeightError());
+
+    bool same = closeValues(buffer->BindCpuBuffer(),
+        data.vertexBuffer->BindCpuBuffer(), 3 * data.numVerts, precision);
+    delete buffer;
+    delete compressed;
+    return same;
+}
+
+//  Stencils and control vertices are reordered for locality (see
+//  Far::StencilTableFactory::CreateReordered()), the results being remapped:
+template <class EVALUATOR>
+static bool
+checkReorderedStencils(EvalData const & data) {
+
+    std::vector<Far::Index> stencilPermutation, vertexPermutation;
+    Far::StencilTable const * reordered = Far::StencilTableFactory::CreateReordered(
+        *data.stencils, stencilPermutation, &vertexPermutation);
+    if (reordered == 0) {
+        return false;
+    }
+
+    Osd::CpuVertexBuffer * buffer = Osd::CpuVertexBuffer::Create(3, data.numVerts);
+
+    float const * positions = data.vertexBuffer->BindCpuBuffer();
+    float * reorderedPositions = buffer->BindCpuBuffer();
+    for (int i = 0; i < data.numControlVerts; ++i) {
+        std::copy(positions + 3 * vertexPermutation[i],
+                  positions + 3 * vertexPermutation[i] + 3,
+                  reorderedPositions + 3 * i);
+    }
+
+    EVALUATOR::EvalStencils(buffer, data.srcDesc, buffer, data.dstDesc, reordered);
+
+    float const * expected = positions + 3 * data.numControlVerts,
+                * result = reorderedPositions + 3 * data.numControlVerts;
+    bool same = true;
+    for (int i = 0; same && (i < (int)stencilPermutation.size()); ++i) {
+        same = std::equal(result + 3 * i, result + 3 * i + 3,
+                          expected + 3 * stencilPermutation[i]);
+    }
+    delete buffer;
+    delete reordered;
+    return same;
+}
+
+//  A few control vertices are moved and only the stencils they affect are
+//  re-evaluated (see Far::StencilDependencyTable):
+static bool
+checkModifiedStencils(EvalData const & data, int numModified) {
+
+    Far::StencilDependencyTable const * dependencies =
+        Far::StencilDependencyTable::Create(*data.stencils);
+    if (dependencies == 0) {
+        return false;
+    }
+
+    Osd::CpuVertexBuffer * buffer = data.createVertexBuffer(0.0f),
+                         * expected = data.createVertexBuffer(0.0f);
+
+    std::vector<Far::Index> modified;
+    for (int i = 0; i < std::min(numModified, data.numControlVerts); ++i) {
+        modified.push_back(i);
+        buffer->BindCpuBuffer()[3 * i] += 1.0f;
+        expected->BindCpuBuffer()[3 * i] += 1.0f;
+    }
+
+    Osd::CpuEvaluator::EvalModifiedStencils(buffer, data.srcDesc,
+        buffer, data.dstDesc, data.stencils,
+        dependencies, &modified[0], (int)modified.size());
+
+    Osd::CpuEvaluator::EvalStencils(expected, data.srcDesc,
+        expected, data.dstDesc, data.stencils);
+
+    bool same = std::equal(expected->BindCpuBuffer(),
+                           expected->BindCpuBuffer() + 3 * data.numVerts,
+                           buffer->BindCpuBuffer());
+    delete expected;
+    delete buffer;
+    delete dependencies;
+    return same;
+}
+
+//  The stencils are applied to several frames of animated control vertices
+//  at once:
+template <class EVALUATOR>
+static bool
+checkStencilFrames(EvalData const & data, int numFrames) {
+
+    std::vector<Osd::CpuVertexBuffer *> frames;
+    for (int frame = 0; frame < numFrames; ++frame) {
+        frames.push_back(data.createVertexBuffer(0.1f * frame));
+    }
+    std::vector<Osd::CpuVertexBuffer *> expected(frames);
+    for (int frame = 0; frame < numFrames; ++frame) {
+        expected[frame] = Osd::CpuVertexBuffer::Create(3, data.numVerts);
+        expected[frame]->UpdateData(frames[frame]->BindCpuBuffer(), 0, data.numVerts);
+
+        //  clear the refined points to be computed again
+        std::fill(frames[frame]->BindCpuBuffer() + 3 * data.numControlVerts,
+                  frames[frame]->BindCpuBuffer() + 3 * data.numVerts, 0.0f);
+    }
+
+    EVALUATOR::EvalStencilFrames(&frames[0], data.srcDesc,
+        &frames[0], data.dstDesc, numFrames, data.stencils);
+
+    bool same = true;
+    for (int frame = 0; frame < numFrames; ++frame) {
+        same = same && std::equal(frames[frame]->BindCpuBuffer(),
+            frames[frame]->BindCpuBuffer() + 3 * data.numVerts,
+            expected[frame]->BindCpuBuffer());
+        delete frames[frame];
+        delete expected[frame];
+    }
+    return same;
+}
+
+//  Limit stencils with 1st derivatives at a grid of locations on each ptex
+//  face, evaluated with all outputs together or with the normals computed
+//  from the derivatives, checked against one output at a time:
+static bool
+checkLimitStencils(EvalData const & data, int gridSize) {
+
+    std::vector<float> s, t;
+    for (int i = 0; i < gridSize * gridSize; ++i) {
+        s.push_back((float)(i % gridSize + 0.5f) / gridSize);
+        t.push_back((float)(i / gridSize + 0.5f) / gridSize);
+    }
+
+    int numPtexFaces = Far::PtexIndices(*data.refiner).GetNumFaces();
+    Far::LimitStencilTableFactory::LocationArrayVec locations(numPtexFaces);
+    for (int i = 0; i < numPtexFaces; ++i) {
+        locations[i].ptexIdx = i;
+        locations[i].numLocations = (int)s.size();
+        locations[i].s = &s[0];
+        locations[i].t = &t[0];
+    }
+    Far::LimitStencilTable const * stencils =
+        Far::LimitStencilTableFactory::Create(*data.refiner, locations);
+    if ((stencils == 0) || (stencils->GetNumStencils() == 0)) {
+        delete stencils;
+        return false;
+    }
+
+    int numStencils = stencils->GetNumStencils();
+
+    Osd::BufferDescriptor valueDesc(0, 3, 3);
+
+    //  limit stencils reference the control vertices only
+    float const * src = data.vertexBuffer->BindCpuBuffer();
+
+    std::vector<float> expected(9 * numStencils);
+    std::vector<float> const * weights[3] = { &stencils->GetWeights(),
+        &stencils->GetDuWeights(), &stencils->GetDvWeights() };
+    for (int i = 0; i < 3; ++i) {
+        Osd::CpuEvaluator::EvalStencils(src, data.srcDesc,
+            &expected[3 * i * numStencils], valueDesc,
+            &stencils->GetSizes()[0], &stencils->GetOffsets()[0],
+            &stencils->GetControlIndices()[0], &(*weights[i])[0],
+            0, numStencils);
+    }
+
+    //  the single output kernel may use FMA instructions, rounding differently
+    std::vector<float> fused(9 * numStencils);
+    Osd::CpuEvaluator::EvalStencils(src, data.srcDesc,
+        &fused[0], valueDesc,
+        &fused[3 * numStencils], valueDesc,
+        &fused[6 * numStencils], valueDesc,
+        &stencils->GetSizes()[0], &stencils->GetOffsets()[0],
+        &stencils->GetControlIndices()[0], &stencils->GetWeights()[0],
+        &stencils->GetDuWeights()[0], &stencils->GetDvWeights()[0],
+        0, numStencils);
+
+    std::vector<float> normals(6 * numStencils);
+    Osd::CpuEvaluator::EvalStencilNormals(src, data.srcDesc,
+        &normals[0], valueDesc, &normals[3 * numStencils], valueDesc,
+        &stencils->GetSizes()[0], &stencils->GetOffsets()[0],
+        &stencils->GetControlIndices()[0], &stencils->GetWeights()[0],
+        &stencils->GetDuWeights()[0], &stencils->GetDvWeights()[0],
+        0, numStencils);
+
+    delete stencils;
+
+    return closeValues(&fused[0], &expected[0], 9 * numStencils, PRECISION) &&
+           closeValues(&normals[0], &expected[0], 3 * numStencils, PRECISION);
+}
+
+//  Patch coordinates as expected by the evaluators:
+struct PatchCoordBuffer {
+    void * BindCpuBuffer() { return &coords[0]; }
+
+    std::vector<Osd::PatchCoord> coords;
+};
+
+//  Patches are evaluated at a grid of locations on each ptex face, checked
+//  against the evaluation of Osd::CpuEvaluator:
+template <class EVALUATOR>
+static bool
+checkPatches(EvalData const & data, int gridSize) {
+
+    PatchCoordBuffer patchCoords;
+
+    Far::PatchMap patchMap(*data.patchTable);
+
+    int numPtexFaces = data.patchTable->GetNumPtexFaces();
+    for (int face = 0; face < numPtexFaces; ++face) {
+        for (int i = 0; i < gridSize * gridSize; ++i) {
+            float s = (float)(i % gridSize + 0.5f) / gridSize,
+                  t = (float)(i / gridSize + 0.5f) / gridSize;
+
+            if (Far::PatchTable::PatchHandle const * handle =
+                patchMap.FindPatch(face, s, t)) {
+                patchCoords.coords.push_back(Osd::PatchCoord(*handle, s, t));
+            }
+        }
+    }
+    if (patchCoords.coords.empty()) {
+        return false;
+    }
+
+    int numCoords = (int)patchCoords.coords.size();
+
+    Osd::CpuPatchTable * patchTable = Osd::CpuPatchTable::Create(data.patchTable);
+    Osd::CpuVertexBuffer * values = Osd::CpuVertexBuffer::Create(3, numCoords),
+                         * expected = Osd::CpuVertexBuffer::Create(3, numCoords);
+    Osd::BufferDescriptor valueDesc(0, 3, 3);
+
+    EVALUATOR::EvalPatches(data.vertexBuffer, data.srcDesc,
+        values, valueDesc, numCoords, &patchCoords, patchTable);
+    Osd::CpuEvaluator::EvalPatches(data.vertexBuffer, data.srcDesc,
+        expected, valueDesc, numCoords, &patchCoords, patchTable);
+
+    bool same = closeValues(values->BindCpuBuffer(), expected->BindCpuBuffer(),
+        3 * numCoords, PRECISION);
+    delete expected;
+    delete values;
+    delete patchTable;
+    return same;
+}
+
+//------------------------------------------------------------------------------
+static int
+report(bool success, char const * evaluator, char const * check) {
+
+    if (! success) {
+        printf("  %s : %s mismatch\n", evaluator, check);
+    }
+    return success ? 0 : 1;
+}
+
+template <class EVALUATOR>
+static int
+checkEvaluator(EvalData const & data, char const * name) {
+
+    int failureCount = 0;
+    failureCount += report(checkStencilTableView<EVALUATOR>(data),
+        name, "stencil table view");
+    failureCount += report(checkReorderedStencils<EVALUATOR>(data),
+        name, "reordered stencils");
+    failureCount += report(checkStencilFrames<EVALUATOR>(data, 8),
+        name, "stencil frames");
+    failureCount += report(checkPatches<EVALUATOR>(data, 3),
+        name, "patches");
+    return failureCount;
+}
+
+//  Compressed stencil tables are not supported by all the evaluators:
+template <class EVALUATOR>
+static int
+checkCompressedEvaluator(EvalData const & data, char const * name) {
+
+    //  (weights are only compressed, with a loss, when requested)
+    int failureCount = 0;
+    failureCount += report(checkCompressedStencils<EVALUATOR>(data,
+        Far::CompressedStencilTable::Options().weightEncoding), name,
+        "compressed stencils (default)");
+    failureCount += report(checkCompressedStencils<EVALUATOR>(data,
+        Far::CompressedStencilTable::WEIGHT_HALF), name, "compressed stencils (half)");
+    failureCount += report(checkCompressedStencils<EVALUATOR>(data,
+        Far::CompressedStencilTable::WEIGHT_FIXED16), name, "compressed stencils (fixed16)");
+    return failureCount;
+}
+
+static int
+checkShape(Shape const & shape, std::string const & name, int maxlevel) {
+
+    static char const * schemes[] = { "Bilinear", "Catmark", "Loop" };
+    printf("- %-25s ( %-8s ): \n", name.c_str(), schemes[shape.scheme]);
+
+    EvalData data(shape, maxlevel);
+
+    int failureCount = 0;
+    failureCount += checkEvaluator<Osd::CpuEvaluator>(data, "CpuEvaluator");
+    failureCount += checkCompressedEvaluator<Osd::CpuEvaluator>(data, "CpuEvaluator");
+    failureCount += report(checkModifiedStencils(data, 16),
+        "CpuEvaluator", "modified stencils");
+    failureCount += report(checkLimitStencils(data, 3),
+        "CpuEvaluator", "limit stencils");
+#ifdef OPENSUBDIV_HAS_OPENMP
+    failureCount += checkEvaluator<Osd::OmpEvaluator>(data, "OmpEvaluator");
+    failureCount += checkCompressedEvaluator<Osd::OmpEvaluator>(data, "OmpEvaluator");
+#endif
+#ifdef OPENSUBDIV_HAS_TBB
+    failureCount += checkEvaluator<Osd::TbbEvaluator>(data, "TbbEvaluator");
+#endif
+
+    if (failureCount == 0) {
+        printf("  success !\n");
+    }
+    return failureCount;
+}
+
+//------------------------------------------------------------------------------
+int main(int /* argc */, char ** /* argv */) {
+
+    int levels=2, total=0;
+
+    initShapes();
+
+    for (int i=0; i<(int)g_shapes.size(); ++i) {
+        ShapeDesc const & desc = g_shapes[i];
+
+        Shape * shape = Shape::parseObj(desc.data.c_str(), desc.scheme,
+            desc.isLeftHanded);
+        if (shape) {
+            total+=checkShape(*shape, desc.name, levels);
+        }
+        delete shape;
+    }
+
+    if (total==0)
+      printf("All tests passed.\n");
+    else
+      printf("Total failures : %d\n", total);
+
+    return total ? 1 : 0;
+}
+
+//------------------------------------------------------------------------------
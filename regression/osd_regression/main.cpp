@@ -47,6 +47,7 @@ GLFWwindow* g_window=0;
 #include <cassert>
 
 #include <osd/cpuEvaluator.h>
+#include <osd/cpuKernel.h>
 #include <osd/cpuVertexBuffer.h>
 #include <osd/cpuGLVertexBuffer.h>
 #include <far/stencilTableFactory.h>
@@ -276,14 +277,24 @@ checkMeshCPU( FarTopologyRefiner *refiner,
         Osd::CpuVertexBuffer::Create(3, refiner->GetNumVerticesTotal());
     
     vb->UpdateData( coarseverts[0].GetPos(), 0, (int)coarseverts.size() );
-    
-    Osd::CpuEvaluator::EvalStencils(
-        vb, Osd::BufferDescriptor(0, 3, 3),
-        vb, Osd::BufferDescriptor(refiner->GetLevel(0).GetNumVertices()*3, 3, 3),
-        vertexStencils);
 
-    int result = checkVertexBuffer(*refiner, refmesh, vb->BindCpuBuffer(), 
-        vb->GetNumElements());
+    // check every SIMD variant of the stencil kernel supported by this CPU
+    int result = 0;
+    Osd::CpuKernelIsa defaultIsa = Osd::CpuGetKernelIsa();
+    for (int isa = Osd::CPU_KERNEL_ISA_SCALAR;
+        isa <= Osd::CpuGetSupportedKernelIsa(); ++isa) {
+
+        Osd::CpuSetKernelIsa((Osd::CpuKernelIsa)isa);
+
+        Osd::CpuEvaluator::EvalStencils(
+            vb, Osd::BufferDescriptor(0, 3, 3),
+            vb, Osd::BufferDescriptor(refiner->GetLevel(0).GetNumVertices()*3, 3, 3),
+            vertexStencils);
+
+        result += checkVertexBuffer(*refiner, refmesh, vb->BindCpuBuffer(),
+            vb->GetNumElements());
+    }
+    Osd::CpuSetKernelIsa(defaultIsa);
 
     delete vertexStencils;
     delete varyingStencils;